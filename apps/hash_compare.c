@@ -0,0 +1,505 @@
+/* vim: set tabstop=4 expandtab shiftwidth=4 softtabstop=4: */
+
+/**
+ * \file apps/hash_compare.c
+ *
+ * \brief An application to compare the throughput and the distribution of the hash functions.
+ *
+ * \author Simone Gattini, Federico Barbero, Anton Iliev
+ *
+ * \copyright 2015 University of Piemonte Orientale, Computer Science Institute
+ *
+ * This file is part of UPOalglib.
+ *
+ * UPOalglib is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * UPOalglib is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with UPOalglib.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <assert.h>
+#include <math.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <upo/bench.h>
+#include <upo/error.h>
+#include <upo/hash.h>
+#include <upo/hashtable.h>
+
+
+#define DEFAULT_OPT_NUM_KEYS (size_t) 1000000
+#define DEFAULT_OPT_NUM_BUCKETS (size_t) 8192
+#define DEFAULT_OPT_STR_LENGTH (size_t) 32
+#define DEFAULT_OPT_NUM_WARMUPS (size_t) 1
+#define DEFAULT_OPT_NUM_TRIALS (size_t) 5
+#define DEFAULT_OPT_RNG_SEED (unsigned int) time(NULL)
+#define DEFAULT_OPT_FORMAT upo_bench_text_format
+#define DEFAULT_OPT_PERF_COUNTERS 0
+#define NUM_DIST_METRICS (size_t) 2
+
+
+/** \brief The kinds of keys. */
+typedef enum {
+            int_key_kind, /**< Keys of type `int`. */
+            str_key_kind /**< Keys of type `char *`. */
+        } key_kind_t;
+
+/** \brief A hash function to compare. */
+typedef struct {
+            const char *id; /**< The name used on the command line. */
+            const char *name; /**< The descriptive name. */
+            key_kind_t kind; /**< The kind of keys it hashes. */
+            upo_ht_hasher_t hash; /**< The function, if it reduces hash values to the number of buckets by itself, or `NULL`. */
+            upo_ht_hasher64_t hash64; /**< The function, if it returns full-width hash values, or `NULL`. */
+        } hasher_impl_t;
+
+/** \brief Defines the state shared by the trials that measure a hash function. */
+typedef struct {
+            const hasher_impl_t *impl; /**< The hash function. */
+            const void *keys; /**< The keys: an array of `int` or of `char *`. */
+            size_t n; /**< The number of keys. */
+            size_t m; /**< The number of buckets passed to the functions that reduce hash values by themselves. */
+            uint64_t sink; /**< The combined hash values, which keeps the calls from being optimized away. */
+        } hash_trial_t;
+
+
+/** \brief Returns the address of the i-th key. */
+static const void* key_at(const hash_trial_t *trial, size_t i);
+
+/** \brief Returns the bucket of the i-th key. */
+static size_t bucket_of(const hash_trial_t *trial, size_t i);
+
+/** \brief Hashes all the keys. */
+static void hash_trial_run(void *arg);
+
+/** \brief Measures the given hash function, along with the distribution of its hash values over the buckets. */
+static void compare_hasher(upo_bench_t bench, const char *group, const hasher_impl_t *impl, const void *keys, size_t n, size_t num_buckets, size_t *counts);
+
+/** \brief Extracts the output format from the given string, returning zero if it is unknown. */
+static int parse_format(const char *str, upo_bench_format_t *format);
+
+/** \brief Displays a help message. */
+static void usage(const char *progname);
+
+
+static const hasher_impl_t hasher_impls[] = {
+    {"int_div", "Division", int_key_kind, upo_ht_hash_int_div, NULL},
+    {"int_mult_knuth", "Multiplication (Knuth)", int_key_kind, upo_ht_hash_int_mult_knuth, NULL},
+    {"int64", "Identity (64-bit)", int_key_kind, NULL, upo_ht_hash64_int},
+    {"hash_int", "SplitMix64 mixer", int_key_kind, NULL, upo_hash_int},
+    {"hash_int_seeded", "SplitMix64 mixer (seeded)", int_key_kind, NULL, upo_hash_int_seeded},
+    {"djb2", "djb2", str_key_kind, upo_ht_hash_str_djb2, NULL},
+    {"djb2a", "djb2a", str_key_kind, upo_ht_hash_str_djb2a, NULL},
+    {"java", "Java", str_key_kind, upo_ht_hash_str_java, NULL},
+    {"sgistl", "SGI STL", str_key_kind, upo_ht_hash_str_sgistl, NULL},
+    {"djb2_64", "djb2 (64-bit)", str_key_kind, NULL, upo_ht_hash64_str_djb2},
+    {"java_64", "Java (64-bit)", str_key_kind, NULL, upo_ht_hash64_str_java},
+    {"sgistl_64", "SGI STL (64-bit)", str_key_kind, NULL, upo_ht_hash64_str_sgistl},
+    {"hash_str", "Word-at-a-time", str_key_kind, NULL, upo_hash_str},
+    {"hash_str_seeded", "Word-at-a-time (seeded)", str_key_kind, NULL, upo_hash_str_seeded}
+};
+
+#define NUM_HASHER_IMPLS (sizeof(hasher_impls) / sizeof(hasher_impls[0]))
+
+static const char *const dist_metrics[] = {"chi2", "chi2_z"};
+
+
+const void* key_at(const hash_trial_t *trial, size_t i)
+{
+    if (trial->impl->kind == int_key_kind)
+    {
+        return (const int *) trial->keys + i;
+    }
+
+    return (char *const *) trial->keys + i;
+}
+
+size_t bucket_of(const hash_trial_t *trial, size_t i)
+{
+    const void *key = key_at(trial, i);
+
+    if (trial->impl->hash != NULL)
+    {
+        return trial->impl->hash(key, trial->m);
+    }
+
+    /* The low-order bits as they are, without the finalizer of the hash tables */
+    return (size_t) (trial->impl->hash64(key) % trial->m);
+}
+
+void hash_trial_run(void *arg)
+{
+    hash_trial_t *trial = arg;
+    uint64_t sink = 0;
+    size_t i;
+
+    if (trial->impl->hash != NULL)
+    {
+        for (i = 0; i < trial->n; ++i)
+        {
+            sink += trial->impl->hash(key_at(trial, i), trial->m);
+        }
+    }
+    else
+    {
+        for (i = 0; i < trial->n; ++i)
+        {
+            sink += trial->impl->hash64(key_at(trial, i));
+        }
+    }
+    trial->sink += sink;
+}
+
+void compare_hasher(upo_bench_t bench, const char *group, const hasher_impl_t *impl, const void *keys, size_t n, size_t num_buckets, size_t *counts)
+{
+    hash_trial_t trial;
+    double chi2;
+    size_t i;
+
+    trial.impl = impl;
+    trial.keys = keys;
+    trial.n = n;
+    trial.m = num_buckets;
+    trial.sink = 0;
+
+    memset(counts, 0, num_buckets*sizeof(size_t));
+    for (i = 0; i < n; ++i)
+    {
+        ++counts[bucket_of(&trial, i)];
+    }
+    chi2 = upo_hash_chi_square(counts, num_buckets);
+    upo_bench_set_metric(bench, 0, chi2);
+    upo_bench_set_metric(bench, 1, (chi2 - (num_buckets - 1)) / sqrt(2.0 * (num_buckets - 1)));
+
+    upo_bench_run(bench, group, impl->name, n, NULL, hash_trial_run, NULL, &trial, NULL);
+}
+
+int parse_format(const char *str, upo_bench_format_t *format)
+{
+    assert( str != NULL );
+    assert( format != NULL );
+
+    if (!strcmp("text", str))
+    {
+        *format = upo_bench_text_format;
+        return 1;
+    }
+    if (!strcmp("csv", str))
+    {
+        *format = upo_bench_csv_format;
+        return 1;
+    }
+    if (!strcmp("json", str))
+    {
+        *format = upo_bench_json_format;
+        return 1;
+    }
+
+    return 0;
+}
+
+void usage(const char *progname)
+{
+    size_t i;
+
+    fprintf(stderr, "Usage: %s <options>\n", progname);
+    fprintf(stderr, "Options:\n");
+    fprintf(stderr, "-a <value>: Specifies the hash function to use.\n"
+                    "            Possible values are:\n");
+    for (i = 0; i < NUM_HASHER_IMPLS; ++i)
+    {
+        fprintf(stderr, "            - %s: %s (%s keys)\n", hasher_impls[i].id, hasher_impls[i].name,
+                (hasher_impls[i].kind == int_key_kind) ? "integer" : "string");
+    }
+    fprintf(stderr, "            Repeats this option as many times as is the number of hash functions to use.\n"
+                    "            Integer keys are sequential, then spaced by 1024; string keys are the\n"
+                    "            decimal representations of sequential integers, then random letters (see -l).\n"
+                    "            Each measurement also reports the chi-square statistic of the distribution of\n"
+                    "            the keys over the buckets (see -b), and how many standard deviations it is from\n"
+                    "            the mean of a uniform distribution (chi2_z); 64-bit hash values are reduced by\n"
+                    "            modulo, without the finalizer of the hash tables.\n"
+                    "            [default: all of them]\n");
+    fprintf(stderr, "-b <value>: Specifies the number of buckets (it is also the capacity passed to the\n"
+                    "            hash functions that reduce their values by themselves; djb2 requires more\n"
+                    "            than 5381).\n"
+                    "            [default: %lu]\n", DEFAULT_OPT_NUM_BUCKETS);
+    fprintf(stderr, "-c: Also reports, for each measurement, the median number of CPU cycles, instructions,\n"
+                    "    cache misses, branch misses and the CPU time (task_clock, in ns) of the timed runs,\n"
+                    "    as counted by Linux perf events; the ones the system cannot count are omitted.\n"
+                    "    [default: <%s>]\n", (DEFAULT_OPT_PERF_COUNTERS ? "enabled" : "disabled"));
+    fprintf(stderr, "-h: Displays this message.\n");
+    fprintf(stderr, "-l <value>: Specifies the length of the random string keys.\n"
+                    "            [default: %lu]\n", DEFAULT_OPT_STR_LENGTH);
+    fprintf(stderr, "-n <value>: Specifies the number of keys.\n"
+                    "            [default: %lu]\n", DEFAULT_OPT_NUM_KEYS);
+    fprintf(stderr, "-o <value>: Specifies the output format of the measurements (text, csv or json).\n"
+                    "            [default: text]\n");
+    fprintf(stderr, "-r <value>: Specifies the number of timed trials of each measurement.\n"
+                    "            [default: %lu]\n", DEFAULT_OPT_NUM_TRIALS);
+    fprintf(stderr, "-s <value>: Specifies the seed for the random number generator.\n"
+                    "            [default: <current time>]\n");
+    fprintf(stderr, "-w <value>: Specifies the number of untimed warmup runs of each measurement.\n"
+                    "            [default: %lu]\n", DEFAULT_OPT_NUM_WARMUPS);
+}
+
+
+int main(int argc, char *argv[])
+{
+    size_t opt_n = DEFAULT_OPT_NUM_KEYS;
+    size_t opt_num_buckets = DEFAULT_OPT_NUM_BUCKETS;
+    size_t opt_str_len = DEFAULT_OPT_STR_LENGTH;
+    size_t opt_num_warmups = DEFAULT_OPT_NUM_WARMUPS;
+    size_t opt_num_trials = DEFAULT_OPT_NUM_TRIALS;
+    unsigned int opt_seed = DEFAULT_OPT_RNG_SEED;
+    upo_bench_format_t opt_format = DEFAULT_OPT_FORMAT;
+    int opt_perf_counters = DEFAULT_OPT_PERF_COUNTERS;
+    int opt_help = 0;
+    int chosen_impls[NUM_HASHER_IMPLS];
+    size_t num_impls = 0;
+    upo_bench_t bench = NULL;
+    int *int_keys = NULL;
+    char **str_keys = NULL;
+    char *str_data = NULL;
+    size_t *counts = NULL;
+    size_t str_size;
+    int arg;
+    size_t i;
+    size_t j;
+
+    memset(chosen_impls, 0, sizeof(chosen_impls));
+
+    for (arg = 1; arg < argc; ++arg)
+    {
+        if (!strcmp("-a", argv[arg]))
+        {
+            ++arg;
+            if (arg >= argc)
+            {
+                fprintf(stderr, "ERROR: expected hash function name.\n");
+                usage(argv[0]);
+                return EXIT_FAILURE;
+            }
+            for (i = 0; i < NUM_HASHER_IMPLS && strcmp(hasher_impls[i].id, argv[arg]); ++i)
+            {
+                ;
+            }
+            if (i == NUM_HASHER_IMPLS)
+            {
+                fprintf(stderr, "ERROR: unknown hash function name '%s'.\n", argv[arg]);
+                usage(argv[0]);
+                return EXIT_FAILURE;
+            }
+            if (chosen_impls[i] == 0)
+            {
+                chosen_impls[i] = 1;
+                ++num_impls;
+            }
+        }
+        else if (!strcmp("-b", argv[arg]))
+        {
+            ++arg;
+            if (arg >= argc)
+            {
+                fprintf(stderr, "ERROR: expected number of buckets.\n");
+                usage(argv[0]);
+                return EXIT_FAILURE;
+            }
+            opt_num_buckets = atol(argv[arg]);
+        }
+        else if (!strcmp("-c", argv[arg]))
+        {
+            opt_perf_counters = 1;
+        }
+        else if (!strcmp("-h", argv[arg]))
+        {
+            opt_help = 1;
+        }
+        else if (!strcmp("-l", argv[arg]))
+        {
+            ++arg;
+            if (arg >= argc)
+            {
+                fprintf(stderr, "ERROR: expected length of string keys.\n");
+                usage(argv[0]);
+                return EXIT_FAILURE;
+            }
+            opt_str_len = atol(argv[arg]);
+        }
+        else if (!strcmp("-n", argv[arg]))
+        {
+            ++arg;
+            if (arg >= argc)
+            {
+                fprintf(stderr, "ERROR: expected number of keys.\n");
+                usage(argv[0]);
+                return EXIT_FAILURE;
+            }
+            opt_n = atol(argv[arg]);
+        }
+        else if (!strcmp("-o", argv[arg]))
+        {
+            ++arg;
+            if (arg >= argc)
+            {
+                fprintf(stderr, "ERROR: expected output format.\n");
+                usage(argv[0]);
+                return EXIT_FAILURE;
+            }
+            if (!parse_format(argv[arg], &opt_format))
+            {
+                fprintf(stderr, "ERROR: unknown output format '%s'.\n", argv[arg]);
+                usage(argv[0]);
+                return EXIT_FAILURE;
+            }
+        }
+        else if (!strcmp("-r", argv[arg]))
+        {
+            ++arg;
+            if (arg >= argc)
+            {
+                fprintf(stderr, "ERROR: expected number of trials.\n");
+                usage(argv[0]);
+                return EXIT_FAILURE;
+            }
+            opt_num_trials = atol(argv[arg]);
+            if (opt_num_trials == 0)
+            {
+                fprintf(stderr, "ERROR: the number of trials must be positive.\n");
+                usage(argv[0]);
+                return EXIT_FAILURE;
+            }
+        }
+        else if (!strcmp("-s", argv[arg]))
+        {
+            ++arg;
+            if (arg >= argc)
+            {
+                fprintf(stderr, "ERROR: expected seed for random number generator.\n");
+                usage(argv[0]);
+                return EXIT_FAILURE;
+            }
+            opt_seed = atoi(argv[arg]);
+        }
+        else if (!strcmp("-w", argv[arg]))
+        {
+            ++arg;
+            if (arg >= argc)
+            {
+                fprintf(stderr, "ERROR: expected number of warmup runs.\n");
+                usage(argv[0]);
+                return EXIT_FAILURE;
+            }
+            opt_num_warmups = atol(argv[arg]);
+        }
+    }
+
+    if (opt_help)
+    {
+        usage(argv[0]);
+        return EXIT_SUCCESS;
+    }
+    if (opt_n == 0)
+    {
+        fprintf(stderr, "ERROR: the number of keys must be positive.\n");
+        usage(argv[0]);
+        return EXIT_FAILURE;
+    }
+    if (opt_num_buckets < 2)
+    {
+        fprintf(stderr, "ERROR: there must be at least two buckets.\n");
+        usage(argv[0]);
+        return EXIT_FAILURE;
+    }
+    if (num_impls == 0)
+    {
+        for (i = 0; i < NUM_HASHER_IMPLS; ++i)
+        {
+            chosen_impls[i] = 1;
+        }
+    }
+
+    /* Room for the random strings, or for the decimal ones (at most 20 digits) */
+    str_size = ((opt_str_len > 20) ? opt_str_len : 20) + 1;
+    int_keys = malloc(opt_n*sizeof(int));
+    str_keys = malloc(opt_n*sizeof(char *));
+    str_data = malloc(opt_n*str_size);
+    counts = malloc(opt_num_buckets*sizeof(size_t));
+    if (int_keys == NULL || str_keys == NULL || str_data == NULL || counts == NULL)
+    {
+        upo_throw_sys_error("Unable to allocate memory for the keys");
+    }
+    srand(opt_seed);
+    upo_hash_set_seed(upo_hash_random_seed());
+
+    bench = upo_bench_create(opt_num_warmups, opt_num_trials);
+    upo_bench_set_metrics(bench, dist_metrics, NUM_DIST_METRICS);
+    upo_bench_set_perf_counters(bench, opt_perf_counters);
+    upo_bench_set_output(bench, stdout, opt_format);
+
+    for (j = 0; j < 2; ++j)
+    {
+        const char *group = (j == 0) ? "int (sequential)" : "int (stride 1024)";
+
+        for (i = 0; i < opt_n; ++i)
+        {
+            int_keys[i] = (int) ((j == 0) ? i : i << 10);
+        }
+        for (i = 0; i < NUM_HASHER_IMPLS; ++i)
+        {
+            if (chosen_impls[i] == 1 && hasher_impls[i].kind == int_key_kind)
+            {
+                compare_hasher(bench, group, &hasher_impls[i], int_keys, opt_n, opt_num_buckets, counts);
+            }
+        }
+    }
+    for (j = 0; j < 2; ++j)
+    {
+        const char *group = (j == 0) ? "str (decimal)" : "str (random)";
+
+        for (i = 0; i < opt_n; ++i)
+        {
+            str_keys[i] = str_data + i*str_size;
+            if (j == 0)
+            {
+                sprintf(str_keys[i], "%lu", (unsigned long) i);
+            }
+            else
+            {
+                size_t k;
+
+                for (k = 0; k < opt_str_len; ++k)
+                {
+                    str_keys[i][k] = (char) ('a' + rand() % 26);
+                }
+                str_keys[i][opt_str_len] = '\0';
+            }
+        }
+        for (i = 0; i < NUM_HASHER_IMPLS; ++i)
+        {
+            if (chosen_impls[i] == 1 && hasher_impls[i].kind == str_key_kind)
+            {
+                compare_hasher(bench, group, &hasher_impls[i], str_keys, opt_n, opt_num_buckets, counts);
+            }
+        }
+    }
+    upo_bench_destroy(bench);
+
+    free(counts);
+    free(str_data);
+    free(str_keys);
+    free(int_keys);
+
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,739 @@
+/* vim: set tabstop=4 expandtab shiftwidth=4 softtabstop=4: */
+
+/**
+ * \file apps/map_compare.c
+ *
+ * \brief An application to compare the hash tables and the binary search tree.
+ *
+ * \author Simone Gattini, Federico Barbero, Anton Iliev
+ *
+ * \copyright 2015 University of Piemonte Orientale, Computer Science Institute
+ *
+ * This file is part of UPOalglib.
+ *
+ * UPOalglib is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * UPOalglib is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with UPOalglib.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <assert.h>
+#include <stddef.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <upo/bench.h>
+#include <upo/bst.h>
+#include <upo/error.h>
+#include <upo/hashtable.h>
+
+
+#define DEFAULT_OPT_NUM_KEYS (size_t) 10000
+#define DEFAULT_OPT_CAPACITY (size_t) 0
+#define DEFAULT_OPT_NUM_WARMUPS (size_t) 1
+#define DEFAULT_OPT_NUM_TRIALS (size_t) 5
+#define DEFAULT_OPT_RNG_SEED (unsigned int) time(NULL)
+#define DEFAULT_OPT_FORMAT upo_bench_text_format
+#define DEFAULT_OPT_PERF_COUNTERS 0
+
+
+/** \brief The operations of a map (symbol table) implementation, on opaque handles. */
+typedef struct {
+            const char *id; /**< The name used on the command line. */
+            const char *name; /**< The descriptive name. */
+            void* (*create)(size_t m); /**< Creates an empty map (\a m is the capacity of hash tables). */
+            void (*destroy)(void *map); /**< Destroys a map, but not its keys. */
+            void (*put)(void *map, void *key, void *value); /**< Inserts or updates a key. */
+            void* (*get)(void *map, const void *key); /**< Returns the value of a key, or `NULL`. */
+            void (*remove)(void *map, const void *key); /**< Deletes a key. */
+            int grows; /**< Tells whether the map resizes itself, so that it can start small. */
+            double (*load_factor)(void *map); /**< Returns the load factor of a hash table, or `NULL` for other maps. */
+        } map_impl_t;
+
+/** \brief Defines the state shared by the trials that measure an operation of a map. */
+typedef struct {
+            const map_impl_t *impl; /**< The map implementation. */
+            void *map; /**< The map. */
+            size_t m; /**< The capacity of hash tables. */
+            int *keys; /**< The keys stored in the map. */
+            int *missing_keys; /**< Keys that are not in the map. */
+            size_t n; /**< The number of keys of each array. */
+            size_t num_found; /**< The number of keys found by the last lookup, which keeps the lookups from being optimized away. */
+        } map_trial_t;
+
+
+static int int_comparator(const void *a, const void *b);
+
+static void* sepchain_create(size_t m);
+static void sepchain_destroy(void *map);
+static void sepchain_put(void *map, void *key, void *value);
+static void* sepchain_get(void *map, const void *key);
+static void sepchain_remove(void *map, const void *key);
+static double sepchain_load_factor(void *map);
+
+static void* sepchain_olist_create(size_t m);
+static void sepchain_olist_destroy(void *map);
+static void sepchain_olist_put(void *map, void *key, void *value);
+static void* sepchain_olist_get(void *map, const void *key);
+static void sepchain_olist_remove(void *map, const void *key);
+static double sepchain_olist_load_factor(void *map);
+
+static void* linprob_create(size_t m);
+static void linprob_destroy(void *map);
+static void linprob_put(void *map, void *key, void *value);
+static void* linprob_get(void *map, const void *key);
+static void linprob_remove(void *map, const void *key);
+static double linprob_load_factor(void *map);
+
+static void* linprob_pow2_create(size_t m);
+
+static void* robinhood_create(size_t m);
+static void robinhood_destroy(void *map);
+static void robinhood_put(void *map, void *key, void *value);
+static void* robinhood_get(void *map, const void *key);
+static void robinhood_remove(void *map, const void *key);
+static double robinhood_load_factor(void *map);
+
+static void* robinhood_pow2_create(size_t m);
+
+static void* swiss_create(size_t m);
+static void swiss_destroy(void *map);
+static void swiss_put(void *map, void *key, void *value);
+static void* swiss_get(void *map, const void *key);
+static void swiss_remove(void *map, const void *key);
+static double swiss_load_factor(void *map);
+
+static void* bst_create(size_t m);
+static void bst_destroy(void *map);
+static void bst_put(void *map, void *key, void *value);
+static void* bst_get(void *map, const void *key);
+static void bst_remove(void *map, const void *key);
+
+/** \brief Creates an empty map. */
+static void map_trial_create(void *arg);
+
+/** \brief Creates a map holding all the keys. */
+static void map_trial_fill(void *arg);
+
+/** \brief Destroys the map. */
+static void map_trial_destroy(void *arg);
+
+/** \brief Inserts all the keys. */
+static void map_trial_put(void *arg);
+
+/** \brief Looks up all the keys in the map. */
+static void map_trial_get_hit(void *arg);
+
+/** \brief Looks up keys that are not in the map. */
+static void map_trial_get_miss(void *arg);
+
+/** \brief Deletes all the keys. */
+static void map_trial_remove(void *arg);
+
+/** \brief Alternately inserts a missing key and deletes a stored one, so that the size of the map stays the same. */
+static void map_trial_churn(void *arg);
+
+/** \brief Measures the operations of the given map implementation. */
+static void compare_operations(upo_bench_t bench, const map_impl_t *impl, int *keys, int *missing_keys, size_t n, size_t m);
+
+/** \brief Extracts the output format from the given string, returning zero if it is unknown. */
+static int parse_format(const char *str, upo_bench_format_t *format);
+
+/** \brief Displays a help message. */
+static void usage(const char *progname);
+
+
+static const map_impl_t map_impls[] = {
+    {"sepchain", "Hash table (separate chaining)", sepchain_create, sepchain_destroy, sepchain_put, sepchain_get, sepchain_remove, 0, sepchain_load_factor},
+    {"sepchain_olist", "Hash table (separate chaining, ordered lists)", sepchain_olist_create, sepchain_olist_destroy, sepchain_olist_put, sepchain_olist_get, sepchain_olist_remove, 0, sepchain_olist_load_factor},
+    {"linprob", "Hash table (linear probing)", linprob_create, linprob_destroy, linprob_put, linprob_get, linprob_remove, 1, linprob_load_factor},
+    {"linprob_pow2", "Hash table (linear probing, power-of-two capacity)", linprob_pow2_create, linprob_destroy, linprob_put, linprob_get, linprob_remove, 1, linprob_load_factor},
+    {"robinhood", "Hash table (Robin Hood hashing)", robinhood_create, robinhood_destroy, robinhood_put, robinhood_get, robinhood_remove, 1, robinhood_load_factor},
+    {"robinhood_pow2", "Hash table (Robin Hood hashing, power-of-two capacity)", robinhood_pow2_create, robinhood_destroy, robinhood_put, robinhood_get, robinhood_remove, 1, robinhood_load_factor},
+    {"swiss", "Hash table (Swiss table)", swiss_create, swiss_destroy, swiss_put, swiss_get, swiss_remove, 1, swiss_load_factor},
+    {"bst", "Binary search tree", bst_create, bst_destroy, bst_put, bst_get, bst_remove, 0, NULL}
+};
+
+#define NUM_MAP_IMPLS (sizeof(map_impls) / sizeof(map_impls[0]))
+
+/** \brief The metrics of the measurements: the load factor of hash tables during lookups. */
+static const char *const map_metrics[] = {"load"};
+
+#define NUM_MAP_METRICS (sizeof(map_metrics) / sizeof(map_metrics[0]))
+
+
+int int_comparator(const void *a, const void *b)
+{
+    const int *aa = a;
+    const int *bb = b;
+
+    return (*aa > *bb) - (*aa < *bb);
+}
+
+void* sepchain_create(size_t m)
+{
+    return upo_ht_sepchain_create(m, upo_ht_hash_int_div, int_comparator);
+}
+
+void sepchain_destroy(void *map)
+{
+    upo_ht_sepchain_destroy(map, 0);
+}
+
+void sepchain_put(void *map, void *key, void *value)
+{
+    upo_ht_sepchain_put(map, key, value);
+}
+
+void* sepchain_get(void *map, const void *key)
+{
+    return upo_ht_sepchain_get(map, key);
+}
+
+void sepchain_remove(void *map, const void *key)
+{
+    upo_ht_sepchain_delete(map, key, 0);
+}
+
+double sepchain_load_factor(void *map)
+{
+    return upo_ht_sepchain_load_factor(map);
+}
+
+void* sepchain_olist_create(size_t m)
+{
+    return upo_ht_sepchain_olist_create(m, upo_ht_hash_int_div, int_comparator);
+}
+
+void sepchain_olist_destroy(void *map)
+{
+    upo_ht_sepchain_olist_destroy(map, 0);
+}
+
+void sepchain_olist_put(void *map, void *key, void *value)
+{
+    upo_ht_sepchain_olist_put(map, key, value);
+}
+
+void* sepchain_olist_get(void *map, const void *key)
+{
+    return upo_ht_sepchain_olist_get(map, key);
+}
+
+void sepchain_olist_remove(void *map, const void *key)
+{
+    upo_ht_sepchain_olist_delete(map, key, 0);
+}
+
+double sepchain_olist_load_factor(void *map)
+{
+    return upo_ht_sepchain_olist_load_factor(map);
+}
+
+void* linprob_create(size_t m)
+{
+    return upo_ht_linprob_create(m, upo_ht_hash_int_div, int_comparator);
+}
+
+void linprob_destroy(void *map)
+{
+    upo_ht_linprob_destroy(map, 0);
+}
+
+void linprob_put(void *map, void *key, void *value)
+{
+    upo_ht_linprob_put(map, key, value);
+}
+
+void* linprob_get(void *map, const void *key)
+{
+    return upo_ht_linprob_get(map, key);
+}
+
+void linprob_remove(void *map, const void *key)
+{
+    upo_ht_linprob_delete(map, key, 0);
+}
+
+double linprob_load_factor(void *map)
+{
+    return upo_ht_linprob_load_factor(map);
+}
+
+void* linprob_pow2_create(size_t m)
+{
+    return upo_ht_linprob_create_hash64(m, upo_ht_hash64_int, int_comparator, 1);
+}
+
+void* robinhood_create(size_t m)
+{
+    return upo_ht_robinhood_create(m, upo_ht_hash_int_div, int_comparator);
+}
+
+void robinhood_destroy(void *map)
+{
+    upo_ht_robinhood_destroy(map, 0);
+}
+
+void robinhood_put(void *map, void *key, void *value)
+{
+    upo_ht_robinhood_put(map, key, value);
+}
+
+void* robinhood_get(void *map, const void *key)
+{
+    return upo_ht_robinhood_get(map, key);
+}
+
+void robinhood_remove(void *map, const void *key)
+{
+    upo_ht_robinhood_delete(map, key, 0);
+}
+
+double robinhood_load_factor(void *map)
+{
+    return upo_ht_robinhood_load_factor(map);
+}
+
+void* robinhood_pow2_create(size_t m)
+{
+    return upo_ht_robinhood_create_hash64(m, upo_ht_hash64_int, int_comparator, 1);
+}
+
+void* swiss_create(size_t m)
+{
+    return upo_ht_swiss_create(m, upo_ht_hash64_int, int_comparator);
+}
+
+void swiss_destroy(void *map)
+{
+    upo_ht_swiss_destroy(map, 0);
+}
+
+void swiss_put(void *map, void *key, void *value)
+{
+    upo_ht_swiss_put(map, key, value);
+}
+
+void* swiss_get(void *map, const void *key)
+{
+    return upo_ht_swiss_get(map, key);
+}
+
+void swiss_remove(void *map, const void *key)
+{
+    upo_ht_swiss_delete(map, key, 0);
+}
+
+double swiss_load_factor(void *map)
+{
+    return upo_ht_swiss_load_factor(map);
+}
+
+void* bst_create(size_t m)
+{
+    (void) m;
+
+    return upo_bst_create(int_comparator);
+}
+
+void bst_destroy(void *map)
+{
+    upo_bst_destroy(map, 0);
+}
+
+void bst_put(void *map, void *key, void *value)
+{
+    upo_bst_put(map, key, value);
+}
+
+void* bst_get(void *map, const void *key)
+{
+    return upo_bst_get(map, key);
+}
+
+void bst_remove(void *map, const void *key)
+{
+    upo_bst_delete(map, key, 0);
+}
+
+void map_trial_create(void *arg)
+{
+    map_trial_t *trial = arg;
+
+    trial->map = trial->impl->create(trial->m);
+}
+
+void map_trial_fill(void *arg)
+{
+    map_trial_t *trial = arg;
+
+    map_trial_create(trial);
+    map_trial_put(trial);
+}
+
+void map_trial_destroy(void *arg)
+{
+    map_trial_t *trial = arg;
+
+    trial->impl->destroy(trial->map);
+    trial->map = NULL;
+}
+
+void map_trial_put(void *arg)
+{
+    map_trial_t *trial = arg;
+    size_t i;
+
+    for (i = 0; i < trial->n; ++i)
+    {
+        /* The key is its own value */
+        trial->impl->put(trial->map, &trial->keys[i], &trial->keys[i]);
+    }
+}
+
+void map_trial_get_hit(void *arg)
+{
+    map_trial_t *trial = arg;
+    size_t i;
+
+    trial->num_found = 0;
+    for (i = 0; i < trial->n; ++i)
+    {
+        trial->num_found += (trial->impl->get(trial->map, &trial->keys[i]) != NULL);
+    }
+    assert( trial->num_found == trial->n );
+}
+
+void map_trial_get_miss(void *arg)
+{
+    map_trial_t *trial = arg;
+    size_t i;
+
+    trial->num_found = 0;
+    for (i = 0; i < trial->n; ++i)
+    {
+        trial->num_found += (trial->impl->get(trial->map, &trial->missing_keys[i]) != NULL);
+    }
+    assert( trial->num_found == 0 );
+}
+
+void map_trial_remove(void *arg)
+{
+    map_trial_t *trial = arg;
+    size_t i;
+
+    for (i = 0; i < trial->n; ++i)
+    {
+        trial->impl->remove(trial->map, &trial->keys[i]);
+    }
+}
+
+void map_trial_churn(void *arg)
+{
+    map_trial_t *trial = arg;
+    size_t i;
+
+    for (i = 0; i < trial->n; ++i)
+    {
+        trial->impl->put(trial->map, &trial->missing_keys[i], &trial->missing_keys[i]);
+        trial->impl->remove(trial->map, &trial->keys[i]);
+    }
+}
+
+void compare_operations(upo_bench_t bench, const map_impl_t *impl, int *keys, int *missing_keys, size_t n, size_t m)
+{
+    map_trial_t trial;
+
+    trial.impl = impl;
+    trial.map = NULL;
+    trial.m = m;
+    trial.keys = keys;
+    trial.missing_keys = missing_keys;
+    trial.n = n;
+    trial.num_found = 0;
+
+    upo_bench_run(bench, "put", impl->name, n, map_trial_create, map_trial_put, map_trial_destroy, &trial, NULL);
+    if (impl->grows)
+    {
+        /* Bulk load into a table of the default capacity, which includes every rehash */
+        trial.m = UPO_HT_LINPROB_DEFAULT_CAPACITY;
+        upo_bench_run(bench, "put (growing)", impl->name, n, map_trial_create, map_trial_put, map_trial_destroy, &trial, NULL);
+        trial.m = m;
+    }
+
+    /* Lookups do not modify the map, so all of their trials share the same one */
+    map_trial_fill(&trial);
+    if (impl->load_factor != NULL)
+    {
+        upo_bench_set_metric(bench, 0, impl->load_factor(trial.map));
+    }
+    upo_bench_run(bench, "get (hit)", impl->name, n, NULL, map_trial_get_hit, NULL, &trial, NULL);
+    if (impl->load_factor != NULL)
+    {
+        upo_bench_set_metric(bench, 0, impl->load_factor(trial.map));
+    }
+    upo_bench_run(bench, "get (miss)", impl->name, n, NULL, map_trial_get_miss, NULL, &trial, NULL);
+    map_trial_destroy(&trial);
+
+    upo_bench_run(bench, "delete", impl->name, n, map_trial_fill, map_trial_remove, map_trial_destroy, &trial, NULL);
+    upo_bench_run(bench, "churn", impl->name, n, map_trial_fill, map_trial_churn, map_trial_destroy, &trial, NULL);
+}
+
+int parse_format(const char *str, upo_bench_format_t *format)
+{
+    assert( str != NULL );
+    assert( format != NULL );
+
+    if (!strcmp("text", str))
+    {
+        *format = upo_bench_text_format;
+        return 1;
+    }
+    if (!strcmp("csv", str))
+    {
+        *format = upo_bench_csv_format;
+        return 1;
+    }
+    if (!strcmp("json", str))
+    {
+        *format = upo_bench_json_format;
+        return 1;
+    }
+
+    return 0;
+}
+
+void usage(const char *progname)
+{
+    size_t i;
+
+    fprintf(stderr, "Usage: %s <options>\n", progname);
+    fprintf(stderr, "Options:\n");
+    fprintf(stderr, "-a <value>: Specifies the data structure to use.\n"
+                    "            Possible values are:\n");
+    for (i = 0; i < NUM_MAP_IMPLS; ++i)
+    {
+        fprintf(stderr, "            - %s: %s\n", map_impls[i].id, map_impls[i].name);
+    }
+    fprintf(stderr, "            Repeats this option as many times as is the number of data structures to use.\n"
+                    "            [default: all of them]\n");
+    fprintf(stderr, "-c: Also reports, for each measurement, the median number of CPU cycles, instructions,\n"
+                    "    cache misses, branch misses and the CPU time (task_clock, in ns) of the timed runs,\n"
+                    "    as counted by Linux perf events; the ones the system cannot count are omitted.\n"
+                    "    [default: <%s>]\n", (DEFAULT_OPT_PERF_COUNTERS ? "enabled" : "disabled"));
+    fprintf(stderr, "-h: Displays this message.\n");
+    fprintf(stderr, "-m <value>: Specifies the initial capacity of the hash tables (0 means as many\n"
+                    "            slots as keys); the hash tables that resize themselves are also\n"
+                    "            measured while growing from %u slots (put (growing)).\n"
+                    "            [default: %lu]\n", UPO_HT_LINPROB_DEFAULT_CAPACITY, DEFAULT_OPT_CAPACITY);
+    fprintf(stderr, "-n <value>: Specifies the number of keys.\n"
+                    "            [default: %lu]\n", DEFAULT_OPT_NUM_KEYS);
+    fprintf(stderr, "-o <value>: Specifies the output format of the measurements (text, csv or json).\n"
+                    "            [default: text]\n");
+    fprintf(stderr, "-r <value>: Specifies the number of timed trials of each measurement.\n"
+                    "            [default: %lu]\n", DEFAULT_OPT_NUM_TRIALS);
+    fprintf(stderr, "-s <value>: Specifies the seed for the random number generator.\n"
+                    "            [default: <current time>]\n");
+    fprintf(stderr, "-w <value>: Specifies the number of untimed warmup runs of each measurement.\n"
+                    "            [default: %lu]\n", DEFAULT_OPT_NUM_WARMUPS);
+}
+
+
+int main(int argc, char *argv[])
+{
+    size_t opt_n = DEFAULT_OPT_NUM_KEYS;
+    size_t opt_m = DEFAULT_OPT_CAPACITY;
+    size_t opt_num_warmups = DEFAULT_OPT_NUM_WARMUPS;
+    size_t opt_num_trials = DEFAULT_OPT_NUM_TRIALS;
+    unsigned int opt_seed = DEFAULT_OPT_RNG_SEED;
+    upo_bench_format_t opt_format = DEFAULT_OPT_FORMAT;
+    int opt_perf_counters = DEFAULT_OPT_PERF_COUNTERS;
+    int opt_help = 0;
+    int chosen_impls[NUM_MAP_IMPLS];
+    size_t num_impls = 0;
+    upo_bench_t bench = NULL;
+    int *keys = NULL;
+    int arg;
+    size_t i;
+
+    memset(chosen_impls, 0, sizeof(chosen_impls));
+
+    for (arg = 1; arg < argc; ++arg)
+    {
+        if (!strcmp("-a", argv[arg]))
+        {
+            ++arg;
+            if (arg >= argc)
+            {
+                fprintf(stderr, "ERROR: expected data structure name.\n");
+                usage(argv[0]);
+                return EXIT_FAILURE;
+            }
+            for (i = 0; i < NUM_MAP_IMPLS && strcmp(map_impls[i].id, argv[arg]); ++i)
+            {
+                ;
+            }
+            if (i == NUM_MAP_IMPLS)
+            {
+                fprintf(stderr, "ERROR: unknown data structure name '%s'.\n", argv[arg]);
+                usage(argv[0]);
+                return EXIT_FAILURE;
+            }
+            if (chosen_impls[i] == 0)
+            {
+                chosen_impls[i] = 1;
+                ++num_impls;
+            }
+        }
+        else if (!strcmp("-c", argv[arg]))
+        {
+            opt_perf_counters = 1;
+        }
+        else if (!strcmp("-h", argv[arg]))
+        {
+            opt_help = 1;
+        }
+        else if (!strcmp("-m", argv[arg]))
+        {
+            ++arg;
+            if (arg >= argc)
+            {
+                fprintf(stderr, "ERROR: expected hash table capacity.\n");
+                usage(argv[0]);
+                return EXIT_FAILURE;
+            }
+            opt_m = atol(argv[arg]);
+        }
+        else if (!strcmp("-n", argv[arg]))
+        {
+            ++arg;
+            if (arg >= argc)
+            {
+                fprintf(stderr, "ERROR: expected number of keys.\n");
+                usage(argv[0]);
+                return EXIT_FAILURE;
+            }
+            opt_n = atol(argv[arg]);
+        }
+        else if (!strcmp("-o", argv[arg]))
+        {
+            ++arg;
+            if (arg >= argc)
+            {
+                fprintf(stderr, "ERROR: expected output format.\n");
+                usage(argv[0]);
+                return EXIT_FAILURE;
+            }
+            if (!parse_format(argv[arg], &opt_format))
+            {
+                fprintf(stderr, "ERROR: unknown output format '%s'.\n", argv[arg]);
+                usage(argv[0]);
+                return EXIT_FAILURE;
+            }
+        }
+        else if (!strcmp("-r", argv[arg]))
+        {
+            ++arg;
+            if (arg >= argc)
+            {
+                fprintf(stderr, "ERROR: expected number of trials.\n");
+                usage(argv[0]);
+                return EXIT_FAILURE;
+            }
+            opt_num_trials = atol(argv[arg]);
+            if (opt_num_trials == 0)
+            {
+                fprintf(stderr, "ERROR: the number of trials must be positive.\n");
+                usage(argv[0]);
+                return EXIT_FAILURE;
+            }
+        }
+        else if (!strcmp("-s", argv[arg]))
+        {
+            ++arg;
+            if (arg >= argc)
+            {
+                fprintf(stderr, "ERROR: expected seed for random number generator.\n");
+                usage(argv[0]);
+                return EXIT_FAILURE;
+            }
+            opt_seed = atoi(argv[arg]);
+        }
+        else if (!strcmp("-w", argv[arg]))
+        {
+            ++arg;
+            if (arg >= argc)
+            {
+                fprintf(stderr, "ERROR: expected number of warmup runs.\n");
+                usage(argv[0]);
+                return EXIT_FAILURE;
+            }
+            opt_num_warmups = atol(argv[arg]);
+        }
+    }
+
+    if (opt_help)
+    {
+        usage(argv[0]);
+        return EXIT_SUCCESS;
+    }
+    if (opt_n == 0)
+    {
+        fprintf(stderr, "ERROR: the number of keys must be positive.\n");
+        usage(argv[0]);
+        return EXIT_FAILURE;
+    }
+    if (opt_m == 0)
+    {
+        opt_m = opt_n;
+    }
+    if (num_impls == 0)
+    {
+        for (i = 0; i < NUM_MAP_IMPLS; ++i)
+        {
+            chosen_impls[i] = 1;
+        }
+    }
+
+    /* A random permutation of 0..2n-1: the first half is stored, the second one is missing */
+    keys = malloc(2*opt_n*sizeof(int));
+    if (keys == NULL)
+    {
+        upo_throw_sys_error("Unable to allocate memory for the keys");
+    }
+    srand(opt_seed);
+    for (i = 0; i < 2*opt_n; ++i)
+    {
+        size_t j = (size_t) rand() % (i + 1);
+
+        keys[i] = keys[j];
+        keys[j] = (int) i;
+    }
+
+    bench = upo_bench_create(opt_num_warmups, opt_num_trials);
+    upo_bench_set_metrics(bench, map_metrics, NUM_MAP_METRICS);
+    upo_bench_set_perf_counters(bench, opt_perf_counters);
+    upo_bench_set_output(bench, stdout, opt_format);
+    for (i = 0; i < NUM_MAP_IMPLS; ++i)
+    {
+        if (chosen_impls[i] == 1)
+        {
+            compare_operations(bench, &map_impls[i], keys, keys + opt_n, opt_n, opt_m);
+        }
+    }
+    upo_bench_destroy(bench);
+
+    free(keys);
+
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1 @@
+apps_targets += hash_compare
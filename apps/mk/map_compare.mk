@@ -0,0 +1 @@
+apps_targets += map_compare
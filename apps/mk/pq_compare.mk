@@ -0,0 +1 @@
+apps_targets += pq_compare
@@ -37,6 +37,7 @@
 
 #define PLAYLIST_ENTRY_DELIMITER '|'
 #define PLAYLIST_ENTRY_NUM_FIELDS 5
+#define PLAYLIST_KEY_STR_WIDTH 12
 
 /** \brief Defines the type of an entry of a playlist. */
 typedef struct
@@ -55,6 +56,15 @@ struct playlist_s
     size_t size;
 };
 
+/** \brief Criteria of a multi-criterion sort, passed as context to the key
+ *   and comparison functions. */
+typedef struct
+{
+    const playlist_sorting_criterion_t *order_by; /**< The criteria, by decreasing priority. */
+    size_t num_criteria; /**< The number of criteria. */
+    size_t num_key_criteria; /**< The number of leading criteria encoded in the sort key. */
+} multi_sort_ctx_t;
+
 /** \brief Destroys the given playlist entry. */
 static void playlist_entry_destroy(entry_t *entry);
 
@@ -73,6 +83,49 @@ static int by_track_title_comparator(const void *a, const void *b);
 /** \brief Comparison function for playlist entries based on album release year */
 static int by_year_comparator(const void *a, const void *b);
 
+/** \brief Key extraction function for playlist entries returning the artist name */
+static const char *artist_key(const void *a);
+
+/** \brief Key extraction function for playlist entries returning the album name */
+static const char *album_key(const void *a);
+
+/** \brief Key extraction function for pointers to playlist entries returning the artist name */
+static const char *artist_ref_key(const void *a);
+
+/** \brief Key extraction function for pointers to playlist entries returning the album name */
+static const char *album_ref_key(const void *a);
+
+/** \brief Returns the first 4 characters of the given string, packed most
+ *   significant first, so that they order like strcmp. */
+static uint32_t string_prefix(const char *s);
+
+/** \brief Key prefix function for playlist entries based on artist name */
+static uint32_t artist_prefix(const void *a);
+
+/** \brief Key prefix function for playlist entries based on album name */
+static uint32_t album_prefix(const void *a);
+
+/** \brief Key prefix function for playlist entries based on album release year */
+static uint32_t year_prefix(const void *a);
+
+/** \brief Key prefix function for playlist entries based on track number */
+static uint32_t track_number_prefix(const void *a);
+
+/** \brief Key prefix function for playlist entries based on track title */
+static uint32_t track_title_prefix(const void *a);
+
+/** \brief Returns the comparison and key prefix functions of the given
+ *   sorting criterion. */
+static void get_sorting_functions(playlist_sorting_criterion_t order_by, upo_sort_comparator_t *cmp, upo_sort_u32_key_t *prefix);
+
+/** \brief Writes the normalized sort key of a playlist entry for a
+ *   multi-criterion sort. */
+static void multi_criteria_key(const void *a, unsigned char *key, void *ctx);
+
+/** \brief Comparison function for playlist entries based on the criteria of
+ *   a multi-criterion sort. */
+static int multi_criteria_comparator(const void *a, const void *b, void *ctx);
+
 /** \brief Extracts a playlist entry from the given string. */
 static int parse_entry(const char *str, entry_t *entry);
 
@@ -80,18 +133,12 @@ static int parse_entry(const char *str, entry_t *entry);
 
 int by_artist_comparator(const void *a, const void *b)
 {
-    const entry_t aa = *(const entry_t *)a;
-    const entry_t bb = *(const entry_t *)b;
-
-    return strcmp(aa.artist, bb.artist);
+    return strcmp(((const entry_t *)a)->artist, ((const entry_t *)b)->artist);
 }
 
 int by_album_comparator(const void *a, const void *b)
 {
-    const entry_t aa = *(const entry_t *)a;
-    const entry_t bb = *(const entry_t *)b;
-
-    return strcmp(aa.album, bb.album);
+    return strcmp(((const entry_t *)a)->album, ((const entry_t *)b)->album);
 }
 
 int by_year_comparator(const void *a, const void *b)
@@ -118,24 +165,91 @@ int by_track_title_comparator(const void *a, const void *b)
     return strcmp(aa.track_title, bb.track_title);
 }
 
-void playlist_sort(playlist_t playlist, playlist_sorting_criterion_t order_by)
+const char *artist_key(const void *a)
+{
+    return ((const entry_t *)a)->artist;
+}
+
+const char *album_key(const void *a)
+{
+    return ((const entry_t *)a)->album;
+}
+
+const char *artist_ref_key(const void *a)
+{
+    return (*(const entry_t *const *)a)->artist;
+}
+
+const char *album_ref_key(const void *a)
+{
+    return (*(const entry_t *const *)a)->album;
+}
+
+uint32_t string_prefix(const char *s)
+{
+    uint32_t prefix = 0;
+    size_t i;
+
+    for (i = 0; i < 4; ++i)
+    {
+        prefix <<= 8;
+        if (*s != '\0')
+        {
+            prefix |= (unsigned char) *s++;
+        }
+    }
+
+    return prefix;
+}
+
+uint32_t artist_prefix(const void *a)
+{
+    return string_prefix(((const entry_t *)a)->artist);
+}
+
+uint32_t album_prefix(const void *a)
+{
+    return string_prefix(((const entry_t *)a)->album);
+}
+
+uint32_t year_prefix(const void *a)
+{
+    return (uint32_t) ((const entry_t *)a)->year ^ 0x80000000U;
+}
+
+uint32_t track_number_prefix(const void *a)
+{
+    return (uint32_t) ((const entry_t *)a)->track_num ^ 0x80000000U;
+}
+
+uint32_t track_title_prefix(const void *a)
+{
+    return string_prefix(((const entry_t *)a)->track_title);
+}
+
+void get_sorting_functions(playlist_sorting_criterion_t order_by, upo_sort_comparator_t *cmp, upo_sort_u32_key_t *prefix)
 {
     switch (order_by)
     {
     case playlist_by_artist_sorting_criterion:
-        upo_merge_sort(playlist->entries, playlist->size, sizeof(playlist->entries[0]), by_artist_comparator);
+        *cmp = by_artist_comparator;
+        *prefix = artist_prefix;
         break;
     case playlist_by_album_sorting_criterion:
-        upo_merge_sort(playlist->entries, playlist->size, sizeof(playlist->entries[0]), by_album_comparator);
+        *cmp = by_album_comparator;
+        *prefix = album_prefix;
         break;
     case playlist_by_year_sorting_criterion:
-        upo_merge_sort(playlist->entries, playlist->size, sizeof(playlist->entries[0]), by_year_comparator);
+        *cmp = by_year_comparator;
+        *prefix = year_prefix;
         break;
     case playlist_by_track_number_sorting_criterion:
-        upo_merge_sort(playlist->entries, playlist->size, sizeof(playlist->entries[0]), by_track_number_comparator);
+        *cmp = by_track_number_comparator;
+        *prefix = track_number_prefix;
         break;
     case playlist_by_track_title_sorting_criterion:
-        upo_merge_sort(playlist->entries, playlist->size, sizeof(playlist->entries[0]), by_track_title_comparator);
+        *cmp = by_track_title_comparator;
+        *prefix = track_title_prefix;
         break;
     case playlist_unknown_sorting_criterion:
     default:
@@ -145,6 +259,161 @@ void playlist_sort(playlist_t playlist, playlist_sorting_criterion_t order_by)
     }
 }
 
+void multi_criteria_key(const void *a, unsigned char *key, void *ctx)
+{
+    const entry_t *entry = a;
+    const multi_sort_ctx_t *ms = ctx;
+    size_t i;
+
+    for (i = 0; i < ms->num_key_criteria; ++i)
+    {
+        switch (ms->order_by[i])
+        {
+        case playlist_by_artist_sorting_criterion:
+            key = upo_sort_key_put_str(key, entry->artist, PLAYLIST_KEY_STR_WIDTH);
+            break;
+        case playlist_by_album_sorting_criterion:
+            key = upo_sort_key_put_str(key, entry->album, PLAYLIST_KEY_STR_WIDTH);
+            break;
+        case playlist_by_year_sorting_criterion:
+            key = upo_sort_key_put_i32(key, entry->year);
+            break;
+        case playlist_by_track_number_sorting_criterion:
+            key = upo_sort_key_put_i32(key, entry->track_num);
+            break;
+        case playlist_by_track_title_sorting_criterion:
+            key = upo_sort_key_put_str(key, entry->track_title, PLAYLIST_KEY_STR_WIDTH);
+            break;
+        case playlist_unknown_sorting_criterion:
+        default:
+            perror("Unknown criterion");
+            abort();
+            break;
+        }
+    }
+}
+
+int multi_criteria_comparator(const void *a, const void *b, void *ctx)
+{
+    const multi_sort_ctx_t *ms = ctx;
+    int res = 0;
+    size_t i;
+
+    for (i = 0; i < ms->num_criteria && res == 0; ++i)
+    {
+        upo_sort_comparator_t cmp = NULL;
+        upo_sort_u32_key_t prefix = NULL;
+
+        get_sorting_functions(ms->order_by[i], &cmp, &prefix);
+        res = cmp(a, b);
+    }
+
+    return res;
+}
+
+void playlist_sort(playlist_t playlist, playlist_sorting_criterion_t order_by)
+{
+    upo_sort_comparator_t cmp = NULL;
+    upo_sort_u32_key_t prefix = NULL;
+
+    assert(playlist != NULL);
+
+    /* String criteria use the (stable) MSD radix sort, which orders keys
+     * like strcmp; the other ones sort (key prefix, pointer) pairs and move
+     * each entry once. */
+    switch (order_by)
+    {
+    case playlist_by_artist_sorting_criterion:
+        upo_radix_sort_str(playlist->entries, playlist->size, sizeof(playlist->entries[0]), artist_key);
+        break;
+    case playlist_by_album_sorting_criterion:
+        upo_radix_sort_str(playlist->entries, playlist->size, sizeof(playlist->entries[0]), album_key);
+        break;
+    default:
+        get_sorting_functions(order_by, &cmp, &prefix);
+        upo_sort_indirect(playlist->entries, playlist->size, sizeof(playlist->entries[0]), cmp, prefix);
+        break;
+    }
+}
+
+void playlist_sort_permutation(const playlist_t playlist, playlist_sorting_criterion_t order_by, size_t *perm)
+{
+    upo_sort_comparator_t cmp = NULL;
+    upo_sort_u32_key_t prefix = NULL;
+    const entry_t **refs = NULL;
+    size_t i;
+
+    assert(playlist != NULL);
+    assert(perm != NULL);
+
+    if (playlist->size == 0)
+    {
+        return;
+    }
+
+    /* As in playlist_sort(), string criteria use the MSD radix sort: it
+     * sorts pointers to the entries, whose offsets give the order. */
+    switch (order_by)
+    {
+    case playlist_by_artist_sorting_criterion:
+    case playlist_by_album_sorting_criterion:
+        refs = malloc(playlist->size * sizeof(refs[0]));
+        if (refs == NULL)
+        {
+            upo_throw_sys_error("Unable to allocate memory for the playlist order");
+        }
+        for (i = 0; i < playlist->size; ++i)
+        {
+            refs[i] = &playlist->entries[i];
+        }
+        upo_radix_sort_str(refs, playlist->size, sizeof(refs[0]),
+                           (order_by == playlist_by_artist_sorting_criterion) ? artist_ref_key : album_ref_key);
+        for (i = 0; i < playlist->size; ++i)
+        {
+            perm[i] = (size_t) (refs[i] - playlist->entries);
+        }
+        free(refs);
+        break;
+    default:
+        get_sorting_functions(order_by, &cmp, &prefix);
+        upo_sort_permutation(playlist->entries, playlist->size, sizeof(playlist->entries[0]), cmp, prefix, perm);
+        break;
+    }
+}
+
+void playlist_sort_multi(playlist_t playlist, const playlist_sorting_criterion_t *order_by, size_t num_criteria)
+{
+    multi_sort_ctx_t ms;
+    size_t key_size = 0;
+    int exact = 1;
+
+    assert(playlist != NULL);
+    assert(order_by != NULL);
+    assert(num_criteria > 0);
+
+    /* The key holds the criteria up to the first string one, whose prefix
+     * ends it: entries whose keys are equal are compared by all criteria. */
+    ms.order_by = order_by;
+    ms.num_criteria = num_criteria;
+    for (ms.num_key_criteria = 0; ms.num_key_criteria < num_criteria && exact; ++ms.num_key_criteria)
+    {
+        switch (order_by[ms.num_key_criteria])
+        {
+        case playlist_by_year_sorting_criterion:
+        case playlist_by_track_number_sorting_criterion:
+            key_size += 4;
+            break;
+        default:
+            key_size += PLAYLIST_KEY_STR_WIDTH;
+            exact = 0;
+            break;
+        }
+    }
+    exact &= ms.num_key_criteria == num_criteria;
+    upo_sort_by_key_r(playlist->entries, playlist->size, sizeof(playlist->entries[0]), key_size,
+                      multi_criteria_key, exact ? NULL : multi_criteria_comparator, &ms);
+}
+
 /**** EXERCISE #2 - END of SORTING PLAYLISTS ****/
 
 int parse_entry(const char *str, entry_t *entry)
@@ -342,6 +611,11 @@ playlist_t playlist_create_from_file(const char *file_name)
 }
 
 void playlist_print(const playlist_t playlist, FILE *fp)
+{
+    playlist_print_permuted(playlist, NULL, fp);
+}
+
+void playlist_print_permuted(const playlist_t playlist, const size_t *perm, FILE *fp)
 {
     size_t i;
 
@@ -349,20 +623,29 @@ void playlist_print(const playlist_t playlist, FILE *fp)
 
     for (i = 0; i < playlist->size; ++i)
     {
+        const entry_t *entry = &playlist->entries[(perm != NULL) ? perm[i] : i];
+
         fprintf(fp, "%c%s%c%s%c%d%c%d%c%s%c\n", PLAYLIST_ENTRY_DELIMITER,
-                playlist->entries[i].artist,
+                entry->artist,
                 PLAYLIST_ENTRY_DELIMITER,
-                playlist->entries[i].album,
+                entry->album,
                 PLAYLIST_ENTRY_DELIMITER,
-                playlist->entries[i].year,
+                entry->year,
                 PLAYLIST_ENTRY_DELIMITER,
-                playlist->entries[i].track_num,
+                entry->track_num,
                 PLAYLIST_ENTRY_DELIMITER,
-                playlist->entries[i].track_title,
+                entry->track_title,
                 PLAYLIST_ENTRY_DELIMITER);
     }
 }
 
+size_t playlist_size(const playlist_t playlist)
+{
+    assert(playlist != NULL);
+
+    return playlist->size;
+}
+
 void playlist_destroy(playlist_t playlist)
 {
     if (playlist != NULL)
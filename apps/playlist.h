@@ -29,6 +29,7 @@
 #define PLAYLIST_H
 
 
+#include <stddef.h>
 #include <stdio.h>
 
 
@@ -69,6 +70,24 @@ void playlist_destroy(playlist_t playlist);
  */
 void playlist_print(const playlist_t playlist, FILE* fp);
 
+/**
+ * \brief Prints the entries of the given playlist in the given order.
+ *
+ * \param playlist The playlist to print.
+ * \param perm The order of the entries, as computed by
+ *  playlist_sort_permutation(), or `NULL` to print them in storage order.
+ * \param fp The stream to which print the playlist.
+ */
+void playlist_print_permuted(const playlist_t playlist, const size_t* perm, FILE* fp);
+
+/**
+ * \brief Returns the number of entries of the given playlist.
+ *
+ * \param playlist The playlist.
+ * \return The number of entries.
+ */
+size_t playlist_size(const playlist_t playlist);
+
 /**
  * \brief Sorts the given playlist with the given criterion.
  *
@@ -77,5 +96,37 @@ void playlist_print(const playlist_t playlist, FILE* fp);
  */
 void playlist_sort(playlist_t playlist, playlist_sorting_criterion_t order_by);
 
+/**
+ * \brief Sorts the given playlist with the given criteria, in a single pass.
+ *
+ * \param playlist The playlist to sort.
+ * \param order_by The sorting criteria, by decreasing priority: entries are
+ *  sorted by the first criterion, entries that are equal by it are sorted by
+ *  the second one, and so on.
+ * \param num_criteria The number of sorting criteria.
+ *
+ * The criteria are packed into a normalized key per entry, compared with
+ * `memcmp`; string criteria contribute a fixed-width prefix, and entries
+ * whose keys are equal are compared by all the criteria.
+ */
+void playlist_sort_multi(playlist_t playlist, const playlist_sorting_criterion_t* order_by, size_t num_criteria);
+
+/**
+ * \brief Computes the order of the given playlist according to the given
+ *  criterion, without moving its entries.
+ *
+ * \param playlist The playlist.
+ * \param order_by The sorting criterion.
+ * \param perm The array of playlist_size() elements where the order is
+ *  stored: `perm[i]` is the position in the playlist of the `i`-th entry
+ *  in sorted order.
+ *
+ * Several orderings of the same playlist can thus be kept at the same time.
+ * As in playlist_sort(), artist and album names are ordered by MSD radix
+ * sort, here on pointers to the entries.
+ * The order is stable.
+ */
+void playlist_sort_permutation(const playlist_t playlist, playlist_sorting_criterion_t order_by, size_t* perm);
+
 
 #endif /* PLAYLIST_H */
@@ -0,0 +1,336 @@
+/* vim: set tabstop=4 expandtab shiftwidth=4 softtabstop=4: */
+
+/**
+ * \file apps/pq_compare.c
+ *
+ * \brief An application to compare priority queues with different arities.
+ *
+ * \author Simone Gattini, Federico Barbero, Anton Iliev
+ *
+ * \copyright 2015 University of Piemonte Orientale, Computer Science Institute
+ *
+ * This file is part of UPOalglib.
+ *
+ * UPOalglib is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * UPOalglib is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with UPOalglib.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <assert.h>
+#include <stddef.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <upo/error.h>
+#include <upo/hires_timer.h>
+#include <upo/pq.h>
+
+
+#define DEFAULT_OPT_NUM_ELEMS (size_t) 100000
+#define DEFAULT_OPT_NUM_RUNS (size_t) 1
+#define DEFAULT_OPT_RNG_SEED (unsigned int) time(NULL)
+#define MAX_NUM_ARITIES 16
+/** \brief Number of decrease-key operations per pop in the decrease-key workload. */
+#define DECREASE_KEYS_PER_POP 4
+
+
+/** \brief The workloads run on each priority queue. */
+typedef enum {
+            push_pop_workload,
+            heapify_pop_workload,
+            decrease_key_workload
+        } workload_t;
+
+#define NUM_WORKLOADS (size_t) 3
+
+
+static int int_comparator(const void *a, const void *b);
+
+static double run_workload(workload_t workload, size_t d, const int *keys, size_t n);
+
+static void print_workload(FILE *fp, workload_t workload);
+
+static void usage(const char *progname);
+
+
+int int_comparator(const void *a, const void *b)
+{
+    const int *aa = a;
+    const int *bb = b;
+
+    return (*aa > *bb) - (*aa < *bb);
+}
+
+double run_workload(workload_t workload, size_t d, const int *keys, size_t n)
+{
+    upo_hires_timer_t timer;
+    upo_pq_t pq = NULL;
+    int *work = NULL;
+    void **data = NULL;
+    upo_pq_handle_t *handles = NULL;
+    double runtime = 0;
+    size_t i;
+
+    /* Prepares the elements outside the timed section */
+    work = malloc(n*sizeof(int));
+    data = malloc(n*sizeof(void*));
+    handles = malloc(n*sizeof(upo_pq_handle_t));
+    if (work == NULL || data == NULL || handles == NULL)
+    {
+        upo_throw_sys_error("Unable to allocate memory for the priority queue elements");
+    }
+    memcpy(work, keys, n*sizeof(int));
+    for (i = 0; i < n; ++i)
+    {
+        data[i] = &work[i];
+    }
+    pq = upo_pq_create(d, int_comparator);
+
+    timer = upo_hires_timer_create();
+    upo_hires_timer_start(timer);
+    switch (workload)
+    {
+        case push_pop_workload:
+            for (i = 0; i < n; ++i)
+            {
+                upo_pq_push(pq, data[i]);
+            }
+            while (!upo_pq_is_empty(pq))
+            {
+                upo_pq_pop(pq);
+            }
+            break;
+        case heapify_pop_workload:
+            upo_pq_heapify(pq, data, n, NULL);
+            while (!upo_pq_is_empty(pq))
+            {
+                upo_pq_pop(pq);
+            }
+            break;
+        case decrease_key_workload:
+            /* As in Dijkstra's algorithm: each pop is followed by a few
+             * decrease-key operations on elements still in the queue */
+            upo_pq_heapify(pq, data, n, handles);
+            while (!upo_pq_is_empty(pq))
+            {
+                const int *top = upo_pq_pop(pq);
+                size_t j;
+
+                handles[top - work] = (upo_pq_handle_t) -1;
+                for (j = 0; j < DECREASE_KEYS_PER_POP; ++j)
+                {
+                    size_t k = (size_t) rand() % n;
+
+                    if (handles[k] != (upo_pq_handle_t) -1)
+                    {
+                        /* Never below the popped key, like a distance update */
+                        work[k] = *top + (work[k] - *top) / 2;
+                        upo_pq_decrease_key(pq, handles[k], &work[k]);
+                    }
+                }
+            }
+            break;
+    }
+    upo_hires_timer_stop(timer);
+
+    runtime = upo_hires_timer_elapsed(timer);
+
+    upo_hires_timer_destroy(timer);
+    upo_pq_destroy(pq, 0);
+    free(handles);
+    free(data);
+    free(work);
+
+    return runtime;
+}
+
+void print_workload(FILE *fp, workload_t workload)
+{
+    switch (workload)
+    {
+        case push_pop_workload:
+            fprintf(fp, "Push all, pop all");
+            break;
+        case heapify_pop_workload:
+            fprintf(fp, "Heapify, pop all");
+            break;
+        case decrease_key_workload:
+            fprintf(fp, "Pop with %d decrease-keys", DECREASE_KEYS_PER_POP);
+            break;
+    }
+}
+
+void usage(const char *progname)
+{
+    fprintf(stderr, "Usage: %s <options>\n", progname);
+    fprintf(stderr, "Options:\n");
+    fprintf(stderr, "-d <value>: Specifies the arity of the heap (at least 2); it can be repeated.\n"
+                    "            [default: 2, 4 and 8]\n");
+    fprintf(stderr, "-h: Shows this message.\n");
+    fprintf(stderr, "-n <value>: Specifies the number of elements.\n"
+                    "            [default: %lu]\n", DEFAULT_OPT_NUM_ELEMS);
+    fprintf(stderr, "-r <value>: Specifies the number of times the comparison must be repeated.\n"
+                    "            [default: %lu]\n", DEFAULT_OPT_NUM_RUNS);
+    fprintf(stderr, "-s <value>: Specifies the seed for the random number generator.\n"
+                    "            [default: <current time>]\n");
+}
+
+
+int main(int argc, char *argv[])
+{
+    size_t opt_arities[MAX_NUM_ARITIES];
+    size_t opt_num_arities = 0;
+    size_t opt_n = DEFAULT_OPT_NUM_ELEMS;
+    size_t opt_num_runs = DEFAULT_OPT_NUM_RUNS;
+    unsigned int opt_seed = DEFAULT_OPT_RNG_SEED;
+    int opt_help = 0;
+    double tot_runtimes[MAX_NUM_ARITIES][NUM_WORKLOADS];
+    int *keys = NULL;
+    int arg;
+    size_t r;
+    size_t i;
+    size_t w;
+
+    for (arg = 1; arg < argc; ++arg)
+    {
+        if (!strcmp("-d", argv[arg]))
+        {
+            ++arg;
+            if (arg >= argc)
+            {
+                fprintf(stderr, "ERROR: expected heap arity.\n");
+                usage(argv[0]);
+                return EXIT_FAILURE;
+            }
+            if (opt_num_arities == MAX_NUM_ARITIES)
+            {
+                fprintf(stderr, "ERROR: at most %d arities can be specified.\n", MAX_NUM_ARITIES);
+                usage(argv[0]);
+                return EXIT_FAILURE;
+            }
+            opt_arities[opt_num_arities] = atol(argv[arg]);
+            if (opt_arities[opt_num_arities] < 2)
+            {
+                fprintf(stderr, "ERROR: the heap arity must be at least 2.\n");
+                usage(argv[0]);
+                return EXIT_FAILURE;
+            }
+            ++opt_num_arities;
+        }
+        else if (!strcmp("-h", argv[arg]))
+        {
+            opt_help = 1;
+        }
+        else if (!strcmp("-n", argv[arg]))
+        {
+            ++arg;
+            if (arg >= argc)
+            {
+                fprintf(stderr, "ERROR: expected number of elements.\n");
+                usage(argv[0]);
+                return EXIT_FAILURE;
+            }
+            opt_n = atol(argv[arg]);
+        }
+        else if (!strcmp("-r", argv[arg]))
+        {
+            ++arg;
+            if (arg >= argc)
+            {
+                fprintf(stderr, "ERROR: expected number of runs.\n");
+                usage(argv[0]);
+                return EXIT_FAILURE;
+            }
+            opt_num_runs = atol(argv[arg]);
+        }
+        else if (!strcmp("-s", argv[arg]))
+        {
+            ++arg;
+            if (arg >= argc)
+            {
+                fprintf(stderr, "ERROR: expected seed for random number generator.\n");
+                usage(argv[0]);
+                return EXIT_FAILURE;
+            }
+            opt_seed = atoi(argv[arg]);
+        }
+    }
+
+    if (opt_help)
+    {
+        usage(argv[0]);
+        return EXIT_SUCCESS;
+    }
+    if (opt_n == 0)
+    {
+        fprintf(stderr, "ERROR: the number of elements must be positive.\n");
+        usage(argv[0]);
+        return EXIT_FAILURE;
+    }
+    if (opt_num_arities == 0)
+    {
+        opt_arities[opt_num_arities++] = 2;
+        opt_arities[opt_num_arities++] = 4;
+        opt_arities[opt_num_arities++] = 8;
+    }
+
+    memset(tot_runtimes, 0, sizeof(tot_runtimes));
+    keys = malloc(opt_n*sizeof(int));
+    if (keys == NULL)
+    {
+        upo_throw_sys_error("Unable to allocate memory for the keys");
+    }
+
+    srand(opt_seed);
+    for (r = 0; r < opt_num_runs; ++r)
+    {
+        printf("RUN #%lu", r+1);
+        fflush(stdout);
+        for (i = 0; i < opt_n; ++i)
+        {
+            keys[i] = rand();
+        }
+        for (i = 0; i < opt_num_arities; ++i)
+        {
+            for (w = 0; w < NUM_WORKLOADS; ++w)
+            {
+                tot_runtimes[i][w] += run_workload((workload_t) w, opt_arities[i], keys, opt_n);
+            }
+            printf(".");
+            fflush(stdout);
+        }
+        printf("\n");
+    }
+
+    printf("SUMMARY\n");
+    for (w = 0; w < NUM_WORKLOADS; ++w)
+    {
+        print_workload(stdout, (workload_t) w);
+        printf(":\n");
+        for (i = 0; i < opt_num_arities; ++i)
+        {
+            double avg = tot_runtimes[i][w]/((double) opt_num_runs);
+
+            printf("... d=%lu -> Average runtime: %f", opt_arities[i], avg);
+            if (i > 0)
+            {
+                printf(" (%f of d=%lu)", tot_runtimes[i][w]/tot_runtimes[0][w], opt_arities[0]);
+            }
+            printf("\n");
+        }
+    }
+
+    free(keys);
+
+    return EXIT_SUCCESS;
+}
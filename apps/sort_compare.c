@@ -28,43 +28,109 @@
 #include <assert.h>
 #include <stddef.h>
 #include <stdio.h>
+#include <stdint.h>
 #include <stdlib.h>
 #include <string.h>
 #include <time.h>
+#include <upo/bench.h>
 #include <upo/error.h>
+#include <upo/random.h>
 #include <upo/sort.h>
-#include <upo/hires_timer.h>
+#include <upo/sort_template.h>
 
 
 #define DEFAULT_OPT_ARRAY_SIZE (size_t) 1000
-#define DEFAULT_OPT_NUM_RUNS (size_t) 1
+#define DEFAULT_OPT_NUM_KEYS (size_t) 0
+#define DEFAULT_OPT_NUM_WARMUPS (size_t) 1
+#define DEFAULT_OPT_NUM_TRIALS (size_t) 5
+#define DEFAULT_OPT_NUM_THREADS (size_t) 4
+#define DEFAULT_OPT_TOP_K (size_t) 0
 #define DEFAULT_OPT_RNG_SEED (unsigned int) time(NULL)
 #define DEFAULT_OPT_SORT_SPECIAL 0
 #define DEFAULT_OPT_VERBOSE 0
-#define NUM_SORTING_ALGORITHMS (size_t) 4
+#define DEFAULT_OPT_PERF_COUNTERS 0
+#define DEFAULT_OPT_FORMAT upo_bench_text_format
+#define NUM_SORTING_ALGORITHMS (size_t) 25
+/** \brief Length of the string keys used by the string sorting algorithms (10 digits plus the terminator). */
+#define STR_KEY_SIZE (size_t) 11
+#define NUM_SORT_STATS_METRICS (size_t) 5
+
+
+/** \brief The names of the counters of upo_sort_stats_t, written next to the runtimes when the library counts them. */
+static const char *const sort_stats_metrics[] = {"compares", "swaps", "bytes_moved", "allocs", "max_depth"};
 
 
 /** \brief Defines the sorting algorithm category type as an enumerated type. */
 typedef enum {
             unknown_sort_algorithm = -1,
             insertion_sort_algorithm,
+            bubble_sort_algorithm,
             merge_sort_algorithm,
+            merge_ex_sort_algorithm,
+            merge_bottomup_sort_algorithm,
+            adaptive_sort_algorithm,
+            parallel_merge_sort_algorithm,
             quick_sort_algorithm,
+            quick_median3_sort_algorithm,
+            quick_3way_sort_algorithm,
+            intro_sort_algorithm,
+            heap_sort_algorithm,
+            parallel_quick_sort_algorithm,
+            typed_insertion_sort_algorithm,
+            typed_merge_sort_algorithm,
+            typed_quick_sort_algorithm,
+            radix_sort_algorithm,
+            merge_str_sort_algorithm,
+            radix_str_sort_algorithm,
+            partial_sort_algorithm,
+            top_k_sort_algorithm,
+            select_algorithm,
+            indirect_sort_algorithm,
+            by_key_sort_algorithm,
             stdc_sort_algorithm
         } sorting_algorithm_t;
 
+/** \brief Defines an input distribution as given on the command line, i.e. as `<name>[:<parameter>]`. */
+typedef struct {
+            const char *label; /**< The distribution as given on the command line, used to name the measurements. */
+            upo_random_dist_t dist; /**< The distribution of the keys. */
+            size_t param; /**< The parameter of the distribution, or zero for its default. */
+        } input_dist_t;
+
 /** \brief Defines the item type as a key-value pair type. */
 typedef struct {
             int key;
             double value;
         } item_t;
 
+/* Defines upo_item_insertion_sort, upo_item_merge_sort and upo_item_quick_sort */
+UPO_SORT_DEFINE(item, item_t, UPO_SORT_KEY_LESS)
+
+/** \brief Defines an item paired with a string version of its key, used by the string sorting algorithms. */
+typedef struct {
+            const char *key;
+            item_t item;
+        } str_item_t;
+
+/** \brief Defines the state shared by the trials that measure a sorting algorithm. */
+typedef struct {
+            sorting_algorithm_t alg; /**< The sorting algorithm. */
+            const item_t *input; /**< The array to sort. */
+            item_t *items; /**< The work array, which holds a copy of the input before each trial. */
+            size_t n; /**< The size of the arrays. */
+            size_t nthreads; /**< The number of threads of parallel algorithms. */
+            size_t k; /**< The number of items to sort for top-k algorithms. */
+            item_t *aux; /**< The auxiliary array, if needed by the algorithm. */
+            str_item_t *str_items; /**< The items with string keys, if needed by the algorithm. */
+            char *str_keys; /**< The string keys of the input items, if needed by the algorithm. */
+        } sort_trial_t;
+
 
 /** \brief Generates a random number uniformly distributed in [0,1) */
 static double runif01();
 
-/** \brief Generates a random array of size \a n */
-static item_t* make_random_array(size_t n);
+/** \brief Generates a random array of size \a n whose keys follow the given input distribution */
+static item_t* make_random_array(size_t n, const input_dist_t *input);
 
 /** \brief Comparison function for elements of type \a item_t to sort in ascending order. */
 static int item_comparator(const void *a, const void *b);
@@ -72,15 +138,51 @@ static int item_comparator(const void *a, const void *b);
 /** \brief Comparison function for elements of type \a item_t to sort in descending order. */
 static int rev_item_comparator(const void *a, const void *b);
 
-/** \brief Sorts the given array \a items of size \a by means of the sorting algorithm \a alg */
-static double sort(sorting_algorithm_t alg, item_t *items, size_t n);
+/** \brief Key extraction function for elements of type \a item_t, mapping keys to unsigned integers with the same order. */
+static uint32_t item_key(const void *a);
+
+/** \brief Normalized key function for elements of type \a item_t, writing their integer key. */
+static void item_sort_key(const void *a, unsigned char *key, void *ctx);
+
+/** \brief Comparison function for elements of type \a str_item_t to sort in ascending order. */
+static int str_item_comparator(const void *a, const void *b);
+
+/** \brief Key extraction function for elements of type \a str_item_t. */
+static const char* str_item_key(const void *a);
 
-/** \brief Compares sorting algorithms. */
-static void compare_algorithms(sorting_algorithm_t algs[], size_t num_algs, size_t n, unsigned int seed, size_t num_runs, int sort_special, int verbose);
+/** \brief Moves the \a k smallest items of the given array \a items of size \a n to its front, in ascending order, through a streaming top-k selection */
+static void top_k_sort(item_t *items, size_t n, size_t k);
+
+/** \brief Restores the work array of a sorting trial from its input (and builds the items with string keys, if used). */
+static void sort_trial_setup(void *arg);
+
+/** \brief Runs the sorting algorithm of a sorting trial. */
+static void sort_trial_run(void *arg);
+
+/** \brief Copies back to the work array the items sorted by string keys, if any. */
+static void sort_trial_teardown(void *arg);
+
+/** \brief Measures the sorting algorithm \a alg on the array \a input of size \a n, leaving the sorted array in \a items; parallel algorithms use at most \a nthreads threads, top-k algorithms only sort the \a k smallest items */
+static void bench_sort(upo_bench_t bench, const char *group, sorting_algorithm_t alg, const item_t *input, item_t *items, size_t n, size_t nthreads, size_t k, upo_bench_stats_t *stats);
+
+/** \brief Compares sorting algorithms, printing a summary of the median runtimes if \a summary is set. */
+static void compare_algorithms(upo_bench_t bench, sorting_algorithm_t algs[], size_t num_algs, const input_dist_t inputs[], size_t num_inputs, size_t n, unsigned int seed, size_t nthreads, size_t top_k, int sort_special, int summary, int verbose);
+
+/** \brief Measures the parallel sorting algorithm \a alg for 1, 2, 4, ... up to \a max_threads threads and, if \a summary is set, prints its speedup over the sequential algorithm \a seq_alg. */
+static void print_speedup_curve(upo_bench_t bench, sorting_algorithm_t alg, sorting_algorithm_t seq_alg, const input_dist_t *input, size_t n, unsigned int seed, size_t max_threads, int summary);
 
 /** \brief Extracts the sorting algorithm name from the given string. */
 static sorting_algorithm_t parse_sorting_algorithm(const char *str);
 
+/** \brief Returns the descriptive name of the sorting algorithm. */
+static const char* sorting_algorithm_name(sorting_algorithm_t alg);
+
+/** \brief Extracts the input distribution, with its optional parameter, from the given string, returning zero if it is unknown. */
+static int parse_input_dist(const char *str, input_dist_t *input);
+
+/** \brief Extracts the output format from the given string, returning zero if it is unknown. */
+static int parse_format(const char *str, upo_bench_format_t *format);
+
 /** \brief Prints the sorting algorithm name to the given output stream. */
 static void print_sorting_algorithm(FILE *fp, sorting_algorithm_t alg);
 
@@ -96,25 +198,32 @@ double runif01()
     return rand()/(RAND_MAX+1.0);
 }
 
-item_t* make_random_array(size_t n)
+item_t* make_random_array(size_t n, const input_dist_t *input)
 {
     size_t i;
     item_t *a;
+    int *keys;
+
+    assert( input != NULL );
 
     a = malloc(n*sizeof(item_t));
-    if (a == NULL)
+    keys = malloc(n*sizeof(int));
+    if (a == NULL || keys == NULL)
     {
         upo_throw_sys_error("Unable to allocate memory for random array");
     }
 
+    upo_random_keys(keys, n, input->dist, input->param);
     for (i = 0; i < n; ++i)
     {
         item_t item;
-        item.key = rand();
+        item.key = keys[i];
         item.value = runif01();
         a[i] = item;
     }
 
+    free(keys);
+
     return a;
 }
 
@@ -140,210 +249,436 @@ int rev_item_comparator(const void *a, const void *b)
     return (aa->key < bb->key) - (aa->key > bb->key);
 }
 
-double sort(sorting_algorithm_t alg, item_t *items, size_t n)
+uint32_t item_key(const void *a)
+{
+    assert( a != NULL );
+
+    /* Flips the sign bit so that negative keys come first */
+    return ((uint32_t) ((const item_t *) a)->key) ^ 0x80000000U;
+}
+
+void item_sort_key(const void *a, unsigned char *key, void *ctx)
+{
+    assert( a != NULL );
+    assert( key != NULL );
+
+    (void) ctx;
+
+    upo_sort_key_put_i32(key, ((const item_t *) a)->key);
+}
+
+int str_item_comparator(const void *a, const void *b)
+{
+    assert( a != NULL );
+    assert( b != NULL );
+
+    return strcmp(((const str_item_t *) a)->key, ((const str_item_t *) b)->key);
+}
+
+const char* str_item_key(const void *a)
+{
+    assert( a != NULL );
+
+    return ((const str_item_t *) a)->key;
+}
+
+void top_k_sort(item_t *items, size_t n, size_t k)
 {
-    upo_hires_timer_t timer;
-    double runtime = 0;
+    upo_top_k_t top = NULL;
 
     assert( items != NULL );
 
-    timer = upo_hires_timer_create();
-    upo_hires_timer_start(timer);
-    switch (alg)
+    if (k == 0)
+    {
+        return;
+    }
+    top = upo_top_k_create(k, sizeof(item_t), item_comparator);
+    upo_top_k_push_array(top, items, n);
+    upo_top_k_get(top, items);
+    upo_top_k_destroy(top);
+}
+
+void sort_trial_setup(void *arg)
+{
+    sort_trial_t *trial = arg;
+    size_t i;
+
+    assert( trial != NULL );
+
+    memcpy(trial->items, trial->input, trial->n*sizeof(item_t));
+    if (trial->str_items != NULL)
+    {
+        for (i = 0; i < trial->n; ++i)
+        {
+            trial->str_items[i].key = trial->str_keys + i*STR_KEY_SIZE;
+            trial->str_items[i].item = trial->input[i];
+        }
+    }
+}
+
+void sort_trial_run(void *arg)
+{
+    sort_trial_t *trial = arg;
+    item_t *items = trial->items;
+    size_t n = trial->n;
+
+    switch (trial->alg)
     {
         case insertion_sort_algorithm:
             upo_insertion_sort(items, n, sizeof(item_t), item_comparator);
             break;
+        case bubble_sort_algorithm:
+            upo_bubble_sort(items, n, sizeof(item_t), item_comparator);
+            break;
         case merge_sort_algorithm:
             upo_merge_sort(items, n, sizeof(item_t), item_comparator);
             break;
+        case merge_ex_sort_algorithm:
+            upo_merge_sort_ex(items, n, sizeof(item_t), item_comparator, trial->aux);
+            break;
+        case merge_bottomup_sort_algorithm:
+            upo_merge_sort_bottomup(items, n, sizeof(item_t), item_comparator);
+            break;
+        case adaptive_sort_algorithm:
+            upo_adaptive_sort(items, n, sizeof(item_t), item_comparator);
+            break;
+        case parallel_merge_sort_algorithm:
+            upo_parallel_merge_sort(items, n, sizeof(item_t), item_comparator, trial->nthreads);
+            break;
         case quick_sort_algorithm:
             upo_quick_sort(items, n, sizeof(item_t), item_comparator);
             break;
+        case quick_median3_sort_algorithm:
+            upo_quick_sort_median3_cutoff(items, n, sizeof(item_t), item_comparator);
+            break;
+        case quick_3way_sort_algorithm:
+            upo_quick_sort_3way(items, n, sizeof(item_t), item_comparator);
+            break;
+        case intro_sort_algorithm:
+            upo_intro_sort(items, n, sizeof(item_t), item_comparator);
+            break;
+        case heap_sort_algorithm:
+            upo_heap_sort(items, n, sizeof(item_t), item_comparator);
+            break;
+        case parallel_quick_sort_algorithm:
+            upo_parallel_quick_sort(items, n, sizeof(item_t), item_comparator, trial->nthreads);
+            break;
+        case typed_insertion_sort_algorithm:
+            upo_item_insertion_sort(items, n);
+            break;
+        case typed_merge_sort_algorithm:
+            upo_item_merge_sort(items, n);
+            break;
+        case typed_quick_sort_algorithm:
+            upo_item_quick_sort(items, n);
+            break;
+        case radix_sort_algorithm:
+            upo_radix_sort_by_key(items, n, sizeof(item_t), item_key);
+            break;
+        case merge_str_sort_algorithm:
+            upo_merge_sort(trial->str_items, n, sizeof(str_item_t), str_item_comparator);
+            break;
+        case radix_str_sort_algorithm:
+            upo_radix_sort_str(trial->str_items, n, sizeof(str_item_t), str_item_key);
+            break;
+        case partial_sort_algorithm:
+            upo_partial_sort(items, n, sizeof(item_t), item_comparator, trial->k);
+            break;
+        case top_k_sort_algorithm:
+            top_k_sort(items, n, trial->k);
+            break;
+        case select_algorithm:
+            /* Selecting the largest item is a degenerate case, so the median stands for "all" */
+            upo_select_nth(items, n, sizeof(item_t), item_comparator, (trial->k < n) ? trial->k - 1 : n/2);
+            break;
+        case indirect_sort_algorithm:
+            upo_sort_indirect(items, n, sizeof(item_t), item_comparator, item_key);
+            break;
+        case by_key_sort_algorithm:
+            /* The keys are exact, so no comparison function is needed */
+            upo_sort_by_key_r(items, n, sizeof(item_t), sizeof(int32_t), item_sort_key, NULL, NULL);
+            break;
         case stdc_sort_algorithm:
             qsort(items, n, sizeof(item_t), item_comparator);
             break;
         case unknown_sort_algorithm:
-            return -1;
             break;
     }
-    upo_hires_timer_stop(timer);
+}
+
+void sort_trial_teardown(void *arg)
+{
+    sort_trial_t *trial = arg;
+    size_t i;
+
+    if (trial->str_items != NULL)
+    {
+        for (i = 0; i < trial->n; ++i)
+        {
+            trial->items[i] = trial->str_items[i].item;
+        }
+    }
+}
 
-    runtime = upo_hires_timer_elapsed(timer);
+void bench_sort(upo_bench_t bench, const char *group, sorting_algorithm_t alg, const item_t *input, item_t *items, size_t n, size_t nthreads, size_t k, upo_bench_stats_t *stats)
+{
+    sort_trial_t trial;
+    size_t i;
 
-    upo_hires_timer_destroy(timer);
+    assert( input != NULL );
+    assert( items != NULL );
 
-    return runtime;
+    trial.alg = alg;
+    trial.input = input;
+    trial.items = items;
+    trial.n = n;
+    trial.nthreads = nthreads;
+    trial.k = k;
+    trial.aux = NULL;
+    trial.str_items = NULL;
+    trial.str_keys = NULL;
+
+    if (alg == merge_ex_sort_algorithm)
+    {
+        /* The auxiliary buffer is provided by the caller, so its allocation is not timed */
+        trial.aux = malloc(n*sizeof(item_t));
+        if (trial.aux == NULL)
+        {
+            upo_throw_sys_error("Unable to allocate memory for the auxiliary array");
+        }
+    }
+    if (alg == merge_str_sort_algorithm || alg == radix_str_sort_algorithm)
+    {
+        /* Builds the string keys, which sort like the integer keys, outside the timed section */
+        trial.str_items = malloc(n*sizeof(str_item_t));
+        trial.str_keys = malloc(n*STR_KEY_SIZE);
+        if (trial.str_items == NULL || trial.str_keys == NULL)
+        {
+            upo_throw_sys_error("Unable to allocate memory for the string keys");
+        }
+        for (i = 0; i < n; ++i)
+        {
+            snprintf(trial.str_keys + i*STR_KEY_SIZE, STR_KEY_SIZE, "%010lu", (unsigned long) item_key(&input[i]));
+        }
+    }
+
+    if (upo_sort_stats_enabled())
+    {
+        /* Counts the work of one more (untimed) run, since counting slows down the timed ones */
+        upo_sort_stats_t counters;
+
+        sort_trial_setup(&trial);
+        upo_sort_stats_reset();
+        sort_trial_run(&trial);
+        upo_sort_stats_get(&counters);
+        sort_trial_teardown(&trial);
+        upo_bench_set_metric(bench, 0, counters.num_compares);
+        upo_bench_set_metric(bench, 1, counters.num_swaps);
+        upo_bench_set_metric(bench, 2, counters.num_bytes_moved);
+        upo_bench_set_metric(bench, 3, counters.num_allocs);
+        upo_bench_set_metric(bench, 4, counters.max_depth);
+    }
+    upo_bench_run(bench, group, sorting_algorithm_name(alg), n, sort_trial_setup, sort_trial_run, sort_trial_teardown, &trial, stats);
+
+    free(trial.str_keys);
+    free(trial.str_items);
+    free(trial.aux);
 }
 
-void compare_algorithms(sorting_algorithm_t algs[], size_t num_algs, size_t n, unsigned int seed, size_t num_runs, int sort_special, int verbose)
+void compare_algorithms(upo_bench_t bench, sorting_algorithm_t algs[], size_t num_algs, const input_dist_t inputs[], size_t num_inputs, size_t n, unsigned int seed, size_t nthreads, size_t top_k, int sort_special, int summary, int verbose)
 {
+    const char *instances[] = {"", " (sorted)", " (reversed)"};
+    item_t *arrays[] = {NULL, NULL, NULL};
+    size_t num_instances = sort_special ? 3 : 1;
     double *tot_runtimes = NULL;
-    size_t r;
+    item_t *work_array = NULL;
+    size_t d;
+    size_t i;
+    size_t j;
     size_t k;
 
-    srand(seed);
-
-    /* Allocates memory for the array that will accumulate the runtimes */
-    tot_runtimes = malloc(num_algs*sizeof(double));
+    /* Allocates memory for the array that will accumulate the median runtimes */
+    tot_runtimes = calloc(num_algs, sizeof(double));
     if (tot_runtimes == NULL)
     {
         upo_throw_sys_error("Unable to allocate memory for the total runtimes");
     }
-    memset(tot_runtimes, 0, num_algs*sizeof(long));
 
-    for (r = 0; r < num_runs; ++r)
+    /* The array the sorting functions work on, restored from the input before each trial */
+    work_array = malloc(n*sizeof(item_t));
+    if (work_array == NULL)
     {
-        item_t *array = NULL;
-        item_t *asc_sorted_array = NULL;
-        item_t *des_sorted_array = NULL;
-        item_t *work_array = NULL;
-        size_t i;
-
-        if (verbose)
-        {
-            printf("RUN #%lu\n", r+1);
-        }
-        else
-        {
-            printf("RUN #%lu", r+1);
-            fflush(stdout);
-        }
+        upo_throw_sys_error("Unable to allocate memory for the work array");
+    }
 
-        /* Creates a random array */
-        array = make_random_array(n);
+    for (d = 0; d < num_inputs; ++d)
+    {
+        /* Creates a random array, from the same seed whatever the other inputs */
+        srand(seed);
+        arrays[0] = make_random_array(n, &inputs[d]);
         if (verbose)
         {
-            printf("Input array: ");
-            print_array(array, n);
+            printf("Input array (%s): ", inputs[d].label);
+            print_array(arrays[0], n);
             putchar('\n');
         }
 
         if (sort_special)
         {
             /* Clones the random array to create an ascending sorted version of the original array */
-            asc_sorted_array = malloc(n*sizeof(item_t));
-            if (asc_sorted_array == NULL)
+            arrays[1] = malloc(n*sizeof(item_t));
+            if (arrays[1] == NULL)
             {
                 upo_throw_sys_error("Unable to allocate memory for the ascending sorted array");
             }
-            memcpy(asc_sorted_array, array, n*sizeof(item_t));
-            qsort(asc_sorted_array, n, sizeof(item_t), item_comparator);
+            memcpy(arrays[1], arrays[0], n*sizeof(item_t));
+            qsort(arrays[1], n, sizeof(item_t), item_comparator);
 
             /* Clones the random array to create a descending sorted version of the original array */
-            des_sorted_array = malloc(n*sizeof(item_t));
-            if (des_sorted_array == NULL)
+            arrays[2] = malloc(n*sizeof(item_t));
+            if (arrays[2] == NULL)
             {
                 upo_throw_sys_error("Unable to allocate memory for the descending sorted array");
             }
-            memcpy(des_sorted_array, array, n*sizeof(item_t));
-            qsort(des_sorted_array, n, sizeof(item_t), rev_item_comparator);
-        }
-
-        /* Clones the random array to use as an argument to the sorting function */
-        work_array = malloc(n*sizeof(item_t));
-        if (work_array == NULL)
-        {
-            upo_throw_sys_error("Unable to allocate memory for the work array");
+            memcpy(arrays[2], arrays[0], n*sizeof(item_t));
+            qsort(arrays[2], n, sizeof(item_t), rev_item_comparator);
         }
 
         for (i = 0; i < num_algs; ++i)
         {
-            double runtime = 0;
-
-            sorting_algorithm_t alg = algs[i];
-
-            if (!verbose)
+            for (j = 0; j < num_instances; ++j)
             {
-                printf(".");
-                fflush(stdout);
-            }
+                upo_bench_stats_t stats;
+                char group[128];
 
-            /* Sort the randon array */
-            memcpy(work_array, array, n*sizeof(item_t));
-            runtime = sort(alg, work_array, n);
-            if (verbose)
-            {
-                print_sorting_algorithm(stdout, alg);
-                printf(" -> runtime to sort original array: %f sec\n", runtime);
-            }
-            if (sort_special)
-            {
-                /* Sort the already sorted array */
-                memcpy(work_array, asc_sorted_array, n*sizeof(item_t));
-                runtime += sort(alg, work_array, n);
-                if (verbose)
-                {
-                    print_sorting_algorithm(stdout, alg);
-                    printf(" -> runtime to sort sorted array: %f sec\n", runtime);
-                }
-                /* Sort the already reversely sorted array */
-                memcpy(work_array, des_sorted_array, n*sizeof(item_t));
-                runtime += sort(alg, work_array, n);
-                if (verbose)
-                {
-                    print_sorting_algorithm(stdout, alg);
-                    printf(" -> runtime to sort reverse array: %f sec\n", runtime);
-                }
+                snprintf(group, sizeof(group), "%s%s", inputs[d].label, instances[j]);
+                bench_sort(bench, group, algs[i], arrays[j], work_array, n, nthreads, top_k, &stats);
+                tot_runtimes[i] += stats.median;
             }
 
             if (verbose)
             {
-                print_sorting_algorithm(stdout, alg);
+                print_sorting_algorithm(stdout, algs[i]);
                 printf(" -> sorted array: ");
                 print_array(work_array, n);
                 putchar('\n');
             }
-
-            tot_runtimes[i] += runtime;
         }
 
-        printf("\n");
-
-        free(work_array);
-        if (sort_special)
+        for (j = 0; j < num_instances; ++j)
         {
-            free(des_sorted_array);
-            free(asc_sorted_array);
+            free(arrays[j]);
+            arrays[j] = NULL;
         }
-        free(array);
     }
 
-    printf("SUMMARY\n");
-    for (k = 0; k < num_algs; ++k)
+    if (summary)
     {
-        size_t i;
-
-        print_sorting_algorithm(stdout, algs[k]);
-        printf("-> Average runtime: %f\n", tot_runtimes[k]/((double) num_runs));
-        if (num_algs > 1)
+        printf("SUMMARY\n");
+        for (k = 0; k < num_algs; ++k)
         {
-            for (i = 0; i < num_algs; ++i)
+            print_sorting_algorithm(stdout, algs[k]);
+            printf("-> Median runtime: %f\n", tot_runtimes[k]);
+            if (num_algs > 1)
             {
-                double ratio = tot_runtimes[i]/((double) tot_runtimes[k]);
-
-                if (i == k)
-                {
-                    continue;
-                }
-
-                printf("... vs. ");
-                print_sorting_algorithm(stdout, algs[i]);
-                if (ratio >= 1)
+                for (i = 0; i < num_algs; ++i)
                 {
-                    printf(" -> %f %s\n", ratio, "faster"); /* i.e., tot_runtimes[k] = tot_runtimes[i]/ratio */
-                }
-                else
-                {
-                    printf(" -> %f %s\n", 1.0/ratio, "slower"); /* i.e., tot_runtimes[k] = tot_runtimes[i]*ratio */
+                    double ratio = tot_runtimes[i]/((double) tot_runtimes[k]);
+
+                    if (i == k)
+                    {
+                        continue;
+                    }
+
+                    printf("... vs. ");
+                    print_sorting_algorithm(stdout, algs[i]);
+                    if (ratio >= 1)
+                    {
+                        printf(" -> %f %s\n", ratio, "faster"); /* i.e., tot_runtimes[k] = tot_runtimes[i]/ratio */
+                    }
+                    else
+                    {
+                        printf(" -> %f %s\n", 1.0/ratio, "slower"); /* i.e., tot_runtimes[k] = tot_runtimes[i]*ratio */
+                    }
                 }
             }
         }
     }
 
+    free(work_array);
     free(tot_runtimes);
 }
 
+void print_speedup_curve(upo_bench_t bench, sorting_algorithm_t alg, sorting_algorithm_t seq_alg, const input_dist_t *input, size_t n, unsigned int seed, size_t max_threads, int summary)
+{
+    double *runtimes = NULL;
+    double serial_runtime = 0;
+    size_t num_points = 0;
+    size_t nthreads;
+    size_t k;
+    item_t *array = NULL;
+    item_t *work_array = NULL;
+    upo_bench_stats_t stats;
+    char group[128];
+
+    /* The thread counts are 1, 2, 4, ..., plus max_threads if it is not a power of two */
+    for (nthreads = 1; nthreads < max_threads; nthreads *= 2)
+    {
+        ++num_points;
+    }
+    ++num_points;
+
+    runtimes = calloc(num_points, sizeof(double));
+    if (runtimes == NULL)
+    {
+        upo_throw_sys_error("Unable to allocate memory for the runtimes");
+    }
+
+    /* Uses the same random array of the comparison */
+    srand(seed);
+    array = make_random_array(n, input);
+    work_array = malloc(n*sizeof(item_t));
+    if (work_array == NULL)
+    {
+        upo_throw_sys_error("Unable to allocate memory for the work array");
+    }
+
+    snprintf(group, sizeof(group), "%s (1 thread)", input->label);
+    bench_sort(bench, group, seq_alg, array, work_array, n, 1, n, &stats);
+    serial_runtime = stats.median;
+    for (k = 0, nthreads = 1; k < num_points; ++k, nthreads *= 2)
+    {
+        if (nthreads > max_threads)
+        {
+            nthreads = max_threads;
+        }
+        snprintf(group, sizeof(group), "%s (%lu thread%s)", input->label, (unsigned long) nthreads, (nthreads > 1) ? "s" : "");
+        bench_sort(bench, group, alg, array, work_array, n, nthreads, n, &stats);
+        runtimes[k] = stats.median;
+    }
+
+    if (summary)
+    {
+        printf("SPEEDUP CURVE (");
+        print_sorting_algorithm(stdout, alg);
+        printf(" vs. ");
+        print_sorting_algorithm(stdout, seq_alg);
+        printf(": %f)\n", serial_runtime);
+        for (k = 0, nthreads = 1; k < num_points; ++k, nthreads *= 2)
+        {
+            if (nthreads > max_threads)
+            {
+                nthreads = max_threads;
+            }
+            printf("%lu threads -> Median runtime: %f, speedup: %f\n", nthreads, runtimes[k], serial_runtime/runtimes[k]);
+        }
+    }
+
+    free(work_array);
+    free(array);
+    free(runtimes);
+}
+
 sorting_algorithm_t parse_sorting_algorithm(const char *str)
 {
     assert( str != NULL );
@@ -352,14 +687,98 @@ sorting_algorithm_t parse_sorting_algorithm(const char *str)
     {
         return insertion_sort_algorithm;
     }
+    if (!strcmp("bubble", str))
+    {
+        return bubble_sort_algorithm;
+    }
     if (!strcmp("merge", str))
     {
         return merge_sort_algorithm;
     }
+    if (!strcmp("mergex", str))
+    {
+        return merge_ex_sort_algorithm;
+    }
+    if (!strcmp("mergebu", str))
+    {
+        return merge_bottomup_sort_algorithm;
+    }
+    if (!strcmp("adaptive", str))
+    {
+        return adaptive_sort_algorithm;
+    }
+    if (!strcmp("pmerge", str))
+    {
+        return parallel_merge_sort_algorithm;
+    }
     if (!strcmp("quick", str))
     {
         return quick_sort_algorithm;
     }
+    if (!strcmp("quickm3", str))
+    {
+        return quick_median3_sort_algorithm;
+    }
+    if (!strcmp("quick3way", str))
+    {
+        return quick_3way_sort_algorithm;
+    }
+    if (!strcmp("intro", str))
+    {
+        return intro_sort_algorithm;
+    }
+    if (!strcmp("heap", str))
+    {
+        return heap_sort_algorithm;
+    }
+    if (!strcmp("pquick", str))
+    {
+        return parallel_quick_sort_algorithm;
+    }
+    if (!strcmp("insertion_t", str))
+    {
+        return typed_insertion_sort_algorithm;
+    }
+    if (!strcmp("merge_t", str))
+    {
+        return typed_merge_sort_algorithm;
+    }
+    if (!strcmp("quick_t", str))
+    {
+        return typed_quick_sort_algorithm;
+    }
+    if (!strcmp("radix", str))
+    {
+        return radix_sort_algorithm;
+    }
+    if (!strcmp("merge_str", str))
+    {
+        return merge_str_sort_algorithm;
+    }
+    if (!strcmp("radix_str", str))
+    {
+        return radix_str_sort_algorithm;
+    }
+    if (!strcmp("partial", str))
+    {
+        return partial_sort_algorithm;
+    }
+    if (!strcmp("topk", str))
+    {
+        return top_k_sort_algorithm;
+    }
+    if (!strcmp("select", str))
+    {
+        return select_algorithm;
+    }
+    if (!strcmp("indirect", str))
+    {
+        return indirect_sort_algorithm;
+    }
+    if (!strcmp("bykey", str))
+    {
+        return by_key_sort_algorithm;
+    }
     if (!strcmp("stdc", str))
     {
         return stdc_sort_algorithm;
@@ -368,28 +787,153 @@ sorting_algorithm_t parse_sorting_algorithm(const char *str)
     return unknown_sort_algorithm;
 }
 
-void print_sorting_algorithm(FILE *fp, sorting_algorithm_t alg)
+const char* sorting_algorithm_name(sorting_algorithm_t alg)
 {
-    assert( fp != NULL );
-
     switch (alg)
     {
         case insertion_sort_algorithm:
-            fprintf(fp, "Insertion sort");
-            break;
+            return "Insertion sort";
+        case bubble_sort_algorithm:
+            return "Bubble sort";
         case merge_sort_algorithm:
-            fprintf(fp, "Merge sort");
-            break;
+            return "Merge sort";
+        case merge_ex_sort_algorithm:
+            return "Merge sort (caller-provided buffer)";
+        case merge_bottomup_sort_algorithm:
+            return "Bottom-up merge sort";
+        case adaptive_sort_algorithm:
+            return "Adaptive merge sort";
+        case parallel_merge_sort_algorithm:
+            return "Parallel merge sort";
         case quick_sort_algorithm:
-            fprintf(fp, "Quick sort");
-            break;
+            return "Quick sort";
+        case quick_median3_sort_algorithm:
+            return "Quick sort (median-of-3, cutoff)";
+        case quick_3way_sort_algorithm:
+            return "Quick sort (3-way partitioning)";
+        case intro_sort_algorithm:
+            return "Intro sort";
+        case heap_sort_algorithm:
+            return "Heap sort";
+        case parallel_quick_sort_algorithm:
+            return "Parallel quick sort";
+        case typed_insertion_sort_algorithm:
+            return "Insertion sort (type-specialized)";
+        case typed_merge_sort_algorithm:
+            return "Merge sort (type-specialized)";
+        case typed_quick_sort_algorithm:
+            return "Quick sort (type-specialized)";
+        case radix_sort_algorithm:
+            return "LSD radix sort";
+        case merge_str_sort_algorithm:
+            return "Merge sort (string keys)";
+        case radix_str_sort_algorithm:
+            return "MSD radix sort (string keys)";
+        case partial_sort_algorithm:
+            return "Partial sort";
+        case top_k_sort_algorithm:
+            return "Top-k selection (heap)";
+        case select_algorithm:
+            return "Selection of the k-th item (introselect)";
+        case indirect_sort_algorithm:
+            return "Indirect sort (key prefix)";
+        case by_key_sort_algorithm:
+            return "Sort by normalized key";
         case stdc_sort_algorithm:
-            fprintf(fp, "Standard C sort");
-            break;
+            return "Standard C sort";
         case unknown_sort_algorithm:
-            fprintf(fp, "Unknown sort");
             break;
     }
+
+    return "Unknown sort";
+}
+
+void print_sorting_algorithm(FILE *fp, sorting_algorithm_t alg)
+{
+    assert( fp != NULL );
+
+    fputs(sorting_algorithm_name(alg), fp);
+}
+
+int parse_input_dist(const char *str, input_dist_t *input)
+{
+    const char *sep = NULL;
+    size_t len;
+
+    assert( str != NULL );
+    assert( input != NULL );
+
+    sep = strchr(str, ':');
+    len = (sep != NULL) ? (size_t) (sep - str) : strlen(str);
+    input->label = str;
+    input->param = (sep != NULL) ? strtoul(sep + 1, NULL, 10) : 0;
+
+    if (len == strlen("random") && !strncmp("random", str, len))
+    {
+        input->dist = upo_random_uniform_dist;
+        return 1;
+    }
+    if (len == strlen("few-unique") && !strncmp("few-unique", str, len))
+    {
+        input->dist = upo_random_few_unique_dist;
+        return 1;
+    }
+    if (len == strlen("organ-pipe") && !strncmp("organ-pipe", str, len))
+    {
+        input->dist = upo_random_organ_pipe_dist;
+        return 1;
+    }
+    if (len == strlen("sawtooth") && !strncmp("sawtooth", str, len))
+    {
+        input->dist = upo_random_sawtooth_dist;
+        return 1;
+    }
+    if (len == strlen("sorted-swaps") && !strncmp("sorted-swaps", str, len))
+    {
+        input->dist = upo_random_sorted_swaps_dist;
+        return 1;
+    }
+    if (len == strlen("zipf") && !strncmp("zipf", str, len))
+    {
+        input->dist = upo_random_zipf_dist;
+        return 1;
+    }
+    if (len == strlen("all-equal") && !strncmp("all-equal", str, len))
+    {
+        input->dist = upo_random_all_equal_dist;
+        return 1;
+    }
+    if (len == strlen("m3-killer") && !strncmp("m3-killer", str, len))
+    {
+        input->dist = upo_random_median3_killer_dist;
+        return 1;
+    }
+
+    return 0;
+}
+
+int parse_format(const char *str, upo_bench_format_t *format)
+{
+    assert( str != NULL );
+    assert( format != NULL );
+
+    if (!strcmp("text", str))
+    {
+        *format = upo_bench_text_format;
+        return 1;
+    }
+    if (!strcmp("csv", str))
+    {
+        *format = upo_bench_csv_format;
+        return 1;
+    }
+    if (!strcmp("json", str))
+    {
+        *format = upo_bench_json_format;
+        return 1;
+    }
+
+    return 0;
 }
 
 void print_array(const item_t *items, size_t n)
@@ -417,19 +961,88 @@ void usage(const char *progname)
     fprintf(stderr, "-a <value>: Specifies the sorting algorithm to use.\n"
                     "            Possible values are:\n"
                     "            - insertion: insertion sort\n"
+                    "            - bubble: bubble sort (quadratic, like insertion: keep -n small)\n"
                     "            - merge: merge sort\n"
+                    "            - mergex: merge sort with a caller-provided auxiliary buffer\n"
+                    "            - mergebu: bottom-up (non-recursive) merge sort\n"
+                    "            - adaptive: adaptive (natural runs) merge sort, i.e. Timsort\n"
+                    "            - pmerge: multi-threaded merge sort (see also -t); also prints\n"
+                    "              its speedup curve over merge sort\n"
                     "            - quick: quick sort\n"
+                    "            - quickm3: quick sort with median-of-3 pivot and insertion sort cutoff\n"
+                    "            - quick3way: quick sort with three-way partitioning\n"
+                    "            - intro: introsort (quick sort with heap sort fallback)\n"
+                    "            - heap: heap sort\n"
+                    "            - pquick: multi-threaded introsort on a work-stealing task pool\n"
+                    "              (see also -t); also prints its speedup curve over introsort\n"
+                    "            - insertion_t, merge_t, quick_t: insertion, merge and quick sort\n"
+                    "              specialized for the item type by upo/sort_template.h\n"
+                    "            - radix: LSD radix sort on the integer keys\n"
+                    "            - merge_str, radix_str: merge sort and MSD radix sort on keys\n"
+                    "              formatted as 10-digit strings (formatting is not timed)\n"
+                    "            - partial: partial sort (selection, then sort of the first items;\n"
+                    "              see also -p)\n"
+                    "            - topk: streaming top-k selection on a heap (see also -p)\n"
+                    "            - select: introselect of the p-th smallest item, or of the median\n"
+                    "              if -p covers the whole array (see also -p)\n"
+                    "            - indirect: indirect sort (sorting permutation applied in place),\n"
+                    "              comparing a 32-bit key prefix before the comparison function\n"
+                    "            - bykey: sort by cached normalized keys (a 4-byte signed integer\n"
+                    "              field), compared with memcmp\n"
                     "            - stdc: standard C's sort\n"
                     "            Repeats this option as many times as is the number of algorithms to use.\n");
+    fprintf(stderr, "-c: Also reports, for each measurement, the median number of CPU cycles, instructions,\n"
+                    "    cache misses, branch misses and the CPU time (task_clock, in ns) of the timed runs,\n"
+                    "    as counted by Linux perf events; the ones the system cannot count are omitted.\n"
+                    "    [default: <%s>]\n", (DEFAULT_OPT_PERF_COUNTERS ? "enabled" : "disabled"));
+    fprintf(stderr, "-d <value>[:<parameter>]: Specifies the distribution of the keys of the array to sort.\n"
+                    "            Possible values are:\n"
+                    "            - random: uniformly distributed keys (see also -k); the parameter, if\n"
+                    "              given, overrides -k\n"
+                    "            - few-unique: uniformly distributed keys taking <parameter> distinct\n"
+                    "              values [default: 16]\n"
+                    "            - organ-pipe: keys ascending up to the middle, then descending\n"
+                    "            - sawtooth: ascending runs of <parameter> keys [default: sqrt(n)]\n"
+                    "            - sorted-swaps: distinct sorted keys with <parameter> random pairs\n"
+                    "              swapped [default: n/100]\n"
+                    "            - zipf: keys following Zipf's law, taking <parameter> distinct values\n"
+                    "              [default: n]\n"
+                    "            - all-equal: all keys equal\n"
+                    "            - m3-killer: a permutation on which quickm3 takes quadratic time\n"
+                    "            Repeats this option as many times as is the number of distributions to use;\n"
+                    "            each one names its measurements, and the speedup curves use the first one.\n"
+                    "            [default: random]\n");
     fprintf(stderr, "-h: Displays this message.\n");
+    fprintf(stderr, "-k <value>: Specifies the number of distinct keys in the array to sort (0 means\n"
+                    "            no limit other than RAND_MAX).\n"
+                    "            [default: %lu]\n", DEFAULT_OPT_NUM_KEYS);
     fprintf(stderr, "-n <value>: Specifies the size of the array to sort.\n"
                     "            [default: %lu]\n", DEFAULT_OPT_ARRAY_SIZE);
-    fprintf(stderr, "-r <value>: Specifies the number of times the comparison must be repeated.\n"
-                    "            [default: %lu]\n", DEFAULT_OPT_NUM_RUNS);
+    fprintf(stderr, "-p <value>: Specifies how many of the smallest items partial and topk must sort,\n"
+                    "            and the rank of the item that select must place\n"
+                    "            (0 means all of them), while the other algorithms sort the whole array.\n"
+                    "            [default: %lu]\n", DEFAULT_OPT_TOP_K);
+    fprintf(stderr, "-o <value>: Specifies the output format of the measurements.\n"
+                    "            Possible values are:\n"
+                    "            - text: one line per measurement, followed by a summary\n"
+                    "            - csv: comma-separated values, with a header line\n"
+                    "            - json: an array of JSON objects\n"
+                    "            If the library is built with -DUPO_SORT_STATS, each measurement also reports\n"
+                    "            the comparisons, swaps, bytes moved, allocations and maximum recursion\n"
+                    "            depth of one more untimed run.\n"
+                    "            [default: text]\n");
+    fprintf(stderr, "-r <value>: Specifies the number of timed trials of each measurement, which are\n"
+                    "            summarized by median, percentiles, mean and standard deviation after\n"
+                    "            the rejection of outliers.\n"
+                    "            [default: %lu]\n", DEFAULT_OPT_NUM_TRIALS);
     fprintf(stderr, "-s <value>: Specifies the seed for the random number generator.\n"
                     "            [default: <current time>]\n");
-    fprintf(stderr, "-v: Enables output verbosity.\n"
+    fprintf(stderr, "-t <value>: Specifies the (maximum) number of threads of parallel sorting algorithms.\n"
+                    "            [default: %lu]\n", DEFAULT_OPT_NUM_THREADS);
+    fprintf(stderr, "-v: Enables output verbosity (only meant for the text output format).\n"
                     "    [default: <%s>]\n", (DEFAULT_OPT_VERBOSE ? "enabled" : "disabled"));
+    fprintf(stderr, "-w <value>: Specifies the number of untimed warmup runs of each measurement.\n"
+                    "            [default: %lu]\n", DEFAULT_OPT_NUM_WARMUPS);
     fprintf(stderr, "-x: For each random array, also sorts its corresponding sorted versions (including the\n"
                     "    ones sorted both in increasing and decreasing order).\n"
                     "    [default: <%s>]\n", (DEFAULT_OPT_SORT_SPECIAL ? "enabled" : "disabled"));
@@ -439,12 +1052,22 @@ void usage(const char *progname)
 int main(int argc, char *argv[])
 {
     sorting_algorithm_t *opt_algs = NULL;
+    input_dist_t *opt_inputs = NULL;
+    size_t num_inputs = 0;
     size_t opt_n = DEFAULT_OPT_ARRAY_SIZE;
-    size_t opt_num_runs = DEFAULT_OPT_NUM_RUNS;
+    size_t opt_num_keys = DEFAULT_OPT_NUM_KEYS;
+    size_t opt_num_warmups = DEFAULT_OPT_NUM_WARMUPS;
+    size_t opt_num_trials = DEFAULT_OPT_NUM_TRIALS;
+    size_t opt_num_threads = DEFAULT_OPT_NUM_THREADS;
+    size_t opt_top_k = DEFAULT_OPT_TOP_K;
     unsigned int opt_seed = DEFAULT_OPT_RNG_SEED;
     int opt_verbose = DEFAULT_OPT_VERBOSE;
+    int opt_perf_counters = DEFAULT_OPT_PERF_COUNTERS;
     int opt_help = 0;
     int opt_sort_special = DEFAULT_OPT_SORT_SPECIAL;
+    upo_bench_format_t opt_format = DEFAULT_OPT_FORMAT;
+    upo_bench_t bench = NULL;
+    int summary = 0;
     size_t num_algs = 0;
     int chosen_algs[NUM_SORTING_ALGORITHMS];
     int arg;
@@ -453,6 +1076,13 @@ int main(int argc, char *argv[])
 
     memset(chosen_algs, 0, NUM_SORTING_ALGORITHMS*sizeof(int));
 
+    /* There cannot be more distributions than arguments */
+    opt_inputs = malloc((argc + 1)*sizeof(input_dist_t));
+    if (opt_inputs == NULL)
+    {
+        upo_throw_sys_error("Unable to allocate memory for input distributions");
+    }
+
     for (arg = 1; arg < argc; ++arg)
     {
         if (!strcmp("-a", argv[arg]))
@@ -480,10 +1110,42 @@ int main(int argc, char *argv[])
                 ++num_algs;
             }
         }
+        else if (!strcmp("-c", argv[arg]))
+        {
+            opt_perf_counters = 1;
+        }
+        else if (!strcmp("-d", argv[arg]))
+        {
+            ++arg;
+            if (arg >= argc)
+            {
+                fprintf(stderr, "ERROR: expected input distribution.\n");
+                usage(argv[0]);
+                return EXIT_FAILURE;
+            }
+            if (!parse_input_dist(argv[arg], &opt_inputs[num_inputs]))
+            {
+                fprintf(stderr, "ERROR: unknown input distribution '%s'.\n", argv[arg]);
+                usage(argv[0]);
+                return EXIT_FAILURE;
+            }
+            ++num_inputs;
+        }
         else if (!strcmp("-h", argv[arg]))
         {
             opt_help = 1;
         }
+        else if (!strcmp("-k", argv[arg]))
+        {
+            ++arg;
+            if (arg >= argc)
+            {
+                fprintf(stderr, "ERROR: expected number of distinct keys.\n");
+                usage(argv[0]);
+                return EXIT_FAILURE;
+            }
+            opt_num_keys = atol(argv[arg]);
+        }
         else if (!strcmp("-n", argv[arg]))
         {
             ++arg;
@@ -495,16 +1157,49 @@ int main(int argc, char *argv[])
             }
             opt_n = atol(argv[arg]);
         }
+        else if (!strcmp("-o", argv[arg]))
+        {
+            ++arg;
+            if (arg >= argc)
+            {
+                fprintf(stderr, "ERROR: expected output format.\n");
+                usage(argv[0]);
+                return EXIT_FAILURE;
+            }
+            if (!parse_format(argv[arg], &opt_format))
+            {
+                fprintf(stderr, "ERROR: unknown output format '%s'.\n", argv[arg]);
+                usage(argv[0]);
+                return EXIT_FAILURE;
+            }
+        }
+        else if (!strcmp("-p", argv[arg]))
+        {
+            ++arg;
+            if (arg >= argc)
+            {
+                fprintf(stderr, "ERROR: expected number of items to select.\n");
+                usage(argv[0]);
+                return EXIT_FAILURE;
+            }
+            opt_top_k = atol(argv[arg]);
+        }
         else if (!strcmp("-r", argv[arg]))
         {
             ++arg;
             if (arg >= argc)
             {
-                fprintf(stderr, "ERROR: expected number of runs.\n");
+                fprintf(stderr, "ERROR: expected number of trials.\n");
+                usage(argv[0]);
+                return EXIT_FAILURE;
+            }
+            opt_num_trials = atol(argv[arg]);
+            if (opt_num_trials == 0)
+            {
+                fprintf(stderr, "ERROR: the number of trials must be positive.\n");
                 usage(argv[0]);
                 return EXIT_FAILURE;
             }
-            opt_num_runs = atol(argv[arg]);
         }
         else if (!strcmp("-s", argv[arg]))
         {
@@ -517,10 +1212,38 @@ int main(int argc, char *argv[])
             }
             opt_seed = atoi(argv[arg]);
         }
+        else if (!strcmp("-t", argv[arg]))
+        {
+            ++arg;
+            if (arg >= argc)
+            {
+                fprintf(stderr, "ERROR: expected number of threads.\n");
+                usage(argv[0]);
+                return EXIT_FAILURE;
+            }
+            opt_num_threads = atol(argv[arg]);
+            if (opt_num_threads == 0)
+            {
+                fprintf(stderr, "ERROR: the number of threads must be positive.\n");
+                usage(argv[0]);
+                return EXIT_FAILURE;
+            }
+        }
         else if (!strcmp("-v", argv[arg]))
         {
             opt_verbose = 1;
         }
+        else if (!strcmp("-w", argv[arg]))
+        {
+            ++arg;
+            if (arg >= argc)
+            {
+                fprintf(stderr, "ERROR: expected number of warmup runs.\n");
+                usage(argv[0]);
+                return EXIT_FAILURE;
+            }
+            opt_num_warmups = atol(argv[arg]);
+        }
         else if (!strcmp("-x", argv[arg]))
         {
             opt_sort_special = 1;
@@ -533,13 +1256,35 @@ int main(int argc, char *argv[])
         return EXIT_SUCCESS;
     }
 
+    if (num_inputs == 0)
+    {
+        parse_input_dist("random", &opt_inputs[num_inputs++]);
+    }
+    for (i = 0; i < num_inputs; ++i)
+    {
+        if (opt_inputs[i].dist == upo_random_uniform_dist && opt_inputs[i].param == 0)
+        {
+            opt_inputs[i].param = opt_num_keys;
+        }
+    }
+
     if (opt_verbose)
     {
         printf("Options:\n");
         printf("* Array size: %lu\n", opt_n);
-        printf("* Number of runs: %lu\n", opt_num_runs);
+        printf("* Number of distinct keys: %lu\n", opt_num_keys);
+        printf("* Number of warmup runs: %lu\n", opt_num_warmups);
+        printf("* Number of trials: %lu\n", opt_num_trials);
         printf("* Seed for random number generation: %u\n", opt_seed);
+        printf("* Number of threads: %lu\n", opt_num_threads);
+        printf("* Number of items to select: %lu\n", opt_top_k);
         printf("* Sorts special instances: %d\n", opt_sort_special);
+        printf("* Input distributions:");
+        for (i = 0; i < num_inputs; ++i)
+        {
+            printf("%s %s", (i > 0) ? "," : "", opt_inputs[i].label);
+        }
+        putchar('\n');
         printf("* Algorithms:\n");
         j = 0;
         for (i = 0; i < NUM_SORTING_ALGORITHMS; ++i)
@@ -578,8 +1323,35 @@ int main(int argc, char *argv[])
         }
     }
 
-    compare_algorithms(opt_algs, num_algs, opt_n, opt_seed, opt_num_runs, opt_sort_special, opt_verbose);
+    if (opt_top_k == 0 || opt_top_k > opt_n)
+    {
+        opt_top_k = opt_n;
+    }
+
+    /* The summaries are only printed along with the text output */
+    bench = upo_bench_create(opt_num_warmups, opt_num_trials);
+    if (upo_sort_stats_enabled())
+    {
+        upo_bench_set_metrics(bench, sort_stats_metrics, NUM_SORT_STATS_METRICS);
+    }
+    upo_bench_set_perf_counters(bench, opt_perf_counters);
+    upo_bench_set_output(bench, stdout, opt_format);
+    summary = (opt_format == upo_bench_text_format);
+
+    compare_algorithms(bench, opt_algs, num_algs, opt_inputs, num_inputs, opt_n, opt_seed, opt_num_threads, opt_top_k, opt_sort_special, summary, opt_verbose);
+
+    if (chosen_algs[parallel_merge_sort_algorithm] == 1)
+    {
+        print_speedup_curve(bench, parallel_merge_sort_algorithm, merge_sort_algorithm, &opt_inputs[0], opt_n, opt_seed, opt_num_threads, summary);
+    }
+    if (chosen_algs[parallel_quick_sort_algorithm] == 1)
+    {
+        print_speedup_curve(bench, parallel_quick_sort_algorithm, intro_sort_algorithm, &opt_inputs[0], opt_n, opt_seed, opt_num_threads, summary);
+    }
+
+    upo_bench_destroy(bench);
 
+    free(opt_inputs);
     free(opt_algs);
 
     return EXIT_SUCCESS;
@@ -28,6 +28,7 @@
 #include <assert.h>
 #include "playlist.h"
 #include <stdio.h>
+#include <stdlib.h>
 #include <string.h>
 #include <upo/error.h>
 #include <upo/sort.h>
@@ -129,6 +130,7 @@ int main(int argc, char *argv[])
     int opt_verbose = DEFAULT_OPT_VERBOSE;
     int arg;
     playlist_t playlist = NULL;
+    size_t *perm = NULL;
 
     for (arg = 1; arg < argc; ++arg)
     {
@@ -217,10 +219,23 @@ int main(int argc, char *argv[])
         print_sorting_criterion(stdout, opt_order_by);
         printf("'...\n");
     }
-    playlist_sort(playlist, opt_order_by);
+    if (playlist_size(playlist) == 0)
+    {
+        playlist_destroy(playlist);
+        return EXIT_SUCCESS;
+    }
+    /* Entries stay where they are: only their order is computed */
+    perm = malloc(playlist_size(playlist) * sizeof(size_t));
+    if (perm == NULL)
+    {
+        perror("Unable to allocate memory for the playlist order");
+        abort();
+    }
+    playlist_sort_permutation(playlist, opt_order_by, perm);
 
-    playlist_print(playlist, stdout);
+    playlist_print_permuted(playlist, perm, stdout);
 
+    free(perm);
     playlist_destroy(playlist);
 
     return EXIT_SUCCESS;
@@ -236,27 +236,26 @@ int main(int argc, char *argv[])
     }
 
     /*
-     * NOTE: if you want to get a playlist ordered by:
-     *          criterion #1, criterion #2, ... and criterion #N,
-     *       you need to call the sorting algorithm N times in the reverse
-     *       order, so that the first time it sorts by criterion #N, then the
-     *       second time it sorts by criterion #(N-1), and so on until the last
-     *       time when it sorts by criterion #1.
-     *       For instance, to get a playlist ordered by:
-     *          artist, album, track number
-     *       you must sort by track number, then by album and finally by artist.
+     * NOTE: the playlist is sorted once, comparing entries by criterion #1,
+     *       then by criterion #2 if they are equal, and so on; this gives the
+     *       same order as sorting N times with a stable sort, from criterion
+     *       #N back to criterion #1.
      */
 
-    for (i = opt_order_by_num; i > 0; --i)
+    if (opt_verbose)
     {
-        if (opt_verbose)
+        printf("Sorting the playlist with criteria '");
+        for (i = 0; i < opt_order_by_num; ++i)
         {
-            printf("Sorting the playlist with criterion '");
-            print_sorting_criterion(stdout, opt_order_by_ary[i-1]);
-            printf("'...\n");
+            if (i > 0)
+            {
+                printf(", ");
+            }
+            print_sorting_criterion(stdout, opt_order_by_ary[i]);
         }
-        playlist_sort(playlist, opt_order_by_ary[i-1]);
+        printf("'...\n");
     }
+    playlist_sort_multi(playlist, opt_order_by_ary, opt_order_by_num);
 
     if (opt_verbose)
     {
@@ -0,0 +1,226 @@
+/* vim: set tabstop=4 expandtab shiftwidth=4 softtabstop=4: */
+
+/**
+ * \file upo/bench.h
+ *
+ * \brief Benchmark harness.
+ *
+ * \author Simone Gattini, Federico Barbero, Anton Iliev
+ *
+ * \copyright 2015 University of Piemonte Orientale, Computer Science Institute
+ *
+ *  This file is part of UPOalglib.
+ *
+ *  UPOalglib is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  UPOalglib is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with UPOalglib.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef UPO_BENCH_H
+#define UPO_BENCH_H
+
+#include <stddef.h>
+#include <stdio.h>
+
+
+/** \brief The default multiplier of the interquartile range used to reject outliers. */
+#define UPO_BENCH_DEFAULT_OUTLIER_FENCE 1.5
+
+
+/** \brief Definition of \c upo_bench_t type */
+typedef struct upo_bench_s* upo_bench_t; /* Pointer to an incomplete structure type. */
+
+/** \brief The type of the functions run by a benchmark; they receive the argument given to upo_bench_run(). */
+typedef void (*upo_bench_func_t)(void *arg);
+
+/** \brief The formats of the results written by a benchmark. */
+typedef enum {
+            upo_bench_text_format, /**< One human-readable line per measurement. */
+            upo_bench_csv_format, /**< Comma-separated values, with a header line. */
+            upo_bench_json_format /**< An array of JSON objects. */
+        } upo_bench_format_t;
+
+/**
+ * \brief Summary statistics of the duration (in seconds) of the trials of a
+ *  measurement.
+ *
+ * All the statistics but \a num_outliers refer to the trials that are left
+ * once the outliers have been rejected.
+ */
+typedef struct {
+            size_t num_samples; /**< The number of trials kept. */
+            size_t num_outliers; /**< The number of trials rejected as outliers. */
+            double min; /**< The shortest duration. */
+            double max; /**< The longest duration. */
+            double mean; /**< The mean duration. */
+            double stddev; /**< The sample standard deviation of the durations. */
+            double median; /**< The median duration. */
+            double p25; /**< The 25th percentile (first quartile) of the durations. */
+            double p75; /**< The 75th percentile (third quartile) of the durations. */
+            double p90; /**< The 90th percentile of the durations. */
+            double p99; /**< The 99th percentile of the durations. */
+        } upo_bench_stats_t;
+
+
+/**
+ * \brief Creates a new benchmark.
+ *
+ * \param num_warmups The number of untimed runs done before the timed ones,
+ *  to warm up caches, branch predictors and the memory allocator.
+ * \param num_trials The number of timed runs (at least one).
+ * \return The new benchmark.
+ *
+ * Outliers are rejected with Tukey's fences, using a multiplier of
+ * #UPO_BENCH_DEFAULT_OUTLIER_FENCE (see upo_bench_set_outlier_fence()), and
+ * no results are written until an output is set (see upo_bench_set_output()).
+ */
+upo_bench_t upo_bench_create(size_t num_warmups, size_t num_trials);
+
+/**
+ * \brief Destroys the given benchmark, completing its output.
+ *
+ * \param bench The benchmark to destroy.
+ *
+ * The output stream is flushed, but not closed.
+ */
+void upo_bench_destroy(upo_bench_t bench);
+
+/**
+ * \brief Sets how outliers are rejected.
+ *
+ * \param bench A benchmark.
+ * \param fence The multiplier \f$k\f$ of the interquartile range: trials
+ *  shorter than \f$Q_1 - k (Q_3 - Q_1)\f$ or longer than
+ *  \f$Q_3 + k (Q_3 - Q_1)\f$ are rejected.
+ *  A value of zero or less disables the rejection.
+ */
+void upo_bench_set_outlier_fence(upo_bench_t bench, double fence);
+
+/**
+ * \brief Sets where and how the results of the benchmark are written.
+ *
+ * \param bench A benchmark.
+ * \param fp The output stream, or `NULL` to write nothing.
+ * \param format The format of the results.
+ *
+ * The CSV header or the opening of the JSON array are written immediately;
+ * the output set before, if any, is completed first.
+ */
+void upo_bench_set_output(upo_bench_t bench, FILE *fp, upo_bench_format_t format);
+
+/**
+ * \brief Sets the names of the metrics written along with the durations.
+ *
+ * \param bench A benchmark.
+ * \param names The names of the metrics (e.g. counts of operations); the
+ *  strings are not copied, so they must outlive the benchmark.
+ * \param num_metrics The number of metrics (zero to remove them).
+ *
+ * It must be called before upo_bench_set_output(), whose CSV header lists the
+ * metrics after the statistics of the durations.
+ * The values of the metrics are set for each measurement through
+ * upo_bench_set_metric().
+ */
+void upo_bench_set_metrics(upo_bench_t bench, const char *const names[], size_t num_metrics);
+
+/**
+ * \brief Sets the value of a metric for the next measurement.
+ *
+ * \param bench A benchmark.
+ * \param i The index of the metric, in the array given to
+ *  upo_bench_set_metrics().
+ * \param value The value of the metric.
+ *
+ * The values are reset after each measurement is written: metrics whose
+ * value is not set are left empty in CSV, `null` in JSON and are omitted in
+ * text.
+ */
+void upo_bench_set_metric(upo_bench_t bench, size_t i, double value);
+
+/**
+ * \brief Enables or disables the performance counters.
+ *
+ * \param bench A benchmark.
+ * \param enabled Nonzero to enable the counters, zero to disable them.
+ *
+ * When enabled, upo_bench_run() times each run with a performance timer (see
+ * upo_perf_timer_create()) and writes, after the metrics set through
+ * upo_bench_set_metrics(), the median count of each event over the timed
+ * runs, named after upo_perf_event_name().
+ * Events that cannot be counted on this system are left unset.
+ * It must be called before upo_bench_set_output(), like
+ * upo_bench_set_metrics().
+ */
+void upo_bench_set_perf_counters(upo_bench_t bench, int enabled);
+
+/**
+ * \brief Measures a function and writes the results.
+ *
+ * \param bench A benchmark.
+ * \param group The name of the group the measurement belongs to (e.g. the
+ *  kind of input).
+ * \param name The name of the measurement (e.g. the algorithm).
+ * \param n The size of the problem, only reported in the results.
+ * \param setup The function that prepares each run, or `NULL`; it is not
+ *  timed.
+ * \param func The function to time.
+ * \param teardown The function that cleans up after each run, or `NULL`; it
+ *  is not timed.
+ * \param arg The argument passed to \a setup, \a func and \a teardown.
+ * \param stats Where the statistics are stored, or `NULL`.
+ *
+ * The sequence \a setup, \a func, \a teardown is run first for the warmup
+ * runs, then for the timed ones.
+ * Durations are measured on a monotonic clock; if the performance counters
+ * are enabled (see upo_bench_set_perf_counters()), the events are counted for
+ * \a func only.
+ */
+void upo_bench_run(upo_bench_t bench, const char *group, const char *name, size_t n, upo_bench_func_t setup, upo_bench_func_t func, upo_bench_func_t teardown, void *arg, upo_bench_stats_t *stats);
+
+/**
+ * \brief Writes the results of a measurement made by the caller.
+ *
+ * \param bench A benchmark.
+ * \param group The name of the group the measurement belongs to.
+ * \param name The name of the measurement.
+ * \param n The size of the problem.
+ * \param stats The statistics to write.
+ *
+ * It is useful when the durations are collected by other means and
+ * summarized through upo_bench_stats_compute().
+ */
+void upo_bench_report(upo_bench_t bench, const char *group, const char *name, size_t n, const upo_bench_stats_t *stats);
+
+/**
+ * \brief Computes the summary statistics of the given durations.
+ *
+ * \param samples The durations; they are sorted in place.
+ * \param n The number of durations (at least one).
+ * \param fence The multiplier of the interquartile range used to reject
+ *  outliers (see upo_bench_set_outlier_fence()).
+ * \param stats Where the statistics are stored.
+ */
+void upo_bench_stats_compute(double *samples, size_t n, double fence, upo_bench_stats_t *stats);
+
+/**
+ * \brief Returns the given percentile of a sorted sequence.
+ *
+ * \param sorted The values, sorted in ascending order.
+ * \param n The number of values (at least one).
+ * \param p The percentile, in \f$[0,100]\f$.
+ * \return The percentile, interpolating linearly between the two closest
+ *  values.
+ */
+double upo_bench_percentile(const double *sorted, size_t n, double p);
+
+
+#endif /* UPO_BENCH_H */
@@ -0,0 +1,151 @@
+/* vim: set tabstop=4 expandtab shiftwidth=4 softtabstop=4: */
+
+/**
+ * \file upo/hash.h
+ *
+ * \brief Full-width 64-bit hash functions.
+ *
+ * \author Simone Gattini, Federico Barbero, Anton Iliev
+ *
+ * \copyright 2015 University of Piemonte Orientale, Computer Science Institute
+ *
+ *  This file is part of UPOalglib.
+ *
+ *  UPOalglib is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  UPOalglib is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with UPOalglib.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef UPO_HASH_H
+#define UPO_HASH_H
+
+
+#include <stddef.h>
+#include <stdint.h>
+
+
+/**
+ * \brief Mixes the bits of a 64-bit integer.
+ *
+ * \param x The integer.
+ * \return The mixed integer.
+ *
+ * It is the finalizer of the SplitMix64 generator: a bijection in which
+ * flipping any bit of the input flips each bit of the output with
+ * probability close to one half.
+ */
+uint64_t upo_hash_mix64(uint64_t x);
+
+/**
+ * \brief Hashes a sequence of bytes.
+ *
+ * \param data The bytes to hash.
+ * \param n The number of bytes.
+ * \param seed The seed, which selects the hash function from a family.
+ * \return The hash value.
+ *
+ * The bytes are read eight at a time and folded with 64x64 to 128-bit
+ * multiplications, in the style of wyhash.
+ * Hash values depend on the byte order of the machine.
+ */
+uint64_t upo_hash_bytes(const void *data, size_t n, uint64_t seed);
+
+/**
+ * \brief Hashes an integer.
+ *
+ * \param x A pointer to the `int` to hash.
+ * \return The hash value.
+ *
+ * It can be used as a full-width hash function of hash tables
+ * (see \c upo_ht_hasher64_t).
+ */
+uint64_t upo_hash_int(const void *x);
+
+/**
+ * \brief Hashes a string.
+ *
+ * \param s A pointer to the (`char *`) string to hash.
+ * \return The hash value, that is upo_hash_bytes() of the characters of the
+ *  string with a zero seed.
+ *
+ * It can be used as a full-width hash function of hash tables
+ * (see \c upo_ht_hasher64_t).
+ */
+uint64_t upo_hash_str(const void *s);
+
+/**
+ * \brief Hashes an integer with the seed set by upo_hash_set_seed().
+ *
+ * \param x A pointer to the `int` to hash.
+ * \return The hash value.
+ *
+ * Unlike with upo_hash_int(), the keys that fall in the same slot of a hash
+ * table depend on the seed.
+ */
+uint64_t upo_hash_int_seeded(const void *x);
+
+/**
+ * \brief Hashes a string with the seed set by upo_hash_set_seed().
+ *
+ * \param s A pointer to the (`char *`) string to hash.
+ * \return The hash value.
+ *
+ * With a random seed, which keys collide cannot be predicted, so hash tables
+ * fed with untrusted keys are protected from collision attacks (HashDoS).
+ */
+uint64_t upo_hash_str_seeded(const void *s);
+
+/**
+ * \brief Sets the seed of the seeded hash functions.
+ *
+ * \param seed The seed.
+ *
+ * The seed is shared by all threads; it must not change while hash tables
+ * that use seeded hash functions hold keys.
+ * It is zero until it is set.
+ */
+void upo_hash_set_seed(uint64_t seed);
+
+/**
+ * \brief Returns the seed of the seeded hash functions.
+ *
+ * \return The seed.
+ */
+uint64_t upo_hash_get_seed();
+
+/**
+ * \brief Returns an unpredictable seed.
+ *
+ * \return The seed.
+ *
+ * It is read from \c /dev/urandom if available, otherwise it is derived from
+ * the current time and the address space layout.
+ */
+uint64_t upo_hash_random_seed();
+
+/**
+ * \brief Returns the chi-square statistic of the given bucket counts.
+ *
+ * \param counts The number of keys in each bucket.
+ * \param num_buckets The number of buckets (at least two).
+ * \return The statistic \f$\sum_i (c_i - E)^2 / E\f$, where \f$E\f$ is the
+ *  mean count.
+ *
+ * For a uniform hash function it follows a chi-square distribution with
+ * \f$B - 1\f$ degrees of freedom, where \f$B\f$ is \a num_buckets: its mean
+ * is \f$B - 1\f$ and its standard deviation \f$\sqrt{2(B - 1)}\f$.
+ * Much larger values reveal clustering, much smaller ones keys too regular
+ * for the test to be meaningful.
+ */
+double upo_hash_chi_square(const size_t *counts, size_t num_buckets);
+
+#endif /* UPO_HASH_H */
@@ -32,6 +32,7 @@
 #define UPO_HASHTABLE_H
 
 #include <stddef.h>
+#include <stdint.h>
 
 /*** BEGIN of COMMON TYPES ***/
 
@@ -47,6 +48,19 @@
  */
 typedef size_t (*upo_ht_hasher_t)(const void *, size_t);
 
+/** \brief The type for full-width hash functions.
+ *
+ * Declares the type for key hash functions that map the key space into the
+ * whole range of 64-bit integers, without knowing the capacity of the hash
+ * table.
+ * A full-width hash function takes a pointer to the key to hash as its only
+ * parameter.
+ * The hash table mixes the hash value with upo_ht_hash_finalize() and reduces
+ * it to an index only once, so the hash function need not spread its values
+ * over the low-order bits.
+ */
+typedef uint64_t (*upo_ht_hasher64_t)(const void *);
+
 /**
  * \brief The type for key comparison functions.
  *
@@ -113,6 +127,21 @@ typedef struct upo_ht_sepchain_s *upo_ht_sepchain_t;
  */
 upo_ht_sepchain_t upo_ht_sepchain_create(size_t m, upo_ht_hasher_t key_hash, upo_ht_comparator_t key_cmp);
 
+/**
+ * \brief Creates a new empty hash table that uses a full-width hash function.
+ *
+ * \param m The initial capacity of the hash table.
+ * \param key_hash A pointer to the function used to hash keys.
+ * \param key_cmp A pointer to the function used to compare keys.
+ * \param pow2 Tells whether the capacity is rounded up to a power of two, so
+ *  that hash values are reduced by masking rather than by division (value
+ *  `1`), or not (value `0`).
+ * \return An empty hash table.
+ *
+ * Worst-case complexity: linear in the capacity `m` of the hash table, `O(m)`.
+ */
+upo_ht_sepchain_t upo_ht_sepchain_create_hash64(size_t m, upo_ht_hasher64_t key_hash, upo_ht_comparator_t key_cmp, int pow2);
+
 /**
  * \brief Destroys the given hash table.
  *
@@ -291,10 +320,20 @@ upo_ht_comparator_t upo_ht_sepchain_get_comparator(const upo_ht_sepchain_t ht);
  * \brief Returns the key hasher function.
  *
  * \param ht The hash table.
- * \return The key hasher function.
+ * \return The key hasher function, or `NULL` if the hash table was created
+ *  by upo_ht_sepchain_create_hash64().
  */
 upo_ht_hasher_t upo_ht_sepchain_get_hasher(const upo_ht_sepchain_t ht);
 
+/**
+ * \brief Returns the full-width key hasher function.
+ *
+ * \param ht The hash table.
+ * \return The key hasher function, or `NULL` if the hash table was created
+ *  by upo_ht_sepchain_create().
+ */
+upo_ht_hasher64_t upo_ht_sepchain_get_hasher64(const upo_ht_sepchain_t ht);
+
 /*** END of HASH TABLE with SEPARATE CHAINING ***/
 
 /*** BEGIN of HASH TABLE with OPEN ADDRESSING ***/
@@ -317,6 +356,22 @@ typedef struct upo_ht_linprob_s *upo_ht_linprob_t;
  */
 upo_ht_linprob_t upo_ht_linprob_create(size_t m, upo_ht_hasher_t hasher, upo_ht_comparator_t key_cmp);
 
+/**
+ * \brief Creates a new empty hash table that uses a full-width hash function.
+ *
+ * \param m The initial capacity of the hash table.
+ * \param key_hash A pointer to the function used to hash keys.
+ * \param key_cmp A pointer to the function used to compare keys.
+ * \param pow2 Tells whether the capacity is rounded up to a power of two, so
+ *  that hash values are reduced and probes advanced by masking rather than by
+ *  division (value `1`), or not (value `0`).
+ *  Resizing keeps the capacity a power of two.
+ * \return An empty hash table.
+ *
+ * Worst-case complexity: linear in the capacity `m` of the hash table, `O(m)`.
+ */
+upo_ht_linprob_t upo_ht_linprob_create_hash64(size_t m, upo_ht_hasher64_t key_hash, upo_ht_comparator_t key_cmp, int pow2);
+
 /**
  * \brief Destroys the given hash table.
  *
@@ -446,7 +501,7 @@ size_t upo_ht_linprob_capacity(const upo_ht_linprob_t ht);
  * \param ht The hash table.
  * \return The number of keys stored in the hash tables.
  *
- * Worst-case complexity: linear in the capacity `m` of the hash table, `O(m)`.
+ * Worst-case complexity: constant, `O(1)`.
  */
 size_t upo_ht_linprob_size(const upo_ht_linprob_t ht);
 
@@ -495,12 +550,507 @@ upo_ht_comparator_t upo_ht_linprob_get_comparator(const upo_ht_linprob_t ht);
  * \brief Returns the key hasher function.
  *
  * \param ht The hash table.
- * \return The key hasher function.
+ * \return The key hasher function, or `NULL` if the hash table was created
+ *  by upo_ht_linprob_create_hash64().
  */
 upo_ht_hasher_t upo_ht_linprob_get_hasher(const upo_ht_linprob_t ht);
 
+/**
+ * \brief Returns the full-width key hasher function.
+ *
+ * \param ht The hash table.
+ * \return The key hasher function, or `NULL` if the hash table was created
+ *  by upo_ht_linprob_create().
+ */
+upo_ht_hasher64_t upo_ht_linprob_get_hasher64(const upo_ht_linprob_t ht);
+
 /*** END of HASH TABLE with OPEN ADDRESSING ***/
 
+/*** BEGIN of HASH TABLE with ROBIN HOOD HASHING ***/
+
+/** \brief Initial capacity of hash tables with Robin Hood hashing. */
+#define UPO_HT_ROBINHOOD_DEFAULT_CAPACITY 16U
+
+/**
+ * \brief Type for hash tables with Robin Hood hashing.
+ *
+ * Robin Hood hashing is linear probing where the keys along a run are kept
+ * sorted by their distance from their home slot: an insertion takes the slot
+ * of the first key that is closer to its home than the new key would be, and
+ * moves that key forward instead.
+ * Probe sequences thus have a low variance, lookups of missing keys stop as
+ * soon as they meet a closer key, and deletions shift the following keys one
+ * slot back rather than leaving tombstones, so that the table keeps working
+ * well at higher load factors than plain linear probing.
+ */
+typedef struct upo_ht_robinhood_s *upo_ht_robinhood_t;
+
+/**
+ * \brief Creates a new empty hash table.
+ *
+ * \param m The initial capacity of the hash table.
+ * \param key_hash A pointer to the function used to hash keys.
+ * \param key_cmp A pointer to the function used to compare keys.
+ * \return An empty hash table.
+ *
+ * Worst-case complexity: linear in the capacity `m` of the hash table, `O(m)`.
+ */
+upo_ht_robinhood_t upo_ht_robinhood_create(size_t m, upo_ht_hasher_t key_hash, upo_ht_comparator_t key_cmp);
+
+/**
+ * \brief Creates a new empty hash table that uses a full-width hash function.
+ *
+ * \param m The initial capacity of the hash table.
+ * \param key_hash A pointer to the function used to hash keys.
+ * \param key_cmp A pointer to the function used to compare keys.
+ * \param pow2 Tells whether the capacity is rounded up to a power of two, so
+ *  that hash values are reduced and probes advanced by masking rather than by
+ *  division (value `1`), or not (value `0`).
+ *  Resizing keeps the capacity a power of two.
+ * \return An empty hash table.
+ *
+ * Worst-case complexity: linear in the capacity `m` of the hash table, `O(m)`.
+ */
+upo_ht_robinhood_t upo_ht_robinhood_create_hash64(size_t m, upo_ht_hasher64_t key_hash, upo_ht_comparator_t key_cmp, int pow2);
+
+/**
+ * \brief Destroys the given hash table.
+ *
+ * \param ht The hash table to destroy.
+ * \param destroy_data Tells whether the previously allocated memory for data
+ *  stored in the hash table must be freed (value `1`) or not (value `0`).
+ *
+ * Memory deallocation (if requested) is performed by means of the `free()`
+ * standard C function.
+ *
+ * Worst-case complexity: linear in the capacity `m` of the hash table, `O(m)`.
+ */
+void upo_ht_robinhood_destroy(upo_ht_robinhood_t ht, int destroy_data);
+
+/**
+ * \brief Removes all key-value pairs from the given hash table.
+ *
+ * \param ht The hash table to clear.
+ * \param destroy_data Tells whether the previously allocated memory for data
+ *  stored in the hash table must be freed (value `1`) or not (value `0`).
+ *
+ * Memory deallocation (if requested) is performed by means of the `free()`
+ * standard C function.
+ *
+ * Worst-case complexity: linear in the capacity `m` of the hash table, `O(m)`.
+ */
+void upo_ht_robinhood_clear(upo_ht_robinhood_t ht, int destroy_data);
+
+/**
+ * \brief Insert the given value identified by the provided key in the given
+ *  hash table.
+ *
+ * \param ht The hash table.
+ * \param key The key.
+ * \param value The value.
+ * \return The replaced value in case of a duplicate, otherwise `NULL`.
+ *
+ * If the key is already present in the hash table, the associated value is
+ * replaced by the one provided as argument to this function.
+ * The old value is returned so that its memory can be deallocated
+ * (if necessary).
+ *
+ * The capacity is doubled before the load factor would exceed
+ * \f$7/8\f$.
+ *
+ * Worst-case complexity: linear in the number `n` of elements, `O(n)`.
+ */
+void *upo_ht_robinhood_put(upo_ht_robinhood_t ht, void *key, void *value);
+
+/**
+ * \brief Inserts the given value identified by the provided key in the given
+ *  hash table but ignores duplicates.
+ *
+ * \param ht The hash table.
+ * \param key The key.
+ * \param value The value.
+ *
+ * If the key is already present in the hash table, no insertion takes place.
+ *
+ * Worst-case complexity: linear in the number `n` of elements, `O(n)`.
+ */
+void upo_ht_robinhood_insert(upo_ht_robinhood_t ht, void *key, void *value);
+
+/**
+ * \brief Returns the value identified by the provided key in the given
+ *  hash table.
+ *
+ * \param ht The hash table.
+ * \param key The key.
+ * \return The value associated to \a key, or `NULL` if the key is not found.
+ *
+ * Worst-case complexity: linear in the number `n` of elements, `O(n)`.
+ */
+void *upo_ht_robinhood_get(const upo_ht_robinhood_t ht, const void *key);
+
+/**
+ * \brief Tells if the given hash table contains an item identified by
+ *  the given key.
+ *
+ * \param ht The hash table.
+ * \param key The key.
+ * \return `1` if the hash table contains an item identified by the
+ *  given key, or `0` if the key is not found.
+ *
+ * Worst-case complexity: linear in the number `n` of elements, `O(n)`.
+ */
+int upo_ht_robinhood_contains(const upo_ht_robinhood_t ht, const void *key);
+
+/**
+ * \brief Removes the value identified by the provided key in the given
+ *  hash table.
+ *
+ * \param ht The hash table.
+ * \param key The key.
+ * \param destroy_data Tells whether the previously allocated memory for data,
+ *  that is to be removed, must be freed (value `1`) or not (value `0`).
+ *
+ * Memory deallocation (if requested) is performed by means of the `free()`
+ * standard C function.
+ *
+ * The keys that follow the removed one in its run are shifted one slot back,
+ * so no tombstone is left behind.
+ *
+ * Worst-case complexity: linear in the number `n` of elements, `O(n)`.
+ */
+void upo_ht_robinhood_delete(upo_ht_robinhood_t ht, const void *key, int destroy_data);
+
+/**
+ * \brief Tells if the given hash table is empty.
+ *
+ * \param ht The hash table.
+ * \return `1` if the hash table is empty or `0` otherwise.
+ *
+ * Worst-case complexity: constant, `O(1)`.
+ */
+int upo_ht_robinhood_is_empty(const upo_ht_robinhood_t ht);
+
+/**
+ * \brief Returns the capacity of the hash table.
+ *
+ * \param ht The hash table.
+ * \return The total number of slots of the hash tables.
+ *
+ * Worst-case complexity: constant, `O(1)`.
+ */
+size_t upo_ht_robinhood_capacity(const upo_ht_robinhood_t ht);
+
+/**
+ * \brief Returns the size of the hash table.
+ *
+ * \param ht The hash table.
+ * \return The number of keys stored in the hash tables.
+ *
+ * Worst-case complexity: constant, `O(1)`.
+ */
+size_t upo_ht_robinhood_size(const upo_ht_robinhood_t ht);
+
+/**
+ * \brief Returns the load factor of the hash table.
+ *
+ * \param ht The hash table.
+ * \return The load factor which is defined as the ratio between the number of
+ *  stored keys (i.e., the keys) and the number of slots (i.e., the capacity).
+ *
+ * Worst-case complexity: constant, `O(1)`.
+ */
+double upo_ht_robinhood_load_factor(const upo_ht_robinhood_t ht);
+
+/**
+ * \brief Returns the keys in the given hash table.
+ *
+ * \param ht The hash table.
+ * \return A singly-linked list of keys, or `NULL` if the hash table is empty.
+ *
+ * Worst-case complexity: linear in the number `m` of slots, `O(m)`.
+ */
+upo_ht_key_list_t upo_ht_robinhood_keys(const upo_ht_robinhood_t ht);
+
+/**
+ * \brief Performs a traversal of the hash table.
+ *
+ * \param ht The hash table to traverse.
+ * \param visit The visit function.
+ * \param visit_context Additional information, passed to the visit function as
+ *  third parameter.
+ *
+ * Worst-case complexity: linear in the number `m` of slots, `O(m)`.
+ */
+void upo_ht_robinhood_traverse(const upo_ht_robinhood_t ht, upo_ht_visitor_t visit, void *visit_context);
+
+/**
+ * \brief Inserts the key-value pairs of a hash table into another one.
+ *
+ * \param dest_ht The hash table that receives the key-value pairs.
+ * \param src_ht The hash table whose key-value pairs are inserted, which is
+ *  left unchanged.
+ *
+ * Keys of \a src_ht that are already in \a dest_ht keep their value in
+ * \a dest_ht, as with upo_ht_robinhood_insert().
+ *
+ * Worst-case complexity: quadratic, `O(m n)`, where `m` is the number of
+ *  slots of \a src_ht and `n` the number of elements of \a dest_ht.
+ */
+void upo_ht_robinhood_merge(upo_ht_robinhood_t dest_ht, const upo_ht_robinhood_t src_ht);
+
+/**
+ * \brief Returns the key comparator function.
+ *
+ * \param ht The hash table.
+ * \return The key comparator function.
+ */
+upo_ht_comparator_t upo_ht_robinhood_get_comparator(const upo_ht_robinhood_t ht);
+
+/**
+ * \brief Returns the key hasher function.
+ *
+ * \param ht The hash table.
+ * \return The key hasher function, or `NULL` if the hash table was created
+ *  by upo_ht_robinhood_create_hash64().
+ */
+upo_ht_hasher_t upo_ht_robinhood_get_hasher(const upo_ht_robinhood_t ht);
+
+/**
+ * \brief Returns the full-width key hasher function.
+ *
+ * \param ht The hash table.
+ * \return The key hasher function, or `NULL` if the hash table was created
+ *  by upo_ht_robinhood_create().
+ */
+upo_ht_hasher64_t upo_ht_robinhood_get_hasher64(const upo_ht_robinhood_t ht);
+
+/*** END of HASH TABLE with ROBIN HOOD HASHING ***/
+
+/*** BEGIN of HASH TABLE with SWISS TABLE LAYOUT ***/
+
+/** \brief Initial capacity of Swiss hash tables, which is also their minimum capacity. */
+#define UPO_HT_SWISS_DEFAULT_CAPACITY 16U
+
+/**
+ * \brief Type for Swiss hash tables.
+ *
+ * A Swiss table is an open-addressing table whose slots are split into groups
+ * of 16, each described by 16 control bytes kept apart from the key-value
+ * pairs.
+ * The control byte of a slot tells whether the slot is empty, deleted or
+ * full and, in the last case, holds 7 bits of the hash value of its key.
+ * A lookup hashes the key once, then compares those 7 bits against all the
+ * control bytes of a group at once (with SSE2 instructions where available)
+ * and compares keys only on matching slots; it stops at the first group with
+ * an empty slot.
+ * Groups are probed quadratically, so the capacity is always a power of two,
+ * and the hash function must provide full-width hash values.
+ */
+typedef struct upo_ht_swiss_s *upo_ht_swiss_t;
+
+/**
+ * \brief Creates a new empty hash table.
+ *
+ * \param m The initial capacity of the hash table, which is rounded up to a
+ *  power of two no smaller than `UPO_HT_SWISS_DEFAULT_CAPACITY`, unless it
+ *  is `0`.
+ * \param key_hash A pointer to the function used to hash keys.
+ * \param key_cmp A pointer to the function used to compare keys.
+ * \return An empty hash table.
+ *
+ * Worst-case complexity: linear in the capacity `m` of the hash table, `O(m)`.
+ */
+upo_ht_swiss_t upo_ht_swiss_create(size_t m, upo_ht_hasher64_t key_hash, upo_ht_comparator_t key_cmp);
+
+/**
+ * \brief Destroys the given hash table.
+ *
+ * \param ht The hash table to destroy.
+ * \param destroy_data Tells whether the previously allocated memory for data
+ *  stored in the hash table must be freed (value `1`) or not (value `0`).
+ *
+ * Memory deallocation (if requested) is performed by means of the `free()`
+ * standard C function.
+ *
+ * Worst-case complexity: linear in the capacity `m` of the hash table, `O(m)`.
+ */
+void upo_ht_swiss_destroy(upo_ht_swiss_t ht, int destroy_data);
+
+/**
+ * \brief Removes all key-value pairs from the given hash table.
+ *
+ * \param ht The hash table to clear.
+ * \param destroy_data Tells whether the previously allocated memory for data
+ *  stored in the hash table must be freed (value `1`) or not (value `0`).
+ *
+ * Memory deallocation (if requested) is performed by means of the `free()`
+ * standard C function.
+ *
+ * Worst-case complexity: linear in the capacity `m` of the hash table, `O(m)`.
+ */
+void upo_ht_swiss_clear(upo_ht_swiss_t ht, int destroy_data);
+
+/**
+ * \brief Insert the given value identified by the provided key in the given
+ *  hash table.
+ *
+ * \param ht The hash table.
+ * \param key The key.
+ * \param value The value.
+ * \return The replaced value in case of a duplicate, otherwise `NULL`.
+ *
+ * If the key is already present in the hash table, the associated value is
+ * replaced by the one provided as argument to this function.
+ * The old value is returned so that its memory can be deallocated
+ * (if necessary).
+ *
+ * The table is rebuilt before keys and deleted slots together would fill more
+ * than \f$7/8\f$ of it; its capacity is doubled if keys alone fill more than
+ * \f$7/16\f$.
+ *
+ * Worst-case complexity: linear in the number `n` of elements, `O(n)`.
+ */
+void *upo_ht_swiss_put(upo_ht_swiss_t ht, void *key, void *value);
+
+/**
+ * \brief Inserts the given value identified by the provided key in the given
+ *  hash table but ignores duplicates.
+ *
+ * \param ht The hash table.
+ * \param key The key.
+ * \param value The value.
+ *
+ * If the key is already present in the hash table, no insertion takes place.
+ *
+ * Worst-case complexity: linear in the number `n` of elements, `O(n)`.
+ */
+void upo_ht_swiss_insert(upo_ht_swiss_t ht, void *key, void *value);
+
+/**
+ * \brief Returns the value identified by the provided key in the given
+ *  hash table.
+ *
+ * \param ht The hash table.
+ * \param key The key.
+ * \return The value associated to \a key, or `NULL` if the key is not found.
+ *
+ * Worst-case complexity: linear in the number `n` of elements, `O(n)`.
+ */
+void *upo_ht_swiss_get(const upo_ht_swiss_t ht, const void *key);
+
+/**
+ * \brief Tells if the given hash table contains an item identified by
+ *  the given key.
+ *
+ * \param ht The hash table.
+ * \param key The key.
+ * \return `1` if the hash table contains an item identified by the
+ *  given key, or `0` if the key is not found.
+ *
+ * Worst-case complexity: linear in the number `n` of elements, `O(n)`.
+ */
+int upo_ht_swiss_contains(const upo_ht_swiss_t ht, const void *key);
+
+/**
+ * \brief Removes the value identified by the provided key in the given
+ *  hash table.
+ *
+ * \param ht The hash table.
+ * \param key The key.
+ * \param destroy_data Tells whether the previously allocated memory for data,
+ *  that is to be removed, must be freed (value `1`) or not (value `0`).
+ *
+ * Memory deallocation (if requested) is performed by means of the `free()`
+ * standard C function.
+ *
+ * The slot is marked as deleted only if its group has no empty slot, since
+ * lookups never go past such a group otherwise.
+ *
+ * Worst-case complexity: linear in the number `n` of elements, `O(n)`.
+ */
+void upo_ht_swiss_delete(upo_ht_swiss_t ht, const void *key, int destroy_data);
+
+/**
+ * \brief Tells if the given hash table is empty.
+ *
+ * \param ht The hash table.
+ * \return `1` if the hash table is empty or `0` otherwise.
+ *
+ * Worst-case complexity: constant, `O(1)`.
+ */
+int upo_ht_swiss_is_empty(const upo_ht_swiss_t ht);
+
+/**
+ * \brief Returns the capacity of the hash table.
+ *
+ * \param ht The hash table.
+ * \return The total number of slots of the hash tables.
+ *
+ * Worst-case complexity: constant, `O(1)`.
+ */
+size_t upo_ht_swiss_capacity(const upo_ht_swiss_t ht);
+
+/**
+ * \brief Returns the size of the hash table.
+ *
+ * \param ht The hash table.
+ * \return The number of keys stored in the hash tables.
+ *
+ * Worst-case complexity: constant, `O(1)`.
+ */
+size_t upo_ht_swiss_size(const upo_ht_swiss_t ht);
+
+/**
+ * \brief Returns the load factor of the hash table.
+ *
+ * \param ht The hash table.
+ * \return The load factor which is defined as the ratio between the number of
+ *  stored keys (i.e., the keys) and the number of slots (i.e., the capacity).
+ *
+ * Worst-case complexity: constant, `O(1)`.
+ */
+double upo_ht_swiss_load_factor(const upo_ht_swiss_t ht);
+
+/**
+ * \brief Returns the keys in the given hash table.
+ *
+ * \param ht The hash table.
+ * \return A singly-linked list of keys, or `NULL` if the hash table is empty.
+ *
+ * Worst-case complexity: linear in the number `m` of slots, `O(m)`.
+ */
+upo_ht_key_list_t upo_ht_swiss_keys(const upo_ht_swiss_t ht);
+
+/**
+ * \brief Performs a traversal of the hash table.
+ *
+ * \param ht The hash table to traverse.
+ * \param visit The visit function.
+ * \param visit_context Additional information, passed to the visit function as
+ *  third parameter.
+ *
+ * Worst-case complexity: linear in the number `m` of slots, `O(m)`.
+ */
+void upo_ht_swiss_traverse(const upo_ht_swiss_t ht, upo_ht_visitor_t visit, void *visit_context);
+
+/**
+ * \brief Returns the key comparator function.
+ *
+ * \param ht The hash table.
+ * \return The key comparator function.
+ */
+upo_ht_comparator_t upo_ht_swiss_get_comparator(const upo_ht_swiss_t ht);
+
+/**
+ * \brief Returns the full-width key hasher function.
+ *
+ * \param ht The hash table.
+ * \return The key hasher function.
+ */
+upo_ht_hasher64_t upo_ht_swiss_get_hasher64(const upo_ht_swiss_t ht);
+
+/*** END of HASH TABLE with SWISS TABLE LAYOUT ***/
+
 /*** BEGIN of HASH FUNCTIONS ***/
 
 /**
@@ -620,6 +1170,48 @@ size_t upo_ht_hash_str_kr2e(const void *s, size_t m);
  */
 size_t upo_ht_hash_str_sgistl(const void *s, size_t m);
 
+/**
+ * \brief Mixes the bits of a full-width hash value.
+ *
+ * \param h The hash value.
+ * \return The mixed hash value.
+ *
+ * It is the finalizer of MurmurHash3, a bijection in which every bit of the
+ * input affects every bit of the output, so that any subset of the bits
+ * (e.g. the low-order ones kept by a mask) is well distributed.
+ */
+uint64_t upo_ht_hash_finalize(uint64_t h);
+
+/**
+ * \brief Full-width hash function for integers.
+ *
+ * \param x The integer to be hashed.
+ * \return The bits of the integer; the hash table mixes them.
+ */
+uint64_t upo_ht_hash64_int(const void *x);
+
+/**
+ * \brief Full-width hash function for strings.
+ *
+ * \param s The string to be hashed.
+ * \param h0 The initial value for the hash value.
+ * \param a A multiplicative factor.
+ * \return The hash value.
+ *
+ * It is upo_ht_hash_str() computed modulo \f$2^{64}\f$, without any
+ * reduction inside the loop.
+ */
+uint64_t upo_ht_hash64_str(const void *s, uint64_t h0, uint64_t a);
+
+/** \brief The full-width version of upo_ht_hash_str_djb2(). */
+uint64_t upo_ht_hash64_str_djb2(const void *s);
+
+/** \brief The full-width version of upo_ht_hash_str_java(). */
+uint64_t upo_ht_hash64_str_java(const void *s);
+
+/** \brief The full-width version of upo_ht_hash_str_sgistl(). */
+uint64_t upo_ht_hash64_str_sgistl(const void *s);
+
 /*** END of HASH FUNCTIONS ***/
 
 /** \brief The hash table with separate chaining (based on ordered linked lists)
@@ -630,6 +1222,11 @@ typedef struct upo_ht_sepchain_olist_s *upo_ht_sepchain_olist_t;
 lists). */
 upo_ht_sepchain_olist_t upo_ht_sepchain_olist_create(size_t m, upo_ht_hasher_t key_hash, upo_ht_comparator_t key_cmp);
 
+/** \brief Creates a new hash table with separate chaining (based on ordered linked
+lists) that uses a full-width hash function, with a power-of-two capacity if
+\a pow2 is `1` (see upo_ht_sepchain_create_hash64()). */
+upo_ht_sepchain_olist_t upo_ht_sepchain_olist_create_hash64(size_t m, upo_ht_hasher64_t key_hash, upo_ht_comparator_t key_cmp, int pow2);
+
 /** \brief Destroys the given hash table with separate chaining (based on ordered
 linked lists). */
 void upo_ht_sepchain_olist_destroy(upo_ht_sepchain_olist_t ht, int destroy_data);
@@ -0,0 +1,147 @@
+/* vim: set tabstop=4 expandtab shiftwidth=4 softtabstop=4: */
+
+/**
+ * \file upo/perf_timer.h
+ *
+ * \brief Timer with hardware performance counters.
+ *
+ * \author Simone Gattini, Federico Barbero, Anton Iliev
+ *
+ * \copyright 2015 University of Piemonte Orientale, Computer Science Institute
+ *
+ *  This file is part of UPOalglib.
+ *
+ *  UPOalglib is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  UPOalglib is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with UPOalglib.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef UPO_PERF_TIMER_H
+#define UPO_PERF_TIMER_H
+
+
+/** \brief The number of events counted by a performance timer. */
+#define UPO_PERF_TIMER_NUM_EVENTS 5
+
+
+/** \brief Definition of \c upo_perf_timer_t type */
+typedef struct upo_perf_timer_s* upo_perf_timer_t; /* Pointer to an incomplete structure type. */
+
+/** \brief The events counted by a performance timer. */
+typedef enum {
+            upo_perf_cycles_event, /**< CPU cycles. */
+            upo_perf_instructions_event, /**< Retired instructions. */
+            upo_perf_cache_misses_event, /**< Last-level cache misses. */
+            upo_perf_branch_misses_event, /**< Mispredicted branches. */
+            upo_perf_task_clock_event /**< CPU time, in nanoseconds. */
+        } upo_perf_event_t;
+
+
+/**
+ * \brief Creates a new performance timer.
+ *
+ * \return The new timer.
+ *
+ * The events are counted through the Linux \c perf_event_open system call, in
+ * user space only, for the calling thread and the threads it creates while
+ * the timer runs.
+ * Events that cannot be counted (e.g. because the hardware has no such
+ * counter, or because \c /proc/sys/kernel/perf_event_paranoid forbids it, or
+ * on other systems) are just not available: the elapsed time is always
+ * measured, on \c CLOCK_MONOTONIC_RAW.
+ */
+upo_perf_timer_t upo_perf_timer_create();
+
+/**
+ * \brief Destroys the given performance timer.
+ *
+ * \param timer The timer to destroy.
+ */
+void upo_perf_timer_destroy(upo_perf_timer_t timer);
+
+/**
+ * \brief Starts or restarts the given performance timer, resetting its
+ *  counters.
+ *
+ * \param timer A timer.
+ */
+void upo_perf_timer_start(upo_perf_timer_t timer);
+
+/**
+ * \brief Stops the given performance timer.
+ *
+ * \param timer A timer.
+ */
+void upo_perf_timer_stop(upo_perf_timer_t timer);
+
+/**
+ * \brief Tells if the given performance timer is started.
+ *
+ * \param timer A timer.
+ * \return \c 1 if the input timer is started; \c 0, otherwise.
+ */
+int upo_perf_timer_is_started(const upo_perf_timer_t timer);
+
+/**
+ * \brief Tells if the given performance timer is stopped.
+ *
+ * \param timer A timer.
+ * \return \c 1 if the input timer is stopped; \c 0, otherwise.
+ */
+int upo_perf_timer_is_stopped(const upo_perf_timer_t timer);
+
+/**
+ * \brief Returns the number of seconds elapsed since when the performance
+ *  timer has been started until the stopping time (or so far, if not stopped
+ *  yet).
+ *
+ * \param timer A timer.
+ * \return the number of seconds elapsed, on success; \c a negative number, if
+ *  the timer has not been started.
+ */
+double upo_perf_timer_elapsed(const upo_perf_timer_t timer);
+
+/**
+ * \brief Tells if the given event is counted by the performance timer.
+ *
+ * \param timer A timer.
+ * \param event An event.
+ * \return \c 1 if the event is counted; \c 0, otherwise.
+ */
+int upo_perf_timer_has_event(const upo_perf_timer_t timer, upo_perf_event_t event);
+
+/**
+ * \brief Returns the number of the given events occurred since when the
+ *  performance timer has been started until the stopping time (or so far, if
+ *  not stopped yet).
+ *
+ * \param timer A timer.
+ * \param event An event.
+ * \return the number of events, on success; \c a negative number, if the event
+ *  is not counted or the timer has not been started.
+ *
+ * When the kernel multiplexes more events than the hardware counters, the
+ * count is scaled to the whole time the timer ran.
+ */
+double upo_perf_timer_count(const upo_perf_timer_t timer, upo_perf_event_t event);
+
+/**
+ * \brief Returns the name of the given event.
+ *
+ * \param event An event.
+ * \return A name without spaces (e.g. \c "cache_misses"), fit for column
+ *  headers.
+ */
+const char* upo_perf_event_name(upo_perf_event_t event);
+
+
+#endif /* UPO_PERF_TIMER_H */
@@ -0,0 +1,172 @@
+/* vim: set tabstop=4 expandtab shiftwidth=4 softtabstop=4: */
+
+/**
+ * \file upo/pq.h
+ *
+ * \brief The Priority Queue abstract data type.
+ *
+ * \author Simone Gattini, Federico Barbero, Anton Iliev
+ *
+ * \copyright 2015 University of Piemonte Orientale, Computer Science Institute
+ *
+ *  This file is part of UPOalglib.
+ *
+ *  UPOalglib is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  UPOalglib is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with UPOalglib.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef UPO_PQ_H
+#define UPO_PQ_H
+
+#include <stddef.h>
+
+
+/**
+ * \brief The type for priority comparison functions.
+ *
+ * The function returns a negative value, zero or a positive value if the
+ * priority of the first element is respectively higher than, equal to or
+ * lower than the one of the second element.
+ */
+typedef int (*upo_pq_comparator_t)(const void*, const void*);
+
+/** \brief Declares the Priority Queue type. */
+typedef struct upo_pq_s* upo_pq_t;
+
+/**
+ * \brief The type of the handles of the elements of a priority queue.
+ *
+ * A handle identifies an element for as long as it stays in the queue;
+ * afterwards, it can be reused for another element.
+ */
+typedef size_t upo_pq_handle_t;
+
+
+/**
+ * \brief Creates a new empty priority queue.
+ *
+ * \param d The number of children of each node of the underlying heap
+ *  (at least 2).
+ * \param cmp The function used to compare the priorities of the elements.
+ * \return A priority queue.
+ *
+ * The queue is an implicit d-ary min-heap stored in an array: the smallest
+ * element according to \a cmp comes first.
+ * Larger values of \a d make the heap shallower, so that push and
+ * decrease-key do fewer comparisons and the children visited by pop are
+ * contiguous in memory, at the cost of more comparisons per level in pop.
+ */
+upo_pq_t upo_pq_create(size_t d, upo_pq_comparator_t cmp);
+
+/**
+ * \brief Destroys the given priority queue.
+ *
+ * \param pq The priority queue to destroy.
+ * \param destroy_data Tells whether the elements must be freed as well.
+ */
+void upo_pq_destroy(upo_pq_t pq, int destroy_data);
+
+/**
+ * \brief Removes all elements from the given priority queue.
+ *
+ * \param pq The priority queue to clear.
+ * \param destroy_data Tells whether the elements must be freed as well.
+ */
+void upo_pq_clear(upo_pq_t pq, int destroy_data);
+
+/**
+ * \brief Inserts an element in the given priority queue.
+ *
+ * \param pq The priority queue.
+ * \param data The element to insert.
+ * \return The handle of the inserted element.
+ *
+ * The time complexity is \f$O(\log_d n)\f$.
+ */
+upo_pq_handle_t upo_pq_push(upo_pq_t pq, void *data);
+
+/**
+ * \brief Inserts several elements in the given priority queue at once.
+ *
+ * \param pq The priority queue.
+ * \param data The elements to insert.
+ * \param n The number of elements to insert.
+ * \param handles Where the handles of the inserted elements are stored (in
+ *  the same order of \a data), or `NULL` if they are not needed.
+ *
+ * The heap is rebuilt bottom-up, in \f$O(m)\f$ time where \f$m\f$ is the
+ * resulting size of the queue, which is faster than pushing the elements one
+ * at a time.
+ */
+void upo_pq_heapify(upo_pq_t pq, void **data, size_t n, upo_pq_handle_t *handles);
+
+/**
+ * \brief Returns the element with the highest priority.
+ *
+ * \param pq The priority queue.
+ * \return The element with the highest priority, or `NULL` if the queue is
+ *  empty.
+ */
+void* upo_pq_peek(const upo_pq_t pq);
+
+/**
+ * \brief Removes and returns the element with the highest priority.
+ *
+ * \param pq The priority queue.
+ * \return The removed element, or `NULL` if the queue is empty.
+ *
+ * The time complexity is \f$O(d \log_d n)\f$.
+ */
+void* upo_pq_pop(upo_pq_t pq);
+
+/**
+ * \brief Returns the element with the given handle.
+ *
+ * \param pq The priority queue.
+ * \param handle The handle of an element of the queue.
+ * \return The element.
+ */
+void* upo_pq_get(const upo_pq_t pq, upo_pq_handle_t handle);
+
+/**
+ * \brief Restores the order of the queue after the priority of an element
+ *  has been raised.
+ *
+ * \param pq The priority queue.
+ * \param handle The handle of an element of the queue.
+ * \param data The element that replaces the one with the given handle (it can
+ *  be the same element, after its priority has been updated in place).
+ *
+ * The new element must not have a lower priority than the replaced one.
+ * The time complexity is \f$O(\log_d n)\f$.
+ */
+void upo_pq_decrease_key(upo_pq_t pq, upo_pq_handle_t handle, void *data);
+
+/**
+ * \brief Returns the number of elements in the given priority queue.
+ *
+ * \param pq The priority queue.
+ * \return The number of elements, or `0` if \a pq is `NULL`.
+ */
+size_t upo_pq_size(const upo_pq_t pq);
+
+/**
+ * \brief Tells whether the given priority queue is empty.
+ *
+ * \param pq The priority queue.
+ * \return `1` if the queue is empty or `NULL`, `0` otherwise.
+ */
+int upo_pq_is_empty(const upo_pq_t pq);
+
+
+#endif /* UPO_PQ_H */
@@ -32,6 +32,19 @@
 #include <stddef.h>
 
 
+/** \brief The distributions of the keys generated by upo_random_keys(). */
+typedef enum {
+            upo_random_uniform_dist, /**< Uniformly distributed keys; the parameter, if not zero, is the number of distinct keys. */
+            upo_random_few_unique_dist, /**< Uniformly distributed keys taking a few distinct values; the parameter is their number (default: 16). */
+            upo_random_organ_pipe_dist, /**< Keys ascending up to the middle of the array, then descending: 0, 1, ..., 1, 0. */
+            upo_random_sawtooth_dist, /**< Ascending runs of keys 0, 1, ..., m-1; the parameter is the length \a m of the runs (default: the square root of the number of keys). */
+            upo_random_sorted_swaps_dist, /**< Distinct keys in ascending order, with randomly chosen pairs swapped; the parameter is the number of swaps (default: 1% of the number of keys). */
+            upo_random_zipf_dist, /**< Keys following Zipf's law with exponent 1, where 0 is the most frequent; the parameter is the number of distinct keys (default: the number of keys). */
+            upo_random_all_equal_dist, /**< Keys all equal to zero. */
+            upo_random_median3_killer_dist /**< A permutation that makes quick sort with median-of-3 pivot selection (see upo_quick_sort_median3_cutoff()) take quadratic time. */
+        } upo_random_dist_t;
+
+
 /**
  * \brief Returns a random real number uniformly distributed in the [lo,hi)
  *  range.
@@ -75,4 +88,38 @@ void upo_random_shuffle(void *base, size_t n, size_t size);
  */
 char* upo_random_string(char *s, size_t n);
 
+/**
+ * \brief Returns a random integer in the [0,m) range following Zipf's law.
+ *
+ * \param m The number of values (at least one).
+ * \param s The exponent of the distribution (positive).
+ * \return A random integer \f$k\f$ in \f$[0,m)\f$, drawn with probability
+ *  proportional to \f$1/(k+1)^s\f$.
+ *
+ * Values are drawn through rejection-inversion sampling (W. Hormann and
+ * G. Derflinger, "Rejection-inversion to generate variates from monotone
+ * discrete distributions", 1996), in constant expected time and without
+ * tables.
+ */
+size_t upo_random_zipf(size_t m, double s);
+
+/**
+ * \brief Fills the given array with keys following the given distribution.
+ *
+ * \param keys The array to fill.
+ * \param n The number of keys.
+ * \param dist The distribution of the keys.
+ * \param param The parameter of the distribution (see upo_random_dist_t), or
+ *  zero to use its default value.
+ *
+ * The keys are non-negative and take time linear in \a n to generate.
+ * They are meant as inputs for sorting benchmarks, to find the worst cases of
+ * the algorithms.
+ * The median-of-3 killer is built for the partitioning scheme of
+ * upo_quick_sort_median3_cutoff(), which picks the median of the first, the
+ * middle and the last key: at every step, the first and the middle key of the
+ * range are the two smallest ones, so the partition only splits off two keys.
+ */
+void upo_random_keys(int *keys, size_t n, upo_random_dist_t dist, size_t param);
+
 #endif /* UPO_RANDOM_H */
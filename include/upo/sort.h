@@ -30,11 +30,89 @@
 
 
 #include <stddef.h>
+#include <stdint.h>
 
 
 /** \brief Type definition for comparison functions used to compare two elements */
 typedef int (*upo_sort_comparator_t)(const void*, const void*);
 
+/** \brief Type definition for functions extracting an unsigned 32-bit integer sort key from an element */
+typedef uint32_t (*upo_sort_u32_key_t)(const void*);
+
+/** \brief Type definition for functions extracting a string sort key from an element */
+typedef const char* (*upo_sort_str_key_t)(const void*);
+
+/**
+ * \brief Type definition for comparison functions that take a context.
+ *
+ * The third argument is the context pointer given to the sorting function,
+ * which the comparison function can use to read its parameters (e.g., a list
+ * of sort criteria) without global variables.
+ */
+typedef int (*upo_sort_comparator_r_t)(const void*, const void*, void*);
+
+/**
+ * \brief Type definition for functions writing the normalized key of an
+ *  element.
+ *
+ * The first argument is the element, the second one the buffer where its key
+ * is written and the third one the context given to the sorting function.
+ */
+typedef void (*upo_sort_key_r_t)(const void*, unsigned char*, void*);
+
+/** \brief Definition of \c upo_top_k_t type */
+typedef struct upo_top_k_s* upo_top_k_t; /* Pointer to an incomplete structure type. */
+
+/**
+ * \brief The work done by the sorting functions, as counted when the library
+ *  is built with `-DUPO_SORT_STATS`.
+ *
+ * Counters cover all the sorting functions of the library, except the
+ * type-specialized ones of upo/sort_template.h, and all of their threads.
+ */
+typedef struct {
+            size_t num_compares; /**< The calls to comparison functions. */
+            size_t num_swaps; /**< The exchanges of two elements. */
+            size_t num_bytes_moved; /**< The bytes copied by swaps (twice the element size each) and by element moves. */
+            size_t num_allocs; /**< The memory allocations. */
+            size_t max_depth; /**< The maximum recursion depth reached (zero for non-recursive sorts). */
+        } upo_sort_stats_t;
+
+
+/**
+ * \brief Calls a comparison function without context.
+ *
+ * \param a The first element to compare.
+ * \param b The second element to compare.
+ * \param ctx Pointer to the `upo_sort_comparator_t` function to call.
+ * \return The result of the comparison function applied to \a a and \a b.
+ *
+ * It lets the `_r` functions be called with a plain comparison function.
+ */
+int upo_sort_comparator_adapter(const void *a, const void *b, void *ctx);
+
+/**
+ * \brief Tells if the work of the sorting functions is counted.
+ *
+ * \return A nonzero value if the library is built with `-DUPO_SORT_STATS`,
+ *  zero otherwise.
+ */
+int upo_sort_stats_enabled();
+
+/**
+ * \brief Returns the work done by the sorting functions since the last reset.
+ *
+ * \param stats Where the counters are stored; they are all zero if the work
+ *  is not counted (see upo_sort_stats_enabled()).
+ *
+ * The counters are updated atomically, so they are exact also for parallel
+ * sorts, but they should be read once the sorting functions have returned.
+ */
+void upo_sort_stats_get(upo_sort_stats_t *stats);
+
+/** \brief Sets to zero the counters of the work done by the sorting functions. */
+void upo_sort_stats_reset();
+
 
 /**
  * \brief Sorts the given array according to the insertion sort algorithm.
@@ -49,14 +127,25 @@ typedef int (*upo_sort_comparator_t)(const void*, const void*);
  *  greater than zero if the first argument is considered to be respectively
  *  less than, equal to, or greater than the second.
  *
- * Insertion sort uses \f$\sim n^2/4\f$ compares and \f$\sim n^2/4\f$ exchanges
- * to sort a randomly ordered array with distinct keys, on the average.
- * The worst case is \f$\sim n^2/2\f$ compares and \f$\sim n^2/2\f$ exchanges,
- * and the best case is \f$n-1\f$ compares and \f$0\f$ exchanges.
- * The time complexity of insertion sort is \f$\Theta(n^2)\f$ in the worst case.
+ * Each element is saved once, its position among the preceding (sorted)
+ * elements is found by binary search, and the elements in between are shifted
+ * by a single `memmove`.
+ * Thus, insertion sort uses \f$O(n \log n)\f$ compares, and the best case
+ * (an already sorted array) is \f$n-1\f$ compares and no moves.
+ * The time complexity of insertion sort is still \f$\Theta(n^2)\f$ in the
+ * worst case, because of the moves, but their cost per element is the one of
+ * a block copy.
+ * The sort is stable.
  */
 void upo_insertion_sort(void *base, size_t n, size_t size, upo_sort_comparator_t cmp);
 
+/**
+ * \brief Same as upo_insertion_sort(), with a comparison function that takes a context.
+ *
+ * \param ctx The pointer passed as third argument to \a cmp.
+ */
+void upo_insertion_sort_r(void *base, size_t n, size_t size, upo_sort_comparator_r_t cmp, void *ctx);
+
 /**
  * \brief Sorts the given array according to the merge sort algorithm.
  *
@@ -76,6 +165,140 @@ void upo_insertion_sort(void *base, size_t n, size_t size, upo_sort_comparator_t
  */
 void upo_merge_sort(void *base, size_t n, size_t size, upo_sort_comparator_t cmp);
 
+/**
+ * \brief Same as upo_merge_sort(), with a comparison function that takes a context.
+ *
+ * \param ctx The pointer passed as third argument to \a cmp.
+ */
+void upo_merge_sort_r(void *base, size_t n, size_t size, upo_sort_comparator_r_t cmp, void *ctx);
+
+/**
+ * \brief Sorts the given array according to the merge sort algorithm, using
+ *  the given auxiliary buffer.
+ *
+ * \param base Pointer to the start of the input array.
+ * \param n Number of elements in the input array.
+ * \param size The size (in bytes) of each element of the array.
+ * \param cmp Pointer to the comparison function used to sort the array in
+ *  ascending order.
+ * \param aux Pointer to an auxiliary buffer of at least `n*size` bytes, or
+ *  `NULL` to let the function allocate (and free) it by itself.
+ *
+ * The auxiliary buffer is allocated (at most) once per call and the roles of
+ * the input array and of the auxiliary buffer are swapped at each level of the
+ * recursion, so that no element is copied back after a merge.
+ * Passing the same buffer to consecutive calls avoids any memory allocation.
+ * The content of \a aux on return is unspecified.
+ *
+ * The sort is stable.
+ */
+void upo_merge_sort_ex(void *base, size_t n, size_t size, upo_sort_comparator_t cmp, void *aux);
+
+/**
+ * \brief Same as upo_merge_sort_ex(), with a comparison function that takes a context.
+ *
+ * \param ctx The pointer passed as third argument to \a cmp.
+ */
+void upo_merge_sort_ex_r(void *base, size_t n, size_t size, upo_sort_comparator_r_t cmp, void *ctx, void *aux);
+
+/**
+ * \brief Sorts the given array according to the bottom-up merge sort
+ *  algorithm.
+ *
+ * \param base Pointer to the start of the input array.
+ * \param n Number of elements in the input array.
+ * \param size The size (in bytes) of each element of the array.
+ * \param cmp Pointer to the comparison function used to sort the array in
+ *  ascending order.
+ *
+ * The array is first split into short runs that are sorted in place by
+ * insertion sort.
+ * Runs are then merged iteratively (without recursion) by alternating between
+ * the input array and a single auxiliary buffer.
+ * Merge passes are first completed inside blocks small enough to stay in the
+ * processor cache, and only then continued over the whole array.
+ *
+ * The sort is stable.
+ */
+void upo_merge_sort_bottomup(void *base, size_t n, size_t size, upo_sort_comparator_t cmp);
+
+/**
+ * \brief Same as upo_merge_sort_bottomup(), with a comparison function that takes a context.
+ *
+ * \param ctx The pointer passed as third argument to \a cmp.
+ */
+void upo_merge_sort_bottomup_r(void *base, size_t n, size_t size, upo_sort_comparator_r_t cmp, void *ctx);
+
+/**
+ * \brief Sorts the given array according to an adaptive merge sort algorithm
+ *  that takes advantage of already sorted runs (Timsort).
+ *
+ * \param base Pointer to the start of the input array.
+ * \param n Number of elements in the input array.
+ * \param size The size (in bytes) of each element of the array.
+ * \param cmp Pointer to the comparison function used to sort the array in
+ *  ascending order.
+ *
+ * The array is scanned from left to right for natural runs, that is maximal
+ * non-descending or strictly descending sequences; the latter are reversed.
+ * Runs shorter than a minimum length (between 32 and 64, depending on \a n)
+ * are extended by binary insertion sort.
+ * Each run is pushed onto a stack, and adjacent runs are merged as soon as
+ * their lengths break the invariants that keep merges balanced.
+ * Merges skip the prefix and suffix that are already in place, use a
+ * temporary array as large as the shorter run, and switch to galloping
+ * (exponential search) when one run keeps winning.
+ *
+ * The time complexity is \f$O(n \log n)\f$ in the worst case and
+ * \f$O(n)\f$ for arrays made of few runs, such as sorted and reversely sorted
+ * arrays, which need no temporary array at all.
+ * The sort is stable.
+ */
+void upo_adaptive_sort(void *base, size_t n, size_t size, upo_sort_comparator_t cmp);
+
+/**
+ * \brief Same as upo_adaptive_sort(), with a comparison function that takes a context.
+ *
+ * \param ctx The pointer passed as third argument to \a cmp.
+ */
+void upo_adaptive_sort_r(void *base, size_t n, size_t size, upo_sort_comparator_r_t cmp, void *ctx);
+
+/**
+ * \brief Sorts the given array according to the merge sort algorithm, using
+ *  several threads.
+ *
+ * \param base Pointer to the start of the input array.
+ * \param n Number of elements in the input array.
+ * \param size The size (in bytes) of each element of the array.
+ * \param cmp Pointer to the comparison function used to sort the array in
+ *  ascending order.
+ *  It is called concurrently by several threads, so it must be thread-safe.
+ * \param nthreads The maximum number of threads to use, or `0` to use as many
+ *  threads as are the online processors.
+ *
+ * The array is split into one chunk per thread and the chunks are sorted
+ * concurrently by upo_merge_sort_ex().
+ * Then, sorted runs are merged pairwise in \f$\lceil \log_2 t \rceil\f$
+ * rounds, where \f$t\f$ is the number of threads.
+ * Each round is itself parallel: every thread produces an equal share of the
+ * output of a merge, whose input ranges are found by a binary search along
+ * the merge path (co-ranking).
+ * Arrays too small to give each thread at least
+ * `UPO_PARALLEL_MERGE_SORT_MIN_CHUNK` elements are sorted by fewer threads.
+ *
+ * The sort is stable, so the result is identical to the one of
+ * upo_merge_sort().
+ * An auxiliary array of `n*size` bytes is allocated.
+ */
+void upo_parallel_merge_sort(void *base, size_t n, size_t size, upo_sort_comparator_t cmp, size_t nthreads);
+
+/**
+ * \brief Same as upo_parallel_merge_sort(), with a comparison function that takes a context.
+ *
+ * \param ctx The pointer passed as third argument to \a cmp.
+ */
+void upo_parallel_merge_sort_r(void *base, size_t n, size_t size, upo_sort_comparator_r_t cmp, void *ctx, size_t nthreads);
+
 /**
  * \brief Sorts the given array according to the quick sort algorithm.
  *
@@ -91,8 +314,484 @@ void upo_merge_sort(void *base, size_t n, size_t size, upo_sort_comparator_t cmp
  */
 void upo_quick_sort(void *base, size_t n, size_t size, upo_sort_comparator_t cmp);
 
+/**
+ * \brief Same as upo_quick_sort(), with a comparison function that takes a context.
+ *
+ * \param ctx The pointer passed as third argument to \a cmp.
+ */
+void upo_quick_sort_r(void *base, size_t n, size_t size, upo_sort_comparator_r_t cmp, void *ctx);
+
+/**
+ * \brief Sorts the given array according to the quick sort algorithm with
+ *  three-way partitioning.
+ *
+ * \param base Pointer to the start of the input array.
+ * \param n Number of elements in the input array.
+ * \param size The size (in bytes) of each element of the array.
+ * \param cmp Pointer to the comparison function used to sort the array in
+ *  ascending order.
+ *
+ * Each range is split by Bentley and McIlroy's three-way partitioning into the
+ * elements less than, equal to, and greater than the pivot, and only the first
+ * and the last group are sorted further.
+ * Keys equal to the pivot are parked at both ends of the range during the scan
+ * and moved to the middle at the end, so distinct keys cost no more swaps than
+ * in the classic two-way partitioning.
+ * Thus, an array with \f$k\f$ distinct keys is sorted with
+ * \f$O(n \log k)\f$ compares, which makes this variant well suited to inputs
+ * with many duplicate keys.
+ * The pivot is the median of the first, middle and last element of each range,
+ * ranges of at most `UPO_QUICK_SORT_CUTOFF` elements are sorted by insertion
+ * sort, and the recursion always descends into the smaller part first.
+ */
+void upo_quick_sort_3way(void *base, size_t n, size_t size, upo_sort_comparator_t cmp);
+
+/**
+ * \brief Same as upo_quick_sort_3way(), with a comparison function that takes a context.
+ *
+ * \param ctx The pointer passed as third argument to \a cmp.
+ */
+void upo_quick_sort_3way_r(void *base, size_t n, size_t size, upo_sort_comparator_r_t cmp, void *ctx);
+
+/**
+ * \brief Sorts the given array according to the introsort algorithm.
+ *
+ * \param base Pointer to the start of the input array.
+ * \param n Number of elements in the input array.
+ * \param size The size (in bytes) of each element of the array.
+ * \param cmp Pointer to the comparison function used to sort the array in
+ *  ascending order.
+ *
+ * Introsort is a quick sort that picks the pivot as the median of three
+ * elements (or as the median of three medians, for large ranges), sorts short
+ * ranges with insertion sort, and switches to heap sort when the recursion
+ * gets deeper than \f$2 \lfloor \log_2 n \rfloor\f$.
+ * The recursion always descends into the smaller part first, while the
+ * larger one is handled by iteration.
+ *
+ * The time complexity of introsort is \f$O(n \log n)\f$ in the worst case,
+ * and its stack usage is \f$O(\log n)\f$.
+ * The sort is not stable.
+ */
+void upo_intro_sort(void *base, size_t n, size_t size, upo_sort_comparator_t cmp);
+
+/**
+ * \brief Same as upo_intro_sort(), with a comparison function that takes a context.
+ *
+ * \param ctx The pointer passed as third argument to \a cmp.
+ */
+void upo_intro_sort_r(void *base, size_t n, size_t size, upo_sort_comparator_r_t cmp, void *ctx);
+
+/**
+ * \brief Sorts the given array according to the heap sort algorithm.
+ *
+ * \param base Pointer to the start of the input array.
+ * \param n Number of elements in the input array.
+ * \param size The size (in bytes) of each element of the array.
+ * \param cmp Pointer to the comparison function used to sort the array in
+ *  ascending order.
+ *
+ * The array is first rearranged in place into a binary max-heap, then the
+ * maximum is repeatedly swapped past the end of the shrinking heap.
+ * This is the same algorithm introsort falls back to (see upo_intro_sort()).
+ *
+ * The time complexity of heap sort is \f$O(n \log n)\f$ in the worst case,
+ * and it uses no additional memory.
+ * The sort is not stable.
+ */
+void upo_heap_sort(void *base, size_t n, size_t size, upo_sort_comparator_t cmp);
+
+/**
+ * \brief Same as upo_heap_sort(), with a comparison function that takes a context.
+ *
+ * \param ctx The pointer passed as third argument to \a cmp.
+ */
+void upo_heap_sort_r(void *base, size_t n, size_t size, upo_sort_comparator_r_t cmp, void *ctx);
+
+/**
+ * \brief Sorts the given array according to the quick sort algorithm, using
+ *  several threads.
+ *
+ * \param base Pointer to the start of the input array.
+ * \param n Number of elements in the input array.
+ * \param size The size (in bytes) of each element of the array.
+ * \param cmp Pointer to the comparison function used to sort the array in
+ *  ascending order.
+ *  It is called concurrently by several threads, so it must be thread-safe.
+ * \param nthreads The maximum number of threads to use, or `0` to use as many
+ *  threads as are the online processors.
+ *
+ * Each partitioning step of introsort (see upo_intro_sort()) spawns the two
+ * resulting ranges as tasks of a work-stealing task pool (see upo/task.h).
+ * Ranges of at most `UPO_PARALLEL_QUICK_SORT_GRAIN` elements are sorted
+ * sequentially by introsort, which also takes over (with the same depth
+ * limit) to bound the worst case to \f$O(n \log n)\f$.
+ *
+ * The sort is not stable.
+ */
+void upo_parallel_quick_sort(void *base, size_t n, size_t size, upo_sort_comparator_t cmp, size_t nthreads);
+
+/**
+ * \brief Same as upo_parallel_quick_sort(), with a comparison function that takes a context.
+ *
+ * \param ctx The pointer passed as third argument to \a cmp.
+ */
+void upo_parallel_quick_sort_r(void *base, size_t n, size_t size, upo_sort_comparator_r_t cmp, void *ctx, size_t nthreads);
+
+/**
+ * \brief Rearranges the given array so that the element at the given
+ *  position is the one that would be there if the array were sorted.
+ *
+ * \param base Pointer to the start of the input array.
+ * \param n Number of elements in the input array.
+ * \param size The size (in bytes) of each element of the array.
+ * \param cmp Pointer to the comparison function used to sort the array in
+ *  ascending order.
+ * \param k The position to fill, in `[0, n)`.
+ *
+ * The elements before position \a k are not greater than it, the ones after
+ * it are not less than it, and both groups are in no particular order.
+ * The array is partitioned as in upo_intro_sort(), but only the part holding
+ * \a k is processed further (quickselect), so the expected time complexity
+ * is \f$\Theta(n)\f$.
+ * After \f$2 \lfloor \log_2 n \rfloor\f$ unbalanced partitions, the range
+ * left is heap sorted, which bounds the worst case to \f$O(n \log n)\f$
+ * (introselect).
+ */
+void upo_select_nth(void *base, size_t n, size_t size, upo_sort_comparator_t cmp, size_t k);
+
+/**
+ * \brief Same as upo_select_nth(), with a comparison function that takes a context.
+ *
+ * \param ctx The pointer passed as third argument to \a cmp.
+ */
+void upo_select_nth_r(void *base, size_t n, size_t size, upo_sort_comparator_r_t cmp, void *ctx, size_t k);
+
+/**
+ * \brief Sorts the smallest elements of the given array.
+ *
+ * \param base Pointer to the start of the input array.
+ * \param n Number of elements in the input array.
+ * \param size The size (in bytes) of each element of the array.
+ * \param cmp Pointer to the comparison function used to sort the array in
+ *  ascending order.
+ * \param k The number of elements to sort (the whole array if it is at least
+ *  \a n).
+ *
+ * On return, the first \a k elements are the smallest ones, in ascending
+ * order, and the others are in no particular order.
+ * The `k`-th smallest element is selected by upo_select_nth(), then the
+ * elements before it are sorted by upo_intro_sort(), in
+ * \f$O(n + k \log k)\f$ expected time.
+ */
+void upo_partial_sort(void *base, size_t n, size_t size, upo_sort_comparator_t cmp, size_t k);
+
+/**
+ * \brief Same as upo_partial_sort(), with a comparison function that takes a context.
+ *
+ * \param ctx The pointer passed as third argument to \a cmp.
+ */
+void upo_partial_sort_r(void *base, size_t n, size_t size, upo_sort_comparator_r_t cmp, void *ctx, size_t k);
+
+/**
+ * \brief Creates a top-k selection, which keeps the \a k smallest elements
+ *  of a stream.
+ *
+ * \param k The (positive) number of elements to keep.
+ * \param size The size (in bytes) of each element.
+ * \param cmp Pointer to the comparison function; to keep the largest
+ *  elements, pass one that orders them in descending order.
+ * \return The new top-k selection.
+ *
+ * The elements are kept in a max-heap of \a k elements, so that each
+ * upo_top_k_push() takes \f$O(\log k)\f$ time (constant time if the element
+ * is not among the smallest ones seen so far) and the stream itself is never
+ * stored.
+ */
+upo_top_k_t upo_top_k_create(size_t k, size_t size, upo_sort_comparator_t cmp);
+
+/**
+ * \brief Same as upo_top_k_create(), with a comparison function that takes a context.
+ *
+ * \param ctx The pointer passed as third argument to \a cmp.
+ */
+upo_top_k_t upo_top_k_create_r(size_t k, size_t size, upo_sort_comparator_r_t cmp, void *ctx);
+
+/**
+ * \brief Destroys the given top-k selection.
+ *
+ * \param top The top-k selection to destroy.
+ */
+void upo_top_k_destroy(upo_top_k_t top);
+
+/**
+ * \brief Adds an element to the given top-k selection.
+ *
+ * \param top The top-k selection.
+ * \param elem Pointer to the element, which is copied if it is kept.
+ *
+ * Among elements equal to the largest one kept, which ones are kept is
+ * unspecified.
+ */
+void upo_top_k_push(upo_top_k_t top, const void *elem);
+
+/**
+ * \brief Adds the elements of the given array to the given top-k selection.
+ *
+ * \param top The top-k selection.
+ * \param base Pointer to the start of the array.
+ * \param n Number of elements in the array.
+ */
+void upo_top_k_push_array(upo_top_k_t top, const void *base, size_t n);
+
+/**
+ * \brief Returns the number of elements kept by the given top-k selection.
+ *
+ * \param top The top-k selection.
+ * \return The number of elements added so far, if less than `k`, else `k`.
+ */
+size_t upo_top_k_size(const upo_top_k_t top);
+
+/**
+ * \brief Copies the elements kept by the given top-k selection, in
+ *  ascending order.
+ *
+ * \param top The top-k selection.
+ * \param out Pointer to an array of at least upo_top_k_size() elements.
+ * \return The number of elements copied.
+ *
+ * The selection is left unchanged, so more elements can be added later.
+ */
+size_t upo_top_k_get(const upo_top_k_t top, void *out);
+
+/**
+ * \brief Removes all the elements kept by the given top-k selection.
+ *
+ * \param top The top-k selection.
+ */
+void upo_top_k_clear(upo_top_k_t top);
+
+/**
+ * \brief Sorts the given array of unsigned 32-bit integers according to the
+ *  LSD radix sort algorithm.
+ *
+ * \param base Pointer to the start of the input array.
+ * \param n Number of elements in the input array.
+ *
+ * Keys are sorted by four counting-sort passes over 8-bit digits, from the
+ * least significant to the most significant one.
+ * The histograms of all digits are computed in a single scan of the input,
+ * and passes over digits that are the same for all keys are skipped.
+ * No comparison function is called: the time complexity is \f$\Theta(n)\f$
+ * and the extra space is \f$\Theta(n)\f$.
+ */
+void upo_radix_sort_u32(uint32_t *base, size_t n);
+
+/**
+ * \brief Sorts the given array by an unsigned 32-bit integer key according to
+ *  the LSD radix sort algorithm.
+ *
+ * \param base Pointer to the start of the input array.
+ * \param n Number of elements in the input array.
+ * \param size The size (in bytes) of each element of the array.
+ * \param key Pointer to the function that extracts the key of an element.
+ *
+ * The key of each element is extracted once, then elements are sorted as in
+ * upo_radix_sort_u32(), moving each element together with its key.
+ * To sort by a signed key `k`, let \a key return `(uint32_t) k ^ 0x80000000U`.
+ *
+ * The sort is stable.
+ */
+void upo_radix_sort_by_key(void *base, size_t n, size_t size, upo_sort_u32_key_t key);
+
+/**
+ * \brief Sorts the given array by a string key according to the MSD radix
+ *  sort algorithm.
+ *
+ * \param base Pointer to the start of the input array.
+ * \param n Number of elements in the input array.
+ * \param size The size (in bytes) of each element of the array.
+ * \param key Pointer to the function that returns the (NUL-terminated) string
+ *  key of an element.
+ *
+ * Elements are distributed by counting sort on the first character of their
+ * key, then each group sharing that character is sorted recursively on the
+ * next character.
+ * Groups of at most `UPO_RADIX_SORT_STR_CUTOFF` elements are finished by
+ * insertion sort.
+ * Each character is thus examined about once, instead of once per comparison.
+ * The resulting order is the one given by `strcmp`.
+ *
+ * The sort is stable.
+ */
+void upo_radix_sort_str(void *base, size_t n, size_t size, upo_sort_str_key_t key);
+
+/**
+ * \brief Sorts the given array indirectly, moving each element only once.
+ *
+ * \param base Pointer to the start of the input array.
+ * \param n Number of elements in the input array.
+ * \param size The size (in bytes) of each element of the array.
+ * \param cmp Pointer to the comparison function used to sort the array in
+ *  ascending order.
+ * \param prefix Pointer to the function that extracts the key prefix of an
+ *  element, or `NULL`.
+ *
+ * The sorting permutation is computed by upo_sort_permutation(), then it is
+ * applied in place by upo_sort_apply_permutation().
+ * It is meant for large elements, where the \f$\Theta(n \log n)\f$ element
+ * moves of a direct sort cost more than the comparisons.
+ *
+ * The sort is stable.
+ */
+void upo_sort_indirect(void *base, size_t n, size_t size, upo_sort_comparator_t cmp, upo_sort_u32_key_t prefix);
+
+/**
+ * \brief Same as upo_sort_indirect(), with a comparison function that takes a context.
+ *
+ * \param ctx The pointer passed as third argument to \a cmp.
+ */
+void upo_sort_indirect_r(void *base, size_t n, size_t size, upo_sort_comparator_r_t cmp, void *ctx, upo_sort_u32_key_t prefix);
+
+/**
+ * \brief Computes the permutation that sorts the given array, without moving
+ *  its elements.
+ *
+ * \param base Pointer to the start of the input array.
+ * \param n Number of elements in the input array.
+ * \param size The size (in bytes) of each element of the array.
+ * \param cmp Pointer to the comparison function used to sort the array in
+ *  ascending order.
+ * \param prefix Pointer to the function that extracts the key prefix of an
+ *  element, or `NULL`.
+ * \param perm Pointer to an array of \a n elements where the permutation is
+ *  stored: `perm[i]` is the index in \a base of the element that goes to
+ *  position `i` of the sorted array.
+ *
+ * A (key prefix, pointer) pair is built for each element and the pairs are
+ * sorted by merge sort, comparing prefixes first and calling \a cmp only
+ * when they are equal.
+ * The prefix must be consistent with \a cmp, that is `prefix(a) < prefix(b)`
+ * must imply `cmp(a, b) < 0` (e.g., the first 4 characters of a string key,
+ * most significant first); if \a prefix is `NULL`, \a cmp is always called.
+ *
+ * The permutation is stable.
+ */
+void upo_sort_permutation(const void *base, size_t n, size_t size, upo_sort_comparator_t cmp, upo_sort_u32_key_t prefix, size_t *perm);
+
+/**
+ * \brief Same as upo_sort_permutation(), with a comparison function that takes a context.
+ *
+ * \param ctx The pointer passed as third argument to \a cmp.
+ */
+void upo_sort_permutation_r(const void *base, size_t n, size_t size, upo_sort_comparator_r_t cmp, void *ctx, upo_sort_u32_key_t prefix, size_t *perm);
+
+/**
+ * \brief Rearranges the given array according to the given permutation.
+ *
+ * \param base Pointer to the start of the input array.
+ * \param n Number of elements in the input array.
+ * \param size The size (in bytes) of each element of the array.
+ * \param perm Pointer to the permutation, as computed by
+ *  upo_sort_permutation(); it is overwritten with the identity permutation.
+ *
+ * The permutation is applied by following its cycles, so that each element
+ * is moved once and only one element of extra space is needed.
+ */
+void upo_sort_apply_permutation(void *base, size_t n, size_t size, size_t *perm);
+
+/**
+ * \brief Sorts the given array by a normalized key compared with `memcmp`.
+ *
+ * \param base Pointer to the start of the input array.
+ * \param n Number of elements in the input array.
+ * \param size The size (in bytes) of each element of the array.
+ * \param key_size The size (in bytes) of the normalized keys.
+ * \param key Pointer to the function that writes the normalized key of an
+ *  element.
+ * \param cmp Pointer to the comparison function that orders the elements
+ *  whose keys are equal, or `NULL` if the keys are exact.
+ * \param ctx The pointer passed as third argument to \a key and \a cmp.
+ *
+ * The key of each element is computed once and cached, so that most
+ * comparisons are a `memcmp` of two keys (and the first 8 bytes of the keys
+ * are compared as an integer) instead of an indirect call to \a cmp.
+ * Keys must be consistent with \a cmp: keys that differ must order the
+ * elements as \a cmp does.
+ * Integers are normalized by upo_sort_key_put_u32() and
+ * upo_sort_key_put_i32(), strings by upo_sort_key_put_str(); a truncated
+ * string must be the last field of the key, and \a cmp must resolve the
+ * ties it leaves.
+ * The elements are then moved once, as in upo_sort_indirect().
+ *
+ * The sort is stable.
+ */
+void upo_sort_by_key_r(void *base, size_t n, size_t size, size_t key_size, upo_sort_key_r_t key, upo_sort_comparator_r_t cmp, void *ctx);
+
+/**
+ * \brief Writes an unsigned integer as a normalized key field.
+ *
+ * \param key The buffer where the 4 bytes of the field are written.
+ * \param value The value to write, most significant byte first.
+ * \return The position following the field.
+ */
+unsigned char* upo_sort_key_put_u32(unsigned char *key, uint32_t value);
+
+/**
+ * \brief Writes a signed integer as a normalized key field.
+ *
+ * \param key The buffer where the 4 bytes of the field are written.
+ * \param value The value to write, with its sign bit flipped so that
+ *  negative values come first.
+ * \return The position following the field.
+ */
+unsigned char* upo_sort_key_put_i32(unsigned char *key, int32_t value);
+
+/**
+ * \brief Writes a string as a normalized key field.
+ *
+ * \param key The buffer where the \a width bytes of the field are written.
+ * \param str The string to write, truncated or padded with NUL characters
+ *  to \a width bytes.
+ * \param width The size (in bytes) of the field.
+ * \return The position following the field.
+ */
+unsigned char* upo_sort_key_put_str(unsigned char *key, const char *str, size_t width);
+
 void upo_bubble_sort(void *base, size_t n, size_t size, upo_sort_comparator_t cmp);
 
+/**
+ * \brief Same as upo_bubble_sort(), with a comparison function that takes a context.
+ *
+ * \param ctx The pointer passed as third argument to \a cmp.
+ */
+void upo_bubble_sort_r(void *base, size_t n, size_t size, upo_sort_comparator_r_t cmp, void *ctx);
+
+/**
+ * \brief Sorts the given array according to the quick sort algorithm with
+ *  median-of-3 pivot selection and insertion sort cutoff.
+ *
+ * \param base Pointer to the start of the input array.
+ * \param n Number of elements in the input array.
+ * \param size The size (in bytes) of each element of the array.
+ * \param cmp Pointer to the comparison function used to sort the array in
+ *  ascending order.
+ *
+ * The pivot is the median among the first, the middle and the last element of
+ * each range.
+ * Ranges of at most `UPO_QUICK_SORT_CUTOFF` elements (16 by default, can be
+ * changed at build time) are sorted by insertion sort.
+ * The recursion always descends into the smaller part first, while the
+ * larger one is handled by iteration, so the stack depth is
+ * \f$O(\log n)\f$.
+ */
 void upo_quick_sort_median3_cutoff(void *base, size_t n, size_t size, upo_sort_comparator_t cmp);
 
+/**
+ * \brief Same as upo_quick_sort_median3_cutoff(), with a comparison function that takes a context.
+ *
+ * \param ctx The pointer passed as third argument to \a cmp.
+ */
+void upo_quick_sort_median3_cutoff_r(void *base, size_t n, size_t size, upo_sort_comparator_r_t cmp, void *ctx);
+
 #endif /* UPO_SORT_H */
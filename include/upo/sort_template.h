@@ -0,0 +1,230 @@
+/* vim: set tabstop=4 expandtab shiftwidth=4 softtabstop=4: */
+
+/**
+ * \file upo/sort_template.h
+ *
+ * \brief Type-specialized sorting algorithms generated by macros.
+ *
+ * \author Simone Gattini, Federico Barbero, Anton Iliev
+ *
+ * \copyright 2015 University of Piemonte Orientale, Computer Science Institute
+ *
+ *  This file is part of UPOalglib.
+ *
+ *  UPOalglib is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  UPOalglib is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with UPOalglib.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef UPO_SORT_TEMPLATE_H
+#define UPO_SORT_TEMPLATE_H
+
+
+#include <stddef.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+
+#ifndef UPO_SORT_TEMPLATE_CUTOFF
+/** \brief Ranges of at most this many elements are sorted by insertion sort
+ *   in the generated merge and quick sorts. */
+# define UPO_SORT_TEMPLATE_CUTOFF 16
+#endif /* UPO_SORT_TEMPLATE_CUTOFF */
+
+/** \brief Orders elements by means of the `<` operator. */
+#define UPO_SORT_LESS(a, b) ((a) < (b))
+
+/** \brief Orders records by means of the `<` operator applied to their `key` member. */
+#define UPO_SORT_KEY_LESS(a, b) ((a).key < (b).key)
+
+
+/**
+ * \brief Defines insertion sort, merge sort and quick sort for arrays of the
+ *  given type.
+ *
+ * \param name The suffix used to build the names of the generated functions.
+ * \param type The type of the elements of the arrays to sort.
+ * \param less The name of a function-like macro (or of a function) that takes
+ *  two elements of type \a type and tells whether the first one is less than
+ *  the second one.
+ *
+ * The following `static inline` functions are generated:
+ * - `void upo_<name>_insertion_sort(type *base, size_t n)`
+ * - `void upo_<name>_merge_sort(type *base, size_t n)`
+ * - `void upo_<name>_quick_sort(type *base, size_t n)`
+ * .
+ * Unlike the generic functions declared in upo/sort.h, elements are accessed
+ * with their actual type and compared by \a less, so the compiler can inline
+ * every comparison and move elements with plain assignments.
+ *
+ * Merge sort is stable and allocates one auxiliary array per call.
+ * Quick sort uses the median-of-3 pivot and sorts the smaller part first, so
+ * its stack depth is \f$O(\log n)\f$.
+ * Both switch to insertion sort on ranges of at most
+ * `UPO_SORT_TEMPLATE_CUTOFF` elements.
+ *
+ * For instance:
+ * \code
+ * #define BY_NAME_LESS(a, b) (strcmp((a).name, (b).name) < 0)
+ * UPO_SORT_DEFINE(person, person_t, BY_NAME_LESS)
+ * ...
+ * upo_person_merge_sort(people, n);
+ * \endcode
+ */
+#define UPO_SORT_DEFINE(name, type, less) \
+static inline void upo_##name##_insertion_sort(type *base, size_t n) \
+{ \
+    size_t i; \
+    for (i = 1; i < n; ++i) \
+    { \
+        type tmp = base[i]; \
+        size_t j = i; \
+        while (j > 0 && less(tmp, base[j - 1])) \
+        { \
+            base[j] = base[j - 1]; \
+            --j; \
+        } \
+        base[j] = tmp; \
+    } \
+} \
+\
+static inline void upo_##name##_merge_sort_rec(type *src, type *dst, size_t lo, size_t hi) \
+{ \
+    /* Sorts src[lo..hi-1] into dst[lo..hi-1]; both arrays hold the same \
+     * elements on entry. */ \
+    size_t mid; \
+    size_t i; \
+    size_t j; \
+    size_t k; \
+    if (hi - lo <= UPO_SORT_TEMPLATE_CUTOFF) \
+    { \
+        upo_##name##_insertion_sort(dst + lo, hi - lo); \
+        return; \
+    } \
+    mid = lo + (hi - lo) / 2; \
+    upo_##name##_merge_sort_rec(dst, src, lo, mid); \
+    upo_##name##_merge_sort_rec(dst, src, mid, hi); \
+    i = lo; \
+    j = mid; \
+    for (k = lo; k < hi; ++k) \
+    { \
+        if (i < mid && (j >= hi || !less(src[j], src[i]))) \
+        { \
+            dst[k] = src[i++]; \
+        } \
+        else \
+        { \
+            dst[k] = src[j++]; \
+        } \
+    } \
+} \
+\
+static inline void upo_##name##_merge_sort(type *base, size_t n) \
+{ \
+    type *aux = NULL; \
+    if (n < 2) \
+    { \
+        return; \
+    } \
+    aux = malloc(n * sizeof(type)); \
+    if (aux == NULL) \
+    { \
+        perror("Unable to allocate memory for auxiliary vector"); \
+        abort(); \
+    } \
+    memcpy(aux, base, n * sizeof(type)); \
+    upo_##name##_merge_sort_rec(aux, base, 0, n); \
+    free(aux); \
+} \
+\
+static inline void upo_##name##_quick_sort(type *base, size_t n) \
+{ \
+    while (n > UPO_SORT_TEMPLATE_CUTOFF) \
+    { \
+        size_t mid = n / 2; \
+        size_t i = 0; \
+        size_t j = n - 1; \
+        type pivot; \
+        type tmp; \
+        /* Sorts the first, middle and last element, which then act as \
+         * sentinels for the partitioning scans. */ \
+        if (less(base[mid], base[0])) \
+        { \
+            tmp = base[mid]; base[mid] = base[0]; base[0] = tmp; \
+        } \
+        if (less(base[n - 1], base[mid])) \
+        { \
+            tmp = base[mid]; base[mid] = base[n - 1]; base[n - 1] = tmp; \
+            if (less(base[mid], base[0])) \
+            { \
+                tmp = base[mid]; base[mid] = base[0]; base[0] = tmp; \
+            } \
+        } \
+        pivot = base[mid]; \
+        /* Partitions into base[0..i-1] <= pivot and base[i..n-1] >= pivot */ \
+        while (1) \
+        { \
+            while (less(base[i], pivot)) \
+            { \
+                ++i; \
+            } \
+            while (less(pivot, base[j])) \
+            { \
+                --j; \
+            } \
+            if (i >= j) \
+            { \
+                break; \
+            } \
+            tmp = base[i]; base[i] = base[j]; base[j] = tmp; \
+            ++i; \
+            --j; \
+        } \
+        /* Sorts the smaller part recursively and the larger one iteratively */ \
+        if (i < n - i) \
+        { \
+            upo_##name##_quick_sort(base, i); \
+            base += i; \
+            n -= i; \
+        } \
+        else \
+        { \
+            upo_##name##_quick_sort(base + i, n - i); \
+            n = i; \
+        } \
+    } \
+    upo_##name##_insertion_sort(base, n); \
+}
+
+
+/** \brief Key-value record with an integer key, which is the layout used by
+ *   the sorting benchmarks. */
+typedef struct
+{
+    int key;      /**< The sort key. */
+    double value; /**< The satellite data. */
+} upo_sort_kv_t;
+
+/* Ready-made instances */
+
+/** \brief Sorting algorithms for arrays of `int`: `upo_int_*_sort`. */
+UPO_SORT_DEFINE(int, int, UPO_SORT_LESS)
+
+/** \brief Sorting algorithms for arrays of `double`: `upo_double_*_sort`. */
+UPO_SORT_DEFINE(double, double, UPO_SORT_LESS)
+
+/** \brief Sorting algorithms for arrays of `upo_sort_kv_t` ordered by key: `upo_kv_*_sort`. */
+UPO_SORT_DEFINE(kv, upo_sort_kv_t, UPO_SORT_KEY_LESS)
+
+
+#endif /* UPO_SORT_TEMPLATE_H */
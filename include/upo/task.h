@@ -0,0 +1,107 @@
+/* vim: set tabstop=4 expandtab shiftwidth=4 softtabstop=4: */
+
+/**
+ * \file upo/task.h
+ *
+ * \brief Work-stealing task scheduler.
+ *
+ * \author Simone Gattini, Federico Barbero, Anton Iliev
+ *
+ * \copyright 2015 University of Piemonte Orientale, Computer Science Institute
+ *
+ *  This file is part of UPOalglib.
+ *
+ *  UPOalglib is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  UPOalglib is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with UPOalglib.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef UPO_TASK_H
+#define UPO_TASK_H
+
+#include <stddef.h>
+
+
+/** \brief Definition of \c upo_task_pool_t type */
+typedef struct upo_task_pool_s* upo_task_pool_t; /* Pointer to an incomplete structure type. */
+
+/**
+ * \brief The type of the functions run as tasks.
+ *
+ * The function receives the pool that runs it, so that it can spawn further
+ * tasks, and the argument given to upo_task_spawn().
+ */
+typedef void (*upo_task_func_t)(upo_task_pool_t pool, void *arg);
+
+
+/**
+ * \brief Creates a new task pool.
+ *
+ * \param nthreads The number of threads that run tasks, including the one
+ *  calling upo_task_pool_wait(), or `0` to use as many threads as are the
+ *  online processors.
+ * \return The new task pool.
+ *
+ * Each thread owns a double-ended queue of tasks.
+ * A thread pushes the tasks it spawns at the bottom of its own queue and
+ * takes tasks from there (LIFO order, which keeps the working set small);
+ * when its queue is empty, it steals the oldest task at the top of the
+ * queue of another thread (FIFO order, which for divide-and-conquer
+ * algorithms is the largest pending piece of work).
+ * Idle threads sleep until new tasks are spawned.
+ */
+upo_task_pool_t upo_task_pool_create(size_t nthreads);
+
+/**
+ * \brief Destroys the given task pool.
+ *
+ * \param pool The task pool to destroy.
+ *
+ * Tasks that are still pending are not run.
+ */
+void upo_task_pool_destroy(upo_task_pool_t pool);
+
+/**
+ * \brief Returns the number of threads of the given task pool.
+ *
+ * \param pool A task pool.
+ * \return The number of threads, including the one calling
+ *  upo_task_pool_wait().
+ */
+size_t upo_task_pool_size(const upo_task_pool_t pool);
+
+/**
+ * \brief Schedules a task for execution in the given task pool.
+ *
+ * \param pool A task pool.
+ * \param func The function to run.
+ * \param arg The argument to pass to \a func.
+ *
+ * It can be called both by the tasks of the pool and by any other thread.
+ * Tasks spawned from outside the pool are queued at the calling thread of
+ * upo_task_pool_wait().
+ */
+void upo_task_spawn(upo_task_pool_t pool, upo_task_func_t func, void *arg);
+
+/**
+ * \brief Runs tasks until all the tasks spawned in the given task pool
+ *  (including the ones they spawn in turn) have completed.
+ *
+ * \param pool A task pool.
+ *
+ * The calling thread takes part in running tasks.
+ * It must not be called by a task.
+ */
+void upo_task_pool_wait(upo_task_pool_t pool);
+
+
+#endif /* UPO_TASK_H */
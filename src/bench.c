@@ -0,0 +1,528 @@
+/* vim: set tabstop=4 expandtab shiftwidth=4 softtabstop=4: */
+
+/*
+ * Copyright 2015 University of Piemonte Orientale, Computer Science Institute
+ *
+ * This file is part of UPOalglib.
+ *
+ * UPOalglib is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * UPOalglib is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with UPOalglib.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/* Needed for clock_gettime with -std=c11 */
+#define _POSIX_C_SOURCE 200809L
+
+#include <assert.h>
+#include "bench_private.h"
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <upo/error.h>
+
+
+upo_bench_t upo_bench_create(size_t num_warmups, size_t num_trials)
+{
+    upo_bench_t bench = NULL;
+
+    assert(num_trials > 0);
+
+    bench = malloc(sizeof(struct upo_bench_s));
+    if (bench == NULL)
+    {
+        upo_throw_sys_error("Unable to allocate memory for the benchmark");
+    }
+    bench->samples = malloc(num_trials * sizeof(double));
+    if (bench->samples == NULL)
+    {
+        upo_throw_sys_error("Unable to allocate memory for the benchmark samples");
+    }
+    bench->num_warmups = num_warmups;
+    bench->num_trials = num_trials;
+    bench->fence = UPO_BENCH_DEFAULT_OUTLIER_FENCE;
+    bench->fp = NULL;
+    bench->format = upo_bench_text_format;
+    bench->num_reports = 0;
+    bench->metric_names = NULL;
+    bench->metric_values = NULL;
+    bench->num_metrics = 0;
+    bench->num_user_metrics = 0;
+    bench->perf_timer = NULL;
+    bench->perf_samples = NULL;
+
+    return bench;
+}
+
+void upo_bench_destroy(upo_bench_t bench)
+{
+    if (bench == NULL)
+    {
+        return;
+    }
+
+    upo_bench_end_output(bench);
+    upo_perf_timer_destroy(bench->perf_timer);
+    free(bench->perf_samples);
+    free(bench->metric_values);
+    free(bench->metric_names);
+    free(bench->samples);
+    free(bench);
+}
+
+void upo_bench_set_outlier_fence(upo_bench_t bench, double fence)
+{
+    assert(bench != NULL);
+
+    bench->fence = fence;
+}
+
+void upo_bench_set_output(upo_bench_t bench, FILE *fp, upo_bench_format_t format)
+{
+    size_t i;
+
+    assert(bench != NULL);
+
+    upo_bench_end_output(bench);
+    bench->fp = fp;
+    bench->format = format;
+    bench->num_reports = 0;
+    if (fp == NULL)
+    {
+        return;
+    }
+    switch (format)
+    {
+        case upo_bench_text_format:
+            break;
+        case upo_bench_csv_format:
+            fprintf(fp, "group,name,n,samples,outliers,min,p25,median,p75,p90,p99,max,mean,stddev");
+            for (i = 0; i < bench->num_metrics; ++i)
+            {
+                fputc(',', fp);
+                upo_bench_write_csv_string(fp, bench->metric_names[i]);
+            }
+            fputc('\n', fp);
+            break;
+        case upo_bench_json_format:
+            fprintf(fp, "[");
+            break;
+    }
+}
+
+void upo_bench_set_metrics(upo_bench_t bench, const char *const names[], size_t num_metrics)
+{
+    assert(bench != NULL);
+    assert(names != NULL || num_metrics == 0);
+
+    upo_bench_layout_metrics(bench, names, num_metrics);
+}
+
+void upo_bench_set_metric(upo_bench_t bench, size_t i, double value)
+{
+    assert(bench != NULL);
+    assert(i < bench->num_metrics);
+
+    bench->metric_values[i] = value;
+}
+
+void upo_bench_set_perf_counters(upo_bench_t bench, int enabled)
+{
+    assert(bench != NULL);
+
+    if (enabled && bench->perf_timer == NULL)
+    {
+        bench->perf_samples = malloc(UPO_PERF_TIMER_NUM_EVENTS * bench->num_trials * sizeof(double));
+        if (bench->perf_samples == NULL)
+        {
+            upo_throw_sys_error("Unable to allocate memory for the benchmark counters");
+        }
+        bench->perf_timer = upo_perf_timer_create();
+    }
+    else if (!enabled && bench->perf_timer != NULL)
+    {
+        upo_perf_timer_destroy(bench->perf_timer);
+        free(bench->perf_samples);
+        bench->perf_timer = NULL;
+        bench->perf_samples = NULL;
+    }
+    upo_bench_layout_metrics(bench, bench->metric_names, bench->num_user_metrics);
+}
+
+void upo_bench_run(upo_bench_t bench, const char *group, const char *name, size_t n, upo_bench_func_t setup, upo_bench_func_t func, upo_bench_func_t teardown, void *arg, upo_bench_stats_t *stats)
+{
+    upo_bench_stats_t local_stats;
+    size_t i;
+
+    assert(bench != NULL);
+    assert(func != NULL);
+
+    for (i = 0; i < bench->num_warmups + bench->num_trials; ++i)
+    {
+        double duration;
+        size_t e;
+
+        if (setup != NULL)
+        {
+            setup(arg);
+        }
+        if (bench->perf_timer != NULL)
+        {
+            upo_perf_timer_start(bench->perf_timer);
+            func(arg);
+            upo_perf_timer_stop(bench->perf_timer);
+            duration = upo_perf_timer_elapsed(bench->perf_timer);
+        }
+        else
+        {
+            duration = upo_bench_now();
+            func(arg);
+            duration = upo_bench_now() - duration;
+        }
+        if (teardown != NULL)
+        {
+            teardown(arg);
+        }
+        if (i >= bench->num_warmups)
+        {
+            bench->samples[i - bench->num_warmups] = duration;
+            for (e = 0; bench->perf_timer != NULL && e < UPO_PERF_TIMER_NUM_EVENTS; ++e)
+            {
+                bench->perf_samples[e * bench->num_trials + i - bench->num_warmups] = upo_perf_timer_count(bench->perf_timer, (upo_perf_event_t) e);
+            }
+        }
+    }
+    if (bench->perf_timer != NULL)
+    {
+        upo_bench_set_perf_metrics(bench);
+    }
+
+    if (stats == NULL)
+    {
+        stats = &local_stats;
+    }
+    upo_bench_stats_compute(bench->samples, bench->num_trials, bench->fence, stats);
+    upo_bench_report(bench, group, name, n, stats);
+}
+
+void upo_bench_report(upo_bench_t bench, const char *group, const char *name, size_t n, const upo_bench_stats_t *stats)
+{
+    FILE *fp = NULL;
+
+    assert(bench != NULL);
+    assert(group != NULL);
+    assert(name != NULL);
+    assert(stats != NULL);
+
+    fp = bench->fp;
+    if (fp == NULL)
+    {
+        upo_bench_clear_metrics(bench);
+        return;
+    }
+    switch (bench->format)
+    {
+        case upo_bench_text_format:
+            fprintf(fp, "%s/%s (n=%lu): median %.6f s [p25 %.6f, p75 %.6f], mean %.6f +/- %.6f s, min %.6f, max %.6f, p90 %.6f, p99 %.6f (%lu samples, %lu outliers)",
+                    group, name, (unsigned long) n,
+                    stats->median, stats->p25, stats->p75, stats->mean, stats->stddev,
+                    stats->min, stats->max, stats->p90, stats->p99,
+                    (unsigned long) stats->num_samples, (unsigned long) stats->num_outliers);
+            upo_bench_write_metrics(bench);
+            fputc('\n', fp);
+            break;
+        case upo_bench_csv_format:
+            upo_bench_write_csv_string(fp, group);
+            fputc(',', fp);
+            upo_bench_write_csv_string(fp, name);
+            fprintf(fp, ",%lu,%lu,%lu,%.9g,%.9g,%.9g,%.9g,%.9g,%.9g,%.9g,%.9g,%.9g",
+                    (unsigned long) n, (unsigned long) stats->num_samples, (unsigned long) stats->num_outliers,
+                    stats->min, stats->p25, stats->median, stats->p75, stats->p90, stats->p99,
+                    stats->max, stats->mean, stats->stddev);
+            upo_bench_write_metrics(bench);
+            fputc('\n', fp);
+            break;
+        case upo_bench_json_format:
+            fprintf(fp, "%s\n  {\"group\": ", (bench->num_reports > 0) ? "," : "");
+            upo_bench_write_json_string(fp, group);
+            fprintf(fp, ", \"name\": ");
+            upo_bench_write_json_string(fp, name);
+            fprintf(fp, ", \"n\": %lu, \"samples\": %lu, \"outliers\": %lu, \"min\": %.9g, \"p25\": %.9g, \"median\": %.9g, \"p75\": %.9g, \"p90\": %.9g, \"p99\": %.9g, \"max\": %.9g, \"mean\": %.9g, \"stddev\": %.9g",
+                    (unsigned long) n, (unsigned long) stats->num_samples, (unsigned long) stats->num_outliers,
+                    stats->min, stats->p25, stats->median, stats->p75, stats->p90, stats->p99,
+                    stats->max, stats->mean, stats->stddev);
+            upo_bench_write_metrics(bench);
+            fputc('}', fp);
+            break;
+    }
+    ++bench->num_reports;
+    upo_bench_clear_metrics(bench);
+    fflush(fp);
+}
+
+void upo_bench_stats_compute(double *samples, size_t n, double fence, upo_bench_stats_t *stats)
+{
+    size_t first = 0;
+    size_t last = n;
+    double sum = 0;
+    double sum_sq = 0;
+    size_t i;
+
+    assert(samples != NULL);
+    assert(n > 0);
+    assert(stats != NULL);
+
+    qsort(samples, n, sizeof(double), upo_bench_sample_comparator);
+
+    if (fence > 0)
+    {
+        // Tukey's fences: since the samples are sorted, the ones kept are contiguous
+        double q1 = upo_bench_percentile(samples, n, 25);
+        double q3 = upo_bench_percentile(samples, n, 75);
+        double lo = q1 - fence * (q3 - q1);
+        double hi = q3 + fence * (q3 - q1);
+
+        while (first < last && samples[first] < lo)
+        {
+            ++first;
+        }
+        while (last > first && samples[last - 1] > hi)
+        {
+            --last;
+        }
+    }
+    samples += first;
+    stats->num_samples = last - first;
+    stats->num_outliers = n - stats->num_samples;
+    n = stats->num_samples;
+
+    for (i = 0; i < n; ++i)
+    {
+        sum += samples[i];
+    }
+    stats->mean = sum / n;
+    // Two-pass variance, which does not lose precision when samples are close to each other
+    for (i = 0; i < n; ++i)
+    {
+        sum_sq += (samples[i] - stats->mean) * (samples[i] - stats->mean);
+    }
+    stats->stddev = (n > 1) ? sqrt(sum_sq / (n - 1)) : 0;
+    stats->min = samples[0];
+    stats->max = samples[n - 1];
+    stats->median = upo_bench_percentile(samples, n, 50);
+    stats->p25 = upo_bench_percentile(samples, n, 25);
+    stats->p75 = upo_bench_percentile(samples, n, 75);
+    stats->p90 = upo_bench_percentile(samples, n, 90);
+    stats->p99 = upo_bench_percentile(samples, n, 99);
+}
+
+double upo_bench_percentile(const double *sorted, size_t n, double p)
+{
+    double pos;
+    size_t i;
+
+    assert(sorted != NULL);
+    assert(n > 0);
+    assert(p >= 0 && p <= 100);
+
+    pos = p / 100 * (n - 1);
+    i = (size_t) pos;
+    if (i + 1 >= n)
+    {
+        return sorted[n - 1];
+    }
+
+    return sorted[i] + (pos - i) * (sorted[i + 1] - sorted[i]);
+}
+
+double upo_bench_now()
+{
+    struct timespec ts;
+
+    if (clock_gettime(CLOCK_MONOTONIC, &ts) == -1)
+    {
+        upo_throw_sys_error("Unable to read the monotonic clock");
+    }
+
+    return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+void upo_bench_end_output(upo_bench_t bench)
+{
+    if (bench->fp == NULL)
+    {
+        return;
+    }
+    if (bench->format == upo_bench_json_format)
+    {
+        fprintf(bench->fp, "%s]\n", (bench->num_reports > 0) ? "\n" : "");
+    }
+    fflush(bench->fp);
+    bench->fp = NULL;
+}
+
+void upo_bench_write_json_string(FILE *fp, const char *s)
+{
+    fputc('"', fp);
+    for (; *s != '\0'; ++s)
+    {
+        unsigned char c = (unsigned char) *s;
+
+        if (c == '"' || c == '\\')
+        {
+            fprintf(fp, "\\%c", c);
+        }
+        else if (c < 0x20)
+        {
+            fprintf(fp, "\\u%04x", c);
+        }
+        else
+        {
+            fputc(c, fp);
+        }
+    }
+    fputc('"', fp);
+}
+
+void upo_bench_write_csv_string(FILE *fp, const char *s)
+{
+    const char *p;
+
+    if (s[strcspn(s, ",\"\n\r")] == '\0')
+    {
+        fputs(s, fp);
+        return;
+    }
+    // Quotes the field, doubling the quotes inside it
+    fputc('"', fp);
+    for (p = s; *p != '\0'; ++p)
+    {
+        if (*p == '"')
+        {
+            fputc('"', fp);
+        }
+        fputc(*p, fp);
+    }
+    fputc('"', fp);
+}
+
+void upo_bench_layout_metrics(upo_bench_t bench, const char *const names[], size_t num_user_metrics)
+{
+    size_t num_metrics = num_user_metrics + ((bench->perf_timer != NULL) ? UPO_PERF_TIMER_NUM_EVENTS : 0);
+    const char **metric_names = NULL;
+    double *metric_values = NULL;
+    size_t i;
+
+    if (num_metrics > 0)
+    {
+        metric_names = malloc(num_metrics * sizeof(const char *));
+        metric_values = malloc(num_metrics * sizeof(double));
+        if (metric_names == NULL || metric_values == NULL)
+        {
+            upo_throw_sys_error("Unable to allocate memory for the benchmark metrics");
+        }
+    }
+    for (i = 0; i < num_metrics; ++i)
+    {
+        metric_names[i] = (i < num_user_metrics) ? names[i] : upo_perf_event_name((upo_perf_event_t) (i - num_user_metrics));
+        metric_values[i] = NAN;
+    }
+    // The names may be the current ones, so they are freed only now
+    free(bench->metric_names);
+    free(bench->metric_values);
+    bench->metric_names = metric_names;
+    bench->metric_values = metric_values;
+    bench->num_metrics = num_metrics;
+    bench->num_user_metrics = num_user_metrics;
+}
+
+void upo_bench_set_perf_metrics(upo_bench_t bench)
+{
+    size_t e;
+
+    for (e = 0; e < UPO_PERF_TIMER_NUM_EVENTS; ++e)
+    {
+        double *counts = bench->perf_samples + e * bench->num_trials;
+
+        if (!upo_perf_timer_has_event(bench->perf_timer, (upo_perf_event_t) e))
+        {
+            continue;
+        }
+        qsort(counts, bench->num_trials, sizeof(double), upo_bench_sample_comparator);
+        bench->metric_values[bench->num_user_metrics + e] = upo_bench_percentile(counts, bench->num_trials, 50);
+    }
+}
+
+void upo_bench_write_metrics(upo_bench_t bench)
+{
+    FILE *fp = bench->fp;
+    size_t num_written = 0;
+    size_t i;
+
+    for (i = 0; i < bench->num_metrics; ++i)
+    {
+        const char *name = bench->metric_names[i];
+        double value = bench->metric_values[i];
+
+        switch (bench->format)
+        {
+            case upo_bench_text_format:
+                if (!isnan(value))
+                {
+                    fprintf(fp, "%s%s %.15g", (num_written > 0) ? ", " : " [", name, value);
+                    ++num_written;
+                }
+                break;
+            case upo_bench_csv_format:
+                fputc(',', fp);
+                if (!isnan(value))
+                {
+                    fprintf(fp, "%.15g", value);
+                }
+                break;
+            case upo_bench_json_format:
+                fputs(", ", fp);
+                upo_bench_write_json_string(fp, name);
+                if (isnan(value))
+                {
+                    fputs(": null", fp);
+                }
+                else
+                {
+                    fprintf(fp, ": %.15g", value);
+                }
+                break;
+        }
+    }
+    if (num_written > 0)
+    {
+        fputc(']', fp);
+    }
+}
+
+void upo_bench_clear_metrics(upo_bench_t bench)
+{
+    size_t i;
+
+    for (i = 0; i < bench->num_metrics; ++i)
+    {
+        bench->metric_values[i] = NAN;
+    }
+}
+
+int upo_bench_sample_comparator(const void *a, const void *b)
+{
+    double aa = *(const double *) a;
+    double bb = *(const double *) b;
+
+    return (aa > bb) - (aa < bb);
+}
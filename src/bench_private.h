@@ -0,0 +1,83 @@
+/* vim: set tabstop=4 expandtab shiftwidth=4 softtabstop=4: */
+
+/**
+ * \file src/bench_private.h
+ *
+ * \brief Private header for the benchmark harness.
+ *
+ * \author Simone Gattini, Federico Barbero, Anton Iliev
+ *
+ * \copyright 2015 University of Piemonte Orientale, Computer Science Institute
+ *
+ *  This file is part of UPOalglib.
+ *
+ *  UPOalglib is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  UPOalglib is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with UPOalglib.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef UPO_BENCH_PRIVATE_H
+#define UPO_BENCH_PRIVATE_H
+
+#include <stdio.h>
+#include <upo/bench.h>
+#include <upo/perf_timer.h>
+
+/** \brief Defines the type of a benchmark. */
+struct upo_bench_s
+{
+    size_t num_warmups; /**< The number of untimed runs. */
+    size_t num_trials; /**< The number of timed runs. */
+    double fence; /**< The multiplier of the interquartile range for outlier rejection. */
+    double *samples; /**< The durations of the timed runs of the current measurement. */
+    FILE *fp; /**< The output stream, or `NULL`. */
+    upo_bench_format_t format; /**< The output format. */
+    size_t num_reports; /**< The number of measurements written to the current output. */
+    const char **metric_names; /**< The names of the metrics written along with the durations. */
+    double *metric_values; /**< The values of the metrics of the next measurement (NaN if not set). */
+    size_t num_metrics; /**< The number of metrics, including the performance counters. */
+    size_t num_user_metrics; /**< The number of metrics set by the caller, which come first. */
+    upo_perf_timer_t perf_timer; /**< The timer counting the hardware events, or `NULL` if disabled. */
+    double *perf_samples; /**< The counts of each event in the timed runs of the current measurement. */
+};
+
+/** \brief Returns the current time, in seconds, on a monotonic clock. */
+static double upo_bench_now();
+
+/** \brief Completes the current output, if any. */
+static void upo_bench_end_output(upo_bench_t bench);
+
+/** \brief Writes the given string as a JSON string literal. */
+static void upo_bench_write_json_string(FILE *fp, const char *s);
+
+/** \brief Writes the given string as a CSV field. */
+static void upo_bench_write_csv_string(FILE *fp, const char *s);
+
+/**
+ * \brief Replaces the metrics with the given ones, followed by the
+ *  performance counters if they are enabled.
+ */
+static void upo_bench_layout_metrics(upo_bench_t bench, const char *const names[], size_t num_user_metrics);
+
+/** \brief Sets the metrics of the performance counters to their medians over the timed runs. */
+static void upo_bench_set_perf_metrics(upo_bench_t bench);
+
+/** \brief Writes the metrics of the next measurement, in the current output format. */
+static void upo_bench_write_metrics(upo_bench_t bench);
+
+/** \brief Resets the values of the metrics, after a measurement is written. */
+static void upo_bench_clear_metrics(upo_bench_t bench);
+
+/** \brief Comparison function for durations. */
+static int upo_bench_sample_comparator(const void *a, const void *b);
+
+#endif /* UPO_BENCH_PRIVATE_H */
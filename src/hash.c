@@ -0,0 +1,253 @@
+/* vim: set tabstop=4 expandtab shiftwidth=4 softtabstop=4: */
+
+/*
+ * Copyright 2015 University of Piemonte Orientale, Computer Science Institute
+ *
+ * This file is part of UPOalglib.
+ *
+ * UPOalglib is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * UPOalglib is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with UPOalglib.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/* Needed for getpid with -std=c11 */
+#define _POSIX_C_SOURCE 200809L
+
+#include <assert.h>
+#include "hash_private.h"
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+
+/** \brief The seed of the seeded hash functions. */
+static uint64_t upo_hash_seed = 0;
+
+
+uint64_t upo_hash_mix64(uint64_t x)
+{
+    x ^= x >> 30;
+    x *= UINT64_C(0xbf58476d1ce4e5b9);
+    x ^= x >> 27;
+    x *= UINT64_C(0x94d049bb133111eb);
+    x ^= x >> 31;
+
+    return x;
+}
+
+uint64_t upo_hash_bytes(const void *data, size_t n, uint64_t seed)
+{
+    const unsigned char *p = data;
+    uint64_t a = 0;
+    uint64_t b = 0;
+
+    assert(data != NULL || n == 0);
+
+    seed ^= upo_hash_mix(seed ^ UPO_HASH_SECRET0, UPO_HASH_SECRET1);
+    if (n <= 16)
+    {
+        if (n >= 4)
+        {
+            // Two possibly overlapping pairs of 4-byte words cover the whole key
+            size_t off = (n >> 3) << 2;
+
+            a = (upo_hash_read32(p) << 32) | upo_hash_read32(p + off);
+            b = (upo_hash_read32(p + n - 4) << 32) | upo_hash_read32(p + n - 4 - off);
+        }
+        else if (n > 0)
+        {
+            a = ((uint64_t) p[0] << 16) | ((uint64_t) p[n >> 1] << 8) | p[n - 1];
+        }
+    }
+    else
+    {
+        size_t i = n;
+
+        if (i > 48)
+        {
+            // Three independent lanes keep the multipliers busy
+            uint64_t seed1 = seed;
+            uint64_t seed2 = seed;
+
+            do
+            {
+                seed = upo_hash_mix(upo_hash_read64(p) ^ UPO_HASH_SECRET1, upo_hash_read64(p + 8) ^ seed);
+                seed1 = upo_hash_mix(upo_hash_read64(p + 16) ^ UPO_HASH_SECRET2, upo_hash_read64(p + 24) ^ seed1);
+                seed2 = upo_hash_mix(upo_hash_read64(p + 32) ^ UPO_HASH_SECRET3, upo_hash_read64(p + 40) ^ seed2);
+                p += 48;
+                i -= 48;
+            }
+            while (i > 48);
+            seed ^= seed1 ^ seed2;
+        }
+        while (i > 16)
+        {
+            seed = upo_hash_mix(upo_hash_read64(p) ^ UPO_HASH_SECRET1, upo_hash_read64(p + 8) ^ seed);
+            p += 16;
+            i -= 16;
+        }
+        // The last 16 bytes, which may overlap the ones already read
+        a = upo_hash_read64(p + i - 16);
+        b = upo_hash_read64(p + i - 8);
+    }
+    a ^= UPO_HASH_SECRET1;
+    b ^= seed;
+    upo_hash_mum(&a, &b);
+
+    return upo_hash_mix(a ^ UPO_HASH_SECRET0 ^ n, b ^ UPO_HASH_SECRET1);
+}
+
+uint64_t upo_hash_int(const void *x)
+{
+    assert(x != NULL);
+
+    return upo_hash_mix64((unsigned int) *((const int *) x));
+}
+
+uint64_t upo_hash_str(const void *s)
+{
+    const char *str = NULL;
+
+    assert(s != NULL);
+
+    str = *((const char **) s);
+
+    return upo_hash_bytes(str, strlen(str), 0);
+}
+
+uint64_t upo_hash_int_seeded(const void *x)
+{
+    assert(x != NULL);
+
+    return upo_hash_mix64((unsigned int) *((const int *) x) ^ upo_hash_mix64(upo_hash_seed ^ UPO_HASH_SECRET0));
+}
+
+uint64_t upo_hash_str_seeded(const void *s)
+{
+    const char *str = NULL;
+
+    assert(s != NULL);
+
+    str = *((const char **) s);
+
+    return upo_hash_bytes(str, strlen(str), upo_hash_seed);
+}
+
+void upo_hash_set_seed(uint64_t seed)
+{
+    upo_hash_seed = seed;
+}
+
+uint64_t upo_hash_get_seed()
+{
+    return upo_hash_seed;
+}
+
+uint64_t upo_hash_random_seed()
+{
+    uint64_t seed = 0;
+    FILE *fp = fopen("/dev/urandom", "rb");
+
+    if (fp != NULL)
+    {
+        size_t nread = fread(&seed, sizeof(seed), 1, fp);
+
+        fclose(fp);
+        if (nread == 1)
+        {
+            return seed;
+        }
+    }
+    // Time, process and the address of a local variable (randomized by ASLR)
+    seed = upo_hash_mix64((uint64_t) time(NULL)) ^ (uint64_t) clock();
+    seed = upo_hash_mix64(seed ^ (uint64_t) getpid());
+
+    return upo_hash_mix64(seed ^ (uint64_t) (uintptr_t) &seed);
+}
+
+double upo_hash_chi_square(const size_t *counts, size_t num_buckets)
+{
+    double total = 0;
+    double expected;
+    double chi2 = 0;
+    size_t i;
+
+    assert(counts != NULL);
+    assert(num_buckets > 1);
+
+    for (i = 0; i < num_buckets; ++i)
+    {
+        total += counts[i];
+    }
+    expected = total / num_buckets;
+    if (expected == 0)
+    {
+        return 0;
+    }
+    for (i = 0; i < num_buckets; ++i)
+    {
+        chi2 += (counts[i] - expected) * (counts[i] - expected) / expected;
+    }
+
+    return chi2;
+}
+
+void upo_hash_mum(uint64_t *a, uint64_t *b)
+{
+#ifdef __SIZEOF_INT128__
+    __extension__ unsigned __int128 r = (unsigned __int128) *a * *b;
+
+    *a = (uint64_t) r;
+    *b = (uint64_t) (r >> 64);
+#else
+    // Schoolbook multiplication on 32-bit halves
+    uint64_t ha = *a >> 32;
+    uint64_t la = (uint32_t) *a;
+    uint64_t hb = *b >> 32;
+    uint64_t lb = (uint32_t) *b;
+    uint64_t hh = ha * hb;
+    uint64_t hl = ha * lb;
+    uint64_t lh = la * hb;
+    uint64_t ll = la * lb;
+    uint64_t mid = (ll >> 32) + (uint32_t) hl + (uint32_t) lh;
+
+    *a = (mid << 32) | (uint32_t) ll;
+    *b = hh + (hl >> 32) + (lh >> 32) + (mid >> 32);
+#endif /* __SIZEOF_INT128__ */
+}
+
+uint64_t upo_hash_mix(uint64_t a, uint64_t b)
+{
+    upo_hash_mum(&a, &b);
+
+    return a ^ b;
+}
+
+uint64_t upo_hash_read64(const unsigned char *p)
+{
+    uint64_t v;
+
+    // memcpy allows unaligned reads, and compilers turn it into a single load
+    memcpy(&v, p, sizeof(v));
+
+    return v;
+}
+
+uint64_t upo_hash_read32(const unsigned char *p)
+{
+    uint32_t v;
+
+    memcpy(&v, p, sizeof(v));
+
+    return v;
+}
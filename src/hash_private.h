@@ -0,0 +1,52 @@
+/* vim: set tabstop=4 expandtab shiftwidth=4 softtabstop=4: */
+
+/**
+ * \file src/hash_private.h
+ *
+ * \brief Private header for the 64-bit hash functions.
+ *
+ * \author Simone Gattini, Federico Barbero, Anton Iliev
+ *
+ * \copyright 2015 University of Piemonte Orientale, Computer Science Institute
+ *
+ *  This file is part of UPOalglib.
+ *
+ *  UPOalglib is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  UPOalglib is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with UPOalglib.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef UPO_HASH_PRIVATE_H
+#define UPO_HASH_PRIVATE_H
+
+#include <stdint.h>
+#include <upo/hash.h>
+
+/* The secret constants of wyhash: odd, with half of the bits set in each byte */
+#define UPO_HASH_SECRET0 UINT64_C(0x2d358dccaa6c78a5)
+#define UPO_HASH_SECRET1 UINT64_C(0x8bb84b93962eacc9)
+#define UPO_HASH_SECRET2 UINT64_C(0x4b33a62ed433d4a3)
+#define UPO_HASH_SECRET3 UINT64_C(0x4d5a2da51de1aa47)
+
+/** \brief Multiplies \a a and \a b, storing the low half of the 128-bit product in \a a and the high half in \a b. */
+static void upo_hash_mum(uint64_t *a, uint64_t *b);
+
+/** \brief Returns the low half of the 128-bit product of \a a and \a b, XORed with the high half. */
+static uint64_t upo_hash_mix(uint64_t a, uint64_t b);
+
+/** \brief Reads eight bytes, in the byte order of the machine. */
+static uint64_t upo_hash_read64(const unsigned char *p);
+
+/** \brief Reads four bytes, in the byte order of the machine. */
+static uint64_t upo_hash_read32(const unsigned char *p);
+
+#endif /* UPO_HASH_PRIVATE_H */
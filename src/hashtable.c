@@ -24,18 +24,34 @@
 #include <math.h>
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
 #include <upo/error.h>
 #include <upo/utility.h>
 
 /*** EXERCISE #1 - BEGIN of HASH TABLE with SEPARATE CHAINING ***/
 
 upo_ht_sepchain_t upo_ht_sepchain_create(size_t m, upo_ht_hasher_t key_hash, upo_ht_comparator_t key_cmp)
+{
+    /* preconditions */
+    assert(key_hash != NULL);
+
+    return upo_ht_sepchain_new(m, key_hash, NULL, 0, key_cmp);
+}
+
+upo_ht_sepchain_t upo_ht_sepchain_create_hash64(size_t m, upo_ht_hasher64_t key_hash, upo_ht_comparator_t key_cmp, int pow2)
+{
+    /* preconditions */
+    assert(key_hash != NULL);
+
+    return upo_ht_sepchain_new(pow2 ? upo_ht_pow2_ceil(m) : m, NULL, key_hash, pow2, key_cmp);
+}
+
+upo_ht_sepchain_t upo_ht_sepchain_new(size_t m, upo_ht_hasher_t key_hash, upo_ht_hasher64_t key_hash64, int pow2, upo_ht_comparator_t key_cmp)
 {
     upo_ht_sepchain_t ht = NULL;
     size_t i = 0;
 
     /* preconditions */
-    assert(key_hash != NULL);
     assert(key_cmp != NULL);
 
     /* Allocate memory for the hash table type */
@@ -71,6 +87,8 @@ upo_ht_sepchain_t upo_ht_sepchain_create(size_t m, upo_ht_hasher_t key_hash, upo
     ht->capacity = m;
     ht->size = 0;
     ht->key_hash = key_hash;
+    ht->key_hash64 = key_hash64;
+    ht->pow2 = pow2;
     ht->key_cmp = key_cmp;
 
     return ht;
@@ -125,8 +143,7 @@ void *upo_ht_sepchain_put(upo_ht_sepchain_t ht, void *key, void *value)
 
     void *old_value = NULL;
 
-    upo_ht_hasher_t hasher = ht->key_hash;
-    size_t hash = hasher(key, ht->capacity);
+    size_t hash = upo_ht_index(key, ht->key_hash, ht->key_hash64, ht->pow2, ht->capacity);
     upo_ht_sepchain_list_node_t *node = ht->slots[hash].head;
     upo_ht_comparator_t cmp = ht->key_cmp;
 
@@ -155,8 +172,7 @@ void upo_ht_sepchain_insert(upo_ht_sepchain_t ht, void *key, void *value)
     if (ht == NULL)
         return;
 
-    upo_ht_hasher_t hasher = ht->key_hash;
-    size_t hash = hasher(key, ht->capacity);
+    size_t hash = upo_ht_index(key, ht->key_hash, ht->key_hash64, ht->pow2, ht->capacity);
     upo_ht_sepchain_list_node_t *node = ht->slots[hash].head;
     upo_ht_comparator_t cmp = ht->key_cmp;
 
@@ -178,8 +194,7 @@ void *upo_ht_sepchain_get(const upo_ht_sepchain_t ht, const void *key)
     if (ht == NULL)
         return NULL;
 
-    upo_ht_hasher_t hasher = ht->key_hash;
-    size_t hash = hasher(key, ht->capacity);
+    size_t hash = upo_ht_index(key, ht->key_hash, ht->key_hash64, ht->pow2, ht->capacity);
     upo_ht_sepchain_list_node_t *node = ht->slots[hash].head;
     upo_ht_comparator_t cmp = ht->key_cmp;
 
@@ -196,8 +211,7 @@ int upo_ht_sepchain_contains(const upo_ht_sepchain_t ht, const void *key)
     if (ht == NULL)
         return 0;
 
-    upo_ht_hasher_t hasher = ht->key_hash;
-    size_t hash = hasher(key, ht->capacity);
+    size_t hash = upo_ht_index(key, ht->key_hash, ht->key_hash64, ht->pow2, ht->capacity);
     upo_ht_sepchain_list_node_t *node = ht->slots[hash].head;
     upo_ht_comparator_t cmp = ht->key_cmp;
 
@@ -214,8 +228,7 @@ void upo_ht_sepchain_delete(upo_ht_sepchain_t ht, const void *key, int destroy_d
     if (ht == NULL)
         return;
 
-    upo_ht_hasher_t hasher = ht->key_hash;
-    size_t hash = hasher(key, ht->capacity);
+    size_t hash = upo_ht_index(key, ht->key_hash, ht->key_hash64, ht->pow2, ht->capacity);
     upo_ht_sepchain_list_node_t *node = ht->slots[hash].head;
     upo_ht_sepchain_list_node_t *ptr = NULL;
     upo_ht_comparator_t cmp = ht->key_cmp;
@@ -283,17 +296,37 @@ upo_ht_hasher_t upo_ht_sepchain_get_hasher(const upo_ht_sepchain_t ht)
     return ht->key_hash;
 }
 
+upo_ht_hasher64_t upo_ht_sepchain_get_hasher64(const upo_ht_sepchain_t ht)
+{
+    return ht->key_hash64;
+}
+
 /*** EXERCISE #1 - END of HASH TABLE with SEPARATE CHAINING ***/
 
 /*** EXERCISE #2 - BEGIN of HASH TABLE with LINEAR PROBING ***/
 
 upo_ht_linprob_t upo_ht_linprob_create(size_t m, upo_ht_hasher_t key_hash, upo_ht_comparator_t key_cmp)
+{
+    /* preconditions */
+    assert(key_hash != NULL);
+
+    return upo_ht_linprob_new(m, key_hash, NULL, 0, key_cmp);
+}
+
+upo_ht_linprob_t upo_ht_linprob_create_hash64(size_t m, upo_ht_hasher64_t key_hash, upo_ht_comparator_t key_cmp, int pow2)
+{
+    /* preconditions */
+    assert(key_hash != NULL);
+
+    return upo_ht_linprob_new(pow2 ? upo_ht_pow2_ceil(m) : m, NULL, key_hash, pow2, key_cmp);
+}
+
+upo_ht_linprob_t upo_ht_linprob_new(size_t m, upo_ht_hasher_t key_hash, upo_ht_hasher64_t key_hash64, int pow2, upo_ht_comparator_t key_cmp)
 {
     upo_ht_linprob_t ht = NULL;
     size_t i = 0;
 
     /* preconditions */
-    assert(key_hash != NULL);
     assert(key_cmp != NULL);
 
     /* Allocate memory for the hash table type */
@@ -330,7 +363,10 @@ upo_ht_linprob_t upo_ht_linprob_create(size_t m, upo_ht_hasher_t key_hash, upo_h
     /* Initialize the other fields */
     ht->capacity = m;
     ht->size = 0;
+    ht->num_tombstones = 0;
     ht->key_hash = key_hash;
+    ht->key_hash64 = key_hash64;
+    ht->pow2 = pow2;
     ht->key_cmp = key_cmp;
 
     return ht;
@@ -352,22 +388,20 @@ void upo_ht_linprob_clear(upo_ht_linprob_t ht, int destroy_data)
     {
         size_t i = 0;
 
-        /* For each slot, clear the associated list of collisions */
+        /* For each slot, clear the key-value pair or the tombstone */
         for (i = 0; i < ht->capacity; ++i)
         {
-            if (ht->slots[i].key != NULL)
+            if (ht->slots[i].key != NULL && destroy_data)
             {
-                if (destroy_data)
-                {
-                    free(ht->slots[i].key);
-                    free(ht->slots[i].value);
-                }
-                ht->slots[i].key = NULL;
-                ht->slots[i].value = NULL;
-                ht->slots[i].tombstone = 0;
+                free(ht->slots[i].key);
+                free(ht->slots[i].value);
             }
+            ht->slots[i].key = NULL;
+            ht->slots[i].value = NULL;
+            ht->slots[i].tombstone = 0;
         }
         ht->size = 0;
+        ht->num_tombstones = 0;
     }
 }
 
@@ -377,12 +411,10 @@ void *upo_ht_linprob_put(upo_ht_linprob_t ht, void *key, void *value)
         return NULL;
     void *old_value = NULL;
 
-    if (upo_ht_linprob_load_factor(ht) >= 0.5)
-        upo_ht_linprob_resize(ht, ht->capacity * 2);
+    upo_ht_linprob_reserve(ht);
 
-    upo_ht_hasher_t hasher = ht->key_hash;
     upo_ht_comparator_t cmp = ht->key_cmp;
-    size_t hash = hasher(key, ht->capacity);
+    size_t hash = upo_ht_index(key, ht->key_hash, ht->key_hash64, ht->pow2, ht->capacity);
     size_t hash_tomb = 0;
     int found_tomb = 0;
     while ((ht->slots[hash].key != NULL && cmp(key, ht->slots[hash].key) != 0) || ht->slots[hash].tombstone)
@@ -392,12 +424,15 @@ void *upo_ht_linprob_put(upo_ht_linprob_t ht, void *key, void *value)
             found_tomb = 1;
             hash_tomb = hash;
         }
-        hash = (hash + 1) % ht->capacity;
+        hash = upo_ht_linprob_next(ht, hash);
     }
     if (ht->slots[hash].key == NULL)
     {
         if (found_tomb)
+        {
             hash = hash_tomb;
+            ht->num_tombstones -= 1;
+        }
         ht->slots[hash].key = key;
         ht->slots[hash].value = value;
         ht->slots[hash].tombstone = 0;
@@ -415,12 +450,10 @@ void upo_ht_linprob_insert(upo_ht_linprob_t ht, void *key, void *value)
 {
     if (ht == NULL)
         return;
-    if (upo_ht_linprob_load_factor(ht) >= 0.5)
-        upo_ht_linprob_resize(ht, ht->capacity * 2);
+    upo_ht_linprob_reserve(ht);
 
-    upo_ht_hasher_t hasher = ht->key_hash;
     upo_ht_comparator_t cmp = ht->key_cmp;
-    size_t hash = hasher(key, ht->capacity);
+    size_t hash = upo_ht_index(key, ht->key_hash, ht->key_hash64, ht->pow2, ht->capacity);
     size_t hash_tomb = 0;
     int found_tomb = 0;
     while ((ht->slots[hash].key != NULL && cmp(key, ht->slots[hash].key) != 0) || ht->slots[hash].tombstone)
@@ -430,12 +463,15 @@ void upo_ht_linprob_insert(upo_ht_linprob_t ht, void *key, void *value)
             found_tomb = 1;
             hash_tomb = hash;
         }
-        hash = (hash + 1) % ht->capacity;
+        hash = upo_ht_linprob_next(ht, hash);
     }
     if (ht->slots[hash].key == NULL)
     {
         if (found_tomb)
+        {
             hash = hash_tomb;
+            ht->num_tombstones -= 1;
+        }
         ht->slots[hash].key = key;
         ht->slots[hash].value = value;
         ht->slots[hash].tombstone = 0;
@@ -447,11 +483,10 @@ void *upo_ht_linprob_get(const upo_ht_linprob_t ht, const void *key)
 {
     if (ht == NULL)
         return NULL;
-    upo_ht_hasher_t hasher = ht->key_hash;
     upo_ht_comparator_t cmp = ht->key_cmp;
-    size_t hash = hasher(key, ht->capacity);
+    size_t hash = upo_ht_index(key, ht->key_hash, ht->key_hash64, ht->pow2, ht->capacity);
     while ((ht->slots[hash].key != NULL && cmp(key, ht->slots[hash].key) != 0) || ht->slots[hash].tombstone)
-        hash = (hash + 1) % ht->capacity;
+        hash = upo_ht_linprob_next(ht, hash);
     if (ht->slots[hash].key != NULL)
         return ht->slots[hash].value;
     return NULL;
@@ -461,11 +496,10 @@ int upo_ht_linprob_contains(const upo_ht_linprob_t ht, const void *key)
 {
     if (ht == NULL)
         return 0;
-    upo_ht_hasher_t hasher = ht->key_hash;
     upo_ht_comparator_t cmp = ht->key_cmp;
-    size_t hash = hasher(key, ht->capacity);
+    size_t hash = upo_ht_index(key, ht->key_hash, ht->key_hash64, ht->pow2, ht->capacity);
     while ((ht->slots[hash].key != NULL && cmp(key, ht->slots[hash].key) != 0) || ht->slots[hash].tombstone)
-        hash = (hash + 1) % ht->capacity;
+        hash = upo_ht_linprob_next(ht, hash);
     if (ht->slots[hash].key != NULL)
         return 1;
     return 0;
@@ -475,11 +509,10 @@ void upo_ht_linprob_delete(upo_ht_linprob_t ht, const void *key, int destroy_dat
 {
     if (ht == NULL)
         return;
-    upo_ht_hasher_t hasher = ht->key_hash;
     upo_ht_comparator_t cmp = ht->key_cmp;
-    size_t hash = hasher(key, ht->capacity);
+    size_t hash = upo_ht_index(key, ht->key_hash, ht->key_hash64, ht->pow2, ht->capacity);
     while ((ht->slots[hash].key != NULL && cmp(key, ht->slots[hash].key) != 0) || ht->slots[hash].tombstone)
-        hash = (hash + 1) % ht->capacity;
+        hash = upo_ht_linprob_next(ht, hash);
     if (ht->slots[hash].key != NULL)
     {
         if (destroy_data)
@@ -490,23 +523,16 @@ void upo_ht_linprob_delete(upo_ht_linprob_t ht, const void *key, int destroy_dat
         ht->slots[hash].key = NULL;
         ht->slots[hash].value = NULL;
         ht->slots[hash].tombstone = 1;
-        if (upo_ht_linprob_load_factor(ht) <= 0.125)
-            upo_ht_linprob_resize(ht, ht->capacity / 2);
         ht->size -= 1;
+        ht->num_tombstones += 1;
+        if (ht->capacity > 1 && upo_ht_linprob_load_factor(ht) <= 0.125)
+            upo_ht_linprob_resize(ht, ht->capacity / 2);
     }
 }
 
 size_t upo_ht_linprob_size(const upo_ht_linprob_t ht)
 {
-    if (ht == NULL)
-        return 0;
-    size_t size = 0;
-    for (size_t i = 0; i < ht->capacity; i++)
-    {
-        if (ht->slots[i].key != NULL)
-            size++;
-    }
-    return size;
+    return (ht != NULL) ? ht->size : 0;
 }
 
 int upo_ht_linprob_is_empty(const upo_ht_linprob_t ht)
@@ -524,6 +550,40 @@ double upo_ht_linprob_load_factor(const upo_ht_linprob_t ht)
     return upo_ht_linprob_size(ht) / (double)upo_ht_linprob_capacity(ht);
 }
 
+upo_ht_comparator_t upo_ht_linprob_get_comparator(const upo_ht_linprob_t ht)
+{
+    return ht->key_cmp;
+}
+
+upo_ht_hasher_t upo_ht_linprob_get_hasher(const upo_ht_linprob_t ht)
+{
+    return ht->key_hash;
+}
+
+upo_ht_hasher64_t upo_ht_linprob_get_hasher64(const upo_ht_linprob_t ht)
+{
+    return ht->key_hash64;
+}
+
+size_t upo_ht_linprob_next(const upo_ht_linprob_t ht, size_t i)
+{
+    if (ht->pow2)
+        return (i + 1) & (ht->capacity - 1);
+    return (i + 1 < ht->capacity) ? i + 1 : 0;
+}
+
+void upo_ht_linprob_reserve(upo_ht_linprob_t ht)
+{
+    if (ht->capacity == 0)
+    {
+        upo_ht_linprob_resize(ht, UPO_HT_LINPROB_DEFAULT_CAPACITY);
+    }
+    else if (2 * (ht->size + ht->num_tombstones) >= ht->capacity)
+    {
+        upo_ht_linprob_resize(ht, (2 * ht->size >= ht->capacity) ? ht->capacity * 2 : ht->capacity);
+    }
+}
+
 void upo_ht_linprob_resize(upo_ht_linprob_t ht, size_t n)
 {
     /* preconditions */
@@ -539,7 +599,7 @@ void upo_ht_linprob_resize(upo_ht_linprob_t ht, size_t n)
         upo_ht_linprob_t new_ht = NULL;
 
         /* Create a new temporary hash table */
-        new_ht = upo_ht_linprob_create(n, ht->key_hash, ht->key_cmp);
+        new_ht = upo_ht_linprob_new(n, ht->key_hash, ht->key_hash64, ht->pow2, ht->key_cmp);
         if (new_ht == NULL)
         {
             perror("Unable to allocate memory for slots of the Hash Table with Separate Chaining");
@@ -567,6 +627,7 @@ void upo_ht_linprob_resize(upo_ht_linprob_t ht, size_t n)
         upo_swap(&ht->slots, &new_ht->slots, sizeof ht->slots);
         upo_swap(&ht->capacity, &new_ht->capacity, sizeof ht->capacity);
         upo_swap(&ht->size, &new_ht->size, sizeof ht->size);
+        upo_swap(&ht->num_tombstones, &new_ht->num_tombstones, sizeof ht->num_tombstones);
 
         /* Destroy temporary hash table */
         upo_ht_linprob_destroy(new_ht, 0);
@@ -626,9 +687,8 @@ void upo_ht_sepchain_traverse(const upo_ht_sepchain_t ht, upo_ht_visitor_t visit
 
 int upo_ht_sepchain_deletex(const upo_ht_sepchain_t ht, const void *key, int destroy_data)
 {
-   upo_ht_hasher_t hasher = ht->key_hash;
    upo_ht_comparator_t cmp = ht->key_cmp;
-   size_t hash = hasher(key, ht->capacity);
+   size_t hash = upo_ht_index(key, ht->key_hash, ht->key_hash64, ht->pow2, ht->capacity);
    upo_ht_sepchain_list_node_t *previous = NULL;
    upo_ht_sepchain_list_node_t *node = ht->slots[hash].head;
 
@@ -780,15 +840,103 @@ size_t upo_ht_hash_str_stlport(const void *x, size_t m)
     return upo_ht_hash_str(x, 0U, 33U, m);
 }
 
+uint64_t upo_ht_hash_finalize(uint64_t h)
+{
+    /* The 64-bit finalizer of MurmurHash3 */
+    h ^= h >> 33;
+    h *= UINT64_C(0xff51afd7ed558ccd);
+    h ^= h >> 33;
+    h *= UINT64_C(0xc4ceb9fe1a85ec53);
+    h ^= h >> 33;
+
+    return h;
+}
+
+uint64_t upo_ht_hash64_int(const void *x)
+{
+    /* preconditions */
+    assert(x != NULL);
+
+    return (uint64_t) (unsigned int) *((const int *)x);
+}
+
+uint64_t upo_ht_hash64_str(const void *x, uint64_t h0, uint64_t a)
+{
+    const char *s = NULL;
+    uint64_t h = h0;
+
+    /* preconditions */
+    assert(x != NULL);
+
+    s = *((const char **)x);
+    for (; *s; ++s)
+    {
+        h = a * h + (unsigned char) *s;
+    }
+
+    return h;
+}
+
+uint64_t upo_ht_hash64_str_djb2(const void *x)
+{
+    return upo_ht_hash64_str(x, 5381U, 33U);
+}
+
+uint64_t upo_ht_hash64_str_java(const void *x)
+{
+    return upo_ht_hash64_str(x, 0U, 31U);
+}
+
+uint64_t upo_ht_hash64_str_sgistl(const void *x)
+{
+    return upo_ht_hash64_str(x, 0U, 5U);
+}
+
+size_t upo_ht_index(const void *key, upo_ht_hasher_t key_hash, upo_ht_hasher64_t key_hash64, int pow2, size_t capacity)
+{
+    uint64_t h;
+
+    /* Hash functions of type upo_ht_hasher_t reduce the hash value by themselves */
+    if (key_hash64 == NULL)
+        return key_hash(key, capacity);
+
+    h = upo_ht_hash_finalize(key_hash64(key));
+    if (pow2)
+        return (size_t) (h & (capacity - 1));
+    return (size_t) (h % capacity);
+}
+
+size_t upo_ht_pow2_ceil(size_t m)
+{
+    size_t p = 1;
+
+    while (p < m)
+        p <<= 1;
+    return p;
+}
+
 /*** END of HASH FUNCTIONS ***/
 
 /*** BEGIN of HASH TABLE with SEPARATE CHAINING with ORDERED LIST ***/
 
 upo_ht_sepchain_olist_t upo_ht_sepchain_olist_create(size_t m, upo_ht_hasher_t key_hash, upo_ht_comparator_t key_cmp)
 {
-    upo_ht_sepchain_olist_t ht = NULL;
+    assert(key_hash != NULL);
+
+    return upo_ht_sepchain_olist_new(m, key_hash, NULL, 0, key_cmp);
+}
 
+upo_ht_sepchain_olist_t upo_ht_sepchain_olist_create_hash64(size_t m, upo_ht_hasher64_t key_hash, upo_ht_comparator_t key_cmp, int pow2)
+{
     assert(key_hash != NULL);
+
+    return upo_ht_sepchain_olist_new(pow2 ? upo_ht_pow2_ceil(m) : m, NULL, key_hash, pow2, key_cmp);
+}
+
+upo_ht_sepchain_olist_t upo_ht_sepchain_olist_new(size_t m, upo_ht_hasher_t key_hash, upo_ht_hasher64_t key_hash64, int pow2, upo_ht_comparator_t key_cmp)
+{
+    upo_ht_sepchain_olist_t ht = NULL;
+
     assert(key_cmp != NULL);
 
     ht = malloc(sizeof(struct upo_ht_sepchain_olist_s));
@@ -820,6 +968,8 @@ upo_ht_sepchain_olist_t upo_ht_sepchain_olist_create(size_t m, upo_ht_hasher_t k
     ht->capacity = m;
     ht->size = 0;
     ht->key_hash = key_hash;
+    ht->key_hash64 = key_hash64;
+    ht->pow2 = pow2;
     ht->key_cmp = key_cmp;
 
     return ht;
@@ -866,8 +1016,7 @@ void *upo_ht_sepchain_olist_get(const upo_ht_sepchain_olist_t ht, const void *ke
         return NULL;
 
     upo_ht_comparator_t cmp = ht->key_cmp;
-    upo_ht_hasher_t hasher = ht->key_hash;
-    size_t hash = hasher(key, ht->capacity);
+    size_t hash = upo_ht_index(key, ht->key_hash, ht->key_hash64, ht->pow2, ht->capacity);
     upo_ht_sepchain_olist_node_t *node = ht->slots[hash].head;
 
     while (node != NULL && cmp(key, node->key) != 0)
@@ -884,8 +1033,7 @@ int upo_ht_sepchain_olist_contains(const upo_ht_sepchain_olist_t ht, const void
         return 0;
 
     upo_ht_comparator_t cmp = ht->key_cmp;
-    upo_ht_hasher_t hasher = ht->key_hash;
-    size_t hash = hasher(key, ht->capacity);
+    size_t hash = upo_ht_index(key, ht->key_hash, ht->key_hash64, ht->pow2, ht->capacity);
     upo_ht_sepchain_olist_node_t *node = ht->slots[hash].head;
 
     while (node != NULL && cmp(key, node->key) != 0)
@@ -903,8 +1051,7 @@ void *upo_ht_sepchain_olist_put(upo_ht_sepchain_olist_t ht, void *key, void *val
 
     void *old_value = NULL;
 
-    upo_ht_hasher_t hasher = ht->key_hash;
-    size_t hash = hasher(key, ht->capacity);
+    size_t hash = upo_ht_index(key, ht->key_hash, ht->key_hash64, ht->pow2, ht->capacity);
     upo_ht_sepchain_olist_node_t *node = ht->slots[hash].head;
     upo_ht_sepchain_olist_node_t *previous = NULL;
     upo_ht_comparator_t cmp = ht->key_cmp;
@@ -949,8 +1096,7 @@ void upo_ht_sepchain_olist_insert(upo_ht_sepchain_olist_t ht, void *key, void *v
     if (ht == NULL)
         return;
 
-    upo_ht_hasher_t hasher = ht->key_hash;
-    size_t hash = hasher(key, ht->capacity);
+    size_t hash = upo_ht_index(key, ht->key_hash, ht->key_hash64, ht->pow2, ht->capacity);
     upo_ht_sepchain_olist_node_t *node = ht->slots[hash].head;
     upo_ht_sepchain_olist_node_t *previous = NULL;
     upo_ht_comparator_t cmp = ht->key_cmp;
@@ -988,8 +1134,7 @@ void upo_ht_sepchain_olist_delete(upo_ht_sepchain_olist_t ht, const void *key, i
     if (ht == NULL || ht->slots == NULL)
         return;
 
-    upo_ht_hasher_t hasher = ht->key_hash;
-    size_t hash = hasher(key, ht->capacity);
+    size_t hash = upo_ht_index(key, ht->key_hash, ht->key_hash64, ht->pow2, ht->capacity);
     upo_ht_sepchain_olist_node_t *node = ht->slots[hash].head;
     upo_ht_sepchain_olist_node_t *previous = NULL;
     upo_ht_comparator_t cmp = ht->key_cmp;
@@ -1048,4 +1193,791 @@ int upo_ht_sepchain_olist_is_empty(const upo_ht_sepchain_olist_t ht)
     return upo_ht_sepchain_olist_size(ht) == 0 ? 1 : 0;
 }
 
-/*** END of HASH TABLE with SEPARATE CHAINING with ORDERED LIST ***/
\ No newline at end of file
+/*** END of HASH TABLE with SEPARATE CHAINING with ORDERED LIST ***/
+/*** BEGIN of HASH TABLE with ROBIN HOOD HASHING ***/
+
+upo_ht_robinhood_t upo_ht_robinhood_create(size_t m, upo_ht_hasher_t key_hash, upo_ht_comparator_t key_cmp)
+{
+    /* preconditions */
+    assert(key_hash != NULL);
+
+    return upo_ht_robinhood_new(m, key_hash, NULL, 0, key_cmp);
+}
+
+upo_ht_robinhood_t upo_ht_robinhood_create_hash64(size_t m, upo_ht_hasher64_t key_hash, upo_ht_comparator_t key_cmp, int pow2)
+{
+    /* preconditions */
+    assert(key_hash != NULL);
+
+    return upo_ht_robinhood_new(pow2 ? upo_ht_pow2_ceil(m) : m, NULL, key_hash, pow2, key_cmp);
+}
+
+upo_ht_robinhood_t upo_ht_robinhood_new(size_t m, upo_ht_hasher_t key_hash, upo_ht_hasher64_t key_hash64, int pow2, upo_ht_comparator_t key_cmp)
+{
+    upo_ht_robinhood_t ht = NULL;
+    size_t i = 0;
+
+    /* preconditions */
+    assert(key_cmp != NULL);
+
+    /* Allocate memory for the hash table type */
+    ht = malloc(sizeof(struct upo_ht_robinhood_s));
+    if (ht == NULL)
+    {
+        perror("Unable to allocate memory for Hash Table with Robin Hood Hashing");
+        abort();
+    }
+
+    /* Allocate memory for the array of slots */
+    if (m > 0)
+    {
+        ht->slots = malloc(m * sizeof(upo_ht_robinhood_slot_t));
+        if (ht->slots == NULL)
+        {
+            perror("Unable to allocate memory for slots of the Hash Table with Robin Hood Hashing");
+            abort();
+        }
+
+        /* Initialize the slots */
+        for (i = 0; i < m; ++i)
+        {
+            ht->slots[i].key = NULL;
+            ht->slots[i].value = NULL;
+            ht->slots[i].dist = 0;
+        }
+    }
+    else
+    {
+        ht->slots = NULL;
+    }
+
+    /* Initialize the other fields */
+    ht->capacity = m;
+    ht->size = 0;
+    ht->key_hash = key_hash;
+    ht->key_hash64 = key_hash64;
+    ht->pow2 = pow2;
+    ht->key_cmp = key_cmp;
+
+    return ht;
+}
+
+void upo_ht_robinhood_destroy(upo_ht_robinhood_t ht, int destroy_data)
+{
+    if (ht != NULL)
+    {
+        upo_ht_robinhood_clear(ht, destroy_data);
+        free(ht->slots);
+        free(ht);
+    }
+}
+
+void upo_ht_robinhood_clear(upo_ht_robinhood_t ht, int destroy_data)
+{
+    if (ht != NULL && ht->slots != NULL)
+    {
+        size_t i = 0;
+
+        for (i = 0; i < ht->capacity; ++i)
+        {
+            if (ht->slots[i].dist != 0 && destroy_data)
+            {
+                free(ht->slots[i].key);
+                free(ht->slots[i].value);
+            }
+            ht->slots[i].key = NULL;
+            ht->slots[i].value = NULL;
+            ht->slots[i].dist = 0;
+        }
+        ht->size = 0;
+    }
+}
+
+void *upo_ht_robinhood_put(upo_ht_robinhood_t ht, void *key, void *value)
+{
+    void *old_value = NULL;
+    size_t i = 0;
+    size_t dist = 0;
+
+    if (ht == NULL)
+        return NULL;
+
+    upo_ht_robinhood_reserve(ht);
+
+    if (upo_ht_robinhood_probe(ht, key, &i, &dist))
+    {
+        old_value = ht->slots[i].value;
+        ht->slots[i].value = value;
+    }
+    else
+    {
+        upo_ht_robinhood_shift_in(ht, i, dist, key, value);
+    }
+    return old_value;
+}
+
+void upo_ht_robinhood_insert(upo_ht_robinhood_t ht, void *key, void *value)
+{
+    size_t i = 0;
+    size_t dist = 0;
+
+    if (ht == NULL)
+        return;
+
+    upo_ht_robinhood_reserve(ht);
+
+    if (!upo_ht_robinhood_probe(ht, key, &i, &dist))
+        upo_ht_robinhood_shift_in(ht, i, dist, key, value);
+}
+
+void *upo_ht_robinhood_get(const upo_ht_robinhood_t ht, const void *key)
+{
+    size_t i = 0;
+    size_t dist = 0;
+
+    if (ht == NULL || !upo_ht_robinhood_probe(ht, key, &i, &dist))
+        return NULL;
+    return ht->slots[i].value;
+}
+
+int upo_ht_robinhood_contains(const upo_ht_robinhood_t ht, const void *key)
+{
+    size_t i = 0;
+    size_t dist = 0;
+
+    if (ht == NULL)
+        return 0;
+    return upo_ht_robinhood_probe(ht, key, &i, &dist);
+}
+
+void upo_ht_robinhood_delete(upo_ht_robinhood_t ht, const void *key, int destroy_data)
+{
+    size_t i = 0;
+    size_t dist = 0;
+
+    if (ht == NULL || !upo_ht_robinhood_probe(ht, key, &i, &dist))
+        return;
+
+    if (destroy_data)
+    {
+        free(ht->slots[i].key);
+        free(ht->slots[i].value);
+    }
+    upo_ht_robinhood_shift_out(ht, i);
+
+    if (ht->capacity > 1 && upo_ht_robinhood_load_factor(ht) <= 0.125)
+        upo_ht_robinhood_resize(ht, ht->capacity / 2);
+}
+
+size_t upo_ht_robinhood_size(const upo_ht_robinhood_t ht)
+{
+    return (ht != NULL) ? ht->size : 0;
+}
+
+int upo_ht_robinhood_is_empty(const upo_ht_robinhood_t ht)
+{
+    return upo_ht_robinhood_size(ht) == 0 ? 1 : 0;
+}
+
+size_t upo_ht_robinhood_capacity(const upo_ht_robinhood_t ht)
+{
+    return (ht != NULL) ? ht->capacity : 0;
+}
+
+double upo_ht_robinhood_load_factor(const upo_ht_robinhood_t ht)
+{
+    return upo_ht_robinhood_size(ht) / (double)upo_ht_robinhood_capacity(ht);
+}
+
+upo_ht_key_list_t upo_ht_robinhood_keys(const upo_ht_robinhood_t ht)
+{
+    upo_ht_key_list_t list = NULL;
+    size_t i = 0;
+
+    if (ht == NULL)
+        return NULL;
+    for (i = 0; i < ht->capacity; ++i)
+    {
+        if (ht->slots[i].dist != 0)
+            upo_ht_build_key_list(ht->slots[i].key, &list);
+    }
+    return list;
+}
+
+void upo_ht_robinhood_traverse(const upo_ht_robinhood_t ht, upo_ht_visitor_t visit, void *visit_context)
+{
+    size_t i = 0;
+
+    if (ht == NULL)
+        return;
+    for (i = 0; i < ht->capacity; ++i)
+    {
+        if (ht->slots[i].dist != 0)
+            visit(ht->slots[i].key, ht->slots[i].value, visit_context);
+    }
+}
+
+void upo_ht_robinhood_merge(upo_ht_robinhood_t dest_ht, const upo_ht_robinhood_t src_ht)
+{
+    size_t i = 0;
+
+    if (dest_ht == NULL || src_ht == NULL)
+        return;
+
+    for (i = 0; i < src_ht->capacity; ++i)
+    {
+        if (src_ht->slots[i].dist != 0)
+            upo_ht_robinhood_insert(dest_ht, src_ht->slots[i].key, src_ht->slots[i].value);
+    }
+}
+
+upo_ht_comparator_t upo_ht_robinhood_get_comparator(const upo_ht_robinhood_t ht)
+{
+    return ht->key_cmp;
+}
+
+upo_ht_hasher_t upo_ht_robinhood_get_hasher(const upo_ht_robinhood_t ht)
+{
+    return ht->key_hash;
+}
+
+upo_ht_hasher64_t upo_ht_robinhood_get_hasher64(const upo_ht_robinhood_t ht)
+{
+    return ht->key_hash64;
+}
+
+size_t upo_ht_robinhood_next(const upo_ht_robinhood_t ht, size_t i)
+{
+    if (ht->pow2)
+        return (i + 1) & (ht->capacity - 1);
+    return (i + 1 < ht->capacity) ? i + 1 : 0;
+}
+
+int upo_ht_robinhood_probe(const upo_ht_robinhood_t ht, const void *key, size_t *pi, size_t *pdist)
+{
+    size_t i = 0;
+    size_t dist = 1;
+
+    /* Only tables that were never written to may lack slots */
+    if (ht->capacity == 0)
+        return 0;
+
+    i = upo_ht_index(key, ht->key_hash, ht->key_hash64, ht->pow2, ht->capacity);
+    while (ht->slots[i].dist >= dist)
+    {
+        /* Only keys with the same home slot are at the same distance */
+        if (ht->slots[i].dist == dist && ht->key_cmp(key, ht->slots[i].key) == 0)
+        {
+            *pi = i;
+            *pdist = dist;
+            return 1;
+        }
+        i = upo_ht_robinhood_next(ht, i);
+        ++dist;
+    }
+    *pi = i;
+    *pdist = dist;
+    return 0;
+}
+
+void upo_ht_robinhood_shift_in(upo_ht_robinhood_t ht, size_t i, size_t dist, void *key, void *value)
+{
+    /* Carry the new key forward, swapping it with every key that is closer to
+     * its home slot, until an empty slot is found */
+    while (ht->slots[i].dist != 0)
+    {
+        if (ht->slots[i].dist < dist)
+        {
+            void *tmp_key = ht->slots[i].key;
+            void *tmp_value = ht->slots[i].value;
+            size_t tmp_dist = ht->slots[i].dist;
+
+            ht->slots[i].key = key;
+            ht->slots[i].value = value;
+            ht->slots[i].dist = dist;
+            key = tmp_key;
+            value = tmp_value;
+            dist = tmp_dist;
+        }
+        i = upo_ht_robinhood_next(ht, i);
+        ++dist;
+    }
+    ht->slots[i].key = key;
+    ht->slots[i].value = value;
+    ht->slots[i].dist = dist;
+    ht->size += 1;
+}
+
+void upo_ht_robinhood_shift_out(upo_ht_robinhood_t ht, size_t i)
+{
+    size_t j = upo_ht_robinhood_next(ht, i);
+
+    /* Move back the rest of the run, up to an empty slot or a key that is
+     * already in its home slot */
+    while (ht->slots[j].dist > 1)
+    {
+        ht->slots[i].key = ht->slots[j].key;
+        ht->slots[i].value = ht->slots[j].value;
+        ht->slots[i].dist = ht->slots[j].dist - 1;
+        i = j;
+        j = upo_ht_robinhood_next(ht, j);
+    }
+    ht->slots[i].key = NULL;
+    ht->slots[i].value = NULL;
+    ht->slots[i].dist = 0;
+    ht->size -= 1;
+}
+
+void upo_ht_robinhood_reserve(upo_ht_robinhood_t ht)
+{
+    if (ht->capacity == 0)
+    {
+        upo_ht_robinhood_resize(ht, UPO_HT_ROBINHOOD_DEFAULT_CAPACITY);
+    }
+    else if (8 * (ht->size + 1) > 7 * ht->capacity)
+    {
+        upo_ht_robinhood_resize(ht, ht->capacity * 2);
+    }
+}
+
+void upo_ht_robinhood_resize(upo_ht_robinhood_t ht, size_t n)
+{
+    /* preconditions */
+    assert(n > 0);
+
+    if (ht != NULL)
+    {
+        size_t i = 0;
+        upo_ht_robinhood_t new_ht = NULL;
+
+        new_ht = upo_ht_robinhood_new(n, ht->key_hash, ht->key_hash64, ht->pow2, ht->key_cmp);
+
+        /* Rehash the keys according to the new capacity.
+         * Keys are distinct, so each one is shifted in from its home slot
+         * without looking for duplicates. */
+        for (i = 0; i < ht->capacity; ++i)
+        {
+            if (ht->slots[i].dist != 0)
+            {
+                size_t home = upo_ht_index(ht->slots[i].key, ht->key_hash, ht->key_hash64, ht->pow2, n);
+
+                upo_ht_robinhood_shift_in(new_ht, home, 1, ht->slots[i].key, ht->slots[i].value);
+            }
+        }
+
+        /* Swap the slots with the temporary hash table, as for linear probing */
+        upo_swap(&ht->slots, &new_ht->slots, sizeof ht->slots);
+        upo_swap(&ht->capacity, &new_ht->capacity, sizeof ht->capacity);
+        upo_swap(&ht->size, &new_ht->size, sizeof ht->size);
+
+        upo_ht_robinhood_destroy(new_ht, 0);
+    }
+}
+
+/*** END of HASH TABLE with ROBIN HOOD HASHING ***/
+
+/*** BEGIN of HASH TABLE with SWISS TABLE LAYOUT ***/
+
+upo_ht_swiss_t upo_ht_swiss_create(size_t m, upo_ht_hasher64_t key_hash, upo_ht_comparator_t key_cmp)
+{
+    /* preconditions */
+    assert(key_hash != NULL);
+
+    if (m > 0)
+    {
+        m = upo_ht_pow2_ceil(m < UPO_HT_SWISS_DEFAULT_CAPACITY ? UPO_HT_SWISS_DEFAULT_CAPACITY : m);
+    }
+    return upo_ht_swiss_new(m, key_hash, key_cmp);
+}
+
+upo_ht_swiss_t upo_ht_swiss_new(size_t m, upo_ht_hasher64_t key_hash, upo_ht_comparator_t key_cmp)
+{
+    upo_ht_swiss_t ht = NULL;
+
+    /* preconditions */
+    assert(key_cmp != NULL);
+    assert(m % UPO_HT_SWISS_GROUP_SIZE == 0);
+
+    ht = malloc(sizeof(struct upo_ht_swiss_s));
+    if (ht == NULL)
+    {
+        perror("Unable to allocate memory for Swiss Hash Table");
+        abort();
+    }
+
+    /* Allocate the control bytes, all empty, and the slots, which are left
+     * uninitialized since they are only read when full */
+    if (m > 0)
+    {
+        ht->ctrl = malloc(m);
+        ht->slots = malloc(m * sizeof(upo_ht_swiss_slot_t));
+        if (ht->ctrl == NULL || ht->slots == NULL)
+        {
+            perror("Unable to allocate memory for slots of the Swiss Hash Table");
+            abort();
+        }
+        memset(ht->ctrl, UPO_HT_SWISS_CTRL_EMPTY, m);
+    }
+    else
+    {
+        ht->ctrl = NULL;
+        ht->slots = NULL;
+    }
+
+    ht->capacity = m;
+    ht->size = 0;
+    ht->num_deleted = 0;
+    ht->key_hash = key_hash;
+    ht->key_cmp = key_cmp;
+
+    return ht;
+}
+
+void upo_ht_swiss_destroy(upo_ht_swiss_t ht, int destroy_data)
+{
+    if (ht != NULL)
+    {
+        upo_ht_swiss_clear(ht, destroy_data);
+        free(ht->ctrl);
+        free(ht->slots);
+        free(ht);
+    }
+}
+
+void upo_ht_swiss_clear(upo_ht_swiss_t ht, int destroy_data)
+{
+    if (ht != NULL && ht->ctrl != NULL)
+    {
+        size_t i = 0;
+
+        if (destroy_data)
+        {
+            for (i = 0; i < ht->capacity; ++i)
+            {
+                if ((ht->ctrl[i] & 0x80) == 0)
+                {
+                    free(ht->slots[i].key);
+                    free(ht->slots[i].value);
+                }
+            }
+        }
+        memset(ht->ctrl, UPO_HT_SWISS_CTRL_EMPTY, ht->capacity);
+        ht->size = 0;
+        ht->num_deleted = 0;
+    }
+}
+
+void *upo_ht_swiss_put(upo_ht_swiss_t ht, void *key, void *value)
+{
+    void *old_value = NULL;
+    uint64_t hash = 0;
+    size_t i = 0;
+
+    if (ht == NULL)
+        return NULL;
+
+    hash = upo_ht_swiss_hash(ht, key);
+    if (upo_ht_swiss_find(ht, key, hash, &i))
+    {
+        old_value = ht->slots[i].value;
+        ht->slots[i].value = value;
+    }
+    else
+    {
+        upo_ht_swiss_reserve(ht);
+        upo_ht_swiss_store(ht, hash, key, value);
+    }
+    return old_value;
+}
+
+void upo_ht_swiss_insert(upo_ht_swiss_t ht, void *key, void *value)
+{
+    uint64_t hash = 0;
+    size_t i = 0;
+
+    if (ht == NULL)
+        return;
+
+    hash = upo_ht_swiss_hash(ht, key);
+    if (!upo_ht_swiss_find(ht, key, hash, &i))
+    {
+        upo_ht_swiss_reserve(ht);
+        upo_ht_swiss_store(ht, hash, key, value);
+    }
+}
+
+void *upo_ht_swiss_get(const upo_ht_swiss_t ht, const void *key)
+{
+    size_t i = 0;
+
+    if (ht == NULL || !upo_ht_swiss_find(ht, key, upo_ht_swiss_hash(ht, key), &i))
+        return NULL;
+    return ht->slots[i].value;
+}
+
+int upo_ht_swiss_contains(const upo_ht_swiss_t ht, const void *key)
+{
+    size_t i = 0;
+
+    if (ht == NULL)
+        return 0;
+    return upo_ht_swiss_find(ht, key, upo_ht_swiss_hash(ht, key), &i);
+}
+
+void upo_ht_swiss_delete(upo_ht_swiss_t ht, const void *key, int destroy_data)
+{
+    size_t i = 0;
+
+    if (ht == NULL || !upo_ht_swiss_find(ht, key, upo_ht_swiss_hash(ht, key), &i))
+        return;
+
+    if (destroy_data)
+    {
+        free(ht->slots[i].key);
+        free(ht->slots[i].value);
+    }
+
+    /* A group with an empty slot has never been full, so no probe sequence
+     * goes past it and the slot can be emptied rather than marked */
+    if (upo_ht_swiss_match(ht->ctrl + (i & ~(size_t) (UPO_HT_SWISS_GROUP_SIZE - 1)), UPO_HT_SWISS_CTRL_EMPTY) != 0)
+    {
+        ht->ctrl[i] = UPO_HT_SWISS_CTRL_EMPTY;
+    }
+    else
+    {
+        ht->ctrl[i] = UPO_HT_SWISS_CTRL_DELETED;
+        ht->num_deleted += 1;
+    }
+    ht->size -= 1;
+
+    if (ht->capacity > UPO_HT_SWISS_DEFAULT_CAPACITY && upo_ht_swiss_load_factor(ht) <= 0.125)
+        upo_ht_swiss_resize(ht, ht->capacity / 2);
+}
+
+size_t upo_ht_swiss_size(const upo_ht_swiss_t ht)
+{
+    return (ht != NULL) ? ht->size : 0;
+}
+
+int upo_ht_swiss_is_empty(const upo_ht_swiss_t ht)
+{
+    return upo_ht_swiss_size(ht) == 0 ? 1 : 0;
+}
+
+size_t upo_ht_swiss_capacity(const upo_ht_swiss_t ht)
+{
+    return (ht != NULL) ? ht->capacity : 0;
+}
+
+double upo_ht_swiss_load_factor(const upo_ht_swiss_t ht)
+{
+    return upo_ht_swiss_size(ht) / (double)upo_ht_swiss_capacity(ht);
+}
+
+upo_ht_key_list_t upo_ht_swiss_keys(const upo_ht_swiss_t ht)
+{
+    upo_ht_key_list_t list = NULL;
+    size_t i = 0;
+
+    if (ht == NULL)
+        return NULL;
+    for (i = 0; i < ht->capacity; ++i)
+    {
+        if ((ht->ctrl[i] & 0x80) == 0)
+            upo_ht_build_key_list(ht->slots[i].key, &list);
+    }
+    return list;
+}
+
+void upo_ht_swiss_traverse(const upo_ht_swiss_t ht, upo_ht_visitor_t visit, void *visit_context)
+{
+    size_t i = 0;
+
+    if (ht == NULL)
+        return;
+    for (i = 0; i < ht->capacity; ++i)
+    {
+        if ((ht->ctrl[i] & 0x80) == 0)
+            visit(ht->slots[i].key, ht->slots[i].value, visit_context);
+    }
+}
+
+upo_ht_comparator_t upo_ht_swiss_get_comparator(const upo_ht_swiss_t ht)
+{
+    return ht->key_cmp;
+}
+
+upo_ht_hasher64_t upo_ht_swiss_get_hasher64(const upo_ht_swiss_t ht)
+{
+    return ht->key_hash;
+}
+
+uint64_t upo_ht_swiss_hash(const upo_ht_swiss_t ht, const void *key)
+{
+    return upo_ht_hash_finalize(ht->key_hash(key));
+}
+
+unsigned upo_ht_swiss_match(const uint8_t *group, uint8_t ctrl)
+{
+#ifdef UPO_HT_SWISS_USE_SSE2
+    __m128i bytes = _mm_loadu_si128((const __m128i *) group);
+
+    return (unsigned) _mm_movemask_epi8(_mm_cmpeq_epi8(bytes, _mm_set1_epi8((char) ctrl)));
+#else
+    unsigned mask = 0;
+    size_t i = 0;
+
+    for (i = 0; i < UPO_HT_SWISS_GROUP_SIZE; ++i)
+    {
+        mask |= (unsigned) (group[i] == ctrl) << i;
+    }
+    return mask;
+#endif /* UPO_HT_SWISS_USE_SSE2 */
+}
+
+unsigned upo_ht_swiss_match_free(const uint8_t *group)
+{
+#ifdef UPO_HT_SWISS_USE_SSE2
+    /* Only empty and deleted slots have the most significant bit set */
+    return (unsigned) _mm_movemask_epi8(_mm_loadu_si128((const __m128i *) group));
+#else
+    unsigned mask = 0;
+    size_t i = 0;
+
+    for (i = 0; i < UPO_HT_SWISS_GROUP_SIZE; ++i)
+    {
+        mask |= (unsigned) (group[i] >> 7) << i;
+    }
+    return mask;
+#endif /* UPO_HT_SWISS_USE_SSE2 */
+}
+
+unsigned upo_ht_swiss_lowest_bit(unsigned mask)
+{
+#ifdef __GNUC__
+    return (unsigned) __builtin_ctz(mask);
+#else
+    unsigned i = 0;
+
+    while ((mask & 1U) == 0)
+    {
+        mask >>= 1;
+        ++i;
+    }
+    return i;
+#endif /* __GNUC__ */
+}
+
+int upo_ht_swiss_find(const upo_ht_swiss_t ht, const void *key, uint64_t hash, size_t *pi)
+{
+    size_t group_mask = 0;
+    size_t g = 0;
+    size_t step = 0;
+    uint8_t tag = (uint8_t) (hash & 0x7F);
+
+    if (ht->size == 0)
+        return 0;
+
+    /* The low 7 bits of the hash value make the tag, the others pick the
+     * first group; groups are then probed at triangular offsets, which visit
+     * all of them since their number is a power of two */
+    group_mask = ht->capacity / UPO_HT_SWISS_GROUP_SIZE - 1;
+    g = (size_t) (hash >> 7) & group_mask;
+    for (;;)
+    {
+        const uint8_t *group = ht->ctrl + g * UPO_HT_SWISS_GROUP_SIZE;
+        unsigned match = upo_ht_swiss_match(group, tag);
+
+        while (match != 0)
+        {
+            size_t i = g * UPO_HT_SWISS_GROUP_SIZE + upo_ht_swiss_lowest_bit(match);
+
+            if (ht->key_cmp(key, ht->slots[i].key) == 0)
+            {
+                *pi = i;
+                return 1;
+            }
+            match &= match - 1;
+        }
+        if (upo_ht_swiss_match(group, UPO_HT_SWISS_CTRL_EMPTY) != 0)
+            return 0;
+        ++step;
+        g = (g + step) & group_mask;
+    }
+}
+
+size_t upo_ht_swiss_find_free(const upo_ht_swiss_t ht, uint64_t hash)
+{
+    size_t group_mask = ht->capacity / UPO_HT_SWISS_GROUP_SIZE - 1;
+    size_t g = (size_t) (hash >> 7) & group_mask;
+    size_t step = 0;
+
+    for (;;)
+    {
+        unsigned match = upo_ht_swiss_match_free(ht->ctrl + g * UPO_HT_SWISS_GROUP_SIZE);
+
+        if (match != 0)
+            return g * UPO_HT_SWISS_GROUP_SIZE + upo_ht_swiss_lowest_bit(match);
+        ++step;
+        g = (g + step) & group_mask;
+    }
+}
+
+void upo_ht_swiss_store(upo_ht_swiss_t ht, uint64_t hash, void *key, void *value)
+{
+    size_t i = upo_ht_swiss_find_free(ht, hash);
+
+    if (ht->ctrl[i] == UPO_HT_SWISS_CTRL_DELETED)
+        ht->num_deleted -= 1;
+    ht->ctrl[i] = (uint8_t) (hash & 0x7F);
+    ht->slots[i].key = key;
+    ht->slots[i].value = value;
+    ht->size += 1;
+}
+
+void upo_ht_swiss_reserve(upo_ht_swiss_t ht)
+{
+    if (ht->capacity == 0)
+    {
+        upo_ht_swiss_resize(ht, UPO_HT_SWISS_DEFAULT_CAPACITY);
+    }
+    else if (8 * (ht->size + ht->num_deleted + 1) > 7 * ht->capacity)
+    {
+        upo_ht_swiss_resize(ht, (16 * (ht->size + 1) > 7 * ht->capacity) ? ht->capacity * 2 : ht->capacity);
+    }
+}
+
+void upo_ht_swiss_resize(upo_ht_swiss_t ht, size_t n)
+{
+    /* preconditions */
+    assert(n > 0);
+
+    if (ht != NULL)
+    {
+        size_t i = 0;
+        upo_ht_swiss_t new_ht = NULL;
+
+        new_ht = upo_ht_swiss_new(n, ht->key_hash, ht->key_cmp);
+
+        /* Keys are distinct, so each one goes to the first free slot of its
+         * probe sequence in the new table */
+        for (i = 0; i < ht->capacity; ++i)
+        {
+            if ((ht->ctrl[i] & 0x80) == 0)
+            {
+                upo_ht_swiss_store(new_ht, upo_ht_swiss_hash(ht, ht->slots[i].key), ht->slots[i].key, ht->slots[i].value);
+            }
+        }
+
+        /* Swap the arrays with the temporary hash table, as for linear probing */
+        upo_swap(&ht->ctrl, &new_ht->ctrl, sizeof ht->ctrl);
+        upo_swap(&ht->slots, &new_ht->slots, sizeof ht->slots);
+        upo_swap(&ht->capacity, &new_ht->capacity, sizeof ht->capacity);
+        upo_swap(&ht->size, &new_ht->size, sizeof ht->size);
+        upo_swap(&ht->num_deleted, &new_ht->num_deleted, sizeof ht->num_deleted);
+
+        upo_ht_swiss_destroy(new_ht, 0);
+    }
+}
+
+/*** END of HASH TABLE with SWISS TABLE LAYOUT ***/
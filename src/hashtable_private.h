@@ -31,6 +31,35 @@
 
 #include <upo/hashtable.h>
 
+/* Swiss tables match the control bytes of a group with SSE2 instructions
+ * unless they are not available, or they are disabled by defining
+ * UPO_HT_SWISS_NO_SSE2 */
+#if defined(__SSE2__) && !defined(UPO_HT_SWISS_NO_SSE2)
+# define UPO_HT_SWISS_USE_SSE2
+# include <emmintrin.h>
+#endif /* __SSE2__ && !UPO_HT_SWISS_NO_SSE2 */
+
+
+/**
+ * \brief Returns the slot of the given key in a hash table.
+ *
+ * \param key The key.
+ * \param key_hash The hash function of the table, or `NULL`.
+ * \param key_hash64 The full-width hash function of the table, or `NULL` if
+ *  \a key_hash is used.
+ * \param pow2 Tells whether the capacity is a power of two.
+ * \param capacity The capacity of the table.
+ * \return The index of the slot of the key.
+ *
+ * Hash values of \a key_hash64 are mixed by upo_ht_hash_finalize() and then
+ * reduced once, by masking if \a pow2 is set; \a key_hash already returns an
+ * index.
+ */
+static size_t upo_ht_index(const void *key, upo_ht_hasher_t key_hash, upo_ht_hasher64_t key_hash64, int pow2, size_t capacity);
+
+/** \brief Returns the smallest power of two not less than \a m. */
+static size_t upo_ht_pow2_ceil(size_t m);
+
 
 /*** BEGIN of HASH TABLE with SEPARATE CHAINING ***/
 
@@ -59,11 +88,17 @@ struct upo_ht_sepchain_s
     upo_ht_sepchain_slot_t *slots; /**< The hash table as array of slots. */
     size_t capacity; /**< The capacity of the hash table. */
     size_t size; /**< The number of elements stored in the hash table. */
-    upo_ht_hasher_t key_hash; /**< The key hash function. */
+    upo_ht_hasher_t key_hash; /**< The key hash function, or `NULL` if \c key_hash64 is used. */
+    upo_ht_hasher64_t key_hash64; /**< The full-width key hash function, or `NULL` if \c key_hash is used. */
+    int pow2; /**< Tells whether the capacity is a power of two. */
     upo_ht_comparator_t key_cmp; /**< The key comparison function. */
 };
 
 
+/** \brief Creates a new empty hash table with the given hash function. */
+static upo_ht_sepchain_t upo_ht_sepchain_new(size_t m, upo_ht_hasher_t key_hash, upo_ht_hasher64_t key_hash64, int pow2, upo_ht_comparator_t key_cmp);
+
+
 /*** END of HASH TABLE with SEPARATE CHAINING ***/
 
 
@@ -87,11 +122,34 @@ struct upo_ht_linprob_s
     upo_ht_linprob_slot_t *slots; /**< The hash table as array of slots. */
     size_t capacity; /**< The capacity of the hash table. */
     size_t size; /**< The number of stored key-value pairs. */
-    upo_ht_hasher_t key_hash; /**< The key hash function. */
+    size_t num_tombstones; /**< The number of slots marked as deleted. */
+    upo_ht_hasher_t key_hash; /**< The key hash function, or `NULL` if \c key_hash64 is used. */
+    upo_ht_hasher64_t key_hash64; /**< The full-width key hash function, or `NULL` if \c key_hash is used. */
+    int pow2; /**< Tells whether the capacity is a power of two. */
     upo_ht_comparator_t key_cmp; /**< The key comparison function. */
 };
 
 
+/** \brief Creates a new empty hash table with the given hash function. */
+static upo_ht_linprob_t upo_ht_linprob_new(size_t m, upo_ht_hasher_t key_hash, upo_ht_hasher64_t key_hash64, int pow2, upo_ht_comparator_t key_cmp);
+
+/** \brief Returns the slot that follows the given one in the probe sequence. */
+static size_t upo_ht_linprob_next(const upo_ht_linprob_t ht, size_t i);
+
+
+/**
+ * \brief Makes room for a new key in the given hash table.
+ *
+ * \param ht The hash table.
+ *
+ * Tombstones lengthen the probe sequences as much as keys do, so the table is
+ * rebuilt when keys and tombstones together fill half of the slots: its
+ * capacity is doubled if keys alone do, otherwise the rebuild just drops the
+ * tombstones.
+ * This also ensures that probes always end on an empty slot.
+ */
+static void upo_ht_linprob_reserve(upo_ht_linprob_t ht);
+
 /**
  * \brief Resize the given hash table to the given capacity.
  *
@@ -105,6 +163,206 @@ static void upo_ht_linprob_resize(upo_ht_linprob_t ht, size_t n);
 
 static void upo_ht_build_key_list(void *key, upo_ht_key_list_t *list);
 
+/*** BEGIN of HASH TABLE with ROBIN HOOD HASHING ***/
+
+
+/** \brief Type for slots of hash tables with Robin Hood hashing. */
+struct upo_ht_robinhood_slot_s
+{
+    void *key; /**< Pointer to the user-provided key. */
+    void *value; /**< Pointer to the value associated to the key. */
+    size_t dist; /**< The distance of the slot from the home slot of the key, plus one, or `0` if the slot is empty. */
+};
+
+/** \brief Alias for type for slots of hash tables with Robin Hood hashing. */
+typedef struct upo_ht_robinhood_slot_s upo_ht_robinhood_slot_t;
+
+/** \brief Type for hash tables with Robin Hood hashing. */
+struct upo_ht_robinhood_s
+{
+    upo_ht_robinhood_slot_t *slots; /**< The hash table as array of slots. */
+    size_t capacity; /**< The capacity of the hash table. */
+    size_t size; /**< The number of stored key-value pairs. */
+    upo_ht_hasher_t key_hash; /**< The key hash function, or `NULL` if \c key_hash64 is used. */
+    upo_ht_hasher64_t key_hash64; /**< The full-width key hash function, or `NULL` if \c key_hash is used. */
+    int pow2; /**< Tells whether the capacity is a power of two. */
+    upo_ht_comparator_t key_cmp; /**< The key comparison function. */
+};
+
+
+/** \brief Creates a new empty hash table with the given hash function. */
+static upo_ht_robinhood_t upo_ht_robinhood_new(size_t m, upo_ht_hasher_t key_hash, upo_ht_hasher64_t key_hash64, int pow2, upo_ht_comparator_t key_cmp);
+
+/** \brief Returns the slot that follows the given one in the probe sequence. */
+static size_t upo_ht_robinhood_next(const upo_ht_robinhood_t ht, size_t i);
+
+/**
+ * \brief Looks for the given key in the given hash table.
+ *
+ * \param ht The hash table.
+ * \param key The key.
+ * \param pi Set to the slot holding the key if it is found, otherwise to the
+ *  slot where the key would be stored.
+ * \param pdist Set to the distance of that slot from the home slot of the key,
+ *  plus one.
+ * \return `1` if the key is found, or `0` otherwise.
+ *  If the hash table has no slots yet, `0` is returned and neither \a pi
+ *  nor \a pdist is set.
+ *
+ * Since the keys along a run never get closer to their home slot than those
+ * that precede them, the search stops at the first slot whose key is closer
+ * to its home slot than \a key would be, and only compares \a key with the
+ * keys that have the same home slot.
+ */
+static int upo_ht_robinhood_probe(const upo_ht_robinhood_t ht, const void *key, size_t *pi, size_t *pdist);
+
+/**
+ * \brief Stores the given key-value pair in the given slot, moving the keys
+ *  that are closer to their home slots forward.
+ *
+ * \param ht The hash table.
+ * \param i The slot returned by upo_ht_robinhood_probe().
+ * \param dist The distance returned by upo_ht_robinhood_probe().
+ * \param key The key.
+ * \param value The value.
+ */
+static void upo_ht_robinhood_shift_in(upo_ht_robinhood_t ht, size_t i, size_t dist, void *key, void *value);
+
+/**
+ * \brief Removes the key-value pair stored in the given slot, moving the keys
+ *  that follow it in their run one slot back.
+ *
+ * \param ht The hash table.
+ * \param i The slot.
+ */
+static void upo_ht_robinhood_shift_out(upo_ht_robinhood_t ht, size_t i);
+
+/**
+ * \brief Makes room for a new key in the given hash table.
+ *
+ * \param ht The hash table.
+ *
+ * The capacity is doubled when a new key would raise the load factor above
+ * \f$7/8\f$, which also ensures that runs always end on an empty slot.
+ */
+static void upo_ht_robinhood_reserve(upo_ht_robinhood_t ht);
+
+/**
+ * \brief Resize the given hash table to the given capacity.
+ *
+ * \param ht The hash table to resize.
+ * \param n The new capacity.
+ */
+static void upo_ht_robinhood_resize(upo_ht_robinhood_t ht, size_t n);
+
+
+/*** END of HASH TABLE with ROBIN HOOD HASHING ***/
+
+/*** BEGIN of HASH TABLE with SWISS TABLE LAYOUT ***/
+
+
+/** \brief Number of slots of a group, which are matched at once. */
+#define UPO_HT_SWISS_GROUP_SIZE 16U
+
+/** \brief Control byte of an empty slot. */
+#define UPO_HT_SWISS_CTRL_EMPTY ((uint8_t) 0x80)
+
+/**
+ * \brief Control byte of a deleted slot.
+ *
+ * Like `UPO_HT_SWISS_CTRL_EMPTY`, and unlike the control bytes of full slots
+ * (the 7-bit tags of their keys), it has the most significant bit set.
+ */
+#define UPO_HT_SWISS_CTRL_DELETED ((uint8_t) 0xFE)
+
+/** \brief Type for slots of Swiss hash tables. */
+struct upo_ht_swiss_slot_s
+{
+    void *key; /**< Pointer to the user-provided key. */
+    void *value; /**< Pointer to the value associated to the key. */
+};
+
+/** \brief Alias for type for slots of Swiss hash tables. */
+typedef struct upo_ht_swiss_slot_s upo_ht_swiss_slot_t;
+
+/** \brief Type for Swiss hash tables. */
+struct upo_ht_swiss_s
+{
+    uint8_t *ctrl; /**< The control bytes, one for each slot. */
+    upo_ht_swiss_slot_t *slots; /**< The key-value pairs, which are valid only in full slots. */
+    size_t capacity; /**< The capacity of the hash table, a power of two and a multiple of the group size, or `0`. */
+    size_t size; /**< The number of stored key-value pairs. */
+    size_t num_deleted; /**< The number of slots marked as deleted. */
+    upo_ht_hasher64_t key_hash; /**< The full-width key hash function. */
+    upo_ht_comparator_t key_cmp; /**< The key comparison function. */
+};
+
+
+/** \brief Creates a new empty hash table with exactly the given capacity. */
+static upo_ht_swiss_t upo_ht_swiss_new(size_t m, upo_ht_hasher64_t key_hash, upo_ht_comparator_t key_cmp);
+
+/** \brief Returns the mixed full-width hash value of the given key. */
+static uint64_t upo_ht_swiss_hash(const upo_ht_swiss_t ht, const void *key);
+
+/**
+ * \brief Returns the mask of the slots of the given group whose control byte
+ *  equals the given one (bit `i` for slot `i`).
+ */
+static unsigned upo_ht_swiss_match(const uint8_t *group, uint8_t ctrl);
+
+/** \brief Returns the mask of the slots of the given group that are empty or deleted. */
+static unsigned upo_ht_swiss_match_free(const uint8_t *group);
+
+/** \brief Returns the index of the lowest bit set in the given non-zero mask. */
+static unsigned upo_ht_swiss_lowest_bit(unsigned mask);
+
+/**
+ * \brief Looks for the given key in the given hash table.
+ *
+ * \param ht The hash table.
+ * \param key The key.
+ * \param hash The hash value of the key, as returned by upo_ht_swiss_hash().
+ * \param pi Set to the slot holding the key, if it is found.
+ * \return `1` if the key is found, or `0` otherwise.
+ */
+static int upo_ht_swiss_find(const upo_ht_swiss_t ht, const void *key, uint64_t hash, size_t *pi);
+
+/**
+ * \brief Returns the first empty or deleted slot in the probe sequence of the
+ *  given hash value.
+ */
+static size_t upo_ht_swiss_find_free(const upo_ht_swiss_t ht, uint64_t hash);
+
+/**
+ * \brief Stores the given key-value pair, which must not be in the given hash
+ *  table yet, and must fit in it.
+ */
+static void upo_ht_swiss_store(upo_ht_swiss_t ht, uint64_t hash, void *key, void *value);
+
+/**
+ * \brief Makes room for a new key in the given hash table.
+ *
+ * \param ht The hash table.
+ *
+ * Deleted slots lengthen the probe sequences as much as keys do, and probes
+ * only stop on groups with an empty slot, so the table is rebuilt when keys
+ * and deleted slots together would fill more than \f$7/8\f$ of it: its
+ * capacity is doubled if keys alone would fill more than \f$7/16\f$,
+ * otherwise the rebuild just drops the deleted slots.
+ */
+static void upo_ht_swiss_reserve(upo_ht_swiss_t ht);
+
+/**
+ * \brief Resize the given hash table to the given capacity.
+ *
+ * \param ht The hash table to resize.
+ * \param n The new capacity.
+ */
+static void upo_ht_swiss_resize(upo_ht_swiss_t ht, size_t n);
+
+
+/*** END of HASH TABLE with SWISS TABLE LAYOUT ***/
+
 /*** BEGIN of HASH TABLE with SEPARATE CHAINING with ORDERED LIST ***/
 
 /** \brief Type for nodes of the ordered list of collisions. */
@@ -132,11 +390,17 @@ struct upo_ht_sepchain_olist_s
     upo_ht_sepchain_olist_slot_t *slots; /**< The hash table as array of slots. */
     size_t capacity; /**< The capacity of the hash table. */
     size_t size; /**< The number of elements stored in the hash table. */
-    upo_ht_hasher_t key_hash; /**< The key hash function. */
+    upo_ht_hasher_t key_hash; /**< The key hash function, or `NULL` if \c key_hash64 is used. */
+    upo_ht_hasher64_t key_hash64; /**< The full-width key hash function, or `NULL` if \c key_hash is used. */
+    int pow2; /**< Tells whether the capacity is a power of two. */
     upo_ht_comparator_t key_cmp; /**< The key comparison function. */
 };
 
 
+/** \brief Creates a new empty hash table with the given hash function. */
+static upo_ht_sepchain_olist_t upo_ht_sepchain_olist_new(size_t m, upo_ht_hasher_t key_hash, upo_ht_hasher64_t key_hash64, int pow2, upo_ht_comparator_t key_cmp);
+
+
 /*** END of HASH TABLE with SEPARATE CHAINING with ORDERED LIST ***/
 
 #endif /* UPO_HASHTABLE_PRIVATE_H */
@@ -0,0 +1,307 @@
+/* vim: set tabstop=4 expandtab shiftwidth=4 softtabstop=4: */
+
+/*
+ * Copyright 2015 University of Piemonte Orientale, Computer Science Institute
+ *
+ * This file is part of UPOalglib.
+ *
+ * UPOalglib is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * UPOalglib is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with UPOalglib.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/* Needed for syscall and CLOCK_MONOTONIC_RAW with -std=c11 */
+#define _GNU_SOURCE
+
+#include <assert.h>
+#include "perf_timer_private.h"
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <upo/error.h>
+
+#ifdef __linux__
+# include <linux/perf_event.h>
+# include <sys/ioctl.h>
+# include <sys/syscall.h>
+# include <unistd.h>
+#endif /* __linux__ */
+
+
+#define UPO_PERF_TIMER_NANOSECONDS_PER_SECOND 1e+9
+
+
+upo_perf_timer_t upo_perf_timer_create()
+{
+    upo_perf_timer_t timer;
+    size_t i;
+
+    timer = malloc(sizeof(struct upo_perf_timer_s));
+    if (timer == NULL)
+    {
+        upo_throw_sys_error("Unable to allocate memory for the performance timer");
+    }
+
+    for (i = 0; i < UPO_PERF_TIMER_NUM_EVENTS; ++i)
+    {
+        timer->fds[i] = upo_perf_timer_open((upo_perf_event_t) i);
+        timer->counts[i] = -1;
+    }
+
+    /* Invalidates the timer */
+    timer->start.tv_sec = timer->stop.tv_sec = -1;
+    timer->start.tv_nsec = timer->stop.tv_nsec = 0;
+
+    return timer;
+}
+
+void upo_perf_timer_destroy(upo_perf_timer_t timer)
+{
+    size_t i;
+
+    if (timer == NULL)
+    {
+        return;
+    }
+
+#ifdef __linux__
+    for (i = 0; i < UPO_PERF_TIMER_NUM_EVENTS; ++i)
+    {
+        if (timer->fds[i] != -1)
+        {
+            close(timer->fds[i]);
+        }
+    }
+#else
+    (void) i;
+#endif /* __linux__ */
+    free(timer);
+}
+
+void upo_perf_timer_start(upo_perf_timer_t timer)
+{
+    size_t i;
+
+    assert( timer != NULL );
+
+#ifdef __linux__
+    for (i = 0; i < UPO_PERF_TIMER_NUM_EVENTS; ++i)
+    {
+        if (timer->fds[i] != -1
+            && (ioctl(timer->fds[i], PERF_EVENT_IOC_RESET, 0) == -1
+                || ioctl(timer->fds[i], PERF_EVENT_IOC_ENABLE, 0) == -1))
+        {
+            upo_throw_sys_error("Unable to start the performance counters");
+        }
+    }
+#else
+    (void) i;
+#endif /* __linux__ */
+
+    /* The clock is read last, so that enabling the counters is not timed */
+    upo_perf_timer_now(&timer->start);
+    timer->stop.tv_sec = -1;
+    timer->stop.tv_nsec = 0;
+}
+
+void upo_perf_timer_stop(upo_perf_timer_t timer)
+{
+    size_t i;
+
+    assert( timer != NULL );
+
+    if (upo_perf_timer_is_stopped(timer) || !upo_perf_timer_is_started(timer))
+    {
+        return;
+    }
+
+    upo_perf_timer_now(&timer->stop);
+    for (i = 0; i < UPO_PERF_TIMER_NUM_EVENTS; ++i)
+    {
+        if (timer->fds[i] == -1)
+        {
+            continue;
+        }
+#ifdef __linux__
+        if (ioctl(timer->fds[i], PERF_EVENT_IOC_DISABLE, 0) == -1)
+        {
+            upo_throw_sys_error("Unable to stop the performance counters");
+        }
+#endif /* __linux__ */
+        timer->counts[i] = upo_perf_timer_read(timer->fds[i]);
+    }
+}
+
+int upo_perf_timer_is_started(const upo_perf_timer_t timer)
+{
+    assert( timer != NULL );
+
+    return (timer->start.tv_sec != -1) ? 1 : 0;
+}
+
+int upo_perf_timer_is_stopped(const upo_perf_timer_t timer)
+{
+    assert( timer != NULL );
+
+    return (timer->stop.tv_sec != -1) ? 1 : 0;
+}
+
+double upo_perf_timer_elapsed(const upo_perf_timer_t timer)
+{
+    struct timespec now;
+    const struct timespec *stop = &timer->stop;
+
+    assert( timer != NULL );
+
+    if (!upo_perf_timer_is_started(timer))
+    {
+        return -1;
+    }
+    if (!upo_perf_timer_is_stopped(timer))
+    {
+        /* The timer isn't stopped: returns the time elapsed so far */
+        upo_perf_timer_now(&now);
+        stop = &now;
+    }
+
+    return difftime(stop->tv_sec, timer->start.tv_sec)
+           + (stop->tv_nsec - timer->start.tv_nsec)/UPO_PERF_TIMER_NANOSECONDS_PER_SECOND;
+}
+
+int upo_perf_timer_has_event(const upo_perf_timer_t timer, upo_perf_event_t event)
+{
+    assert( timer != NULL );
+    assert( event >= 0 && event < UPO_PERF_TIMER_NUM_EVENTS );
+
+    return (timer->fds[event] != -1) ? 1 : 0;
+}
+
+double upo_perf_timer_count(const upo_perf_timer_t timer, upo_perf_event_t event)
+{
+    assert( timer != NULL );
+    assert( event >= 0 && event < UPO_PERF_TIMER_NUM_EVENTS );
+
+    if (timer->fds[event] == -1 || !upo_perf_timer_is_started(timer))
+    {
+        return -1;
+    }
+    if (upo_perf_timer_is_stopped(timer))
+    {
+        return timer->counts[event];
+    }
+
+    return upo_perf_timer_read(timer->fds[event]);
+}
+
+const char* upo_perf_event_name(upo_perf_event_t event)
+{
+    switch (event)
+    {
+        case upo_perf_cycles_event:
+            return "cycles";
+        case upo_perf_instructions_event:
+            return "instructions";
+        case upo_perf_cache_misses_event:
+            return "cache_misses";
+        case upo_perf_branch_misses_event:
+            return "branch_misses";
+        case upo_perf_task_clock_event:
+            return "task_clock";
+    }
+
+    return "unknown";
+}
+
+int upo_perf_timer_open(upo_perf_event_t event)
+{
+#ifdef __linux__
+    struct perf_event_attr attr;
+
+    memset(&attr, 0, sizeof(attr));
+    attr.size = sizeof(attr);
+    attr.type = PERF_TYPE_HARDWARE;
+    switch (event)
+    {
+        case upo_perf_cycles_event:
+            attr.config = PERF_COUNT_HW_CPU_CYCLES;
+            break;
+        case upo_perf_instructions_event:
+            attr.config = PERF_COUNT_HW_INSTRUCTIONS;
+            break;
+        case upo_perf_cache_misses_event:
+            attr.config = PERF_COUNT_HW_CACHE_MISSES;
+            break;
+        case upo_perf_branch_misses_event:
+            attr.config = PERF_COUNT_HW_BRANCH_MISSES;
+            break;
+        case upo_perf_task_clock_event:
+            attr.type = PERF_TYPE_SOFTWARE;
+            attr.config = PERF_COUNT_SW_TASK_CLOCK;
+            break;
+    }
+    attr.read_format = PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+    attr.disabled = 1;
+    /* Counting the kernel is forbidden to unprivileged users by default */
+    attr.exclude_kernel = 1;
+    attr.exclude_hv = 1;
+    /* Counts the threads created by parallel algorithms too */
+    attr.inherit = 1;
+
+    /* This thread, on any CPU, in no group; failures just mean unavailable */
+    return (int) syscall(SYS_perf_event_open, &attr, 0, -1, -1, 0);
+#else
+    (void) event;
+
+    return -1;
+#endif /* __linux__ */
+}
+
+double upo_perf_timer_read(int fd)
+{
+#ifdef __linux__
+    uint64_t values[3]; /* The value, the time enabled and the time running */
+
+    if (read(fd, values, sizeof(values)) != (ssize_t) sizeof(values))
+    {
+        upo_throw_sys_error("Unable to read the performance counters");
+    }
+    if (values[2] == 0)
+    {
+        /* The counter was never scheduled on the CPU */
+        return 0;
+    }
+    if (values[2] < values[1])
+    {
+        return (double) values[0] * values[1] / values[2];
+    }
+
+    return (double) values[0];
+#else
+    (void) fd;
+
+    return -1;
+#endif /* __linux__ */
+}
+
+void upo_perf_timer_now(struct timespec *ts)
+{
+#ifdef CLOCK_MONOTONIC_RAW
+    /* Not slewed by NTP, unlike CLOCK_MONOTONIC */
+    if (clock_gettime(CLOCK_MONOTONIC_RAW, ts) == -1)
+#else
+    if (clock_gettime(CLOCK_MONOTONIC, ts) == -1)
+#endif /* CLOCK_MONOTONIC_RAW */
+    {
+        upo_throw_sys_error("Unable to read the monotonic clock");
+    }
+}
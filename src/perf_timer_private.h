@@ -0,0 +1,52 @@
+/* vim: set tabstop=4 expandtab shiftwidth=4 softtabstop=4: */
+
+/**
+ * \file src/perf_timer_private.h
+ *
+ * \brief Private header for the timer with hardware performance counters.
+ *
+ * \author Simone Gattini, Federico Barbero, Anton Iliev
+ *
+ * \copyright 2015 University of Piemonte Orientale, Computer Science Institute
+ *
+ *  This file is part of UPOalglib.
+ *
+ *  UPOalglib is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  UPOalglib is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with UPOalglib.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef UPO_PERF_TIMER_PRIVATE_H
+#define UPO_PERF_TIMER_PRIVATE_H
+
+#include <time.h>
+#include <upo/perf_timer.h>
+
+/** \brief Implementation of the \c upo_perf_timer_t type. */
+struct upo_perf_timer_s
+{
+    int fds[UPO_PERF_TIMER_NUM_EVENTS]; /**< The file descriptors of the counters, or -1 for the events that are not counted. */
+    double counts[UPO_PERF_TIMER_NUM_EVENTS]; /**< The counts at the stopping time. */
+    struct timespec start; /**< The starting time. */
+    struct timespec stop; /**< The stopping time. */
+};
+
+/** \brief Opens the counter of the given event, returning -1 if it is not available. */
+static int upo_perf_timer_open(upo_perf_event_t event);
+
+/** \brief Returns the current value of the given counter, scaled if it was multiplexed. */
+static double upo_perf_timer_read(int fd);
+
+/** \brief Reads the current time, on the raw monotonic clock if available. */
+static void upo_perf_timer_now(struct timespec *ts);
+
+#endif /* UPO_PERF_TIMER_PRIVATE_H */
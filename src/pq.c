@@ -0,0 +1,294 @@
+/* vim: set tabstop=4 expandtab shiftwidth=4 softtabstop=4: */
+
+/*
+ * Copyright 2015 University of Piemonte Orientale, Computer Science Institute
+ *
+ * This file is part of UPOalglib.
+ *
+ * UPOalglib is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * UPOalglib is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with UPOalglib.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <assert.h>
+#include "pq_private.h"
+#include <stdlib.h>
+#include <upo/error.h>
+
+
+upo_pq_t upo_pq_create(size_t d, upo_pq_comparator_t cmp)
+{
+    upo_pq_t pq = NULL;
+
+    assert(d >= 2);
+    assert(cmp != NULL);
+
+    pq = malloc(sizeof(struct upo_pq_s));
+    if (pq == NULL)
+    {
+        upo_throw_sys_error("Unable to allocate memory for the priority queue");
+    }
+    pq->heap = NULL;
+    pq->pos = NULL;
+    pq->size = 0;
+    pq->capacity = 0;
+    pq->num_handles = 0;
+    pq->free_handle = UPO_PQ_NO_HANDLE;
+    pq->d = d;
+    pq->cmp = cmp;
+
+    return pq;
+}
+
+void upo_pq_destroy(upo_pq_t pq, int destroy_data)
+{
+    if (pq == NULL)
+    {
+        return;
+    }
+
+    upo_pq_clear(pq, destroy_data);
+    free(pq->heap);
+    free(pq->pos);
+    free(pq);
+}
+
+void upo_pq_clear(upo_pq_t pq, int destroy_data)
+{
+    size_t i;
+
+    if (pq == NULL)
+    {
+        return;
+    }
+
+    if (destroy_data)
+    {
+        for (i = 0; i < pq->size; ++i)
+        {
+            free(pq->heap[i].data);
+        }
+    }
+    pq->size = 0;
+    pq->num_handles = 0;
+    pq->free_handle = UPO_PQ_NO_HANDLE;
+}
+
+upo_pq_handle_t upo_pq_push(upo_pq_t pq, void *data)
+{
+    struct upo_pq_entry_s entry;
+
+    assert(pq != NULL);
+
+    upo_pq_reserve(pq, 1);
+    entry.data = data;
+    entry.handle = upo_pq_new_handle(pq);
+    ++pq->size;
+    upo_pq_sift_up(pq, pq->size - 1, entry);
+
+    return entry.handle;
+}
+
+void upo_pq_heapify(upo_pq_t pq, void **data, size_t n, upo_pq_handle_t *handles)
+{
+    size_t i;
+
+    assert(pq != NULL);
+    assert(data != NULL || n == 0);
+
+    upo_pq_reserve(pq, n);
+    for (i = 0; i < n; ++i)
+    {
+        struct upo_pq_entry_s *entry = &pq->heap[pq->size];
+
+        entry->data = data[i];
+        entry->handle = upo_pq_new_handle(pq);
+        pq->pos[entry->handle] = pq->size;
+        if (handles != NULL)
+        {
+            handles[i] = entry->handle;
+        }
+        ++pq->size;
+    }
+    // Sifts down every internal node, starting from the last one
+    if (pq->size > 1)
+    {
+        for (i = (pq->size - 2) / pq->d + 1; i > 0; --i)
+        {
+            upo_pq_sift_down(pq, i - 1, pq->heap[i - 1]);
+        }
+    }
+}
+
+void* upo_pq_peek(const upo_pq_t pq)
+{
+    if (upo_pq_is_empty(pq))
+    {
+        return NULL;
+    }
+
+    return pq->heap[0].data;
+}
+
+void* upo_pq_pop(upo_pq_t pq)
+{
+    void *data = NULL;
+    upo_pq_handle_t handle;
+
+    if (upo_pq_is_empty(pq))
+    {
+        return NULL;
+    }
+
+    data = pq->heap[0].data;
+    handle = pq->heap[0].handle;
+    pq->pos[handle] = pq->free_handle;
+    pq->free_handle = handle;
+    --pq->size;
+    if (pq->size > 0)
+    {
+        // The last entry fills the hole left at the root
+        upo_pq_sift_down(pq, 0, pq->heap[pq->size]);
+    }
+
+    return data;
+}
+
+void* upo_pq_get(const upo_pq_t pq, upo_pq_handle_t handle)
+{
+    assert(pq != NULL);
+    assert(handle < pq->num_handles);
+    assert(pq->pos[handle] < pq->size && pq->heap[pq->pos[handle]].handle == handle);
+
+    return pq->heap[pq->pos[handle]].data;
+}
+
+void upo_pq_decrease_key(upo_pq_t pq, upo_pq_handle_t handle, void *data)
+{
+    struct upo_pq_entry_s entry;
+
+    assert(pq != NULL);
+    assert(handle < pq->num_handles);
+    assert(pq->pos[handle] < pq->size && pq->heap[pq->pos[handle]].handle == handle);
+
+    entry.data = data;
+    entry.handle = handle;
+    upo_pq_sift_up(pq, pq->pos[handle], entry);
+}
+
+size_t upo_pq_size(const upo_pq_t pq)
+{
+    return (pq != NULL) ? pq->size : 0;
+}
+
+int upo_pq_is_empty(const upo_pq_t pq)
+{
+    return upo_pq_size(pq) == 0;
+}
+
+void upo_pq_reserve(upo_pq_t pq, size_t n)
+{
+    size_t capacity = pq->capacity;
+    struct upo_pq_entry_s *heap = NULL;
+    size_t *pos = NULL;
+
+    if (pq->size + n <= capacity)
+    {
+        return;
+    }
+
+    capacity = (capacity > 0) ? 2 * capacity : UPO_PQ_INITIAL_CAPACITY;
+    if (capacity < pq->size + n)
+    {
+        capacity = pq->size + n;
+    }
+    // There are never more handles than the largest size the queue had, so
+    // the two arrays can grow together
+    heap = realloc(pq->heap, capacity * sizeof(struct upo_pq_entry_s));
+    if (heap == NULL)
+    {
+        upo_throw_sys_error("Unable to allocate memory for the priority queue");
+    }
+    pq->heap = heap;
+    pos = realloc(pq->pos, capacity * sizeof(size_t));
+    if (pos == NULL)
+    {
+        upo_throw_sys_error("Unable to allocate memory for the priority queue");
+    }
+    pq->pos = pos;
+    pq->capacity = capacity;
+}
+
+upo_pq_handle_t upo_pq_new_handle(upo_pq_t pq)
+{
+    upo_pq_handle_t handle = pq->free_handle;
+
+    if (handle != UPO_PQ_NO_HANDLE)
+    {
+        pq->free_handle = pq->pos[handle];
+        return handle;
+    }
+    assert(pq->num_handles < pq->capacity);
+
+    return pq->num_handles++;
+}
+
+void upo_pq_sift_up(upo_pq_t pq, size_t i, struct upo_pq_entry_s entry)
+{
+    // Moves parents down into the hole at i, then fills it with the entry
+    while (i > 0)
+    {
+        size_t parent = (i - 1) / pq->d;
+
+        if (pq->cmp(entry.data, pq->heap[parent].data) >= 0)
+        {
+            break;
+        }
+        pq->heap[i] = pq->heap[parent];
+        pq->pos[pq->heap[i].handle] = i;
+        i = parent;
+    }
+    pq->heap[i] = entry;
+    pq->pos[entry.handle] = i;
+}
+
+void upo_pq_sift_down(upo_pq_t pq, size_t i, struct upo_pq_entry_s entry)
+{
+    size_t d = pq->d;
+    size_t n = pq->size;
+
+    // Moves the smallest child up into the hole at i, then fills it with the entry
+    while (d * i + 1 < n)
+    {
+        size_t first = d * i + 1;
+        size_t last = (n - first > d) ? first + d : n;
+        size_t child = first;
+        size_t j;
+
+        for (j = first + 1; j < last; ++j)
+        {
+            if (pq->cmp(pq->heap[j].data, pq->heap[child].data) < 0)
+            {
+                child = j;
+            }
+        }
+        if (pq->cmp(pq->heap[child].data, entry.data) >= 0)
+        {
+            break;
+        }
+        pq->heap[i] = pq->heap[child];
+        pq->pos[pq->heap[i].handle] = i;
+        i = child;
+    }
+    pq->heap[i] = entry;
+    pq->pos[entry.handle] = i;
+}
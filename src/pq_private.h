@@ -0,0 +1,78 @@
+/* vim: set tabstop=4 expandtab shiftwidth=4 softtabstop=4: */
+
+/**
+ * \file src/pq_private.h
+ *
+ * \brief Private header for the Priority Queue abstract data type.
+ *
+ * \author Simone Gattini, Federico Barbero, Anton Iliev
+ *
+ * \copyright 2015 University of Piemonte Orientale, Computer Science Institute
+ *
+ *  This file is part of UPOalglib.
+ *
+ *  UPOalglib is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  UPOalglib is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with UPOalglib.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef UPO_PQ_PRIVATE_H
+#define UPO_PQ_PRIVATE_H
+
+#include <upo/pq.h>
+
+/** \brief Initial capacity of the heap of a priority queue. */
+#define UPO_PQ_INITIAL_CAPACITY 16
+
+/** \brief Marks the end of the list of free handles. */
+#define UPO_PQ_NO_HANDLE ((size_t) -1)
+
+/** \brief An entry of the heap: the element together with its handle. */
+struct upo_pq_entry_s
+{
+    void *data; /**< The element. */
+    upo_pq_handle_t handle; /**< The handle of the element. */
+};
+
+/**
+ * \brief Defines the Priority Queue type.
+ *
+ * The elements are kept in an implicit d-ary heap: the children of the entry
+ * at position `i` are at positions `d*i+1` to `d*i+d`.
+ * The array \a pos maps each handle to the position of its entry in the
+ * heap; the handles not in use are linked in a list through the same array.
+ */
+struct upo_pq_s
+{
+    struct upo_pq_entry_s *heap; /**< The heap. */
+    size_t size; /**< The number of elements. */
+    size_t capacity; /**< The capacity of both \a heap and \a pos. */
+    size_t *pos; /**< The heap positions, indexed by handle. */
+    size_t num_handles; /**< The number of handles allocated so far. */
+    upo_pq_handle_t free_handle; /**< The first handle not in use, if any. */
+    size_t d; /**< The number of children of each node. */
+    upo_pq_comparator_t cmp; /**< The priority comparison function. */
+};
+
+/** \brief Makes room for at least \a n more elements. */
+static void upo_pq_reserve(upo_pq_t pq, size_t n);
+
+/** \brief Returns a handle that is not in use. */
+static upo_pq_handle_t upo_pq_new_handle(upo_pq_t pq);
+
+/** \brief Moves the given entry up from position \a i to its place in the heap. */
+static void upo_pq_sift_up(upo_pq_t pq, size_t i, struct upo_pq_entry_s entry);
+
+/** \brief Moves the given entry down from position \a i to its place in the heap. */
+static void upo_pq_sift_down(upo_pq_t pq, size_t i, struct upo_pq_entry_s entry);
+
+#endif /* UPO_PQ_PRIVATE_H */
@@ -20,7 +20,10 @@
  */
 
 #include <assert.h>
+#include <math.h>
+#include "random_private.h"
 #include <stdlib.h>
+#include <upo/error.h>
 #include <upo/random.h>
 #include <upo/utility.h>
 
@@ -64,3 +67,216 @@ char* upo_random_string(char *s, size_t n)
 
     return s;
 }
+
+size_t upo_random_zipf(size_t m, double s)
+{
+    double h_integral_x1;
+    double h_integral_m;
+    double threshold;
+
+    assert( m > 0 );
+    assert( s > 0 );
+
+    /* Values k = 1..m are drawn from the continuous density h(x) = x^-s over
+     * [0.5,m+0.5] by inversion, then accepted if they also fall below the
+     * discrete probability of k; x1 covers the whole mass of k = 1. */
+    h_integral_x1 = upo_random_zipf_h_integral(1.5, s) - 1;
+    h_integral_m = upo_random_zipf_h_integral(m + 0.5, s);
+    threshold = 2 - upo_random_zipf_h_integral_inverse(upo_random_zipf_h_integral(2.5, s) - upo_random_zipf_h(2, s), s);
+    while (1)
+    {
+        double u = h_integral_m + upo_random_uniform_real(0, 1) * (h_integral_x1 - h_integral_m);
+        double x = upo_random_zipf_h_integral_inverse(u, s);
+        size_t k = (size_t) (x + 0.5);
+
+        if (k < 1)
+        {
+            k = 1;
+        }
+        else if (k > m)
+        {
+            k = m;
+        }
+        if (k - x <= threshold || u >= upo_random_zipf_h_integral(k + 0.5, s) - upo_random_zipf_h(k, s))
+        {
+            return k - 1;
+        }
+    }
+}
+
+void upo_random_keys(int *keys, size_t n, upo_random_dist_t dist, size_t param)
+{
+    size_t i;
+
+    assert( keys != NULL || n == 0 );
+
+    switch (dist)
+    {
+        case upo_random_uniform_dist:
+            for (i = 0; i < n; ++i)
+            {
+                keys[i] = (param > 0) ? (int) (rand() % param) : rand();
+            }
+            break;
+        case upo_random_few_unique_dist:
+            if (param == 0)
+            {
+                param = UPO_RANDOM_FEW_UNIQUE_DEFAULT_KEYS;
+            }
+            for (i = 0; i < n; ++i)
+            {
+                keys[i] = (int) (rand() % param);
+            }
+            break;
+        case upo_random_organ_pipe_dist:
+            for (i = 0; i < n; ++i)
+            {
+                keys[i] = (int) ((i < n - 1 - i) ? i : n - 1 - i);
+            }
+            break;
+        case upo_random_sawtooth_dist:
+            if (param == 0)
+            {
+                param = (size_t) ceil(sqrt((double) n));
+            }
+            for (i = 0; i < n; ++i)
+            {
+                keys[i] = (int) (i % param);
+            }
+            break;
+        case upo_random_sorted_swaps_dist:
+            if (param == 0)
+            {
+                param = n / 100;
+            }
+            for (i = 0; i < n; ++i)
+            {
+                keys[i] = (int) i;
+            }
+            for (i = 0; i < param && n > 1; ++i)
+            {
+                size_t a = (size_t) upo_random_uniform_real(0, n);
+                size_t b = (size_t) upo_random_uniform_real(0, n);
+
+                upo_swap(&keys[a], &keys[b], sizeof(int));
+            }
+            break;
+        case upo_random_zipf_dist:
+            if (param == 0)
+            {
+                param = n;
+            }
+            for (i = 0; i < n; ++i)
+            {
+                keys[i] = (int) upo_random_zipf(param, 1);
+            }
+            break;
+        case upo_random_all_equal_dist:
+            for (i = 0; i < n; ++i)
+            {
+                keys[i] = 0;
+            }
+            break;
+        case upo_random_median3_killer_dist:
+            upo_random_median3_killer(keys, n);
+            break;
+    }
+}
+
+double upo_random_zipf_h(double x, double s)
+{
+    return exp(-s * log(x));
+}
+
+double upo_random_zipf_h_integral(double x, double s)
+{
+    double log_x = log(x);
+
+    /* (x^(1-s) - 1) / (1-s), which tends to log(x) as s tends to 1 */
+    return upo_random_expm1_ratio((1 - s) * log_x) * log_x;
+}
+
+double upo_random_zipf_h_integral_inverse(double x, double s)
+{
+    double t = x * (1 - s);
+
+    /* Guards against rounding errors, as the result must not be negative */
+    if (t < -1)
+    {
+        t = -1;
+    }
+
+    return exp(upo_random_log1p_ratio(t) * x);
+}
+
+double upo_random_log1p_ratio(double x)
+{
+    if (fabs(x) > 1e-8)
+    {
+        return log1p(x) / x;
+    }
+
+    return 1 - x * (0.5 - x * (1.0 / 3 - 0.25 * x));
+}
+
+double upo_random_expm1_ratio(double x)
+{
+    if (fabs(x) > 1e-8)
+    {
+        return expm1(x) / x;
+    }
+
+    return 1 + x * 0.5 * (1 + x / 3 * (1 + 0.25 * x));
+}
+
+void upo_random_median3_killer(int *keys, size_t n)
+{
+    size_t *pos = NULL;
+    size_t lo = 0;
+    int next = 0;
+    size_t i;
+
+    if (n == 0)
+    {
+        return;
+    }
+
+    /* Replays the partitions of the sort on the positions of the keys, where
+     * pos[i] is the original position of the key that is at position i.
+     * Giving the two smallest keys left to the first and the middle position
+     * of the range makes the pivot the second smallest key: the partition
+     * does not move any other key, and the range only shrinks by two. */
+    pos = malloc(n * sizeof(size_t));
+    if (pos == NULL)
+    {
+        upo_throw_sys_error("Unable to allocate memory for the positions of the keys");
+    }
+    for (i = 0; i < n; ++i)
+    {
+        pos[i] = i;
+        keys[i] = -1;
+    }
+    while (n - lo > 3)
+    {
+        size_t mid = lo + (n - 1 - lo) / 2;
+        size_t tmp;
+
+        keys[pos[lo]] = next++;
+        keys[pos[mid]] = next++;
+        /* The pivot is moved next to the first key */
+        tmp = pos[mid];
+        pos[mid] = pos[lo + 1];
+        pos[lo + 1] = tmp;
+        lo += 2;
+    }
+    /* The remaining keys are larger than all the others, in any order */
+    for (i = 0; i < n; ++i)
+    {
+        if (keys[i] < 0)
+        {
+            keys[i] = next++;
+        }
+    }
+
+    free(pos);
+}
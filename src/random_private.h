@@ -0,0 +1,55 @@
+/* vim: set tabstop=4 expandtab shiftwidth=4 softtabstop=4: */
+
+/**
+ * \file src/random_private.h
+ *
+ * \brief Private header for the random number generation.
+ *
+ * \author Simone Gattini, Federico Barbero, Anton Iliev
+ *
+ * \copyright 2015 University of Piemonte Orientale, Computer Science Institute
+ *
+ *  This file is part of UPOalglib.
+ *
+ *  UPOalglib is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  UPOalglib is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with UPOalglib.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef UPO_RANDOM_PRIVATE_H
+#define UPO_RANDOM_PRIVATE_H
+
+#include <stddef.h>
+#include <upo/random.h>
+
+/** \brief The default number of distinct keys of upo_random_few_unique_dist. */
+#define UPO_RANDOM_FEW_UNIQUE_DEFAULT_KEYS 16
+
+/** \brief The density \f$h(x) = x^{-s}\f$ of the Zipf sampler. */
+static double upo_random_zipf_h(double x, double s);
+
+/** \brief The integral \f$H(x)\f$ of upo_random_zipf_h(), shifted so that \f$H(1) = 0\f$. */
+static double upo_random_zipf_h_integral(double x, double s);
+
+/** \brief The inverse of upo_random_zipf_h_integral(). */
+static double upo_random_zipf_h_integral_inverse(double x, double s);
+
+/** \brief Returns \f$\log(1+x)/x\f$, also for \a x close to zero. */
+static double upo_random_log1p_ratio(double x);
+
+/** \brief Returns \f$(e^x-1)/x\f$, also for \a x close to zero. */
+static double upo_random_expm1_ratio(double x);
+
+/** \brief Fills \a keys with the median-of-3 killer permutation of size \a n. */
+static void upo_random_median3_killer(int *keys, size_t n);
+
+#endif /* UPO_RANDOM_PRIVATE_H */
@@ -21,168 +21,1987 @@
 
 #include <assert.h>
 #include "sort_private.h"
+#include "sort_stats_private.h"
 #include <stddef.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
 #include <upo/utility.h>
 
+#ifdef UPO_SORT_STATS
+struct upo_sort_stats_counters_s upo_sort_stats_counters;
+_Thread_local size_t upo_sort_stats_depth;
+#endif /* UPO_SORT_STATS */
+
+int upo_sort_comparator_adapter(const void *a, const void *b, void *ctx)
+{
+    return (*(const upo_sort_comparator_t *) ctx)(a, b);
+}
+
+int upo_sort_stats_enabled()
+{
+#ifdef UPO_SORT_STATS
+    return 1;
+#else
+    return 0;
+#endif /* UPO_SORT_STATS */
+}
+
+void upo_sort_stats_get(upo_sort_stats_t *stats)
+{
+    assert(stats != NULL);
+
+#ifdef UPO_SORT_STATS
+    stats->num_compares = atomic_load(&upo_sort_stats_counters.num_compares);
+    stats->num_swaps = atomic_load(&upo_sort_stats_counters.num_swaps);
+    stats->num_bytes_moved = atomic_load(&upo_sort_stats_counters.num_bytes_moved);
+    stats->num_allocs = atomic_load(&upo_sort_stats_counters.num_allocs);
+    stats->max_depth = atomic_load(&upo_sort_stats_counters.max_depth);
+#else
+    memset(stats, 0, sizeof(upo_sort_stats_t));
+#endif /* UPO_SORT_STATS */
+}
+
+void upo_sort_stats_reset()
+{
+#ifdef UPO_SORT_STATS
+    atomic_store(&upo_sort_stats_counters.num_compares, 0);
+    atomic_store(&upo_sort_stats_counters.num_swaps, 0);
+    atomic_store(&upo_sort_stats_counters.num_bytes_moved, 0);
+    atomic_store(&upo_sort_stats_counters.num_allocs, 0);
+    atomic_store(&upo_sort_stats_counters.max_depth, 0);
+#endif /* UPO_SORT_STATS */
+}
+
 void upo_insertion_sort(void *base, size_t n, size_t size, upo_sort_comparator_t cmp)
 {
+    upo_insertion_sort_r(base, n, size, upo_sort_comparator_adapter, &cmp);
+}
+
+void upo_insertion_sort_r(void *base, size_t n, size_t size, upo_sort_comparator_r_t cmp, void *ctx)
+{
+    unsigned char buf[UPO_INSERTION_SORT_STACK_BYTES];
+    unsigned char *tmp = buf;
+
     assert(base != NULL);
-    assert(n > 0);
     assert(size > 0);
     assert(cmp != NULL);
 
-    unsigned char *ptr = base, *current = NULL, *previous = NULL;
+    if (n < 2)
+    {
+        return;
+    }
+    // Only elements larger than the buffer on the stack need an allocation
+    if (size > sizeof(buf))
+    {
+        tmp = UPO_SORT_MALLOC(size);
+        if (tmp == NULL)
+        {
+            perror("Unable to allocate memory for auxiliary element");
+            abort();
+        }
+    }
+    upo_insertion_sort_range(base, 1, n, size, cmp, ctx, tmp);
+    if (tmp != buf)
+    {
+        free(tmp);
+    }
+}
+
+void upo_insertion_sort_range(unsigned char *base, size_t start, size_t n, size_t size, upo_sort_comparator_r_t cmp, void *ctx, unsigned char *tmp)
+{
+    size_t i;
 
-    for (size_t i = 1; i < n; ++i)
+    for (i = start; i < n; ++i)
     {
-        int j = i;
-        while (j > 0 && cmp(ptr + j * size, ptr + (j - 1) * size) < 0)
+        unsigned char *current = base + i * size;
+        size_t lo = 0;
+        size_t hi = i - 1;
+
+        // Nothing to do if the element is not less than its predecessor,
+        // which makes sorted runs cost one compare per element
+        if (UPO_SORT_CMP(cmp, current - size, current, ctx) <= 0)
         {
-            current = ptr + j * size;
-            previous = ptr + (j * size) - (1 * size);
+            continue;
+        }
+        // Finds the first element in base[0..i-1] greater than the current
+        // one (the predecessor is known to be), so that equal elements keep
+        // their order
+        while (lo < hi)
+        {
+            size_t mid = lo + (hi - lo) / 2;
 
-            upo_swap(current, previous, size);
-            j--;
+            if (UPO_SORT_CMP(cmp, base + mid * size, current, ctx) <= 0)
+            {
+                lo = mid + 1;
+            }
+            else
+            {
+                hi = mid;
+            }
         }
+        // Shifts base[lo..i-1] one position right with a single move
+        UPO_SORT_COPY(tmp, current, size);
+        UPO_SORT_MOVE(base + (lo + 1) * size, base + lo * size, (i - lo) * size);
+        UPO_SORT_COPY(base + lo * size, tmp, size);
     }
 }
 
 void upo_merge_sort(void *base, size_t n, size_t size, upo_sort_comparator_t cmp)
 {
+    upo_merge_sort_r(base, n, size, upo_sort_comparator_adapter, &cmp);
+}
+
+void upo_merge_sort_r(void *base, size_t n, size_t size, upo_sort_comparator_r_t cmp, void *ctx)
+{
+    upo_merge_sort_ex_r(base, n, size, cmp, ctx, NULL);
+}
+
+void upo_merge_sort_ex(void *base, size_t n, size_t size, upo_sort_comparator_t cmp, void *aux)
+{
+    upo_merge_sort_ex_r(base, n, size, upo_sort_comparator_adapter, &cmp, aux);
+}
+
+void upo_merge_sort_ex_r(void *base, size_t n, size_t size, upo_sort_comparator_r_t cmp, void *ctx, void *aux)
+{
+    unsigned char *own_aux = NULL;
+
     assert(base != NULL);
     assert(n > 0);
     assert(size > 0);
     assert(cmp != NULL);
 
-    upo_merge_sort_rec(base, 0, n - 1, size, cmp);
+    if (aux == NULL)
+    {
+        own_aux = UPO_SORT_MALLOC(n * size);
+        if (own_aux == NULL)
+        {
+            perror("Unable to allocate memory for auxiliary vector");
+            abort();
+        }
+        aux = own_aux;
+    }
+    // Both arrays must hold the same elements before the recursion starts,
+    // since each level reads from one and writes into the other.
+    UPO_SORT_COPY(aux, base, n * size);
+    upo_merge_sort_rec(aux, base, 0, n - 1, size, cmp, ctx);
+    free(own_aux);
 }
 
-void upo_merge_sort_rec(void *base, size_t lo, size_t hi, size_t size, upo_sort_comparator_t cmp)
+void upo_merge_sort_rec(unsigned char *src, unsigned char *dst, size_t lo, size_t hi, size_t size, upo_sort_comparator_r_t cmp, void *ctx)
 {
     size_t mid;
     if (lo >= hi)
     {
         return;
     }
+    UPO_SORT_STATS_ENTER();
     // mid = (hi+lo)/2; //WARN: do not use this assignment as it may overflow
     mid = lo + (hi - lo) / 2;
-    // Sorts left half
-    upo_merge_sort_rec(base, lo, mid, size, cmp);
-    // Sorts right half
-    upo_merge_sort_rec(base, mid + 1, hi, size, cmp);
-    // Merges results
-    upo_merge_sort_merge(base, lo, mid, hi, size, cmp);
+    // Sorts both halves into src, using dst as their auxiliary array
+    upo_merge_sort_rec(dst, src, lo, mid, size, cmp, ctx);
+    upo_merge_sort_rec(dst, src, mid + 1, hi, size, cmp, ctx);
+    // Merges the sorted halves of src into dst
+    upo_merge_sort_merge(src, dst, lo, mid, hi, size, cmp, ctx);
+    UPO_SORT_STATS_LEAVE();
 }
 
-void upo_merge_sort_merge(void *base, size_t lo, size_t mid, size_t hi, size_t size, upo_sort_comparator_t cmp)
+void upo_merge_sort_merge(const unsigned char *src, unsigned char *dst, size_t lo, size_t mid, size_t hi, size_t size, upo_sort_comparator_r_t cmp, void *ctx)
 {
-    unsigned char *ptr = base;
-    unsigned char *aux = NULL;
-    size_t n = hi - lo + 1;
-    size_t i = 0;
-    size_t j = mid + 1 - lo;
+    size_t i = lo;
+    size_t j = mid + 1;
     size_t k;
-    aux = malloc(n * size);
-    if (aux == NULL)
-    {
-        perror("Unable to allocate memory for auxiliary vector");
-        abort();
-    }
-    // Copy base[lo],...,base[hi] into the auxiliary array
-    memcpy(aux, ptr + lo * size, n * size);
-    // Merge base[lo],...,base[mid] with base[mid+1],...,base[hi].
-    // Elements are read from the aux vector and written to the base vector.
+    // Merge src[lo],...,src[mid] with src[mid+1],...,src[hi] into dst[lo],...,dst[hi].
     for (k = lo; k <= hi; ++k)
     {
-        if (i > (mid - lo))
+        if (i > mid)
         {
-            memcpy(ptr + k * size, aux + j * size, size);
+            UPO_SORT_COPY(dst + k * size, src + j * size, size);
             ++j;
         }
-        else if (j > (hi - lo))
+        else if (j > hi)
         {
-            memcpy(ptr + k * size, aux + i * size, size);
+            UPO_SORT_COPY(dst + k * size, src + i * size, size);
             ++i;
         }
-        else if (cmp(aux + j * size, aux + i * size) < 0)
+        else if (UPO_SORT_CMP(cmp, src + j * size, src + i * size, ctx) < 0)
         {
-            memcpy(ptr + k * size, aux + j * size, size);
+            UPO_SORT_COPY(dst + k * size, src + j * size, size);
             ++j;
         }
         else
         {
-            memcpy(ptr + k * size, aux + i * size, size);
+            UPO_SORT_COPY(dst + k * size, src + i * size, size);
             ++i;
         }
     }
+}
+
+void upo_merge_sort_bottomup(void *base, size_t n, size_t size, upo_sort_comparator_t cmp)
+{
+    upo_merge_sort_bottomup_r(base, n, size, upo_sort_comparator_adapter, &cmp);
+}
+
+void upo_merge_sort_bottomup_r(void *base, size_t n, size_t size, upo_sort_comparator_r_t cmp, void *ctx)
+{
+    unsigned char *ptr = base;
+    unsigned char *aux = NULL;
+    unsigned char *src = NULL;
+    unsigned char *dst = NULL;
+    unsigned char *tmp = NULL;
+    size_t run = UPO_MERGE_SORT_BOTTOMUP_RUN;
+    size_t block = run;
+    size_t lo;
+    size_t width;
+
+    assert(base != NULL);
+    assert(n > 0);
+    assert(size > 0);
+    assert(cmp != NULL);
+
+    aux = UPO_SORT_MALLOC(n * size);
+    if (aux == NULL)
+    {
+        perror("Unable to allocate memory for auxiliary vector");
+        abort();
+    }
+
+    // The block must be a power-of-two multiple of the run length, so that
+    // the passes over the whole array start where the blocked ones stopped.
+    while (2 * (2 * block) * size <= UPO_MERGE_SORT_BOTTOMUP_BLOCK_BYTES)
+    {
+        block *= 2;
+    }
+
+    // Sorts short runs in place
+    for (lo = 0; lo < n; lo += run)
+    {
+        upo_insertion_sort_r(ptr + lo * size, (n - lo < run) ? n - lo : run, size, cmp, ctx);
+    }
+
+    // Merges runs inside each block while it is still in cache.
+    // Every block performs the same number of passes, so all of them end up
+    // in the same array.
+    for (lo = 0; lo < n; lo += block)
+    {
+        size_t hi = (n - lo < block) ? n : lo + block;
+
+        src = ptr;
+        dst = aux;
+        for (width = run; width < block; width *= 2)
+        {
+            upo_merge_sort_pass(src, dst, lo, hi, width, size, cmp, ctx);
+            tmp = src;
+            src = dst;
+            dst = tmp;
+        }
+    }
+
+    // Merges blocks over the whole array
+    for (width = block; width < n; width *= 2)
+    {
+        upo_merge_sort_pass(src, dst, 0, n, width, size, cmp, ctx);
+        tmp = src;
+        src = dst;
+        dst = tmp;
+    }
+
+    if (src != ptr)
+    {
+        UPO_SORT_COPY(ptr, src, n * size);
+    }
     free(aux);
 }
 
-void upo_quick_sort(void *base, size_t n, size_t size, upo_sort_comparator_t cmp)
+void upo_merge_sort_pass(const unsigned char *src, unsigned char *dst, size_t lo, size_t hi, size_t width, size_t size, upo_sort_comparator_r_t cmp, void *ctx)
 {
-    upo_quick_sort_rec(base, 0, n - 1, size, cmp);
+    // Merges adjacent pairs of sorted runs of the given width found in
+    // src[lo],...,src[hi-1] into dst; a trailing unpaired run is just copied.
+    for (; lo < hi; lo += 2 * width)
+    {
+        size_t mid = (hi - lo <= width) ? hi - 1 : lo + width - 1;
+        size_t end = (hi - lo <= 2 * width) ? hi - 1 : lo + 2 * width - 1;
+
+        upo_merge_sort_merge(src, dst, lo, mid, end, size, cmp, ctx);
+    }
 }
 
-void upo_quick_sort_rec(void *base, size_t lo, size_t hi, size_t size, upo_sort_comparator_t cmp)
+void upo_adaptive_sort(void *base, size_t n, size_t size, upo_sort_comparator_t cmp)
 {
-    if (lo >= hi)
+    upo_adaptive_sort_r(base, n, size, upo_sort_comparator_adapter, &cmp);
+}
+
+void upo_adaptive_sort_r(void *base, size_t n, size_t size, upo_sort_comparator_r_t cmp, void *ctx)
+{
+    struct upo_adaptive_sort_s ms;
+    size_t min_run;
+    size_t lo = 0;
+
+    assert(base != NULL);
+    assert(size > 0);
+    assert(cmp != NULL);
+
+    if (n < 2)
+    {
         return;
-    size_t j = upo_quick_sort_partition(base, lo, hi, size, cmp);
-    if (j > 0)
-        upo_quick_sort_rec(base, lo, j - 1, size, cmp);
-    upo_quick_sort_rec(base, j + 1, hi, size, cmp);
+    }
+
+    ms.base = base;
+    ms.n = n;
+    ms.size = size;
+    ms.cmp = cmp;
+    ms.ctx = ctx;
+    ms.tmp = NULL;
+    ms.min_gallop = UPO_ADAPTIVE_SORT_MIN_GALLOP;
+    ms.num_runs = 0;
+    ms.pivot = UPO_SORT_MALLOC(size);
+    if (ms.pivot == NULL)
+    {
+        perror("Unable to allocate memory for auxiliary element");
+        abort();
+    }
+
+    min_run = upo_adaptive_sort_min_run(n);
+    while (lo < n)
+    {
+        size_t len = upo_adaptive_sort_count_run(&ms, lo, n);
+
+        // Extends short runs to min_run elements (or up to the end of the array)
+        if (len < min_run)
+        {
+            size_t forced = (n - lo < min_run) ? n - lo : min_run;
+
+            upo_insertion_sort_range(ms.base + lo * size, len, forced, size, cmp, ctx, ms.pivot);
+            len = forced;
+        }
+        assert(ms.num_runs < UPO_ADAPTIVE_SORT_MAX_RUNS);
+        ms.run_base[ms.num_runs] = lo;
+        ms.run_len[ms.num_runs] = len;
+        ++ms.num_runs;
+        upo_adaptive_sort_merge_collapse(&ms);
+        lo += len;
+    }
+    upo_adaptive_sort_merge_force_collapse(&ms);
+    assert(ms.num_runs == 1 && ms.run_len[0] == n);
+
+    free(ms.tmp);
+    free(ms.pivot);
 }
 
-void upo_bubble_sort(void *base, size_t n, size_t size, upo_sort_comparator_t cmp)
+size_t upo_adaptive_sort_min_run(size_t n)
 {
-    unsigned char *ptr = base;
-    for (size_t i = 0; i < n; i++)
+    size_t r = 0;
+
+    // Takes the 6 most significant bits of n, plus one if any of the others
+    // is set, so that n/min_run is a power of two or slightly less than one
+    while (n >= 64)
     {
-        for (size_t j = 0; j < ((n - 1) - i); j++)
+        r |= n & 1;
+        n >>= 1;
+    }
+    return n + r;
+}
+
+size_t upo_adaptive_sort_count_run(const struct upo_adaptive_sort_s *ms, size_t lo, size_t hi)
+{
+    unsigned char *ptr = ms->base;
+    size_t size = ms->size;
+    size_t i = lo + 1;
+
+    if (i == hi)
+    {
+        return 1;
+    }
+    if (UPO_SORT_CMP(ms->cmp, ptr + i * size, ptr + lo * size, ms->ctx) < 0)
+    {
+        // Only strictly descending runs are reversed, to keep the sort stable
+        size_t first;
+        size_t last;
+
+        for (++i; i < hi && UPO_SORT_CMP(ms->cmp, ptr + i * size, ptr + (i - 1) * size, ms->ctx) < 0; ++i)
+        {
+            ;
+        }
+        for (first = lo, last = i - 1; first < last; ++first, --last)
+        {
+            UPO_SORT_SWAP(ptr + first * size, ptr + last * size, size);
+        }
+    }
+    else
+    {
+        for (++i; i < hi && UPO_SORT_CMP(ms->cmp, ptr + i * size, ptr + (i - 1) * size, ms->ctx) >= 0; ++i)
         {
-            if (cmp(ptr + j * size, ptr + ((j + 1) * size)) > 0)
-                upo_swap(ptr + ((j + 1) * size), ptr + j * size, size);
+            ;
         }
     }
+    return i - lo;
 }
 
-void upo_quick_sort_median3_cutoff(void *base, size_t n, size_t size, upo_sort_comparator_t cmp)
+size_t upo_adaptive_sort_gallop(const void *key, const unsigned char *a, size_t n, int right, int from_end, size_t size, upo_sort_comparator_r_t cmp, void *ctx)
+{
+    // Elements "before" the key form a prefix of a: they are the ones less
+    // than the key or, if right is set, the ones less than or equal to it.
+    // The length of that prefix is returned.
+    size_t lo;
+    size_t hi;
+    size_t ofs = 1;
+
+#define UPO_ADAPTIVE_SORT_BEFORE(i) (right ? UPO_SORT_CMP(cmp, a + (i) * size, key, ctx) <= 0 : UPO_SORT_CMP(cmp, a + (i) * size, key, ctx) < 0)
+    if (n == 0)
+    {
+        return 0;
+    }
+    if (!from_end)
+    {
+        // Probes a[0], a[1], a[3], a[7], ... until an element is not before the key
+        if (!UPO_ADAPTIVE_SORT_BEFORE(0))
+        {
+            return 0;
+        }
+        lo = 0;
+        while (ofs < n && UPO_ADAPTIVE_SORT_BEFORE(ofs))
+        {
+            lo = ofs;
+            ofs = 2 * ofs + 1;
+        }
+        // The answer is in (lo, hi]
+        hi = (ofs < n) ? ofs : n;
+        ++lo;
+    }
+    else
+    {
+        // Probes a[n-1], a[n-2], a[n-4], a[n-8], ... until an element is before the key
+        if (UPO_ADAPTIVE_SORT_BEFORE(n - 1))
+        {
+            return n;
+        }
+        hi = n - 1;
+        while (ofs < n && !UPO_ADAPTIVE_SORT_BEFORE(n - 1 - ofs))
+        {
+            hi = n - 1 - ofs;
+            ofs = 2 * ofs + 1;
+        }
+        // The answer is in [lo, hi]
+        lo = (ofs < n) ? n - ofs : 0;
+    }
+    while (lo < hi)
+    {
+        size_t mid = lo + (hi - lo) / 2;
+
+        if (UPO_ADAPTIVE_SORT_BEFORE(mid))
+        {
+            lo = mid + 1;
+        }
+        else
+        {
+            hi = mid;
+        }
+    }
+#undef UPO_ADAPTIVE_SORT_BEFORE
+    return lo;
+}
+
+void upo_adaptive_sort_merge_collapse(struct upo_adaptive_sort_s *ms)
+{
+    size_t *len = ms->run_len;
+
+    // Restores the invariants len[i-2] > len[i-1] + len[i] and
+    // len[i-1] > len[i] on the whole stack, which keep the merges balanced
+    // and the stack shorter than log_phi(n) runs
+    while (ms->num_runs > 1)
+    {
+        size_t i = ms->num_runs - 2;
+
+        if ((i > 0 && len[i - 1] <= len[i] + len[i + 1])
+            || (i > 1 && len[i - 2] <= len[i - 1] + len[i]))
+        {
+            if (len[i - 1] < len[i + 1])
+            {
+                --i;
+            }
+        }
+        else if (len[i] > len[i + 1])
+        {
+            break;
+        }
+        upo_adaptive_sort_merge_at(ms, i);
+    }
+}
+
+void upo_adaptive_sort_merge_force_collapse(struct upo_adaptive_sort_s *ms)
 {
-    upo_quick_sort_median3_cutoff_driver_topdown(base, 0, n - 1, size, cmp);
+    while (ms->num_runs > 1)
+    {
+        size_t i = ms->num_runs - 2;
+
+        if (i > 0 && ms->run_len[i - 1] < ms->run_len[i + 1])
+        {
+            --i;
+        }
+        upo_adaptive_sort_merge_at(ms, i);
+    }
 }
 
-void upo_quick_sort_median3_cutoff_driver_topdown(void *base, size_t lo, size_t hi, size_t size, upo_sort_comparator_t cmp)
+void upo_adaptive_sort_merge_at(struct upo_adaptive_sort_s *ms, size_t i)
 {
-    size_t pivot;
-    if (lo >= hi)
+    unsigned char *ptr = ms->base;
+    size_t size = ms->size;
+    unsigned char *a = ptr + ms->run_base[i] * size;
+    size_t na = ms->run_len[i];
+    unsigned char *b = ptr + ms->run_base[i + 1] * size;
+    size_t nb = ms->run_len[i + 1];
+    size_t k;
+
+    ms->run_len[i] += nb;
+    if (i + 3 == ms->num_runs)
+    {
+        ms->run_base[i + 1] = ms->run_base[i + 2];
+        ms->run_len[i + 1] = ms->run_len[i + 2];
+    }
+    --ms->num_runs;
+
+    // Elements of a not greater than b[0] are already in place
+    k = upo_adaptive_sort_gallop(b, a, na, 1, 0, size, ms->cmp, ms->ctx);
+    a += k * size;
+    na -= k;
+    if (na == 0)
+    {
+        return;
+    }
+    // Elements of b not less than the last of a are already in place
+    nb = upo_adaptive_sort_gallop(a + (na - 1) * size, b, nb, 0, 1, size, ms->cmp, ms->ctx);
+    if (nb == 0)
     {
         return;
     }
-    if ((hi - lo + 1) <= 10)
+
+    // The shorter run (at most n/2 elements) is moved to the temporary
+    // array, which is allocated by the first merge only
+    if (ms->tmp == NULL)
+    {
+        ms->tmp = UPO_SORT_MALLOC((ms->n / 2 + 1) * size);
+        if (ms->tmp == NULL)
+        {
+            perror("Unable to allocate memory for auxiliary vector");
+            abort();
+        }
+    }
+    if (na <= nb)
+    {
+        upo_adaptive_sort_merge_lo(ms, a, na, b, nb);
+    }
+    else
+    {
+        upo_adaptive_sort_merge_hi(ms, a, na, b, nb);
+    }
+}
+
+void upo_adaptive_sort_merge_lo(struct upo_adaptive_sort_s *ms, unsigned char *a, size_t na, unsigned char *b, size_t nb)
+{
+    size_t size = ms->size;
+    upo_sort_comparator_r_t cmp = ms->cmp;
+    void *ctx = ms->ctx;
+    size_t min_gallop = ms->min_gallop;
+    unsigned char *dest = a;
+    unsigned char *pa = ms->tmp;
+    unsigned char *pb = b;
+
+    // Merges from left to right, with a moved to the temporary array.
+    // On entry b[0] < a[0], so b[0] comes first.
+    UPO_SORT_COPY(pa, a, na * size);
+    UPO_SORT_COPY(dest, pb, size);
+    dest += size;
+    pb += size;
+    --nb;
+
+    while (na > 0 && nb > 0)
+    {
+        size_t count_a = 0;
+        size_t count_b = 0;
+
+        // Compares one pair at a time until a run wins min_gallop times in a row
+        while (na > 0 && nb > 0 && count_a < min_gallop && count_b < min_gallop)
+        {
+            if (UPO_SORT_CMP(cmp, pb, pa, ctx) < 0)
+            {
+                UPO_SORT_COPY(dest, pb, size);
+                pb += size;
+                --nb;
+                ++count_b;
+                count_a = 0;
+            }
+            else
+            {
+                UPO_SORT_COPY(dest, pa, size);
+                pa += size;
+                --na;
+                ++count_a;
+                count_b = 0;
+            }
+            dest += size;
+        }
+
+        // Galloping mode: looks for the end of the winning streaks by exponential search
+        while (na > 0 && nb > 0)
+        {
+            size_t ka;
+            size_t kb;
+
+            ka = upo_adaptive_sort_gallop(pb, pa, na, 1, 0, size, cmp, ctx);
+            UPO_SORT_COPY(dest, pa, ka * size);
+            dest += ka * size;
+            pa += ka * size;
+            na -= ka;
+            if (na == 0)
+            {
+                break;
+            }
+            UPO_SORT_COPY(dest, pb, size);
+            dest += size;
+            pb += size;
+            --nb;
+            if (nb == 0)
+            {
+                break;
+            }
+
+            kb = upo_adaptive_sort_gallop(pa, pb, nb, 0, 0, size, cmp, ctx);
+            UPO_SORT_MOVE(dest, pb, kb * size);
+            dest += kb * size;
+            pb += kb * size;
+            nb -= kb;
+            if (nb == 0)
+            {
+                break;
+            }
+            UPO_SORT_COPY(dest, pa, size);
+            dest += size;
+            pa += size;
+            --na;
+
+            // Galloping pays off, so it is entered more easily next time
+            if (min_gallop > 1)
+            {
+                --min_gallop;
+            }
+            if (ka < UPO_ADAPTIVE_SORT_MIN_GALLOP && kb < UPO_ADAPTIVE_SORT_MIN_GALLOP)
+            {
+                ++min_gallop;
+                break;
+            }
+        }
+    }
+
+    // The rest of b, if any, is already in place
+    UPO_SORT_COPY(dest, pa, na * size);
+    ms->min_gallop = min_gallop;
+}
+
+void upo_adaptive_sort_merge_hi(struct upo_adaptive_sort_s *ms, unsigned char *a, size_t na, unsigned char *b, size_t nb)
+{
+    size_t size = ms->size;
+    upo_sort_comparator_r_t cmp = ms->cmp;
+    void *ctx = ms->ctx;
+    size_t min_gallop = ms->min_gallop;
+    unsigned char *tmp = ms->tmp;
+
+    // Merges from right to left, with b moved to the temporary array.
+    // The elements still to merge are a[0..na-1] and tmp[0..nb-1], and the
+    // next output position is na+nb-1 (counting from a).
+    // On entry the last of a is greater than the last of b, so it comes last.
+    UPO_SORT_COPY(tmp, b, nb * size);
+    UPO_SORT_COPY(a + (na + nb - 1) * size, a + (na - 1) * size, size);
+    --na;
+
+    while (na > 0 && nb > 0)
+    {
+        size_t count_a = 0;
+        size_t count_b = 0;
+
+        // Compares one pair at a time until a run wins min_gallop times in a row
+        while (na > 0 && nb > 0 && count_a < min_gallop && count_b < min_gallop)
+        {
+            if (UPO_SORT_CMP(cmp, tmp + (nb - 1) * size, a + (na - 1) * size, ctx) < 0)
+            {
+                UPO_SORT_COPY(a + (na + nb - 1) * size, a + (na - 1) * size, size);
+                --na;
+                ++count_a;
+                count_b = 0;
+            }
+            else
+            {
+                UPO_SORT_COPY(a + (na + nb - 1) * size, tmp + (nb - 1) * size, size);
+                --nb;
+                ++count_b;
+                count_a = 0;
+            }
+        }
+
+        // Galloping mode: looks for the end of the winning streaks by exponential search
+        while (na > 0 && nb > 0)
+        {
+            size_t ka;
+            size_t kb;
+
+            ka = na - upo_adaptive_sort_gallop(tmp + (nb - 1) * size, a, na, 1, 1, size, cmp, ctx);
+            UPO_SORT_MOVE(a + (na + nb - ka) * size, a + (na - ka) * size, ka * size);
+            na -= ka;
+            if (na == 0)
+            {
+                break;
+            }
+            UPO_SORT_COPY(a + (na + nb - 1) * size, tmp + (nb - 1) * size, size);
+            --nb;
+            if (nb == 0)
+            {
+                break;
+            }
+
+            kb = nb - upo_adaptive_sort_gallop(a + (na - 1) * size, tmp, nb, 0, 1, size, cmp, ctx);
+            UPO_SORT_COPY(a + (na + nb - kb) * size, tmp + (nb - kb) * size, kb * size);
+            nb -= kb;
+            if (nb == 0)
+            {
+                break;
+            }
+            UPO_SORT_COPY(a + (na + nb - 1) * size, a + (na - 1) * size, size);
+            --na;
+
+            // Galloping pays off, so it is entered more easily next time
+            if (min_gallop > 1)
+            {
+                --min_gallop;
+            }
+            if (ka < UPO_ADAPTIVE_SORT_MIN_GALLOP && kb < UPO_ADAPTIVE_SORT_MIN_GALLOP)
+            {
+                ++min_gallop;
+                break;
+            }
+        }
+    }
+
+    // The rest of a, if any, is already in place
+    UPO_SORT_COPY(a, tmp, nb * size);
+    ms->min_gallop = min_gallop;
+}
+
+void upo_quick_sort(void *base, size_t n, size_t size, upo_sort_comparator_t cmp)
+{
+    upo_quick_sort_r(base, n, size, upo_sort_comparator_adapter, &cmp);
+}
+
+void upo_quick_sort_r(void *base, size_t n, size_t size, upo_sort_comparator_r_t cmp, void *ctx)
+{
+    if (n < 2)
     {
-        upo_insertion_sort((unsigned char *)base + lo * size, hi - lo + 1, size, cmp);
         return;
     }
+    upo_quick_sort_rec(base, 0, n - 1, size, cmp, ctx);
+}
 
-    size_t j = upo_quick_sort_median3_partition(base, lo, hi, size, cmp);
+void upo_quick_sort_rec(void *base, size_t lo, size_t hi, size_t size, upo_sort_comparator_r_t cmp, void *ctx)
+{
+    if (lo >= hi)
+        return;
+    UPO_SORT_STATS_ENTER();
+    size_t j = upo_quick_sort_partition(base, lo, hi, size, cmp, ctx);
     if (j > 0)
-        upo_quick_sort_median3_cutoff_driver_topdown(base, lo, j - 1, size, cmp);
-    upo_quick_sort_median3_cutoff_driver_topdown(base, j + 1, hi, size, cmp);
-    /* Partitions the whole array */
-    pivot = upo_quick_sort_median3_partition(base, lo, hi, size, cmp);
-    /* Sorts left half */
-    if (pivot > 0)
+        upo_quick_sort_rec(base, lo, j - 1, size, cmp, ctx);
+    upo_quick_sort_rec(base, j + 1, hi, size, cmp, ctx);
+    UPO_SORT_STATS_LEAVE();
+}
+
+void upo_quick_sort_3way(void *base, size_t n, size_t size, upo_sort_comparator_t cmp)
+{
+    upo_quick_sort_3way_r(base, n, size, upo_sort_comparator_adapter, &cmp);
+}
+
+void upo_quick_sort_3way_r(void *base, size_t n, size_t size, upo_sort_comparator_r_t cmp, void *ctx)
+{
+    assert(base != NULL);
+    assert(size > 0);
+    assert(cmp != NULL);
+
+    if (n < 2)
+    {
+        return;
+    }
+    upo_quick_sort_3way_rec(base, 0, n - 1, size, cmp, ctx);
+}
+
+void upo_quick_sort_3way_rec(void *base, size_t lo, size_t hi, size_t size, upo_sort_comparator_r_t cmp, void *ctx)
+{
+    unsigned char *ptr = base;
+
+    UPO_SORT_STATS_ENTER();
+
+    while (lo < hi && (hi - lo + 1) > UPO_QUICK_SORT_CUTOFF)
+    {
+        unsigned char *pivot_ptr = ptr + lo * size;
+        size_t i = lo;
+        size_t j = hi + 1;
+        size_t p = lo;
+        size_t q = hi + 1;
+        size_t num_less;
+        size_t num_greater;
+        size_t k;
+        size_t m;
+
+        UPO_SORT_SWAP(pivot_ptr, ptr + upo_sort_median3(base, lo, lo + (hi - lo) / 2, hi, size, cmp, ctx) * size, size);
+
+        /* Partitions base[lo+1..hi], moving the keys equal to the pivot to the
+         * ends: base[lo..p] == pivot, base[p+1..i-1] < pivot,
+         * base[j+1..q-1] > pivot and base[q..hi] == pivot. */
+        while (1)
+        {
+            while (UPO_SORT_CMP(cmp, ptr + (++i) * size, pivot_ptr, ctx) < 0)
+            {
+                if (i == hi)
+                {
+                    break;
+                }
+            }
+            while (UPO_SORT_CMP(cmp, pivot_ptr, ptr + (--j) * size, ctx) < 0)
+            {
+                if (j == lo)
+                {
+                    break;
+                }
+            }
+            if (i == j && UPO_SORT_CMP(cmp, ptr + i * size, pivot_ptr, ctx) == 0)
+            {
+                UPO_SORT_SWAP(ptr + (++p) * size, ptr + i * size, size);
+            }
+            if (i >= j)
+            {
+                break;
+            }
+            UPO_SORT_SWAP(ptr + i * size, ptr + j * size, size);
+            if (UPO_SORT_CMP(cmp, ptr + i * size, pivot_ptr, ctx) == 0)
+            {
+                UPO_SORT_SWAP(ptr + (++p) * size, ptr + i * size, size);
+            }
+            if (UPO_SORT_CMP(cmp, ptr + j * size, pivot_ptr, ctx) == 0)
+            {
+                UPO_SORT_SWAP(ptr + (--q) * size, ptr + j * size, size);
+            }
+        }
+        num_less = j - p;
+        num_greater = q - j - 1;
+
+        /* Moves the keys equal to the pivot from the ends to the middle */
+        for (k = lo, m = j; k <= p; ++k, --m)
+        {
+            UPO_SORT_SWAP(ptr + k * size, ptr + m * size, size);
+        }
+        for (k = hi, m = j + 1; k >= q; --k, ++m)
+        {
+            UPO_SORT_SWAP(ptr + k * size, ptr + m * size, size);
+        }
+
+        /* Keys equal to the pivot are now in their final place */
+        if (num_less < num_greater)
+        {
+            if (num_less > 1)
+            {
+                upo_quick_sort_3way_rec(base, lo, lo + num_less - 1, size, cmp, ctx);
+            }
+            lo = hi - num_greater + 1;
+        }
+        else
+        {
+            if (num_greater > 1)
+            {
+                upo_quick_sort_3way_rec(base, hi - num_greater + 1, hi, size, cmp, ctx);
+            }
+            if (num_less == 0)
+            {
+                UPO_SORT_STATS_LEAVE();
+                return;
+            }
+            hi = lo + num_less - 1;
+        }
+    }
+    if (lo < hi)
+    {
+        upo_insertion_sort_r(ptr + lo * size, hi - lo + 1, size, cmp, ctx);
+    }
+    UPO_SORT_STATS_LEAVE();
+}
+
+void upo_intro_sort(void *base, size_t n, size_t size, upo_sort_comparator_t cmp)
+{
+    upo_intro_sort_r(base, n, size, upo_sort_comparator_adapter, &cmp);
+}
+
+void upo_intro_sort_r(void *base, size_t n, size_t size, upo_sort_comparator_r_t cmp, void *ctx)
+{
+    size_t depth = 0;
+    size_t m;
+
+    assert(base != NULL);
+    assert(size > 0);
+    assert(cmp != NULL);
+
+    if (n < 2)
+    {
+        return;
+    }
+    /* The depth limit is 2*floor(log2(n)) */
+    for (m = n; m > 1; m /= 2)
+    {
+        depth += 2;
+    }
+    upo_intro_sort_rec(base, 0, n - 1, depth, size, cmp, ctx);
+}
+
+void upo_heap_sort(void *base, size_t n, size_t size, upo_sort_comparator_t cmp)
+{
+    upo_heap_sort_r(base, n, size, upo_sort_comparator_adapter, &cmp);
+}
+
+void upo_heap_sort_r(void *base, size_t n, size_t size, upo_sort_comparator_r_t cmp, void *ctx)
+{
+    assert(base != NULL);
+    assert(size > 0);
+    assert(cmp != NULL);
+
+    upo_heap_sort_range(base, n, size, cmp, ctx);
+}
+
+void upo_intro_sort_rec(void *base, size_t lo, size_t hi, size_t depth, size_t size, upo_sort_comparator_r_t cmp, void *ctx)
+{
+    unsigned char *ptr = base;
+
+    UPO_SORT_STATS_ENTER();
+
+    while (hi - lo + 1 > UPO_INTRO_SORT_CUTOFF)
+    {
+        size_t n = hi - lo + 1;
+        size_t pivot;
+        size_t j;
+
+        if (depth == 0)
+        {
+            /* Too many unbalanced partitions: falls back to heap sort */
+            upo_heap_sort_range(ptr + lo * size, n, size, cmp, ctx);
+            UPO_SORT_STATS_LEAVE();
+            return;
+        }
+        --depth;
+
+        /* Moves the pivot to position lo, as expected by the partition */
+        pivot = upo_intro_sort_pivot(base, lo, hi, size, cmp, ctx);
+        UPO_SORT_SWAP(ptr + lo * size, ptr + pivot * size, size);
+
+        j = upo_quick_sort_partition(base, lo, hi, size, cmp, ctx);
+
+        /* Recurses on the smaller part and iterates on the larger one */
+        if (j - lo < hi - j)
+        {
+            if (j > lo)
+            {
+                upo_intro_sort_rec(base, lo, j - 1, depth, size, cmp, ctx);
+            }
+            lo = j + 1;
+        }
+        else
+        {
+            if (j < hi)
+            {
+                upo_intro_sort_rec(base, j + 1, hi, depth, size, cmp, ctx);
+            }
+            hi = j - 1;
+        }
+    }
+    if (lo < hi)
+    {
+        upo_insertion_sort_r(ptr + lo * size, hi - lo + 1, size, cmp, ctx);
+    }
+    UPO_SORT_STATS_LEAVE();
+}
+
+size_t upo_intro_sort_pivot(const void *base, size_t lo, size_t hi, size_t size, upo_sort_comparator_r_t cmp, void *ctx)
+{
+    size_t n = hi - lo + 1;
+    size_t mid = lo + (hi - lo) / 2;
+
+    if (n > UPO_INTRO_SORT_NINTHER_THRESHOLD)
+    {
+        size_t s = n / 8;
+
+        return upo_sort_median3(base,
+                                upo_sort_median3(base, lo, lo + s, lo + 2 * s, size, cmp, ctx),
+                                upo_sort_median3(base, mid - s, mid, mid + s, size, cmp, ctx),
+                                upo_sort_median3(base, hi - 2 * s, hi - s, hi, size, cmp, ctx),
+                                size,
+                                cmp, ctx);
+    }
+    return upo_sort_median3(base, lo, mid, hi, size, cmp, ctx);
+}
+
+void upo_parallel_quick_sort(void *base, size_t n, size_t size, upo_sort_comparator_t cmp, size_t nthreads)
+{
+    upo_parallel_quick_sort_r(base, n, size, upo_sort_comparator_adapter, &cmp, nthreads);
+}
+
+void upo_parallel_quick_sort_r(void *base, size_t n, size_t size, upo_sort_comparator_r_t cmp, void *ctx, size_t nthreads)
+{
+    upo_task_pool_t pool = NULL;
+    size_t depth = 0;
+    size_t m;
+
+    assert(base != NULL);
+    assert(size > 0);
+    assert(cmp != NULL);
+
+    if (n <= UPO_PARALLEL_QUICK_SORT_GRAIN || nthreads == 1)
+    {
+        upo_intro_sort_r(base, n, size, cmp, ctx);
+        return;
+    }
+    /* Same depth limit of introsort, which is shared by the tasks along each path */
+    for (m = n; m > 1; m /= 2)
+    {
+        depth += 2;
+    }
+    pool = upo_task_pool_create(nthreads);
+    upo_parallel_quick_sort_spawn(pool, base, 0, n - 1, depth, size, cmp, ctx);
+    upo_task_pool_wait(pool);
+    upo_task_pool_destroy(pool);
+}
+
+void upo_parallel_quick_sort_spawn(upo_task_pool_t pool, unsigned char *base, size_t lo, size_t hi, size_t depth, size_t size, upo_sort_comparator_r_t cmp, void *ctx)
+{
+    struct upo_parallel_quick_sort_task_s *task = UPO_SORT_MALLOC(sizeof(struct upo_parallel_quick_sort_task_s));
+
+    if (task == NULL)
+    {
+        perror("Unable to allocate memory for a task of parallel quick sort");
+        abort();
+    }
+    task->base = base;
+    task->lo = lo;
+    task->hi = hi;
+    task->depth = depth;
+    task->size = size;
+    task->cmp = cmp;
+    task->ctx = ctx;
+    upo_task_spawn(pool, upo_parallel_quick_sort_task, task);
+}
+
+void upo_parallel_quick_sort_task(upo_task_pool_t pool, void *arg)
+{
+    struct upo_parallel_quick_sort_task_s task = *(struct upo_parallel_quick_sort_task_s *) arg;
+    size_t pivot;
+    size_t j;
+
+    free(arg);
+
+    if (task.hi - task.lo + 1 <= UPO_PARALLEL_QUICK_SORT_GRAIN || task.depth == 0)
+    {
+        upo_intro_sort_rec(task.base, task.lo, task.hi, task.depth, task.size, task.cmp, task.ctx);
+        return;
+    }
+
+    pivot = upo_intro_sort_pivot(task.base, task.lo, task.hi, task.size, task.cmp, task.ctx);
+    UPO_SORT_SWAP(task.base + task.lo * task.size, task.base + pivot * task.size, task.size);
+    j = upo_quick_sort_partition(task.base, task.lo, task.hi, task.size, task.cmp, task.ctx);
+
+    /* Spawns the larger part first: the spawning thread takes back the
+     * smaller one, while idle threads steal the larger one */
+    if (j - task.lo >= task.hi - j)
+    {
+        if (j > task.lo)
+        {
+            upo_parallel_quick_sort_spawn(pool, task.base, task.lo, j - 1, task.depth - 1, task.size, task.cmp, task.ctx);
+        }
+        if (j < task.hi)
+        {
+            upo_parallel_quick_sort_spawn(pool, task.base, j + 1, task.hi, task.depth - 1, task.size, task.cmp, task.ctx);
+        }
+    }
+    else
+    {
+        upo_parallel_quick_sort_spawn(pool, task.base, j + 1, task.hi, task.depth - 1, task.size, task.cmp, task.ctx);
+        if (j > task.lo)
+        {
+            upo_parallel_quick_sort_spawn(pool, task.base, task.lo, j - 1, task.depth - 1, task.size, task.cmp, task.ctx);
+        }
+    }
+}
+
+void upo_select_nth(void *base, size_t n, size_t size, upo_sort_comparator_t cmp, size_t k)
+{
+    upo_select_nth_r(base, n, size, upo_sort_comparator_adapter, &cmp, k);
+}
+
+void upo_select_nth_r(void *base, size_t n, size_t size, upo_sort_comparator_r_t cmp, void *ctx, size_t k)
+{
+    unsigned char *ptr = base;
+    size_t lo = 0;
+    size_t hi = n - 1;
+    size_t depth = 0;
+    size_t m;
+
+    assert(base != NULL);
+    assert(k < n);
+    assert(size > 0);
+    assert(cmp != NULL);
+
+    /* Same depth limit as intro sort */
+    for (m = n; m > 1; m /= 2)
+    {
+        depth += 2;
+    }
+    /* Partitions as intro sort does, but only goes on with the part holding k */
+    while (hi - lo + 1 > UPO_INTRO_SORT_CUTOFF)
+    {
+        size_t pivot;
+        size_t j;
+
+        if (depth == 0)
+        {
+            /* Too many unbalanced partitions: sorts what is left */
+            upo_heap_sort_range(ptr + lo * size, hi - lo + 1, size, cmp, ctx);
+            return;
+        }
+        --depth;
+
+        pivot = upo_intro_sort_pivot(base, lo, hi, size, cmp, ctx);
+        UPO_SORT_SWAP(ptr + lo * size, ptr + pivot * size, size);
+        j = upo_quick_sort_partition(base, lo, hi, size, cmp, ctx);
+        if (j == k)
+        {
+            return;
+        }
+        if (k < j)
+        {
+            hi = j - 1;
+        }
+        else
+        {
+            lo = j + 1;
+        }
+    }
+    if (lo < hi)
+    {
+        upo_insertion_sort_r(ptr + lo * size, hi - lo + 1, size, cmp, ctx);
+    }
+}
+
+void upo_partial_sort(void *base, size_t n, size_t size, upo_sort_comparator_t cmp, size_t k)
+{
+    upo_partial_sort_r(base, n, size, upo_sort_comparator_adapter, &cmp, k);
+}
+
+void upo_partial_sort_r(void *base, size_t n, size_t size, upo_sort_comparator_r_t cmp, void *ctx, size_t k)
+{
+    assert(base != NULL);
+    assert(size > 0);
+    assert(cmp != NULL);
+
+    if (k >= n)
+    {
+        upo_intro_sort_r(base, n, size, cmp, ctx);
+        return;
+    }
+    if (k == 0)
+    {
+        return;
+    }
+    /* The k-th smallest element goes to position k-1, the smaller ones before it */
+    upo_select_nth_r(base, n, size, cmp, ctx, k - 1);
+    upo_intro_sort_r(base, k - 1, size, cmp, ctx);
+}
+
+upo_top_k_t upo_top_k_create(size_t k, size_t size, upo_sort_comparator_t cmp)
+{
+    upo_top_k_t top = upo_top_k_create_r(k, size, upo_sort_comparator_adapter, NULL);
+
+    /* The adapter reads the comparison function from the structure itself */
+    top->plain_cmp = cmp;
+    top->ctx = &top->plain_cmp;
+
+    return top;
+}
+
+upo_top_k_t upo_top_k_create_r(size_t k, size_t size, upo_sort_comparator_r_t cmp, void *ctx)
+{
+    upo_top_k_t top = NULL;
+
+    assert(k > 0);
+    assert(size > 0);
+    assert(cmp != NULL);
+
+    top = UPO_SORT_MALLOC(sizeof(struct upo_top_k_s));
+    if (top == NULL)
+    {
+        perror("Unable to allocate memory for top-k selection");
+        abort();
+    }
+    top->heap = UPO_SORT_MALLOC(k * size);
+    if (top->heap == NULL)
+    {
+        perror("Unable to allocate memory for the heap of top-k selection");
+        abort();
+    }
+    top->k = k;
+    top->n = 0;
+    top->size = size;
+    top->cmp = cmp;
+    top->ctx = ctx;
+    top->plain_cmp = NULL;
+
+    return top;
+}
+
+void upo_top_k_destroy(upo_top_k_t top)
+{
+    if (top != NULL)
+    {
+        free(top->heap);
+        free(top);
+    }
+}
+
+void upo_top_k_push(upo_top_k_t top, const void *elem)
+{
+    assert(top != NULL);
+    assert(elem != NULL);
+
+    if (top->n < top->k)
+    {
+        UPO_SORT_COPY(top->heap + top->n * top->size, elem, top->size);
+        upo_top_k_sift_up(top, top->n);
+        ++top->n;
+    }
+    else if (UPO_SORT_CMP(top->cmp, elem, top->heap, top->ctx) < 0)
+    {
+        /* Replaces the largest element kept so far */
+        UPO_SORT_COPY(top->heap, elem, top->size);
+        upo_heap_sort_sift_down(top->heap, 0, top->n, top->size, top->cmp, top->ctx);
+    }
+}
+
+void upo_top_k_push_array(upo_top_k_t top, const void *base, size_t n)
+{
+    const unsigned char *ptr = base;
+    size_t i;
+
+    assert(top != NULL);
+    assert(base != NULL || n == 0);
+
+    for (i = 0; i < n; ++i)
+    {
+        upo_top_k_push(top, ptr + i * top->size);
+    }
+}
+
+size_t upo_top_k_size(const upo_top_k_t top)
+{
+    assert(top != NULL);
+
+    return top->n;
+}
+
+size_t upo_top_k_get(const upo_top_k_t top, void *out)
+{
+    assert(top != NULL);
+    assert(out != NULL);
+
+    UPO_SORT_COPY(out, top->heap, top->n * top->size);
+    upo_heap_sort_range(out, top->n, top->size, top->cmp, top->ctx);
+
+    return top->n;
+}
+
+void upo_top_k_clear(upo_top_k_t top)
+{
+    assert(top != NULL);
+
+    top->n = 0;
+}
+
+void upo_top_k_sift_up(upo_top_k_t top, size_t i)
+{
+    while (i > 0)
+    {
+        size_t parent = (i - 1) / 2;
+
+        if (UPO_SORT_CMP(top->cmp, top->heap + parent * top->size, top->heap + i * top->size, top->ctx) >= 0)
+        {
+            break;
+        }
+        UPO_SORT_SWAP(top->heap + parent * top->size, top->heap + i * top->size, top->size);
+        i = parent;
+    }
+}
+
+size_t upo_sort_median3(const void *base, size_t i, size_t j, size_t k, size_t size, upo_sort_comparator_r_t cmp, void *ctx)
+{
+    const unsigned char *ptr = base;
+    const unsigned char *a = ptr + i * size;
+    const unsigned char *b = ptr + j * size;
+    const unsigned char *c = ptr + k * size;
+
+    if (UPO_SORT_CMP(cmp, a, b, ctx) < 0)
+    {
+        if (UPO_SORT_CMP(cmp, b, c, ctx) < 0)
+        {
+            return j;
+        }
+        return (UPO_SORT_CMP(cmp, a, c, ctx) < 0) ? k : i;
+    }
+    if (UPO_SORT_CMP(cmp, a, c, ctx) < 0)
+    {
+        return i;
+    }
+    return (UPO_SORT_CMP(cmp, b, c, ctx) < 0) ? k : j;
+}
+
+void upo_heap_sort_range(void *base, size_t n, size_t size, upo_sort_comparator_r_t cmp, void *ctx)
+{
+    unsigned char *ptr = base;
+    size_t i;
+
+    /* Builds a max-heap in place */
+    for (i = n / 2; i > 0; --i)
+    {
+        upo_heap_sort_sift_down(base, i - 1, n, size, cmp, ctx);
+    }
+    /* Repeatedly moves the maximum past the end of the heap */
+    for (i = n; i > 1; --i)
+    {
+        UPO_SORT_SWAP(ptr, ptr + (i - 1) * size, size);
+        upo_heap_sort_sift_down(base, 0, i - 1, size, cmp, ctx);
+    }
+}
+
+void upo_heap_sort_sift_down(void *base, size_t i, size_t n, size_t size, upo_sort_comparator_r_t cmp, void *ctx)
+{
+    unsigned char *ptr = base;
+
+    while (2 * i + 1 < n)
+    {
+        size_t child = 2 * i + 1;
+
+        if (child + 1 < n && UPO_SORT_CMP(cmp, ptr + child * size, ptr + (child + 1) * size, ctx) < 0)
+        {
+            ++child;
+        }
+        if (UPO_SORT_CMP(cmp, ptr + i * size, ptr + child * size, ctx) >= 0)
+        {
+            break;
+        }
+        UPO_SORT_SWAP(ptr + i * size, ptr + child * size, size);
+        i = child;
+    }
+}
+
+void upo_radix_sort_u32(uint32_t *base, size_t n)
+{
+    assert(base != NULL);
+
+    upo_radix_sort_lsd(base, NULL, n, 0);
+}
+
+void upo_radix_sort_by_key(void *base, size_t n, size_t size, upo_sort_u32_key_t key)
+{
+    unsigned char *ptr = base;
+    uint32_t *keys = NULL;
+    size_t i;
+
+    assert(base != NULL);
+    assert(size > 0);
+    assert(key != NULL);
+
+    if (n < 2)
+    {
+        return;
+    }
+    keys = UPO_SORT_MALLOC(n * sizeof(uint32_t));
+    if (keys == NULL)
+    {
+        perror("Unable to allocate memory for the keys");
+        abort();
+    }
+    for (i = 0; i < n; ++i)
+    {
+        keys[i] = key(ptr + i * size);
+    }
+    upo_radix_sort_lsd(keys, base, n, size);
+    free(keys);
+}
+
+void upo_radix_sort_lsd(uint32_t *keys, void *base, size_t n, size_t size)
+{
+    size_t count[sizeof(uint32_t)][256];
+    uint32_t *key_aux = NULL;
+    unsigned char *aux = NULL;
+    uint32_t *key_src = keys;
+    uint32_t *key_dst = NULL;
+    unsigned char *src = base;
+    unsigned char *dst = NULL;
+    size_t d;
+    size_t i;
+
+    /* Elements (if any) are moved together with their keys */
+    if (n < 2)
+    {
+        return;
+    }
+    key_aux = UPO_SORT_MALLOC(n * sizeof(uint32_t));
+    if (key_aux == NULL)
+    {
+        perror("Unable to allocate memory for auxiliary vector");
+        abort();
+    }
+    if (base != NULL)
+    {
+        aux = UPO_SORT_MALLOC(n * size);
+        if (aux == NULL)
+        {
+            perror("Unable to allocate memory for auxiliary vector");
+            abort();
+        }
+    }
+    key_dst = key_aux;
+    dst = aux;
+
+    /* Computes the histograms of all digits at once */
+    memset(count, 0, sizeof count);
+    for (i = 0; i < n; ++i)
+    {
+        for (d = 0; d < sizeof(uint32_t); ++d)
+        {
+            ++count[d][(keys[i] >> (8 * d)) & 0xFF];
+        }
+    }
+
+    for (d = 0; d < sizeof(uint32_t); ++d)
+    {
+        size_t shift = 8 * d;
+        size_t pos = 0;
+        size_t c;
+        void *tmp;
+
+        /* All keys have the same digit: nothing to do */
+        if (count[d][(key_src[0] >> shift) & 0xFF] == n)
+        {
+            continue;
+        }
+        /* Turns the counts into the starting position of each digit */
+        for (c = 0; c < 256; ++c)
+        {
+            size_t cnt = count[d][c];
+            count[d][c] = pos;
+            pos += cnt;
+        }
+        for (i = 0; i < n; ++i)
+        {
+            size_t j = count[d][(key_src[i] >> shift) & 0xFF]++;
+
+            key_dst[j] = key_src[i];
+            if (src != NULL)
+            {
+                UPO_SORT_COPY(dst + j * size, src + i * size, size);
+            }
+        }
+        tmp = key_src;
+        key_src = key_dst;
+        key_dst = tmp;
+        tmp = src;
+        src = dst;
+        dst = tmp;
+    }
+
+    if (key_src != keys)
+    {
+        UPO_SORT_COPY(keys, key_src, n * sizeof(uint32_t));
+        if (src != NULL)
+        {
+            UPO_SORT_COPY(base, src, n * size);
+        }
+    }
+    free(aux);
+    free(key_aux);
+}
+
+void upo_radix_sort_str(void *base, size_t n, size_t size, upo_sort_str_key_t key)
+{
+    void *aux = NULL;
+
+    assert(base != NULL);
+    assert(size > 0);
+    assert(key != NULL);
+
+    if (n < 2)
+    {
+        return;
+    }
+    aux = UPO_SORT_MALLOC(n * size);
+    if (aux == NULL)
+    {
+        perror("Unable to allocate memory for auxiliary vector");
+        abort();
+    }
+    upo_radix_sort_str_rec(base, aux, 0, n, 0, size, key);
+    free(aux);
+}
+
+void upo_radix_sort_str_rec(void *base, void *aux, size_t lo, size_t hi, size_t depth, size_t size, upo_sort_str_key_t key)
+{
+    unsigned char *ptr = base;
+    unsigned char *aux_ptr = aux;
+    size_t count[256 + 1];
+    size_t i;
+    size_t c;
+
+    UPO_SORT_STATS_ENTER();
+
+    /* Sorts base[lo..hi-1], whose keys share the first depth characters */
+    if (hi - lo <= UPO_RADIX_SORT_STR_CUTOFF)
+    {
+        for (i = lo + 1; i < hi; ++i)
+        {
+            size_t j = i;
+
+            while (j > lo && strcmp(key(ptr + j * size) + depth, key(ptr + (j - 1) * size) + depth) < 0)
+            {
+                UPO_SORT_SWAP(ptr + j * size, ptr + (j - 1) * size, size);
+                --j;
+            }
+        }
+        UPO_SORT_STATS_LEAVE();
+        return;
+    }
+
+    /* Counting sort on the character at the given depth ('\0' comes first) */
+    memset(count, 0, sizeof count);
+    for (i = lo; i < hi; ++i)
+    {
+        ++count[(unsigned char) key(ptr + i * size)[depth] + 1];
+    }
+    for (c = 1; c <= 256; ++c)
+    {
+        count[c] += count[c - 1];
+    }
+    for (i = lo; i < hi; ++i)
+    {
+        size_t j = lo + count[(unsigned char) key(ptr + i * size)[depth]]++;
+
+        UPO_SORT_COPY(aux_ptr + j * size, ptr + i * size, size);
+    }
+    UPO_SORT_COPY(ptr + lo * size, aux_ptr + lo * size, (hi - lo) * size);
+
+    /* Now count[c] is the end of the group of character c.
+     * Keys in the group of '\0' are equal, the other groups go one level down. */
+    for (c = 1; c < 256; ++c)
+    {
+        if (count[c] - count[c - 1] > 1)
+        {
+            upo_radix_sort_str_rec(base, aux, lo + count[c - 1], lo + count[c], depth + 1, size, key);
+        }
+    }
+    UPO_SORT_STATS_LEAVE();
+}
+
+void upo_sort_indirect(void *base, size_t n, size_t size, upo_sort_comparator_t cmp, upo_sort_u32_key_t prefix)
+{
+    upo_sort_indirect_r(base, n, size, upo_sort_comparator_adapter, &cmp, prefix);
+}
+
+void upo_sort_indirect_r(void *base, size_t n, size_t size, upo_sort_comparator_r_t cmp, void *ctx, upo_sort_u32_key_t prefix)
+{
+    size_t *perm = NULL;
+
+    assert(base != NULL);
+    assert(size > 0);
+    assert(cmp != NULL);
+
+    if (n < 2)
+    {
+        return;
+    }
+    perm = UPO_SORT_MALLOC(n * sizeof(size_t));
+    if (perm == NULL)
+    {
+        perror("Unable to allocate memory for permutation");
+        abort();
+    }
+    upo_sort_permutation_r(base, n, size, cmp, ctx, prefix, perm);
+    upo_sort_apply_permutation(base, n, size, perm);
+    free(perm);
+}
+
+void upo_sort_permutation(const void *base, size_t n, size_t size, upo_sort_comparator_t cmp, upo_sort_u32_key_t prefix, size_t *perm)
+{
+    upo_sort_permutation_r(base, n, size, upo_sort_comparator_adapter, &cmp, prefix, perm);
+}
+
+void upo_sort_permutation_r(const void *base, size_t n, size_t size, upo_sort_comparator_r_t cmp, void *ctx, upo_sort_u32_key_t prefix, size_t *perm)
+{
+    const unsigned char *ptr = base;
+    struct upo_sort_indirect_item_s *items = NULL;
+    struct upo_sort_indirect_item_s *aux = NULL;
+    size_t i;
+
+    assert(base != NULL);
+    assert(size > 0);
+    assert(cmp != NULL);
+    assert(perm != NULL);
+
+    if (n == 0)
+    {
+        return;
+    }
+    items = UPO_SORT_MALLOC(2 * n * sizeof(struct upo_sort_indirect_item_s));
+    if (items == NULL)
+    {
+        perror("Unable to allocate memory for auxiliary vector");
+        abort();
+    }
+    aux = items + n;
+    for (i = 0; i < n; ++i)
+    {
+        items[i].prefix = (prefix != NULL) ? prefix(ptr + i * size) : 0;
+        items[i].ptr = ptr + i * size;
+    }
+    UPO_SORT_COPY(aux, items, n * sizeof(struct upo_sort_indirect_item_s));
+    // Sorts the (prefix, pointer) pairs: only 16 bytes are moved per element
+    // whatever its size, and equal prefixes are the only ones that need cmp
+    upo_sort_indirect_merge_rec(aux, items, 0, n, cmp, ctx);
+    for (i = 0; i < n; ++i)
+    {
+        perm[i] = (size_t) (items[i].ptr - ptr) / size;
+    }
+    free(items);
+}
+
+void upo_sort_apply_permutation(void *base, size_t n, size_t size, size_t *perm)
+{
+    unsigned char *ptr = base;
+    unsigned char *tmp = NULL;
+    size_t i;
+
+    assert(base != NULL);
+    assert(size > 0);
+    assert(perm != NULL);
+
+    tmp = UPO_SORT_MALLOC(size);
+    if (tmp == NULL)
+    {
+        perror("Unable to allocate memory for auxiliary element");
+        abort();
+    }
+    // Follows each cycle of the permutation, moving every element once; the
+    // visited positions are marked as fixed points, so perm ends up being
+    // the identity
+    for (i = 0; i < n; ++i)
+    {
+        size_t j = i;
+
+        if (perm[i] == i)
+        {
+            continue;
+        }
+        UPO_SORT_COPY(tmp, ptr + i * size, size);
+        while (perm[j] != i)
+        {
+            size_t k = perm[j];
+
+            assert(k < n);
+            UPO_SORT_COPY(ptr + j * size, ptr + k * size, size);
+            perm[j] = j;
+            j = k;
+        }
+        UPO_SORT_COPY(ptr + j * size, tmp, size);
+        perm[j] = j;
+    }
+    free(tmp);
+}
+
+void upo_sort_indirect_merge_rec(struct upo_sort_indirect_item_s *src, struct upo_sort_indirect_item_s *dst, size_t lo, size_t hi, upo_sort_comparator_r_t cmp, void *ctx)
+{
+    size_t mid;
+    size_t i;
+    size_t j;
+    size_t k;
+
+    UPO_SORT_STATS_ENTER();
+
+    // Sorts src[lo..hi-1] into dst[lo..hi-1]; both arrays hold the same
+    // elements on entry
+    if (hi - lo <= UPO_SORT_INDIRECT_CUTOFF)
+    {
+        for (i = lo + 1; i < hi; ++i)
+        {
+            struct upo_sort_indirect_item_s item = dst[i];
+
+            for (j = i; j > lo && upo_sort_indirect_less(&item, &dst[j - 1], cmp, ctx); --j)
+            {
+                dst[j] = dst[j - 1];
+            }
+            dst[j] = item;
+        }
+        UPO_SORT_STATS_LEAVE();
+        return;
+    }
+    mid = lo + (hi - lo) / 2;
+    upo_sort_indirect_merge_rec(dst, src, lo, mid, cmp, ctx);
+    upo_sort_indirect_merge_rec(dst, src, mid, hi, cmp, ctx);
+    i = lo;
+    j = mid;
+    for (k = lo; k < hi; ++k)
+    {
+        if (i < mid && (j >= hi || !upo_sort_indirect_less(&src[j], &src[i], cmp, ctx)))
+        {
+            dst[k] = src[i++];
+        }
+        else
+        {
+            dst[k] = src[j++];
+        }
+    }
+    UPO_SORT_STATS_LEAVE();
+}
+
+int upo_sort_indirect_less(const struct upo_sort_indirect_item_s *a, const struct upo_sort_indirect_item_s *b, upo_sort_comparator_r_t cmp, void *ctx)
+{
+    if (a->prefix != b->prefix)
+    {
+        return a->prefix < b->prefix;
+    }
+    return UPO_SORT_CMP(cmp, a->ptr, b->ptr, ctx) < 0;
+}
+
+void upo_sort_by_key_r(void *base, size_t n, size_t size, size_t key_size, upo_sort_key_r_t key, upo_sort_comparator_r_t cmp, void *ctx)
+{
+    unsigned char *ptr = base;
+    struct upo_sort_by_key_s bk;
+    struct upo_sort_by_key_item_s *items = NULL;
+    struct upo_sort_by_key_item_s *aux = NULL;
+    size_t *perm = NULL;
+    size_t i;
+
+    assert(base != NULL);
+    assert(size > 0);
+    assert(key_size > 0);
+    assert(key != NULL);
+
+    if (n < 2)
+    {
+        return;
+    }
+    bk.base = base;
+    bk.size = size;
+    bk.key_size = key_size;
+    bk.cmp = cmp;
+    bk.ctx = ctx;
+    bk.keys = UPO_SORT_MALLOC(n * key_size);
+    items = UPO_SORT_MALLOC(2 * n * sizeof(struct upo_sort_by_key_item_s));
+    perm = UPO_SORT_MALLOC(n * sizeof(size_t));
+    if (bk.keys == NULL || items == NULL || perm == NULL)
+    {
+        perror("Unable to allocate memory for sort keys");
+        abort();
+    }
+    aux = items + n;
+    for (i = 0; i < n; ++i)
+    {
+        unsigned char *k = bk.keys + i * key_size;
+        size_t j;
+
+        key(ptr + i * size, k, ctx);
+        // The first 8 bytes of the key, most significant first
+        items[i].prefix = 0;
+        for (j = 0; j < 8; ++j)
+        {
+            items[i].prefix = (items[i].prefix << 8) | ((j < key_size) ? k[j] : 0);
+        }
+        items[i].index = i;
+    }
+    UPO_SORT_COPY(aux, items, n * sizeof(struct upo_sort_by_key_item_s));
+    upo_sort_by_key_merge_rec(aux, items, 0, n, &bk);
+    for (i = 0; i < n; ++i)
+    {
+        perm[i] = items[i].index;
+    }
+    upo_sort_apply_permutation(base, n, size, perm);
+    free(perm);
+    free(items);
+    free(bk.keys);
+}
+
+unsigned char* upo_sort_key_put_u32(unsigned char *key, uint32_t value)
+{
+    assert(key != NULL);
+
+    key[0] = (unsigned char) (value >> 24);
+    key[1] = (unsigned char) (value >> 16);
+    key[2] = (unsigned char) (value >> 8);
+    key[3] = (unsigned char) value;
+
+    return key + 4;
+}
+
+unsigned char* upo_sort_key_put_i32(unsigned char *key, int32_t value)
+{
+    return upo_sort_key_put_u32(key, (uint32_t) value ^ 0x80000000U);
+}
+
+unsigned char* upo_sort_key_put_str(unsigned char *key, const char *str, size_t width)
+{
+    size_t i;
+
+    assert(key != NULL);
+    assert(str != NULL);
+
+    for (i = 0; i < width && str[i] != '\0'; ++i)
+    {
+        key[i] = (unsigned char) str[i];
+    }
+    memset(key + i, 0, width - i);
+
+    return key + width;
+}
+
+void upo_sort_by_key_merge_rec(struct upo_sort_by_key_item_s *src, struct upo_sort_by_key_item_s *dst, size_t lo, size_t hi, const struct upo_sort_by_key_s *bk)
+{
+    size_t mid;
+    size_t i;
+    size_t j;
+    size_t k;
+
+    UPO_SORT_STATS_ENTER();
+
+    // Same scheme as upo_sort_indirect_merge_rec(), but comparisons are
+    // direct calls
+    if (hi - lo <= UPO_SORT_INDIRECT_CUTOFF)
+    {
+        for (i = lo + 1; i < hi; ++i)
+        {
+            struct upo_sort_by_key_item_s item = dst[i];
+
+            for (j = i; j > lo && upo_sort_by_key_less(&item, &dst[j - 1], bk); --j)
+            {
+                dst[j] = dst[j - 1];
+            }
+            dst[j] = item;
+        }
+        UPO_SORT_STATS_LEAVE();
+        return;
+    }
+    mid = lo + (hi - lo) / 2;
+    upo_sort_by_key_merge_rec(dst, src, lo, mid, bk);
+    upo_sort_by_key_merge_rec(dst, src, mid, hi, bk);
+    i = lo;
+    j = mid;
+    for (k = lo; k < hi; ++k)
+    {
+        if (i < mid && (j >= hi || !upo_sort_by_key_less(&src[j], &src[i], bk)))
+        {
+            dst[k] = src[i++];
+        }
+        else
+        {
+            dst[k] = src[j++];
+        }
+    }
+    UPO_SORT_STATS_LEAVE();
+}
+
+int upo_sort_by_key_less(const struct upo_sort_by_key_item_s *a, const struct upo_sort_by_key_item_s *b, const struct upo_sort_by_key_s *bk)
+{
+    int res = 0;
+
+    if (a->prefix != b->prefix)
+    {
+        return a->prefix < b->prefix;
+    }
+    if (bk->key_size > 8)
+    {
+        res = memcmp(bk->keys + a->index * bk->key_size + 8, bk->keys + b->index * bk->key_size + 8, bk->key_size - 8);
+    }
+    if (res == 0 && bk->cmp != NULL)
+    {
+        res = UPO_SORT_CMP(bk->cmp, bk->base + a->index * bk->size, bk->base + b->index * bk->size, bk->ctx);
+    }
+
+    return res < 0;
+}
+
+void upo_bubble_sort(void *base, size_t n, size_t size, upo_sort_comparator_t cmp)
+{
+    upo_bubble_sort_r(base, n, size, upo_sort_comparator_adapter, &cmp);
+}
+
+void upo_bubble_sort_r(void *base, size_t n, size_t size, upo_sort_comparator_r_t cmp, void *ctx)
+{
+    unsigned char *ptr = base;
+    for (size_t i = 0; i < n; i++)
+    {
+        for (size_t j = 0; j < ((n - 1) - i); j++)
+        {
+            if (UPO_SORT_CMP(cmp, ptr + j * size, ptr + ((j + 1) * size), ctx) > 0)
+                UPO_SORT_SWAP(ptr + ((j + 1) * size), ptr + j * size, size);
+        }
+    }
+}
+
+void upo_quick_sort_median3_cutoff(void *base, size_t n, size_t size, upo_sort_comparator_t cmp)
+{
+    upo_quick_sort_median3_cutoff_r(base, n, size, upo_sort_comparator_adapter, &cmp);
+}
+
+void upo_quick_sort_median3_cutoff_r(void *base, size_t n, size_t size, upo_sort_comparator_r_t cmp, void *ctx)
+{
+    assert(base != NULL);
+    assert(size > 0);
+    assert(cmp != NULL);
+
+    if (n < 2)
+    {
+        return;
+    }
+    upo_quick_sort_median3_cutoff_driver_topdown(base, 0, n - 1, size, cmp, ctx);
+}
+
+void upo_quick_sort_median3_cutoff_driver_topdown(void *base, size_t lo, size_t hi, size_t size, upo_sort_comparator_r_t cmp, void *ctx)
+{
+    UPO_SORT_STATS_ENTER();
+    while (lo < hi && (hi - lo + 1) > UPO_QUICK_SORT_CUTOFF)
+    {
+        /* Partitions the range once */
+        size_t pivot = upo_quick_sort_median3_partition(base, lo, hi, size, cmp, ctx);
+
+        /* Sorts the smaller half recursively and the larger one iteratively */
+        if (pivot - lo < hi - pivot)
+        {
+            if (pivot > lo)
+            {
+                upo_quick_sort_median3_cutoff_driver_topdown(base, lo, pivot - 1, size, cmp, ctx);
+            }
+            lo = pivot + 1;
+        }
+        else
+        {
+            if (pivot < hi)
+            {
+                upo_quick_sort_median3_cutoff_driver_topdown(base, pivot + 1, hi, size, cmp, ctx);
+            }
+            hi = pivot - 1;
+        }
+    }
+    if (lo < hi)
     {
-        upo_quick_sort_median3_cutoff_driver_topdown(base, lo, pivot - 1, size, cmp);
+        upo_insertion_sort_r((unsigned char *)base + lo * size, hi - lo + 1, size, cmp, ctx);
     }
-    /* Sorts right half */
-    upo_quick_sort_median3_cutoff_driver_topdown(base, pivot + 1, hi, size, cmp);
+    UPO_SORT_STATS_LEAVE();
 }
 
-size_t upo_quick_sort_median3_partition(void *base, size_t lo, size_t hi, size_t size, upo_sort_comparator_t cmp)
+size_t upo_quick_sort_median3_partition(void *base, size_t lo, size_t hi, size_t size, upo_sort_comparator_r_t cmp, void *ctx)
 {
     size_t mid = lo + (hi - lo) / 2;
     unsigned char *ptr = base;
@@ -190,29 +2009,29 @@ size_t upo_quick_sort_median3_partition(void *base, size_t lo, size_t hi, size_t
     unsigned char *mid_ptr = ptr + mid * size;
     unsigned char *hi_ptr = ptr + hi * size;
     /* Select the median element among base[lo], base[mid] and base[hi]. */
-    if (cmp(lo_ptr, mid_ptr) > 0)
+    if (UPO_SORT_CMP(cmp, lo_ptr, mid_ptr, ctx) > 0)
     {
-        upo_swap(lo_ptr, mid_ptr, size);
+        UPO_SORT_SWAP(lo_ptr, mid_ptr, size);
     }
-    if (cmp(lo_ptr, hi_ptr) > 0)
+    if (UPO_SORT_CMP(cmp, lo_ptr, hi_ptr, ctx) > 0)
     {
-        upo_swap(lo_ptr, hi_ptr, size);
+        UPO_SORT_SWAP(lo_ptr, hi_ptr, size);
     }
-    if (cmp(mid_ptr, hi_ptr) > 0)
+    if (UPO_SORT_CMP(cmp, mid_ptr, hi_ptr, ctx) > 0)
     {
-        upo_swap(mid_ptr, hi_ptr, size);
+        UPO_SORT_SWAP(mid_ptr, hi_ptr, size);
     }
     if ((hi - lo + 1) <= 3)
     {
         return mid;
     }
     /* Put the middle element on position lo+1. */
-    upo_swap(mid_ptr, ptr + (lo + 1) * size, size);
+    UPO_SORT_SWAP(mid_ptr, ptr + (lo + 1) * size, size);
     /* Now partition the array base[lo+1 .. hi-1] */
-    return upo_quick_sort_partition(base, lo + 1, hi - 1, size, cmp);
+    return upo_quick_sort_partition(base, lo + 1, hi - 1, size, cmp, ctx);
 }
 
-size_t upo_quick_sort_partition(void *base, size_t lo, size_t hi, size_t size, upo_sort_comparator_t cmp)
+size_t upo_quick_sort_partition(void *base, size_t lo, size_t hi, size_t size, upo_sort_comparator_r_t cmp, void *ctx)
 {
     size_t i = lo;
     size_t j = hi + 1;
@@ -224,20 +2043,20 @@ size_t upo_quick_sort_partition(void *base, size_t lo, size_t hi, size_t size, u
         do
         {
             ++i;
-        } while (i < hi && cmp(ptr + i * size, pivot_ptr) < 0);
+        } while (i < hi && UPO_SORT_CMP(cmp, ptr + i * size, pivot_ptr, ctx) < 0);
 
         /* Scans right side of the array */
         do
         {
             --j;
-        } while (j > lo && cmp(pivot_ptr, ptr + j * size) < 0);
+        } while (j > lo && UPO_SORT_CMP(cmp, pivot_ptr, ptr + j * size, ctx) < 0);
         if (i >= j)
         {
             break;
         }
-        upo_swap(ptr + i * size, ptr + j * size, size);
+        UPO_SORT_SWAP(ptr + i * size, ptr + j * size, size);
     }
-    upo_swap(ptr + lo * size, ptr + j * size, size);
+    UPO_SORT_SWAP(ptr + lo * size, ptr + j * size, size);
 
     return j;
 }
\ No newline at end of file
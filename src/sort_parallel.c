@@ -0,0 +1,225 @@
+/* vim: set tabstop=4 expandtab shiftwidth=4 softtabstop=4: */
+
+/*
+ * Copyright 2015 University of Piemonte Orientale, Computer Science Institute
+ *
+ * This file is part of UPOalglib.
+ *
+ * UPOalglib is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * UPOalglib is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with UPOalglib.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/* Needed for pthread barriers and sysconf with -std=c11 */
+#define _POSIX_C_SOURCE 200809L
+
+#include <assert.h>
+#include "sort_parallel_private.h"
+#include "sort_stats_private.h"
+#include <stddef.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <upo/error.h>
+
+
+void upo_parallel_merge_sort(void *base, size_t n, size_t size, upo_sort_comparator_t cmp, size_t nthreads)
+{
+    upo_parallel_merge_sort_r(base, n, size, upo_sort_comparator_adapter, &cmp, nthreads);
+}
+
+void upo_parallel_merge_sort_r(void *base, size_t n, size_t size, upo_sort_comparator_r_t cmp, void *ctx, size_t nthreads)
+{
+    struct upo_parallel_merge_sort_s ps;
+    struct upo_parallel_merge_sort_worker_s *workers = NULL;
+    pthread_t *threads = NULL;
+    size_t t;
+
+    assert(base != NULL);
+    assert(n > 0);
+    assert(size > 0);
+    assert(cmp != NULL);
+
+    if (nthreads == 0)
+    {
+        long ncpus = sysconf(_SC_NPROCESSORS_ONLN);
+        nthreads = (ncpus > 0) ? (size_t) ncpus : 1;
+    }
+    // Every thread must get at least UPO_PARALLEL_MERGE_SORT_MIN_CHUNK elements
+    if (nthreads > n / UPO_PARALLEL_MERGE_SORT_MIN_CHUNK)
+    {
+        nthreads = n / UPO_PARALLEL_MERGE_SORT_MIN_CHUNK;
+    }
+    if (nthreads <= 1)
+    {
+        upo_merge_sort_r(base, n, size, cmp, ctx);
+        return;
+    }
+
+    ps.base = base;
+    ps.n = n;
+    ps.size = size;
+    ps.cmp = cmp;
+    ps.ctx = ctx;
+    ps.nthreads = nthreads;
+    ps.aux = UPO_SORT_MALLOC(n * size);
+    workers = UPO_SORT_MALLOC(nthreads * sizeof(struct upo_parallel_merge_sort_worker_s));
+    threads = UPO_SORT_MALLOC(nthreads * sizeof(pthread_t));
+    if (ps.aux == NULL || workers == NULL || threads == NULL)
+    {
+        perror("Unable to allocate memory for parallel merge sort");
+        abort();
+    }
+    if (pthread_barrier_init(&ps.barrier, NULL, (unsigned) nthreads) != 0)
+    {
+        upo_throw_error("Unable to initialize the barrier of parallel merge sort");
+    }
+
+    // The calling thread acts as worker #0
+    for (t = 0; t < nthreads; ++t)
+    {
+        workers[t].shared = &ps;
+        workers[t].id = t;
+    }
+    for (t = 1; t < nthreads; ++t)
+    {
+        if (pthread_create(&threads[t], NULL, upo_parallel_merge_sort_worker, &workers[t]) != 0)
+        {
+            upo_throw_error("Unable to create a thread for parallel merge sort");
+        }
+    }
+    upo_parallel_merge_sort_worker(&workers[0]);
+    for (t = 1; t < nthreads; ++t)
+    {
+        pthread_join(threads[t], NULL);
+    }
+
+    pthread_barrier_destroy(&ps.barrier);
+    free(threads);
+    free(workers);
+    free(ps.aux);
+}
+
+void* upo_parallel_merge_sort_worker(void *arg)
+{
+    struct upo_parallel_merge_sort_worker_s *worker = arg;
+    struct upo_parallel_merge_sort_s *ps = worker->shared;
+    size_t size = ps->size;
+    size_t t = worker->id;
+    // Each thread owns chunk #t of the array, that is the range [first,last)
+    size_t first = upo_parallel_merge_sort_bound(ps, t);
+    size_t last = upo_parallel_merge_sort_bound(ps, t + 1);
+    unsigned char *src = ps->base;
+    unsigned char *dst = ps->aux;
+    size_t width;
+
+    // Sorts the chunk, using the same range of the auxiliary array
+    upo_merge_sort_ex_r(ps->base + first * size, last - first, size, ps->cmp, ps->ctx, ps->aux + first * size);
+
+    // At each round, runs made of `width` chunks are merged pairwise from src
+    // into dst. Thread #t writes the output positions of chunk #t, so that
+    // every thread does the same amount of work whatever the round; the
+    // elements that land there are located by a binary search on the merge
+    // path of the two runs (co-ranking).
+    for (width = 1; width < ps->nthreads; width *= 2)
+    {
+        size_t g = t - t % (2 * width);
+        size_t mid_chunk = (g + width < ps->nthreads) ? g + width : ps->nthreads;
+        size_t hi_chunk = (g + 2 * width < ps->nthreads) ? g + 2 * width : ps->nthreads;
+        size_t lo = upo_parallel_merge_sort_bound(ps, g);
+        size_t mid = upo_parallel_merge_sort_bound(ps, mid_chunk);
+        size_t hi = upo_parallel_merge_sort_bound(ps, hi_chunk);
+        const unsigned char *a = src + lo * size;
+        const unsigned char *b = src + mid * size;
+        size_t i0;
+        size_t i1;
+        unsigned char *tmp = NULL;
+
+        // Waits for the previous round (or the chunk sorts) to complete
+        pthread_barrier_wait(&ps->barrier);
+
+        i0 = upo_parallel_merge_corank(first - lo, a, mid - lo, b, hi - mid, size, ps->cmp, ps->ctx);
+        i1 = upo_parallel_merge_corank(last - lo, a, mid - lo, b, hi - mid, size, ps->cmp, ps->ctx);
+        upo_parallel_merge(a + i0 * size, i1 - i0,
+                           b + (first - lo - i0) * size, (last - lo - i1) - (first - lo - i0),
+                           dst + first * size, size, ps->cmp, ps->ctx);
+
+        tmp = src;
+        src = dst;
+        dst = tmp;
+    }
+
+    // Copies the chunk back once no thread reads the array anymore
+    if (src != ps->base)
+    {
+        pthread_barrier_wait(&ps->barrier);
+        UPO_SORT_COPY(ps->base + first * size, src + first * size, (last - first) * size);
+    }
+
+    return NULL;
+}
+
+size_t upo_parallel_merge_sort_bound(const struct upo_parallel_merge_sort_s *ps, size_t chunk)
+{
+    // Computes chunk*n/nthreads without overflowing
+    return (ps->n / ps->nthreads) * chunk + (ps->n % ps->nthreads) * chunk / ps->nthreads;
+}
+
+size_t upo_parallel_merge_corank(size_t k, const unsigned char *a, size_t na, const unsigned char *b, size_t nb, size_t size, upo_sort_comparator_r_t cmp, void *ctx)
+{
+    size_t lo = (k > nb) ? k - nb : 0;
+    size_t hi = (k < na) ? k : na;
+
+    // Finds the smallest i such that b[k-i-1] < a[i], i.e. a[i] is not among
+    // the first k elements (equal elements are taken from a first).
+    while (lo < hi)
+    {
+        size_t i = lo + (hi - lo) / 2;
+        size_t j = k - i;
+
+        if (UPO_SORT_CMP(cmp, a + i * size, b + (j - 1) * size, ctx) <= 0)
+        {
+            lo = i + 1;
+        }
+        else
+        {
+            hi = i;
+        }
+    }
+
+    return lo;
+}
+
+void upo_parallel_merge(const unsigned char *a, size_t na, const unsigned char *b, size_t nb, unsigned char *dst, size_t size, upo_sort_comparator_r_t cmp, void *ctx)
+{
+    size_t i = 0;
+    size_t j = 0;
+
+    while (i < na && j < nb)
+    {
+        if (UPO_SORT_CMP(cmp, b + j * size, a + i * size, ctx) < 0)
+        {
+            UPO_SORT_COPY(dst, b + j * size, size);
+            ++j;
+        }
+        else
+        {
+            UPO_SORT_COPY(dst, a + i * size, size);
+            ++i;
+        }
+        dst += size;
+    }
+    UPO_SORT_COPY(dst, a + i * size, (na - i) * size);
+    dst += (na - i) * size;
+    UPO_SORT_COPY(dst, b + j * size, (nb - j) * size);
+}
@@ -0,0 +1,71 @@
+/* vim: set tabstop=4 expandtab shiftwidth=4 softtabstop=4: */
+
+/**
+ * \file src/sort_parallel_private.h
+ *
+ * \brief Private header for multi-threaded sorting algorithms.
+ *
+ * \author Simone Gattini, Federico Barbero, Anton Iliev
+ *
+ * \copyright 2015 University of Piemonte Orientale, Computer Science Institute
+ *
+ *  This file is part of UPOalglib.
+ *
+ *  UPOalglib is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  UPOalglib is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with UPOalglib.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef UPO_SORT_PARALLEL_PRIVATE_H
+#define UPO_SORT_PARALLEL_PRIVATE_H
+
+#include <pthread.h>
+#include <upo/sort.h>
+
+/** \brief Minimum number of elements per thread in parallel merge sort:
+ *   smaller arrays are sorted by fewer threads (possibly only one). */
+#define UPO_PARALLEL_MERGE_SORT_MIN_CHUNK 4096
+
+/** \brief Shared state of the threads of a parallel merge sort. */
+struct upo_parallel_merge_sort_s
+{
+    unsigned char *base; /**< The array to sort. */
+    unsigned char *aux; /**< The auxiliary array, of the same size of \a base. */
+    size_t n; /**< The number of elements in the array. */
+    size_t size; /**< The size (in bytes) of each element. */
+    upo_sort_comparator_r_t cmp; /**< The comparison function. */
+    void *ctx; /**< The context passed to \a cmp. */
+    size_t nthreads; /**< The number of threads (and of initial chunks). */
+    pthread_barrier_t barrier; /**< The barrier separating merge rounds. */
+};
+
+/** \brief Per-thread argument of a parallel merge sort. */
+struct upo_parallel_merge_sort_worker_s
+{
+    struct upo_parallel_merge_sort_s *shared; /**< The shared state. */
+    size_t id; /**< The thread index, in [0, nthreads). */
+};
+
+/** \brief Body of each thread of parallel merge sort. */
+static void* upo_parallel_merge_sort_worker(void *arg);
+
+/** \brief Returns the index of the first element of the given chunk. */
+static size_t upo_parallel_merge_sort_bound(const struct upo_parallel_merge_sort_s *ps, size_t chunk);
+
+/** \brief Returns how many of the first \a k elements of the stable merge of
+ *   \a a (of \a na elements) and \a b (of \a nb elements) come from \a a. */
+static size_t upo_parallel_merge_corank(size_t k, const unsigned char *a, size_t na, const unsigned char *b, size_t nb, size_t size, upo_sort_comparator_r_t cmp, void *ctx);
+
+/** \brief Stably merges \a a (of \a na elements) and \a b (of \a nb elements) into \a dst. */
+static void upo_parallel_merge(const unsigned char *a, size_t na, const unsigned char *b, size_t nb, unsigned char *dst, size_t size, upo_sort_comparator_r_t cmp, void *ctx);
+
+#endif /* UPO_SORT_PARALLEL_PRIVATE_H */
@@ -29,6 +29,7 @@
 #define UPO_SORT_PRIVATE_H
 
 #include <upo/sort.h>
+#include <upo/task.h>
 
 /* TO STUDENTS:
  *
@@ -48,16 +49,178 @@
  *
  */
 
-static void upo_merge_sort_rec(void *base, size_t lo, size_t hi, size_t size, upo_sort_comparator_t cmp);
+/** \brief Elements up to this size (in bytes) are saved on the stack by
+ *   insertion sort, while larger ones need a heap allocation. */
+#define UPO_INSERTION_SORT_STACK_BYTES 256
 
-static void upo_merge_sort_merge(void *base, size_t lo, size_t mid, size_t hi, size_t size, upo_sort_comparator_t cmp);
+static void upo_insertion_sort_range(unsigned char *base, size_t start, size_t n, size_t size, upo_sort_comparator_r_t cmp, void *ctx, unsigned char *tmp);
 
-static void upo_quick_sort_rec(void *base, size_t lo, size_t hi, size_t size, upo_sort_comparator_t cmp);
+/** \brief Length of the runs sorted by insertion sort in bottom-up merge sort. */
+#define UPO_MERGE_SORT_BOTTOMUP_RUN 16
 
-static size_t upo_quick_sort_partition(void *base, size_t lo, size_t hi, size_t size, upo_sort_comparator_t cmp);
+/** \brief Memory (in bytes) that a block of bottom-up merge sort, together with
+ *   its auxiliary space, may use; tuned on the size of a typical L2 cache. */
+#define UPO_MERGE_SORT_BOTTOMUP_BLOCK_BYTES (256 * 1024)
 
-static void upo_quick_sort_median3_cutoff_driver_topdown(void *base, size_t lo, size_t hi, size_t size, upo_sort_comparator_t cmp);
+static void upo_merge_sort_rec(unsigned char *src, unsigned char *dst, size_t lo, size_t hi, size_t size, upo_sort_comparator_r_t cmp, void *ctx);
 
-static size_t upo_quick_sort_median3_partition(void *base, size_t lo, size_t hi, size_t size, upo_sort_comparator_t cmp);
+static void upo_merge_sort_merge(const unsigned char *src, unsigned char *dst, size_t lo, size_t mid, size_t hi, size_t size, upo_sort_comparator_r_t cmp, void *ctx);
+
+static void upo_merge_sort_pass(const unsigned char *src, unsigned char *dst, size_t lo, size_t hi, size_t width, size_t size, upo_sort_comparator_r_t cmp, void *ctx);
+
+/** \brief Initial number of consecutive wins of a run after which adaptive
+ *   sort switches to galloping mode. */
+#define UPO_ADAPTIVE_SORT_MIN_GALLOP 7
+
+/** \brief Maximum number of pending runs in adaptive sort, which is enough for
+ *   2^64 elements thanks to the invariants on the run lengths. */
+#define UPO_ADAPTIVE_SORT_MAX_RUNS 85
+
+/** \brief State of adaptive sort. */
+struct upo_adaptive_sort_s
+{
+    unsigned char *base; /**< The array to sort. */
+    size_t n; /**< The number of elements in the array. */
+    size_t size; /**< The size (in bytes) of each element. */
+    upo_sort_comparator_r_t cmp; /**< The comparison function. */
+    void *ctx; /**< The context passed to \a cmp. */
+    unsigned char *tmp; /**< The temporary array for merges (up to n/2 elements), allocated on the first merge. */
+    unsigned char *pivot; /**< Room for one element, used by binary insertion. */
+    size_t min_gallop; /**< The current threshold for galloping mode. */
+    size_t run_base[UPO_ADAPTIVE_SORT_MAX_RUNS]; /**< The start of each pending run. */
+    size_t run_len[UPO_ADAPTIVE_SORT_MAX_RUNS]; /**< The length of each pending run. */
+    size_t num_runs; /**< The number of pending runs. */
+};
+
+static size_t upo_adaptive_sort_min_run(size_t n);
+
+static size_t upo_adaptive_sort_count_run(const struct upo_adaptive_sort_s *ms, size_t lo, size_t hi);
+
+static size_t upo_adaptive_sort_gallop(const void *key, const unsigned char *a, size_t n, int right, int from_end, size_t size, upo_sort_comparator_r_t cmp, void *ctx);
+
+static void upo_adaptive_sort_merge_collapse(struct upo_adaptive_sort_s *ms);
+
+static void upo_adaptive_sort_merge_force_collapse(struct upo_adaptive_sort_s *ms);
+
+static void upo_adaptive_sort_merge_at(struct upo_adaptive_sort_s *ms, size_t i);
+
+static void upo_adaptive_sort_merge_lo(struct upo_adaptive_sort_s *ms, unsigned char *a, size_t na, unsigned char *b, size_t nb);
+
+static void upo_adaptive_sort_merge_hi(struct upo_adaptive_sort_s *ms, unsigned char *a, size_t na, unsigned char *b, size_t nb);
+
+#ifndef UPO_QUICK_SORT_CUTOFF
+/** \brief Ranges of at most this many elements are sorted by insertion sort in
+ *   median-of-3 quick sort (can be overridden with `-DUPO_QUICK_SORT_CUTOFF=<n>`). */
+# define UPO_QUICK_SORT_CUTOFF 16
+#endif /* UPO_QUICK_SORT_CUTOFF */
+
+/** \brief Ranges no longer than this are sorted by insertion sort in introsort and selection. */
+#define UPO_INTRO_SORT_CUTOFF 16
+
+/** \brief Ranges longer than this use the median of three medians as pivot. */
+#define UPO_INTRO_SORT_NINTHER_THRESHOLD 40
+
+static void upo_quick_sort_rec(void *base, size_t lo, size_t hi, size_t size, upo_sort_comparator_r_t cmp, void *ctx);
+
+static size_t upo_quick_sort_partition(void *base, size_t lo, size_t hi, size_t size, upo_sort_comparator_r_t cmp, void *ctx);
+
+static void upo_quick_sort_3way_rec(void *base, size_t lo, size_t hi, size_t size, upo_sort_comparator_r_t cmp, void *ctx);
+
+static void upo_intro_sort_rec(void *base, size_t lo, size_t hi, size_t depth, size_t size, upo_sort_comparator_r_t cmp, void *ctx);
+
+static size_t upo_intro_sort_pivot(const void *base, size_t lo, size_t hi, size_t size, upo_sort_comparator_r_t cmp, void *ctx);
+
+/** \brief Ranges longer than this are partitioned into two tasks by parallel
+ *   quick sort, while shorter ones are sorted by introsort. */
+#define UPO_PARALLEL_QUICK_SORT_GRAIN 8192
+
+/** \brief A range of the array to sort by a task of parallel quick sort. */
+struct upo_parallel_quick_sort_task_s
+{
+    unsigned char *base; /**< The whole array. */
+    size_t lo; /**< The index of the first element of the range. */
+    size_t hi; /**< The index of the last element of the range. */
+    size_t depth; /**< The remaining partitioning depth before falling back to heap sort. */
+    size_t size; /**< The size (in bytes) of each element. */
+    upo_sort_comparator_r_t cmp; /**< The comparison function. */
+    void *ctx; /**< The context passed to \a cmp. */
+};
+
+static void upo_parallel_quick_sort_task(upo_task_pool_t pool, void *arg);
+
+static void upo_parallel_quick_sort_spawn(upo_task_pool_t pool, unsigned char *base, size_t lo, size_t hi, size_t depth, size_t size, upo_sort_comparator_r_t cmp, void *ctx);
+
+/** \brief Defines the type of a top-k selection. */
+struct upo_top_k_s
+{
+    unsigned char *heap; /**< The max-heap of the elements kept. */
+    size_t k; /**< The capacity of the heap. */
+    size_t n; /**< The number of elements in the heap. */
+    size_t size; /**< The size (in bytes) of each element. */
+    upo_sort_comparator_r_t cmp; /**< The comparison function. */
+    void *ctx; /**< The context passed to \a cmp. */
+    upo_sort_comparator_t plain_cmp; /**< The comparison function given to upo_top_k_create(), if any. */
+};
+
+/** \brief Moves up the element at position \a i of the heap of a top-k selection. */
+static void upo_top_k_sift_up(upo_top_k_t top, size_t i);
+
+static size_t upo_sort_median3(const void *base, size_t i, size_t j, size_t k, size_t size, upo_sort_comparator_r_t cmp, void *ctx);
+
+static void upo_heap_sort_sift_down(void *base, size_t i, size_t n, size_t size, upo_sort_comparator_r_t cmp, void *ctx);
+
+static void upo_heap_sort_range(void *base, size_t n, size_t size, upo_sort_comparator_r_t cmp, void *ctx);
+
+/** \brief Groups of at most this many elements are sorted by insertion sort in MSD radix sort. */
+#define UPO_RADIX_SORT_STR_CUTOFF 16
+
+static void upo_radix_sort_lsd(uint32_t *keys, void *base, size_t n, size_t size);
+
+static void upo_radix_sort_str_rec(void *base, void *aux, size_t lo, size_t hi, size_t depth, size_t size, upo_sort_str_key_t key);
+
+/** \brief Ranges of at most this many elements are sorted by insertion sort
+ *   in indirect sort. */
+#define UPO_SORT_INDIRECT_CUTOFF 16
+
+/** \brief A (key prefix, pointer) pair sorted by indirect sort in place of
+ *   the element it points to. */
+struct upo_sort_indirect_item_s
+{
+    uint32_t prefix; /**< The key prefix of the element (0 if there is no prefix function). */
+    const unsigned char *ptr; /**< The element. */
+};
+
+static void upo_sort_indirect_merge_rec(struct upo_sort_indirect_item_s *src, struct upo_sort_indirect_item_s *dst, size_t lo, size_t hi, upo_sort_comparator_r_t cmp, void *ctx);
+
+static int upo_sort_indirect_less(const struct upo_sort_indirect_item_s *a, const struct upo_sort_indirect_item_s *b, upo_sort_comparator_r_t cmp, void *ctx);
+
+/** \brief State of a sort by normalized key. */
+struct upo_sort_by_key_s
+{
+    const unsigned char *base; /**< The array to sort. */
+    size_t size; /**< The size (in bytes) of each element. */
+    unsigned char *keys; /**< The keys of the elements, in the same order. */
+    size_t key_size; /**< The size (in bytes) of each key. */
+    upo_sort_comparator_r_t cmp; /**< The comparison function for equal keys, or `NULL`. */
+    void *ctx; /**< The context passed to \a cmp. */
+};
+
+/** \brief An element sorted by normalized key: the first 8 bytes of its key
+ *   and its index. */
+struct upo_sort_by_key_item_s
+{
+    uint64_t prefix; /**< The first 8 bytes of the key, most significant first (zero-padded). */
+    size_t index; /**< The index of the element (and of its key). */
+};
+
+static void upo_sort_by_key_merge_rec(struct upo_sort_by_key_item_s *src, struct upo_sort_by_key_item_s *dst, size_t lo, size_t hi, const struct upo_sort_by_key_s *bk);
+
+/** \brief Compares two elements by prefix, then by the rest of their key,
+ *   then by the comparison function if the keys are equal. */
+static int upo_sort_by_key_less(const struct upo_sort_by_key_item_s *a, const struct upo_sort_by_key_item_s *b, const struct upo_sort_by_key_s *bk);
+
+static void upo_quick_sort_median3_cutoff_driver_topdown(void *base, size_t lo, size_t hi, size_t size, upo_sort_comparator_r_t cmp, void *ctx);
+
+static size_t upo_quick_sort_median3_partition(void *base, size_t lo, size_t hi, size_t size, upo_sort_comparator_r_t cmp, void *ctx);
 
 #endif /* UPO_SORT_PRIVATE_H */
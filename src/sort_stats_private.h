@@ -0,0 +1,108 @@
+/* vim: set tabstop=4 expandtab shiftwidth=4 softtabstop=4: */
+
+/**
+ * \file src/sort_stats_private.h
+ *
+ * \brief Private header for the instrumentation of the sorting functions.
+ *
+ * \author Simone Gattini, Federico Barbero, Anton Iliev
+ *
+ * \copyright 2015 University of Piemonte Orientale, Computer Science Institute
+ *
+ *  This file is part of UPOalglib.
+ *
+ *  UPOalglib is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  UPOalglib is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with UPOalglib.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef UPO_SORT_STATS_PRIVATE_H
+#define UPO_SORT_STATS_PRIVATE_H
+
+#include <stdlib.h>
+#include <string.h>
+#include <upo/utility.h>
+
+/* The sorting functions compare, swap, copy and allocate through the macros
+ * below, which only count the work when built with -DUPO_SORT_STATS and
+ * otherwise expand to the plain calls. */
+
+#ifdef UPO_SORT_STATS
+
+#include <stdatomic.h>
+
+/** \brief The counters of the work done by the sorting functions (see upo_sort_stats_t). */
+struct upo_sort_stats_counters_s
+{
+    atomic_size_t num_compares;
+    atomic_size_t num_swaps;
+    atomic_size_t num_bytes_moved;
+    atomic_size_t num_allocs;
+    atomic_size_t max_depth;
+};
+
+/** \brief The counters shared by all the sorting functions, defined in sort.c. */
+extern struct upo_sort_stats_counters_s upo_sort_stats_counters;
+
+/** \brief The recursion depth of the calling thread, defined in sort.c. */
+extern _Thread_local size_t upo_sort_stats_depth;
+
+/** \brief Adds \a n to the given counter. */
+# define UPO_SORT_STATS_ADD(counter, n) atomic_fetch_add_explicit(&upo_sort_stats_counters.counter, (n), memory_order_relaxed)
+
+/** \brief Marks the entry into a recursive function. */
+# define UPO_SORT_STATS_ENTER() upo_sort_stats_enter()
+
+/** \brief Marks the exit from a recursive function. */
+# define UPO_SORT_STATS_LEAVE() (--upo_sort_stats_depth)
+
+/** \brief Calls the comparison function \a cmp. */
+# define UPO_SORT_CMP(cmp, a, b, ctx) (UPO_SORT_STATS_ADD(num_compares, 1), (cmp)((a), (b), (ctx)))
+
+/** \brief Swaps two elements of \a size bytes. */
+# define UPO_SORT_SWAP(a, b, size) (UPO_SORT_STATS_ADD(num_swaps, 1), UPO_SORT_STATS_ADD(num_bytes_moved, 2 * (size)), upo_swap((a), (b), (size)))
+
+/** \brief Copies \a n bytes between non-overlapping areas. */
+# define UPO_SORT_COPY(dst, src, n) (UPO_SORT_STATS_ADD(num_bytes_moved, (n)), memcpy((dst), (src), (n)))
+
+/** \brief Copies \a n bytes between possibly overlapping areas. */
+# define UPO_SORT_MOVE(dst, src, n) (UPO_SORT_STATS_ADD(num_bytes_moved, (n)), memmove((dst), (src), (n)))
+
+/** \brief Allocates \a n bytes. */
+# define UPO_SORT_MALLOC(n) (UPO_SORT_STATS_ADD(num_allocs, 1), malloc(n))
+
+/** \brief Increments the recursion depth of the calling thread, updating the maximum one. */
+static inline void upo_sort_stats_enter()
+{
+    size_t depth = ++upo_sort_stats_depth;
+    size_t max_depth = atomic_load_explicit(&upo_sort_stats_counters.max_depth, memory_order_relaxed);
+
+    while (depth > max_depth
+           && !atomic_compare_exchange_weak_explicit(&upo_sort_stats_counters.max_depth, &max_depth, depth, memory_order_relaxed, memory_order_relaxed))
+    {
+        /* max_depth now holds the current maximum: tries again */
+    }
+}
+
+#else /* UPO_SORT_STATS */
+
+# define UPO_SORT_STATS_ENTER() ((void) 0)
+# define UPO_SORT_STATS_LEAVE() ((void) 0)
+# define UPO_SORT_CMP(cmp, a, b, ctx) (cmp)((a), (b), (ctx))
+# define UPO_SORT_SWAP(a, b, size) upo_swap((a), (b), (size))
+# define UPO_SORT_COPY(dst, src, n) memcpy((dst), (src), (n))
+# define UPO_SORT_MOVE(dst, src, n) memmove((dst), (src), (n))
+# define UPO_SORT_MALLOC(n) malloc(n)
+
+#endif /* UPO_SORT_STATS */
+
+#endif /* UPO_SORT_STATS_PRIVATE_H */
@@ -0,0 +1,319 @@
+/* vim: set tabstop=4 expandtab shiftwidth=4 softtabstop=4: */
+
+/*
+ * Copyright 2015 University of Piemonte Orientale, Computer Science Institute
+ *
+ * This file is part of UPOalglib.
+ *
+ * UPOalglib is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * UPOalglib is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with UPOalglib.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/* Needed for sysconf with -std=c11 */
+#define _POSIX_C_SOURCE 200809L
+
+#include <assert.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include "task_private.h"
+#include <unistd.h>
+#include <upo/error.h>
+
+
+/* The pool thread running on the current thread, if any */
+static _Thread_local struct upo_task_worker_s *upo_task_current_worker = NULL;
+
+
+upo_task_pool_t upo_task_pool_create(size_t nthreads)
+{
+    upo_task_pool_t pool = NULL;
+    size_t i;
+
+    if (nthreads == 0)
+    {
+        long ncpus = sysconf(_SC_NPROCESSORS_ONLN);
+        nthreads = (ncpus > 0) ? (size_t) ncpus : 1;
+    }
+
+    pool = malloc(sizeof(struct upo_task_pool_s));
+    if (pool == NULL)
+    {
+        upo_throw_sys_error("Unable to allocate memory for the task pool");
+    }
+    pool->workers = malloc(nthreads * sizeof(struct upo_task_worker_s));
+    if (pool->workers == NULL)
+    {
+        upo_throw_sys_error("Unable to allocate memory for the threads of the task pool");
+    }
+    pool->nthreads = nthreads;
+    atomic_init(&pool->num_pending, 0);
+    atomic_init(&pool->num_queued, 0);
+    atomic_init(&pool->num_sleeping, 0);
+    pool->stop = 0;
+    pthread_mutex_init(&pool->mutex, NULL);
+    pthread_cond_init(&pool->cond, NULL);
+
+    for (i = 0; i < nthreads; ++i)
+    {
+        pool->workers[i].pool = pool;
+        pool->workers[i].id = i;
+        upo_task_deque_init(&pool->workers[i].deque);
+    }
+    // Thread #0 is the one that calls upo_task_pool_wait()
+    for (i = 1; i < nthreads; ++i)
+    {
+        if (pthread_create(&pool->workers[i].thread, NULL, upo_task_worker_main, &pool->workers[i]) != 0)
+        {
+            upo_throw_error("Unable to create a thread for the task pool");
+        }
+    }
+
+    return pool;
+}
+
+void upo_task_pool_destroy(upo_task_pool_t pool)
+{
+    size_t i;
+
+    if (pool == NULL)
+    {
+        return;
+    }
+
+    pthread_mutex_lock(&pool->mutex);
+    pool->stop = 1;
+    pthread_cond_broadcast(&pool->cond);
+    pthread_mutex_unlock(&pool->mutex);
+    for (i = 1; i < pool->nthreads; ++i)
+    {
+        pthread_join(pool->workers[i].thread, NULL);
+    }
+
+    for (i = 0; i < pool->nthreads; ++i)
+    {
+        upo_task_deque_destroy(&pool->workers[i].deque);
+    }
+    pthread_cond_destroy(&pool->cond);
+    pthread_mutex_destroy(&pool->mutex);
+    free(pool->workers);
+    free(pool);
+}
+
+size_t upo_task_pool_size(const upo_task_pool_t pool)
+{
+    assert(pool != NULL);
+
+    return pool->nthreads;
+}
+
+void upo_task_spawn(upo_task_pool_t pool, upo_task_func_t func, void *arg)
+{
+    struct upo_task_worker_s *worker = upo_task_current_worker;
+    struct upo_task_s task;
+
+    assert(pool != NULL);
+    assert(func != NULL);
+
+    if (worker == NULL || worker->pool != pool)
+    {
+        worker = &pool->workers[0];
+    }
+
+    task.func = func;
+    task.arg = arg;
+    // The task is counted as pending before it can be taken, so that the
+    // count never drops to zero while its parent is still running.
+    atomic_fetch_add(&pool->num_pending, 1);
+    upo_task_deque_push(&worker->deque, &task);
+    atomic_fetch_add(&pool->num_queued, 1);
+    // Sleeping threads announce themselves before checking num_queued, so
+    // either they see the new task or the signal below reaches them.
+    if (atomic_load(&pool->num_sleeping) > 0)
+    {
+        pthread_mutex_lock(&pool->mutex);
+        pthread_cond_signal(&pool->cond);
+        pthread_mutex_unlock(&pool->mutex);
+    }
+}
+
+void upo_task_pool_wait(upo_task_pool_t pool)
+{
+    struct upo_task_worker_s *prev_worker = upo_task_current_worker;
+    struct upo_task_s task;
+    int done = 0;
+
+    assert(pool != NULL);
+
+    upo_task_current_worker = &pool->workers[0];
+    while (!done)
+    {
+        if (upo_task_take(&pool->workers[0], &task))
+        {
+            upo_task_run(pool, &task);
+            continue;
+        }
+        pthread_mutex_lock(&pool->mutex);
+        atomic_fetch_add(&pool->num_sleeping, 1);
+        while (atomic_load(&pool->num_queued) == 0 && atomic_load(&pool->num_pending) > 0)
+        {
+            pthread_cond_wait(&pool->cond, &pool->mutex);
+        }
+        atomic_fetch_sub(&pool->num_sleeping, 1);
+        done = atomic_load(&pool->num_pending) == 0;
+        pthread_mutex_unlock(&pool->mutex);
+    }
+    upo_task_current_worker = prev_worker;
+}
+
+void* upo_task_worker_main(void *arg)
+{
+    struct upo_task_worker_s *worker = arg;
+    upo_task_pool_t pool = worker->pool;
+    struct upo_task_s task;
+    int stop = 0;
+
+    upo_task_current_worker = worker;
+    while (!stop)
+    {
+        if (upo_task_take(worker, &task))
+        {
+            upo_task_run(pool, &task);
+            continue;
+        }
+        pthread_mutex_lock(&pool->mutex);
+        atomic_fetch_add(&pool->num_sleeping, 1);
+        while (atomic_load(&pool->num_queued) == 0 && !pool->stop)
+        {
+            pthread_cond_wait(&pool->cond, &pool->mutex);
+        }
+        atomic_fetch_sub(&pool->num_sleeping, 1);
+        stop = pool->stop;
+        pthread_mutex_unlock(&pool->mutex);
+    }
+
+    return NULL;
+}
+
+int upo_task_take(struct upo_task_worker_s *worker, struct upo_task_s *task)
+{
+    upo_task_pool_t pool = worker->pool;
+    size_t i;
+
+    if (upo_task_deque_pop(&worker->deque, task))
+    {
+        atomic_fetch_sub(&pool->num_queued, 1);
+        return 1;
+    }
+    for (i = 1; i < pool->nthreads; ++i)
+    {
+        size_t victim = (worker->id + i) % pool->nthreads;
+
+        if (upo_task_deque_steal(&pool->workers[victim].deque, task))
+        {
+            atomic_fetch_sub(&pool->num_queued, 1);
+            return 1;
+        }
+    }
+
+    return 0;
+}
+
+void upo_task_run(upo_task_pool_t pool, const struct upo_task_s *task)
+{
+    task->func(pool, task->arg);
+    if (atomic_fetch_sub(&pool->num_pending, 1) == 1)
+    {
+        // Wakes up the thread waiting for all tasks to complete
+        pthread_mutex_lock(&pool->mutex);
+        pthread_cond_broadcast(&pool->cond);
+        pthread_mutex_unlock(&pool->mutex);
+    }
+}
+
+void upo_task_deque_init(struct upo_task_deque_s *deque)
+{
+    pthread_mutex_init(&deque->mutex, NULL);
+    deque->tasks = malloc(UPO_TASK_DEQUE_INITIAL_CAPACITY * sizeof(struct upo_task_s));
+    if (deque->tasks == NULL)
+    {
+        upo_throw_sys_error("Unable to allocate memory for the task queue");
+    }
+    deque->capacity = UPO_TASK_DEQUE_INITIAL_CAPACITY;
+    deque->top = deque->bottom = 0;
+}
+
+void upo_task_deque_destroy(struct upo_task_deque_s *deque)
+{
+    free(deque->tasks);
+    pthread_mutex_destroy(&deque->mutex);
+}
+
+void upo_task_deque_push(struct upo_task_deque_s *deque, const struct upo_task_s *task)
+{
+    pthread_mutex_lock(&deque->mutex);
+    if (deque->bottom - deque->top == deque->capacity)
+    {
+        // Doubles the capacity, moving the tasks to the start of the new array
+        struct upo_task_s *tasks = malloc(2 * deque->capacity * sizeof(struct upo_task_s));
+        size_t i;
+
+        if (tasks == NULL)
+        {
+            upo_throw_sys_error("Unable to allocate memory for the task queue");
+        }
+        for (i = 0; i < deque->capacity; ++i)
+        {
+            tasks[i] = deque->tasks[(deque->top + i) & (deque->capacity - 1)];
+        }
+        free(deque->tasks);
+        deque->tasks = tasks;
+        deque->bottom -= deque->top;
+        deque->top = 0;
+        deque->capacity *= 2;
+    }
+    deque->tasks[deque->bottom & (deque->capacity - 1)] = *task;
+    ++deque->bottom;
+    pthread_mutex_unlock(&deque->mutex);
+}
+
+int upo_task_deque_pop(struct upo_task_deque_s *deque, struct upo_task_s *task)
+{
+    int found = 0;
+
+    pthread_mutex_lock(&deque->mutex);
+    if (deque->bottom != deque->top)
+    {
+        --deque->bottom;
+        *task = deque->tasks[deque->bottom & (deque->capacity - 1)];
+        found = 1;
+    }
+    pthread_mutex_unlock(&deque->mutex);
+
+    return found;
+}
+
+int upo_task_deque_steal(struct upo_task_deque_s *deque, struct upo_task_s *task)
+{
+    int found = 0;
+
+    pthread_mutex_lock(&deque->mutex);
+    if (deque->bottom != deque->top)
+    {
+        *task = deque->tasks[deque->top & (deque->capacity - 1)];
+        ++deque->top;
+        found = 1;
+    }
+    pthread_mutex_unlock(&deque->mutex);
+
+    return found;
+}
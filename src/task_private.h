@@ -0,0 +1,108 @@
+/* vim: set tabstop=4 expandtab shiftwidth=4 softtabstop=4: */
+
+/**
+ * \file src/task_private.h
+ *
+ * \brief Private header for the work-stealing task scheduler.
+ *
+ * \author Simone Gattini, Federico Barbero, Anton Iliev
+ *
+ * \copyright 2015 University of Piemonte Orientale, Computer Science Institute
+ *
+ *  This file is part of UPOalglib.
+ *
+ *  UPOalglib is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  UPOalglib is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with UPOalglib.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef UPO_TASK_PRIVATE_H
+#define UPO_TASK_PRIVATE_H
+
+#include <pthread.h>
+#include <stdatomic.h>
+#include <upo/task.h>
+
+/** \brief Initial capacity of the task queue of each thread. */
+#define UPO_TASK_DEQUE_INITIAL_CAPACITY 64
+
+/** \brief A task, that is a function together with its argument. */
+struct upo_task_s
+{
+    upo_task_func_t func; /**< The function to run. */
+    void *arg; /**< The argument of the function. */
+};
+
+/**
+ * \brief A double-ended queue of tasks, stored in a circular array.
+ *
+ * The owner thread pushes and pops at the bottom, other threads steal from
+ * the top.
+ * Positions grow without bound and are reduced modulo the capacity when the
+ * array is accessed, so the number of tasks is always `bottom - top`.
+ */
+struct upo_task_deque_s
+{
+    pthread_mutex_t mutex; /**< Serializes the accesses to the queue. */
+    struct upo_task_s *tasks; /**< The circular array of tasks. */
+    size_t capacity; /**< The capacity of the array (a power of two). */
+    size_t top; /**< The position of the oldest task. */
+    size_t bottom; /**< The position following the newest task. */
+};
+
+/** \brief A thread of a task pool. */
+struct upo_task_worker_s
+{
+    upo_task_pool_t pool; /**< The pool this thread belongs to. */
+    size_t id; /**< The thread index (#0 is the thread calling upo_task_pool_wait()). */
+    struct upo_task_deque_s deque; /**< The tasks spawned by this thread. */
+    pthread_t thread; /**< The thread (unused for thread #0). */
+};
+
+/** \brief Defines the type of a task pool. */
+struct upo_task_pool_s
+{
+    size_t nthreads; /**< The number of threads. */
+    struct upo_task_worker_s *workers; /**< The threads. */
+    atomic_size_t num_pending; /**< The number of tasks spawned and not completed yet. */
+    atomic_size_t num_queued; /**< The number of tasks waiting in some queue. */
+    atomic_size_t num_sleeping; /**< The number of threads sleeping (or about to) on \a cond. */
+    int stop; /**< Tells threads to exit (protected by \a mutex). */
+    pthread_mutex_t mutex; /**< Protects the sleep/wake-up protocol. */
+    pthread_cond_t cond; /**< Signaled when tasks are spawned, all of them complete, or threads must stop. */
+};
+
+/** \brief Body of each thread of a task pool but thread #0. */
+static void* upo_task_worker_main(void *arg);
+
+/** \brief Takes a task from the queue of the given thread or, if it is empty, steals one from another thread. */
+static int upo_task_take(struct upo_task_worker_s *worker, struct upo_task_s *task);
+
+/** \brief Runs the given task and records its completion. */
+static void upo_task_run(upo_task_pool_t pool, const struct upo_task_s *task);
+
+/** \brief Initializes an empty task queue. */
+static void upo_task_deque_init(struct upo_task_deque_s *deque);
+
+/** \brief Destroys a task queue. */
+static void upo_task_deque_destroy(struct upo_task_deque_s *deque);
+
+/** \brief Inserts a task at the bottom of a task queue. */
+static void upo_task_deque_push(struct upo_task_deque_s *deque, const struct upo_task_s *task);
+
+/** \brief Removes the task at the bottom of a task queue, if any. */
+static int upo_task_deque_pop(struct upo_task_deque_s *deque, struct upo_task_s *task);
+
+/** \brief Removes the task at the top of a task queue, if any. */
+static int upo_task_deque_steal(struct upo_task_deque_s *deque, struct upo_task_s *task);
+
+#endif /* UPO_TASK_PRIVATE_H */
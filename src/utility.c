@@ -20,21 +20,25 @@
  */
 
 #include <assert.h>
-/* Uncomment these lines if Alternative #2 is used
+#include <stdint.h>
 #include <string.h>
+/* Uncomment these lines if Alternative #2 is used
 #include <stdlib.h>
 #include <upo/error.h>
 */
 #include <upo/utility.h>
 
 
+/** \brief Size (in bytes) of the chunks exchanged at once by \c upo_swap. */
+#define UPO_SWAP_CHUNK_SIZE 32
+
+
 void upo_swap(void *a, void *b, size_t size)
 {
     // BEGIN of Alternative #1
 
     unsigned char *aa = a;
     unsigned char *bb = b;
-    size_t i;
 
     assert( a );
     assert( b );
@@ -45,13 +49,74 @@ void upo_swap(void *a, void *b, size_t size)
         return;
     }
 
-    for (i = 0; i < size; ++i)
+    /* Element sizes that are common in practice are exchanged with a few
+     * word-sized loads and stores (memcpy with a constant size is compiled to
+     * plain moves and is safe for unaligned data). */
+    switch (size)
+    {
+        case sizeof(uint32_t):
+            {
+                uint32_t tmp;
+                memcpy(&tmp, aa, sizeof tmp);
+                memcpy(aa, bb, sizeof tmp);
+                memcpy(bb, &tmp, sizeof tmp);
+            }
+            return;
+        case sizeof(uint64_t):
+            {
+                uint64_t tmp;
+                memcpy(&tmp, aa, sizeof tmp);
+                memcpy(aa, bb, sizeof tmp);
+                memcpy(bb, &tmp, sizeof tmp);
+            }
+            return;
+        case 2*sizeof(uint64_t):
+            {
+                uint64_t tmp[2];
+                memcpy(tmp, aa, sizeof tmp);
+                memcpy(aa, bb, sizeof tmp);
+                memcpy(bb, tmp, sizeof tmp);
+            }
+            return;
+        case 4*sizeof(uint64_t):
+            {
+                uint64_t tmp[4];
+                memcpy(tmp, aa, sizeof tmp);
+                memcpy(aa, bb, sizeof tmp);
+                memcpy(bb, tmp, sizeof tmp);
+            }
+            return;
+    }
+
+    /* Other sizes are exchanged in chunks, then in words, then byte by byte */
+    while (size >= UPO_SWAP_CHUNK_SIZE)
+    {
+        unsigned char tmp[UPO_SWAP_CHUNK_SIZE];
+        memcpy(tmp, aa, UPO_SWAP_CHUNK_SIZE);
+        memcpy(aa, bb, UPO_SWAP_CHUNK_SIZE);
+        memcpy(bb, tmp, UPO_SWAP_CHUNK_SIZE);
+        aa += UPO_SWAP_CHUNK_SIZE;
+        bb += UPO_SWAP_CHUNK_SIZE;
+        size -= UPO_SWAP_CHUNK_SIZE;
+    }
+    while (size >= sizeof(uint64_t))
+    {
+        uint64_t tmp;
+        memcpy(&tmp, aa, sizeof tmp);
+        memcpy(aa, bb, sizeof tmp);
+        memcpy(bb, &tmp, sizeof tmp);
+        aa += sizeof tmp;
+        bb += sizeof tmp;
+        size -= sizeof tmp;
+    }
+    while (size > 0)
     {
         unsigned char tmp = *aa;
         *aa = *bb;
         *bb = tmp;
         ++aa;
         ++bb;
+        --size;
     }
 
     // END of Alternative #1
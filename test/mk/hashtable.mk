@@ -1 +1 @@
-test_targets += test_hashtable_sepchain test_hashtable_linprob test_hashtable_sepchain_more test_hashtable_linprob_more test_hashtable_sepchain_olist
+test_targets += test_hashtable_sepchain test_hashtable_linprob test_hashtable_sepchain_more test_hashtable_linprob_more test_hashtable_sepchain_olist test_hashtable_robinhood test_hashtable_swiss
@@ -0,0 +1,405 @@
+/* vim: set tabstop=4 expandtab shiftwidth=4 softtabstop=4: */
+
+/**
+ * \file test/test_bench.c
+ *
+ * \brief Implementation for benchmark harness testing.
+ *
+ * \author Simone Gattini, Federico Barbero, Anton Iliev
+ *
+ * \copyright 2015 University of Piemonte Orientale, Computer Science Institute
+ *
+ *  This file is part of UPOalglib.
+ *
+ *  UPOalglib is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  UPOalglib is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with UPOalglib.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <assert.h>
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <upo/bench.h>
+
+
+#define EPS 1e-12
+
+
+/** \brief Counts the calls made by the benchmark. */
+typedef struct {
+            size_t num_setups;
+            size_t num_runs;
+            size_t num_teardowns;
+            int prepared;
+        } counter_t;
+
+
+static void counter_setup(void *arg);
+static void counter_run(void *arg);
+static void counter_teardown(void *arg);
+static char* read_output(FILE *fp);
+
+static void test_percentile();
+static void test_stats();
+static void test_outliers();
+static void test_run();
+static void test_csv_output();
+static void test_json_output();
+static void test_metrics();
+static void test_perf_counters();
+
+
+void counter_setup(void *arg)
+{
+    counter_t *c = arg;
+
+    assert(!c->prepared);
+    c->prepared = 1;
+    ++c->num_setups;
+}
+
+void counter_run(void *arg)
+{
+    counter_t *c = arg;
+
+    assert(c->prepared);
+    ++c->num_runs;
+}
+
+void counter_teardown(void *arg)
+{
+    counter_t *c = arg;
+
+    assert(c->prepared);
+    c->prepared = 0;
+    ++c->num_teardowns;
+}
+
+char* read_output(FILE *fp)
+{
+    long len;
+    size_t nread;
+    char *s = NULL;
+
+    fflush(fp);
+    len = ftell(fp);
+    assert(len >= 0);
+    s = malloc(len + 1);
+    assert(s != NULL);
+    rewind(fp);
+    nread = fread(s, 1, len, fp);
+    assert(nread == (size_t) len);
+    s[len] = '\0';
+
+    return s;
+}
+
+void test_percentile()
+{
+    double a[] = {1, 2, 3, 4, 5};
+    double b[] = {10, 20};
+    double c[] = {7};
+
+    assert(fabs(upo_bench_percentile(a, 5, 0) - 1) < EPS);
+    assert(fabs(upo_bench_percentile(a, 5, 50) - 3) < EPS);
+    assert(fabs(upo_bench_percentile(a, 5, 100) - 5) < EPS);
+    assert(fabs(upo_bench_percentile(a, 5, 25) - 2) < EPS);
+    assert(fabs(upo_bench_percentile(a, 5, 90) - 4.6) < EPS);
+    assert(fabs(upo_bench_percentile(b, 2, 50) - 15) < EPS);
+    assert(fabs(upo_bench_percentile(b, 2, 75) - 17.5) < EPS);
+    assert(fabs(upo_bench_percentile(c, 1, 0) - 7) < EPS);
+    assert(fabs(upo_bench_percentile(c, 1, 99) - 7) < EPS);
+}
+
+void test_stats()
+{
+    double samples[] = {4, 2, 5, 1, 3};
+    upo_bench_stats_t stats;
+
+    upo_bench_stats_compute(samples, 5, 0, &stats);
+    /* The samples are sorted in place */
+    assert(samples[0] == 1 && samples[4] == 5);
+    assert(stats.num_samples == 5);
+    assert(stats.num_outliers == 0);
+    assert(fabs(stats.min - 1) < EPS);
+    assert(fabs(stats.max - 5) < EPS);
+    assert(fabs(stats.mean - 3) < EPS);
+    assert(fabs(stats.median - 3) < EPS);
+    assert(fabs(stats.p25 - 2) < EPS);
+    assert(fabs(stats.p75 - 4) < EPS);
+    /* Sample standard deviation: sqrt(10/4) */
+    assert(fabs(stats.stddev - sqrt(2.5)) < EPS);
+
+    samples[0] = 0.5;
+    upo_bench_stats_compute(samples, 1, UPO_BENCH_DEFAULT_OUTLIER_FENCE, &stats);
+    assert(stats.num_samples == 1);
+    assert(stats.num_outliers == 0);
+    assert(fabs(stats.mean - 0.5) < EPS);
+    assert(fabs(stats.median - 0.5) < EPS);
+    assert(stats.stddev == 0);
+}
+
+void test_outliers()
+{
+    double samples[] = {10, 11, 12, 13, 14, 15, 16, 17, 18, 1000, 0.001};
+    size_t n = sizeof(samples) / sizeof(samples[0]);
+    double copy[sizeof(samples) / sizeof(samples[0])];
+    upo_bench_stats_t stats;
+
+    memcpy(copy, samples, sizeof(samples));
+    upo_bench_stats_compute(copy, n, UPO_BENCH_DEFAULT_OUTLIER_FENCE, &stats);
+    assert(stats.num_samples == 9);
+    assert(stats.num_outliers == 2);
+    assert(fabs(stats.min - 10) < EPS);
+    assert(fabs(stats.max - 18) < EPS);
+    assert(fabs(stats.mean - 14) < EPS);
+    assert(fabs(stats.median - 14) < EPS);
+
+    /* Rejection disabled */
+    memcpy(copy, samples, sizeof(samples));
+    upo_bench_stats_compute(copy, n, 0, &stats);
+    assert(stats.num_samples == n);
+    assert(stats.num_outliers == 0);
+    assert(fabs(stats.max - 1000) < EPS);
+
+    /* Identical samples are never outliers */
+    for (size_t i = 0; i < n; ++i)
+    {
+        copy[i] = 2;
+    }
+    upo_bench_stats_compute(copy, n, UPO_BENCH_DEFAULT_OUTLIER_FENCE, &stats);
+    assert(stats.num_samples == n);
+    assert(stats.stddev == 0);
+}
+
+void test_run()
+{
+    upo_bench_t bench = upo_bench_create(3, 7);
+    counter_t c = {0, 0, 0, 0};
+    upo_bench_stats_t stats;
+
+    assert(bench != NULL);
+    upo_bench_run(bench, "group", "name", 10, counter_setup, counter_run, counter_teardown, &c, &stats);
+    assert(c.num_setups == 10);
+    assert(c.num_runs == 10);
+    assert(c.num_teardowns == 10);
+    assert(stats.num_samples + stats.num_outliers == 7);
+    assert(stats.min >= 0);
+    assert(stats.min <= stats.median && stats.median <= stats.max);
+
+    /* Setup, teardown and statistics are optional */
+    c.prepared = 1;
+    upo_bench_run(bench, "group", "name", 10, NULL, counter_run, NULL, &c, NULL);
+    assert(c.num_runs == 20);
+    assert(c.num_setups == 10);
+
+    upo_bench_destroy(bench);
+    upo_bench_destroy(NULL);
+}
+
+void test_csv_output()
+{
+    FILE *fp = tmpfile();
+    upo_bench_t bench = upo_bench_create(0, 3);
+    upo_bench_stats_t stats;
+    double samples[] = {1, 2, 3};
+    char *out = NULL;
+
+    assert(fp != NULL);
+    upo_bench_stats_compute(samples, 3, 0, &stats);
+    upo_bench_set_output(bench, fp, upo_bench_csv_format);
+    upo_bench_report(bench, "random", "merge", 100, &stats);
+    upo_bench_report(bench, "a,b", "say \"hi\"", 5, &stats);
+    upo_bench_destroy(bench);
+
+    out = read_output(fp);
+    assert(strcmp(out,
+                  "group,name,n,samples,outliers,min,p25,median,p75,p90,p99,max,mean,stddev\n"
+                  "random,merge,100,3,0,1,1.5,2,2.5,2.8,2.98,3,2,1\n"
+                  "\"a,b\",\"say \"\"hi\"\"\",5,3,0,1,1.5,2,2.5,2.8,2.98,3,2,1\n") == 0);
+    free(out);
+    fclose(fp);
+}
+
+void test_json_output()
+{
+    FILE *fp = tmpfile();
+    upo_bench_t bench = upo_bench_create(0, 1);
+    upo_bench_stats_t stats;
+    double samples[] = {0.25};
+    char *out = NULL;
+
+    assert(fp != NULL);
+    upo_bench_stats_compute(samples, 1, 0, &stats);
+    upo_bench_set_output(bench, fp, upo_bench_json_format);
+    upo_bench_report(bench, "sorted", "quick", 8, &stats);
+    upo_bench_report(bench, "a\"b", "c\\d", 9, &stats);
+    upo_bench_destroy(bench);
+
+    out = read_output(fp);
+    assert(strcmp(out,
+                  "[\n"
+                  "  {\"group\": \"sorted\", \"name\": \"quick\", \"n\": 8, \"samples\": 1, \"outliers\": 0, \"min\": 0.25, \"p25\": 0.25, \"median\": 0.25, \"p75\": 0.25, \"p90\": 0.25, \"p99\": 0.25, \"max\": 0.25, \"mean\": 0.25, \"stddev\": 0},\n"
+                  "  {\"group\": \"a\\\"b\", \"name\": \"c\\\\d\", \"n\": 9, \"samples\": 1, \"outliers\": 0, \"min\": 0.25, \"p25\": 0.25, \"median\": 0.25, \"p75\": 0.25, \"p90\": 0.25, \"p99\": 0.25, \"max\": 0.25, \"mean\": 0.25, \"stddev\": 0}\n"
+                  "]\n") == 0);
+    free(out);
+    fclose(fp);
+
+    /* An empty report is still a valid JSON array */
+    fp = tmpfile();
+    assert(fp != NULL);
+    bench = upo_bench_create(0, 1);
+    upo_bench_set_output(bench, fp, upo_bench_json_format);
+    upo_bench_destroy(bench);
+    out = read_output(fp);
+    assert(strcmp(out, "[]\n") == 0);
+    free(out);
+    fclose(fp);
+}
+
+void test_metrics()
+{
+    const char *names[] = {"compares", "allocs"};
+    FILE *fp = tmpfile();
+    upo_bench_t bench = upo_bench_create(0, 1);
+    upo_bench_stats_t stats;
+    double samples[] = {0.5};
+    char *out = NULL;
+
+    assert(fp != NULL);
+    upo_bench_stats_compute(samples, 1, 0, &stats);
+    upo_bench_set_metrics(bench, names, 2);
+    upo_bench_set_output(bench, fp, upo_bench_csv_format);
+    upo_bench_set_metric(bench, 0, 12345678901.0);
+    upo_bench_set_metric(bench, 1, 1);
+    upo_bench_report(bench, "g", "a", 4, &stats);
+    /* Values are reset after each measurement */
+    upo_bench_set_metric(bench, 1, 2);
+    upo_bench_report(bench, "g", "b", 4, &stats);
+    upo_bench_destroy(bench);
+    out = read_output(fp);
+    assert(strcmp(out,
+                  "group,name,n,samples,outliers,min,p25,median,p75,p90,p99,max,mean,stddev,compares,allocs\n"
+                  "g,a,4,1,0,0.5,0.5,0.5,0.5,0.5,0.5,0.5,0.5,0,12345678901,1\n"
+                  "g,b,4,1,0,0.5,0.5,0.5,0.5,0.5,0.5,0.5,0.5,0,,2\n") == 0);
+    free(out);
+    fclose(fp);
+
+    fp = tmpfile();
+    assert(fp != NULL);
+    bench = upo_bench_create(0, 1);
+    upo_bench_set_metrics(bench, names, 2);
+    upo_bench_set_output(bench, fp, upo_bench_json_format);
+    upo_bench_set_metric(bench, 0, 7);
+    upo_bench_report(bench, "g", "a", 4, &stats);
+    upo_bench_destroy(bench);
+    out = read_output(fp);
+    assert(strcmp(out,
+                  "[\n"
+                  "  {\"group\": \"g\", \"name\": \"a\", \"n\": 4, \"samples\": 1, \"outliers\": 0, \"min\": 0.5, \"p25\": 0.5, \"median\": 0.5, \"p75\": 0.5, \"p90\": 0.5, \"p99\": 0.5, \"max\": 0.5, \"mean\": 0.5, \"stddev\": 0, \"compares\": 7, \"allocs\": null}\n"
+                  "]\n") == 0);
+    free(out);
+    fclose(fp);
+
+    fp = tmpfile();
+    assert(fp != NULL);
+    bench = upo_bench_create(0, 1);
+    upo_bench_set_metrics(bench, names, 2);
+    upo_bench_set_output(bench, fp, upo_bench_text_format);
+    upo_bench_set_metric(bench, 1, 3);
+    upo_bench_report(bench, "g", "a", 4, &stats);
+    upo_bench_report(bench, "g", "b", 4, &stats);
+    upo_bench_destroy(bench);
+    out = read_output(fp);
+    assert(strstr(out, "outliers) [allocs 3]\n") != NULL);
+    assert(strstr(out, "outliers)\n") != NULL);
+    free(out);
+    fclose(fp);
+}
+
+void test_perf_counters()
+{
+    const char *names[] = {"compares"};
+    FILE *fp = tmpfile();
+    upo_bench_t bench = upo_bench_create(1, 3);
+    counter_t c = {0, 0, 0, 0};
+    upo_bench_stats_t stats;
+    char *out = NULL;
+
+    assert(fp != NULL);
+    upo_bench_set_metrics(bench, names, 1);
+    upo_bench_set_perf_counters(bench, 1);
+    upo_bench_set_output(bench, fp, upo_bench_csv_format);
+    upo_bench_set_metric(bench, 0, 5);
+    upo_bench_run(bench, "g", "a", 4, counter_setup, counter_run, counter_teardown, &c, &stats);
+    assert(c.num_runs == 4);
+    assert(stats.min >= 0);
+    /* The counters come after the metrics set by the caller */
+    upo_bench_set_perf_counters(bench, 0);
+    upo_bench_set_output(bench, fp, upo_bench_csv_format);
+    upo_bench_destroy(bench);
+    out = read_output(fp);
+    assert(strncmp(out,
+                   "group,name,n,samples,outliers,min,p25,median,p75,p90,p99,max,mean,stddev,compares,cycles,instructions,cache_misses,branch_misses,task_clock\n"
+                   "g,a,4,", 146) == 0);
+    assert(strstr(out, "\ngroup,name,n,samples,outliers,min,p25,median,p75,p90,p99,max,mean,stddev,compares\n") != NULL);
+    free(out);
+    fclose(fp);
+}
+
+
+int main(void)
+{
+    printf("Test case 'percentile'... ");
+    fflush(stdout);
+    test_percentile();
+    printf("OK\n");
+
+    printf("Test case 'statistics'... ");
+    fflush(stdout);
+    test_stats();
+    printf("OK\n");
+
+    printf("Test case 'outlier rejection'... ");
+    fflush(stdout);
+    test_outliers();
+    printf("OK\n");
+
+    printf("Test case 'run'... ");
+    fflush(stdout);
+    test_run();
+    printf("OK\n");
+
+    printf("Test case 'CSV output'... ");
+    fflush(stdout);
+    test_csv_output();
+    printf("OK\n");
+
+    printf("Test case 'JSON output'... ");
+    fflush(stdout);
+    test_json_output();
+    printf("OK\n");
+
+    printf("Test case 'metrics'... ");
+    fflush(stdout);
+    test_metrics();
+    printf("OK\n");
+
+    printf("Test case 'performance counters'... ");
+    fflush(stdout);
+    test_perf_counters();
+    printf("OK\n");
+
+    return 0;
+}
@@ -0,0 +1,289 @@
+/* vim: set tabstop=4 expandtab shiftwidth=4 softtabstop=4: */
+
+/*
+ * Copyright 2015 University of Piemonte Orientale, Computer Science Institute
+ *
+ * This file is part of UPOalglib.
+ *
+ * UPOalglib is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * UPOalglib is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with UPOalglib.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <assert.h>
+#include <math.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <upo/hash.h>
+
+
+#define NUM_BUCKETS 1024U
+#define NUM_KEYS (100U*NUM_BUCKETS)
+
+
+static int uint64_comparator(const void *a, const void *b);
+static size_t num_distinct(uint64_t *hashes, size_t n);
+/** \brief Returns how many standard deviations the chi-square statistic of the low-order bits of the hashes is from its mean. */
+static double chi_square_z(const uint64_t *hashes, size_t n);
+
+static void test_mix64();
+static void test_bytes();
+static void test_int_str();
+static void test_seeded();
+static void test_chi_square();
+static void test_distribution();
+
+
+int uint64_comparator(const void *a, const void *b)
+{
+    uint64_t aa = *(const uint64_t *) a;
+    uint64_t bb = *(const uint64_t *) b;
+
+    return (aa > bb) - (aa < bb);
+}
+
+size_t num_distinct(uint64_t *hashes, size_t n)
+{
+    size_t count = (n > 0) ? 1 : 0;
+    size_t i;
+
+    qsort(hashes, n, sizeof(uint64_t), uint64_comparator);
+    for (i = 1; i < n; ++i)
+    {
+        count += (hashes[i] != hashes[i - 1]);
+    }
+
+    return count;
+}
+
+double chi_square_z(const uint64_t *hashes, size_t n)
+{
+    size_t counts[NUM_BUCKETS];
+    size_t i;
+
+    memset(counts, 0, sizeof(counts));
+    for (i = 0; i < n; ++i)
+    {
+        ++counts[hashes[i] & (NUM_BUCKETS - 1)];
+    }
+
+    return (upo_hash_chi_square(counts, NUM_BUCKETS) - (NUM_BUCKETS - 1)) / sqrt(2.0 * (NUM_BUCKETS - 1));
+}
+
+void test_mix64()
+{
+    uint64_t hashes[1000];
+    size_t flips = 0;
+    size_t i;
+    int bit;
+
+    for (i = 0; i < 1000; ++i)
+    {
+        hashes[i] = upo_hash_mix64(i);
+    }
+    assert(num_distinct(hashes, 1000) == 1000);
+
+    /* Avalanche: flipping an input bit flips half of the output bits on average */
+    for (i = 0; i < 100; ++i)
+    {
+        uint64_t x = upo_hash_mix64(i + 12345);
+
+        for (bit = 0; bit < 64; ++bit)
+        {
+            uint64_t d = upo_hash_mix64(x) ^ upo_hash_mix64(x ^ (UINT64_C(1) << bit));
+
+            for (; d != 0; d &= d - 1)
+            {
+                ++flips;
+            }
+        }
+    }
+    assert(fabs(flips / (100.0 * 64) - 32) < 1);
+}
+
+void test_bytes()
+{
+    unsigned char buf[200];
+    unsigned char copy[208];
+    uint64_t hashes[129];
+    size_t n;
+    size_t off;
+
+    for (n = 0; n < sizeof(buf); ++n)
+    {
+        buf[n] = (unsigned char) (n * 7 + 1);
+    }
+
+    /* Every prefix, including the empty one, has its own hash */
+    for (n = 0; n <= 128; ++n)
+    {
+        hashes[n] = upo_hash_bytes(buf, n, 0);
+        assert(hashes[n] == upo_hash_bytes(buf, n, 0));
+    }
+    assert(num_distinct(hashes, 129) == 129);
+
+    /* The hash depends on the bytes only, not on their alignment */
+    for (n = 0; n <= 128; n += 3)
+    {
+        for (off = 1; off < 8; ++off)
+        {
+            memcpy(copy + off, buf, n);
+            assert(upo_hash_bytes(copy + off, n, 0) == upo_hash_bytes(buf, n, 0));
+        }
+    }
+
+    /* Every byte matters, in every length class */
+    for (n = 1; n <= 128; n += 5)
+    {
+        for (off = 0; off < n; ++off)
+        {
+            memcpy(copy, buf, n);
+            copy[off] ^= 1;
+            assert(upo_hash_bytes(copy, n, 0) != upo_hash_bytes(buf, n, 0));
+        }
+    }
+
+    /* The seed selects another function */
+    assert(upo_hash_bytes(buf, 10, 1) != upo_hash_bytes(buf, 10, 0));
+    assert(upo_hash_bytes(NULL, 0, 1) != upo_hash_bytes(NULL, 0, 0));
+}
+
+void test_int_str()
+{
+    int x = 42;
+    int y = -1;
+    const char *s = "alice";
+    const char *t = "";
+
+    assert(upo_hash_int(&x) == upo_hash_mix64(42));
+    assert(upo_hash_int(&y) == upo_hash_mix64(UINT64_C(0xffffffff)));
+    assert(upo_hash_str(&s) == upo_hash_bytes("alice", 5, 0));
+    assert(upo_hash_str(&t) == upo_hash_bytes("", 0, 0));
+}
+
+void test_seeded()
+{
+    int x = 42;
+    const char *s = "alice";
+    uint64_t h_int;
+    uint64_t h_str;
+
+    assert(upo_hash_get_seed() == 0);
+
+    h_int = upo_hash_int_seeded(&x);
+    h_str = upo_hash_str_seeded(&s);
+    assert(h_str == upo_hash_str(&s));
+
+    upo_hash_set_seed(upo_hash_random_seed());
+    /* The chance of drawing zero again is negligible */
+    assert(upo_hash_get_seed() != 0);
+    assert(upo_hash_int_seeded(&x) != h_int);
+    assert(upo_hash_str_seeded(&s) != h_str);
+    assert(upo_hash_str_seeded(&s) == upo_hash_bytes("alice", 5, upo_hash_get_seed()));
+    assert(upo_hash_random_seed() != upo_hash_random_seed());
+
+    upo_hash_set_seed(0);
+    assert(upo_hash_int_seeded(&x) == h_int);
+}
+
+void test_chi_square()
+{
+    size_t uniform[] = {5, 5, 5, 5};
+    size_t skewed[] = {8, 0, 4, 4};
+    size_t empty[] = {0, 0};
+
+    assert(upo_hash_chi_square(uniform, 4) == 0);
+    /* (9 + 16 + 1 + 1) / 4 */
+    assert(fabs(upo_hash_chi_square(skewed, 4) - 8) < 1e-12);
+    assert(upo_hash_chi_square(empty, 2) == 0);
+}
+
+void test_distribution()
+{
+    static uint64_t hashes[NUM_KEYS];
+    static char strs[NUM_KEYS][12];
+    size_t i;
+
+    /* Structured keys, which the low-order bits must spread anyway */
+    for (i = 0; i < NUM_KEYS; ++i)
+    {
+        int x = (int) (i << 10);
+
+        hashes[i] = upo_hash_int(&x);
+    }
+    assert(fabs(chi_square_z(hashes, NUM_KEYS)) < 5);
+
+    for (i = 0; i < NUM_KEYS; ++i)
+    {
+        int x = (int) i;
+
+        hashes[i] = upo_hash_int_seeded(&x);
+    }
+    assert(fabs(chi_square_z(hashes, NUM_KEYS)) < 5);
+
+    for (i = 0; i < NUM_KEYS; ++i)
+    {
+        const char *s = strs[i];
+
+        sprintf(strs[i], "%lu", (unsigned long) i);
+        hashes[i] = upo_hash_str(&s);
+    }
+    assert(fabs(chi_square_z(hashes, NUM_KEYS)) < 5);
+
+    for (i = 0; i < NUM_KEYS; ++i)
+    {
+        const char *s = strs[i];
+
+        sprintf(strs[i], "key%07lu", (unsigned long) i);
+        hashes[i] = upo_hash_str(&s);
+    }
+    assert(fabs(chi_square_z(hashes, NUM_KEYS)) < 5);
+    assert(num_distinct(hashes, NUM_KEYS) == NUM_KEYS);
+}
+
+
+int main()
+{
+    printf("Test case 'mix64'... ");
+    fflush(stdout);
+    test_mix64();
+    printf("OK\n");
+
+    printf("Test case 'bytes'... ");
+    fflush(stdout);
+    test_bytes();
+    printf("OK\n");
+
+    printf("Test case 'int/str'... ");
+    fflush(stdout);
+    test_int_str();
+    printf("OK\n");
+
+    printf("Test case 'seeded'... ");
+    fflush(stdout);
+    test_seeded();
+    printf("OK\n");
+
+    printf("Test case 'chi-square'... ");
+    fflush(stdout);
+    test_chi_square();
+    printf("OK\n");
+
+    printf("Test case 'distribution'... ");
+    fflush(stdout);
+    test_distribution();
+    printf("OK\n");
+
+    return 0;
+}
@@ -39,7 +39,9 @@ static void test_clear();
 static void test_empty();
 static void test_size();
 static void test_resize();
+static void test_tombstones();
 static void test_hash_funcs();
+static void test_hash64();
 static void test_null();
 
 int str_compare(const void *a, const void *b)
@@ -1203,6 +1205,62 @@ void test_resize()
     upo_ht_linprob_destroy(ht, 0);
 }
 
+void test_tombstones()
+{
+    int keys[1000];
+    size_t n = sizeof keys / sizeof keys[0];
+    size_t m = 16;
+    size_t i = 0;
+    upo_ht_linprob_t ht = NULL;
+
+    ht = upo_ht_linprob_create(m, upo_ht_hash_int_div, int_compare);
+
+    assert(ht != NULL);
+
+    for (i = 0; i < n; ++i)
+    {
+        keys[i] = (int) i;
+    }
+
+    /* Keeps four keys while inserting and deleting many others: the deleted
+     * slots must not fill the table, nor make it grow */
+    for (i = 0; i < 4; ++i)
+    {
+        upo_ht_linprob_put(ht, &keys[i], &keys[i]);
+    }
+    for (i = 4; i < n; ++i)
+    {
+        upo_ht_linprob_put(ht, &keys[i], &keys[i]);
+        upo_ht_linprob_delete(ht, &keys[i - 1], 0);
+
+        assert(upo_ht_linprob_size(ht) == 4);
+        assert(upo_ht_linprob_capacity(ht) == m);
+        assert(upo_ht_linprob_get(ht, &keys[i]) == &keys[i]);
+        assert(upo_ht_linprob_get(ht, &keys[i - 1]) == NULL);
+    }
+    for (i = 0; i < 3; ++i)
+    {
+        assert(upo_ht_linprob_contains(ht, &keys[i]));
+    }
+
+    /* Clearing removes the tombstones too */
+    upo_ht_linprob_clear(ht, 0);
+
+    assert(upo_ht_linprob_size(ht) == 0);
+    assert(upo_ht_linprob_get(ht, &keys[0]) == NULL);
+
+    upo_ht_linprob_destroy(ht, 0);
+
+    /* A table without slots gets some on the first insertion */
+    ht = upo_ht_linprob_create(0, upo_ht_hash_int_div, int_compare);
+    upo_ht_linprob_insert(ht, &keys[0], &keys[0]);
+
+    assert(upo_ht_linprob_size(ht) == 1);
+    assert(upo_ht_linprob_capacity(ht) > 0);
+
+    upo_ht_linprob_destroy(ht, 0);
+}
+
 void test_hash_funcs()
 {
     int int_keys[] = {0, 1, 2, 3, 4, 5, 6, 7, 8, 9};
@@ -1294,6 +1352,73 @@ void test_hash_funcs()
     upo_ht_linprob_destroy(ht, 0);
 }
 
+void test_hash64()
+{
+    int keys[100];
+    char *str_keys[] = {"alice", "bob", "charlie", "dany", "eric", "george", "john", "katy", "luke", "mark"};
+    size_t n = sizeof keys / sizeof keys[0];
+    size_t n_str = sizeof str_keys / sizeof str_keys[0];
+    size_t i = 0;
+    int pow2 = 0;
+    upo_ht_linprob_t ht = NULL;
+
+    /* The finalizer is a bijection that spreads small keys */
+    assert(upo_ht_hash_finalize(0) == 0);
+    assert(upo_ht_hash_finalize(1) != upo_ht_hash_finalize(2));
+    assert((upo_ht_hash_finalize(1) >> 32) != 0);
+
+    for (i = 0; i < n; ++i)
+    {
+        keys[i] = (int) (i * 1024);
+    }
+
+    for (pow2 = 0; pow2 <= 1; ++pow2)
+    {
+        ht = upo_ht_linprob_create_hash64(10, upo_ht_hash64_int, int_compare, pow2);
+
+        assert(ht != NULL);
+        assert(upo_ht_linprob_capacity(ht) == (pow2 ? 16U : 10U));
+        assert(upo_ht_linprob_get_hasher(ht) == NULL);
+        assert(upo_ht_linprob_get_hasher64(ht) == upo_ht_hash64_int);
+
+        for (i = 0; i < n; ++i)
+        {
+            upo_ht_linprob_put(ht, &keys[i], &keys[i]);
+        }
+
+        assert(upo_ht_linprob_size(ht) == n);
+        if (pow2)
+        {
+            size_t m = upo_ht_linprob_capacity(ht);
+
+            assert((m & (m - 1)) == 0);
+        }
+
+        for (i = 0; i < n; i += 2)
+        {
+            upo_ht_linprob_delete(ht, &keys[i], 0);
+        }
+        for (i = 0; i < n; ++i)
+        {
+            assert(upo_ht_linprob_get(ht, &keys[i]) == ((i % 2) ? &keys[i] : NULL));
+        }
+
+        upo_ht_linprob_destroy(ht, 0);
+    }
+
+    ht = upo_ht_linprob_create_hash64(0, upo_ht_hash64_str_djb2, str_compare, 1);
+    for (i = 0; i < n_str; ++i)
+    {
+        upo_ht_linprob_insert(ht, &str_keys[i], &keys[i]);
+    }
+    for (i = 0; i < n_str; ++i)
+    {
+        assert(upo_ht_linprob_contains(ht, &str_keys[i]));
+        assert(upo_ht_linprob_get(ht, &str_keys[i]) == &keys[i]);
+    }
+    upo_ht_linprob_destroy(ht, 0);
+}
+
 void test_null()
 {
     upo_ht_linprob_t ht = NULL;
@@ -1346,11 +1471,21 @@ int main()
     test_resize();
     printf("OK\n");
 
+    printf("Test case 'tombstones'... ");
+    fflush(stdout);
+    test_tombstones();
+    printf("OK\n");
+
     printf("Test case 'hash_funcs'... ");
     fflush(stdout);
     test_hash_funcs();
     printf("OK\n");
 
+    printf("Test case 'hash64'... ");
+    fflush(stdout);
+    test_hash64();
+    printf("OK\n");
+
     printf("Test case 'null'... ");
     fflush(stdout);
     test_null();
@@ -0,0 +1,602 @@
+/* vim: set tabstop=4 expandtab shiftwidth=4 softtabstop=4: */
+
+/*
+ * Copyright 2015 University of Piemonte Orientale, Computer Science Institute
+ *
+ * This file is part of UPOalglib.
+ *
+ * UPOalglib is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * UPOalglib is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with UPOalglib.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <assert.h>
+#include <stddef.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <upo/hashtable.h>
+#include <upo/error.h>
+
+static int str_compare(const void *a, const void *b);
+static int int_compare(const void *a, const void *b);
+static void count_visitor(void *key, void *value, void *context);
+
+static void test_create_destroy();
+static void test_put_get_contains_delete();
+static void test_insert();
+static void test_clear_empty_size();
+static void test_resize();
+static void test_backward_shift();
+static void test_churn();
+static void test_keys_traverse();
+static void test_merge();
+static void test_hash64();
+static void test_null();
+
+int str_compare(const void *a, const void *b)
+{
+    const char **aa = (const char **)a;
+    const char **bb = (const char **)b;
+
+    assert(a != NULL);
+    assert(b != NULL);
+
+    return strcmp(*aa, *bb);
+}
+
+int int_compare(const void *a, const void *b)
+{
+    const int *aa = a;
+    const int *bb = b;
+
+    assert(a != NULL);
+    assert(b != NULL);
+
+    return (*aa > *bb) - (*aa < *bb);
+}
+
+void count_visitor(void *key, void *value, void *context)
+{
+    size_t *count = context;
+
+    assert(key != NULL);
+    assert(key == value);
+
+    *count += 1;
+}
+
+void test_create_destroy()
+{
+    upo_ht_robinhood_t ht;
+
+    ht = upo_ht_robinhood_create(UPO_HT_ROBINHOOD_DEFAULT_CAPACITY, upo_ht_hash_str_kr2e, str_compare);
+
+    assert(ht != NULL);
+    assert(upo_ht_robinhood_capacity(ht) == UPO_HT_ROBINHOOD_DEFAULT_CAPACITY);
+    assert(upo_ht_robinhood_get_comparator(ht) == str_compare);
+    assert(upo_ht_robinhood_get_hasher(ht) == upo_ht_hash_str_kr2e);
+    assert(upo_ht_robinhood_get_hasher64(ht) == NULL);
+
+    upo_ht_robinhood_destroy(ht, 0);
+
+    ht = upo_ht_robinhood_create(UPO_HT_ROBINHOOD_DEFAULT_CAPACITY, upo_ht_hash_str_kr2e, str_compare);
+
+    assert(ht != NULL);
+
+    upo_ht_robinhood_destroy(ht, 1);
+}
+
+void test_put_get_contains_delete()
+{
+    int keys1[] = {0, 1, 2, 3, 4, 5, 6, 7, 8, 9};
+    int keys2[] = {0, 10, 20, 30, 40, 50, 60, 70, 80, 90};
+    int keys3[] = {0, 1, 2, 3, 4, 10, 11, 12, 13, 14};
+    int *keys[] = {keys1, keys2, keys3};
+    int values[] = {0, 1, 2, 3, 4, 5, 6, 7, 8, 9};
+    int values_upd[] = {9, 8, 7, 6, 5, 4, 3, 2, 1, 0};
+    int missing = 100;
+    size_t n = sizeof keys1 / sizeof keys1[0];
+    size_t k = 0;
+    size_t i = 0;
+    size_t j = 0;
+    upo_ht_robinhood_t ht = NULL;
+
+    /* HT: no collision, many collisions, some collisions */
+    for (k = 0; k < sizeof keys / sizeof keys[0]; ++k)
+    {
+        ht = upo_ht_robinhood_create(2 * n, upo_ht_hash_int_div, int_compare);
+
+        assert(ht != NULL);
+
+        /* Insertion */
+        for (i = 0; i < n; ++i)
+        {
+            assert(upo_ht_robinhood_put(ht, &keys[k][i], &values[i]) == NULL);
+        }
+        assert(upo_ht_robinhood_size(ht) == n);
+        /* Search */
+        for (i = 0; i < n; ++i)
+        {
+            int *value = upo_ht_robinhood_get(ht, &keys[k][i]);
+
+            assert(value != NULL);
+            assert(*value == values[i]);
+            assert(upo_ht_robinhood_contains(ht, &keys[k][i]));
+        }
+        assert(upo_ht_robinhood_get(ht, &missing) == NULL);
+        assert(!upo_ht_robinhood_contains(ht, &missing));
+        /* Update */
+        for (i = 0; i < n; ++i)
+        {
+            int *old_value = upo_ht_robinhood_put(ht, &keys[k][i], &values_upd[i]);
+
+            assert(old_value == &values[i]);
+        }
+        assert(upo_ht_robinhood_size(ht) == n);
+        /* Removal */
+        for (i = 0; i < n; ++i)
+        {
+            upo_ht_robinhood_delete(ht, &keys[k][i], 0);
+
+            assert(!upo_ht_robinhood_contains(ht, &keys[k][i]));
+            for (j = i + 1; j < n; ++j)
+            {
+                int *value = upo_ht_robinhood_get(ht, &keys[k][j]);
+
+                assert(value != NULL);
+                assert(*value == values_upd[j]);
+            }
+        }
+        assert(upo_ht_robinhood_is_empty(ht));
+
+        /* Removal of a missing key */
+        upo_ht_robinhood_delete(ht, &missing, 0);
+
+        assert(upo_ht_robinhood_is_empty(ht));
+
+        upo_ht_robinhood_destroy(ht, 0);
+    }
+}
+
+void test_insert()
+{
+    int keys[] = {0, 10, 20, 30};
+    int values[] = {0, 1, 2, 3};
+    int values_upd[] = {3, 2, 1, 0};
+    size_t n = sizeof keys / sizeof keys[0];
+    size_t i = 0;
+    upo_ht_robinhood_t ht = NULL;
+
+    ht = upo_ht_robinhood_create(10, upo_ht_hash_int_div, int_compare);
+
+    assert(ht != NULL);
+
+    for (i = 0; i < n; ++i)
+    {
+        upo_ht_robinhood_insert(ht, &keys[i], &values[i]);
+    }
+    /* Duplicates are ignored */
+    for (i = 0; i < n; ++i)
+    {
+        upo_ht_robinhood_insert(ht, &keys[i], &values_upd[i]);
+    }
+
+    assert(upo_ht_robinhood_size(ht) == n);
+    for (i = 0; i < n; ++i)
+    {
+        assert(upo_ht_robinhood_get(ht, &keys[i]) == &values[i]);
+    }
+
+    upo_ht_robinhood_destroy(ht, 0);
+}
+
+void test_clear_empty_size()
+{
+    size_t n = 10;
+    size_t i = 0;
+    upo_ht_robinhood_t ht = NULL;
+
+    ht = upo_ht_robinhood_create(UPO_HT_ROBINHOOD_DEFAULT_CAPACITY, upo_ht_hash_int_div, int_compare);
+
+    assert(ht != NULL);
+    assert(upo_ht_robinhood_is_empty(ht));
+    assert(upo_ht_robinhood_size(ht) == 0);
+
+    /* Keys and values are freed on clear */
+    for (i = 0; i < n; ++i)
+    {
+        int *key = malloc(sizeof(int));
+        int *value = malloc(sizeof(int));
+
+        if (key == NULL || value == NULL)
+        {
+            upo_throw_sys_error("Unable to allocate memory for key-value pairs");
+        }
+        *key = (int) i;
+        *value = (int) i;
+        upo_ht_robinhood_put(ht, key, value);
+
+        assert(upo_ht_robinhood_size(ht) == i + 1);
+        assert(!upo_ht_robinhood_is_empty(ht));
+    }
+
+    upo_ht_robinhood_clear(ht, 1);
+
+    assert(upo_ht_robinhood_is_empty(ht));
+    assert(upo_ht_robinhood_size(ht) == 0);
+    assert(upo_ht_robinhood_load_factor(ht) == 0);
+
+    upo_ht_robinhood_destroy(ht, 0);
+}
+
+void test_resize()
+{
+    int keys[1000];
+    size_t n = sizeof keys / sizeof keys[0];
+    size_t i = 0;
+    upo_ht_robinhood_t ht = NULL;
+
+    for (i = 0; i < n; ++i)
+    {
+        keys[i] = (int) i;
+    }
+
+    /* Capacities from none to one slot */
+    for (i = 0; i <= 1; ++i)
+    {
+        size_t j = 0;
+
+        ht = upo_ht_robinhood_create(i, upo_ht_hash_int_div, int_compare);
+
+        assert(ht != NULL);
+
+        /* Insertion */
+        for (j = 0; j < n; ++j)
+        {
+            upo_ht_robinhood_put(ht, &keys[j], &keys[j]);
+
+            assert(upo_ht_robinhood_size(ht) == j + 1);
+            assert(upo_ht_robinhood_load_factor(ht) <= 0.875);
+        }
+        for (j = 0; j < n; ++j)
+        {
+            assert(upo_ht_robinhood_get(ht, &keys[j]) == &keys[j]);
+        }
+
+        /* Removal */
+        for (j = 0; j < n; ++j)
+        {
+            upo_ht_robinhood_delete(ht, &keys[j], 0);
+
+            assert(upo_ht_robinhood_size(ht) == n - j - 1);
+            assert(upo_ht_robinhood_size(ht) < upo_ht_robinhood_capacity(ht));
+        }
+        assert(upo_ht_robinhood_capacity(ht) < 16);
+
+        upo_ht_robinhood_destroy(ht, 0);
+    }
+}
+
+void test_backward_shift()
+{
+    /* With 16 slots, keys 0, 16, 32 and 48 share slot 0, keys 1 and 17 share
+     * slot 1, and key 15 wraps around the end of the table */
+    int keys[] = {0, 16, 1, 32, 17, 48, 15, 31};
+    size_t n = sizeof keys / sizeof keys[0];
+    size_t first = 0;
+    size_t i = 0;
+    upo_ht_robinhood_t ht = NULL;
+
+    /* Deletes each key in turn from a fresh table and checks that the rest of
+     * the run is still reachable */
+    for (first = 0; first < n; ++first)
+    {
+        ht = upo_ht_robinhood_create(16, upo_ht_hash_int_div, int_compare);
+
+        assert(ht != NULL);
+
+        for (i = 0; i < n; ++i)
+        {
+            upo_ht_robinhood_put(ht, &keys[i], &keys[i]);
+        }
+
+        assert(upo_ht_robinhood_capacity(ht) == 16);
+
+        for (i = 0; i < n; ++i)
+        {
+            size_t k = (first + i) % n;
+            size_t j = 0;
+
+            upo_ht_robinhood_delete(ht, &keys[k], 0);
+
+            assert(upo_ht_robinhood_get(ht, &keys[k]) == NULL);
+            for (j = i + 1; j < n; ++j)
+            {
+                size_t h = (first + j) % n;
+
+                assert(upo_ht_robinhood_get(ht, &keys[h]) == &keys[h]);
+            }
+        }
+        assert(upo_ht_robinhood_is_empty(ht));
+
+        upo_ht_robinhood_destroy(ht, 0);
+    }
+}
+
+void test_churn()
+{
+    int keys[10000];
+    size_t n = sizeof keys / sizeof keys[0];
+    size_t live = 12;
+    size_t m = 16;
+    size_t i = 0;
+    upo_ht_robinhood_t ht = NULL;
+
+    for (i = 0; i < n; ++i)
+    {
+        keys[i] = (int) (i * 7);
+    }
+
+    ht = upo_ht_robinhood_create(m, upo_ht_hash_int_div, int_compare);
+
+    assert(ht != NULL);
+
+    /* Keeps a window of keys at a load factor of 3/4 while inserting and
+     * deleting many others: nothing is left behind to fill the table */
+    for (i = 0; i < live; ++i)
+    {
+        upo_ht_robinhood_put(ht, &keys[i], &keys[i]);
+    }
+    for (i = live; i < n; ++i)
+    {
+        size_t j = 0;
+
+        upo_ht_robinhood_put(ht, &keys[i], &keys[i]);
+        upo_ht_robinhood_delete(ht, &keys[i - live], 0);
+
+        assert(upo_ht_robinhood_size(ht) == live);
+        assert(upo_ht_robinhood_capacity(ht) == m);
+        assert(!upo_ht_robinhood_contains(ht, &keys[i - live]));
+        for (j = i - live + 1; j <= i; ++j)
+        {
+            assert(upo_ht_robinhood_get(ht, &keys[j]) == &keys[j]);
+        }
+    }
+
+    upo_ht_robinhood_destroy(ht, 0);
+}
+
+void test_keys_traverse()
+{
+    int keys[] = {0, 16, 1, 32, 17, 5, 15, 31};
+    size_t n = sizeof keys / sizeof keys[0];
+    size_t count = 0;
+    size_t i = 0;
+    upo_ht_key_list_t list = NULL;
+    upo_ht_robinhood_t ht = NULL;
+
+    ht = upo_ht_robinhood_create(16, upo_ht_hash_int_div, int_compare);
+
+    assert(upo_ht_robinhood_keys(ht) == NULL);
+
+    for (i = 0; i < n; ++i)
+    {
+        upo_ht_robinhood_put(ht, &keys[i], &keys[i]);
+    }
+
+    upo_ht_robinhood_traverse(ht, count_visitor, &count);
+
+    assert(count == n);
+
+    list = upo_ht_robinhood_keys(ht);
+    count = 0;
+    while (list != NULL)
+    {
+        upo_ht_key_list_t next = list->next;
+
+        assert(upo_ht_robinhood_contains(ht, list->key));
+
+        ++count;
+        free(list);
+        list = next;
+    }
+
+    assert(count == n);
+
+    upo_ht_robinhood_destroy(ht, 0);
+}
+
+void test_merge()
+{
+    int keys[] = {0, 16, 1, 32, 17, 5, 15, 31};
+    int values[] = {10, 11, 12, 13, 14, 15, 16, 17};
+    size_t n = sizeof keys / sizeof keys[0];
+    size_t half = n / 2;
+    size_t i = 0;
+    upo_ht_robinhood_t dest_ht = NULL;
+    upo_ht_robinhood_t src_ht = NULL;
+
+    dest_ht = upo_ht_robinhood_create(UPO_HT_ROBINHOOD_DEFAULT_CAPACITY, upo_ht_hash_int_div, int_compare);
+    src_ht = upo_ht_robinhood_create(UPO_HT_ROBINHOOD_DEFAULT_CAPACITY, upo_ht_hash_int_div, int_compare);
+
+    /* The tables share the key in the middle */
+    for (i = 0; i <= half; ++i)
+    {
+        upo_ht_robinhood_put(dest_ht, &keys[i], &keys[i]);
+    }
+    for (i = half; i < n; ++i)
+    {
+        upo_ht_robinhood_put(src_ht, &keys[i], &values[i]);
+    }
+
+    upo_ht_robinhood_merge(dest_ht, src_ht);
+
+    assert(upo_ht_robinhood_size(dest_ht) == n);
+    assert(upo_ht_robinhood_size(src_ht) == n - half);
+    for (i = 0; i < n; ++i)
+    {
+        /* Shared keys keep the value of the destination */
+        assert(upo_ht_robinhood_get(dest_ht, &keys[i]) == (i <= half ? &keys[i] : &values[i]));
+    }
+
+    /* Merging with a missing table does nothing */
+    upo_ht_robinhood_merge(dest_ht, NULL);
+    upo_ht_robinhood_merge(NULL, src_ht);
+
+    assert(upo_ht_robinhood_size(dest_ht) == n);
+
+    upo_ht_robinhood_destroy(dest_ht, 0);
+    upo_ht_robinhood_destroy(src_ht, 0);
+}
+
+void test_hash64()
+{
+    int keys[100];
+    char *str_keys[] = {"alice", "bob", "charlie", "dany", "eric", "george", "john", "katy", "luke", "mark"};
+    size_t n = sizeof keys / sizeof keys[0];
+    size_t n_str = sizeof str_keys / sizeof str_keys[0];
+    size_t i = 0;
+    int pow2 = 0;
+    upo_ht_robinhood_t ht = NULL;
+
+    for (i = 0; i < n; ++i)
+    {
+        keys[i] = (int) (i * 1024);
+    }
+
+    for (pow2 = 0; pow2 <= 1; ++pow2)
+    {
+        ht = upo_ht_robinhood_create_hash64(10, upo_ht_hash64_int, int_compare, pow2);
+
+        assert(ht != NULL);
+        assert(upo_ht_robinhood_capacity(ht) == (pow2 ? 16U : 10U));
+        assert(upo_ht_robinhood_get_hasher(ht) == NULL);
+        assert(upo_ht_robinhood_get_hasher64(ht) == upo_ht_hash64_int);
+
+        for (i = 0; i < n; ++i)
+        {
+            upo_ht_robinhood_put(ht, &keys[i], &keys[i]);
+        }
+
+        assert(upo_ht_robinhood_size(ht) == n);
+        if (pow2)
+        {
+            size_t m = upo_ht_robinhood_capacity(ht);
+
+            assert((m & (m - 1)) == 0);
+        }
+
+        for (i = 0; i < n; i += 2)
+        {
+            upo_ht_robinhood_delete(ht, &keys[i], 0);
+        }
+        for (i = 0; i < n; ++i)
+        {
+            assert(upo_ht_robinhood_get(ht, &keys[i]) == ((i % 2) ? &keys[i] : NULL));
+        }
+
+        upo_ht_robinhood_destroy(ht, 0);
+    }
+
+    ht = upo_ht_robinhood_create_hash64(0, upo_ht_hash64_str_djb2, str_compare, 1);
+    for (i = 0; i < n_str; ++i)
+    {
+        upo_ht_robinhood_insert(ht, &str_keys[i], &keys[i]);
+    }
+    for (i = 0; i < n_str; ++i)
+    {
+        assert(upo_ht_robinhood_contains(ht, &str_keys[i]));
+        assert(upo_ht_robinhood_get(ht, &str_keys[i]) == &keys[i]);
+    }
+    upo_ht_robinhood_destroy(ht, 0);
+}
+
+void test_null()
+{
+    upo_ht_robinhood_t ht = NULL;
+    int key = 0;
+
+    assert(upo_ht_robinhood_size(ht) == 0);
+
+    assert(upo_ht_robinhood_is_empty(ht));
+
+    assert(upo_ht_robinhood_get(ht, &key) == NULL);
+
+    assert(!upo_ht_robinhood_contains(ht, &key));
+
+    upo_ht_robinhood_clear(ht, 0);
+
+    assert(upo_ht_robinhood_size(ht) == 0);
+
+    upo_ht_robinhood_destroy(ht, 0);
+}
+
+int main()
+{
+    printf("Test case 'create/destroy'... ");
+    fflush(stdout);
+    test_create_destroy();
+    printf("OK\n");
+
+    printf("Test case 'put/get/delete'... ");
+    fflush(stdout);
+    test_put_get_contains_delete();
+    printf("OK\n");
+
+    printf("Test case 'insert'... ");
+    fflush(stdout);
+    test_insert();
+    printf("OK\n");
+
+    printf("Test case 'clear/empty/size'... ");
+    fflush(stdout);
+    test_clear_empty_size();
+    printf("OK\n");
+
+    printf("Test case 'resize'... ");
+    fflush(stdout);
+    test_resize();
+    printf("OK\n");
+
+    printf("Test case 'backward shift'... ");
+    fflush(stdout);
+    test_backward_shift();
+    printf("OK\n");
+
+    printf("Test case 'churn'... ");
+    fflush(stdout);
+    test_churn();
+    printf("OK\n");
+
+    printf("Test case 'keys/traverse'... ");
+    fflush(stdout);
+    test_keys_traverse();
+    printf("OK\n");
+
+    printf("Test case 'merge'... ");
+    fflush(stdout);
+    test_merge();
+    printf("OK\n");
+
+    printf("Test case 'hash64'... ");
+    fflush(stdout);
+    test_hash64();
+    printf("OK\n");
+
+    printf("Test case 'null'... ");
+    fflush(stdout);
+    test_null();
+    printf("OK\n");
+
+    return 0;
+}
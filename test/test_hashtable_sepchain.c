@@ -41,6 +41,7 @@ static void test_clear();
 static void test_empty();
 static void test_size();
 static void test_hash_funcs();
+static void test_hash64();
 static void test_null();
 
 
@@ -1258,6 +1259,68 @@ void test_hash_funcs()
     upo_ht_sepchain_destroy(ht, 0);
 }
 
+void test_hash64()
+{
+    int keys[100];
+    char *str_keys[] = {"alice", "bob", "charlie", "dany", "eric", "george", "john", "katy", "luke", "mark"};
+    size_t n = sizeof keys / sizeof keys[0];
+    size_t n_str = sizeof str_keys / sizeof str_keys[0];
+    size_t i = 0;
+    int pow2 = 0;
+    upo_ht_sepchain_t ht = NULL;
+
+    for (i = 0; i < n; ++i)
+    {
+        keys[i] = (int) (i * 1024);
+    }
+
+    for (pow2 = 0; pow2 <= 1; ++pow2)
+    {
+        ht = upo_ht_sepchain_create_hash64(10, upo_ht_hash64_int, int_compare, pow2);
+
+        assert(ht != NULL);
+        assert(upo_ht_sepchain_capacity(ht) == (pow2 ? 16U : 10U));
+        assert(upo_ht_sepchain_get_hasher(ht) == NULL);
+        assert(upo_ht_sepchain_get_hasher64(ht) == upo_ht_hash64_int);
+
+        for (i = 0; i < n; ++i)
+        {
+            upo_ht_sepchain_put(ht, &keys[i], &keys[i]);
+        }
+
+        assert(upo_ht_sepchain_size(ht) == n);
+        if (pow2)
+        {
+            size_t m = upo_ht_sepchain_capacity(ht);
+
+            assert((m & (m - 1)) == 0);
+        }
+
+        for (i = 0; i < n; i += 2)
+        {
+            upo_ht_sepchain_delete(ht, &keys[i], 0);
+        }
+        for (i = 0; i < n; ++i)
+        {
+            assert(upo_ht_sepchain_get(ht, &keys[i]) == ((i % 2) ? &keys[i] : NULL));
+        }
+
+        upo_ht_sepchain_destroy(ht, 0);
+    }
+
+    ht = upo_ht_sepchain_create_hash64(0, upo_ht_hash64_str_djb2, str_compare, 1);
+    for (i = 0; i < n_str; ++i)
+    {
+        upo_ht_sepchain_insert(ht, &str_keys[i], &keys[i]);
+    }
+    for (i = 0; i < n_str; ++i)
+    {
+        assert(upo_ht_sepchain_contains(ht, &str_keys[i]));
+        assert(upo_ht_sepchain_get(ht, &str_keys[i]) == &keys[i]);
+    }
+    upo_ht_sepchain_destroy(ht, 0);
+}
+
 void test_null()
 {
     upo_ht_sepchain_t ht = NULL;
@@ -1311,6 +1374,11 @@ int main()
     test_hash_funcs();
     printf("OK\n");
 
+    printf("Test case 'hash64'... ");
+    fflush(stdout);
+    test_hash64();
+    printf("OK\n");
+
     printf("Test case 'null'... ");
     fflush(stdout);
     test_null();
@@ -0,0 +1,571 @@
+/* vim: set tabstop=4 expandtab shiftwidth=4 softtabstop=4: */
+
+/*
+ * Copyright 2015 University of Piemonte Orientale, Computer Science Institute
+ *
+ * This file is part of UPOalglib.
+ *
+ * UPOalglib is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * UPOalglib is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with UPOalglib.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <assert.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <upo/hashtable.h>
+#include <upo/error.h>
+
+static int str_compare(const void *a, const void *b);
+static int int_compare(const void *a, const void *b);
+static uint64_t const_hash(const void *x);
+static void count_visitor(void *key, void *value, void *context);
+
+static void test_create_destroy();
+static void test_put_get_contains_delete();
+static void test_insert();
+static void test_clear_empty_size();
+static void test_resize();
+static void test_load_factor();
+static void test_collisions();
+static void test_churn();
+static void test_keys_traverse();
+static void test_str_keys();
+static void test_null();
+
+int str_compare(const void *a, const void *b)
+{
+    const char **aa = (const char **)a;
+    const char **bb = (const char **)b;
+
+    assert(a != NULL);
+    assert(b != NULL);
+
+    return strcmp(*aa, *bb);
+}
+
+int int_compare(const void *a, const void *b)
+{
+    const int *aa = a;
+    const int *bb = b;
+
+    assert(a != NULL);
+    assert(b != NULL);
+
+    return (*aa > *bb) - (*aa < *bb);
+}
+
+uint64_t const_hash(const void *x)
+{
+    (void) x;
+
+    return 0;
+}
+
+void count_visitor(void *key, void *value, void *context)
+{
+    size_t *count = context;
+
+    assert(key != NULL);
+    assert(key == value);
+
+    *count += 1;
+}
+
+void test_create_destroy()
+{
+    upo_ht_swiss_t ht;
+
+    ht = upo_ht_swiss_create(UPO_HT_SWISS_DEFAULT_CAPACITY, upo_ht_hash64_str_djb2, str_compare);
+
+    assert(ht != NULL);
+    assert(upo_ht_swiss_capacity(ht) == UPO_HT_SWISS_DEFAULT_CAPACITY);
+    assert(upo_ht_swiss_get_comparator(ht) == str_compare);
+    assert(upo_ht_swiss_get_hasher64(ht) == upo_ht_hash64_str_djb2);
+
+    upo_ht_swiss_destroy(ht, 1);
+
+    /* Capacities are powers of two, made of whole groups */
+    ht = upo_ht_swiss_create(1, upo_ht_hash64_int, int_compare);
+
+    assert(upo_ht_swiss_capacity(ht) == UPO_HT_SWISS_DEFAULT_CAPACITY);
+
+    upo_ht_swiss_destroy(ht, 0);
+
+    ht = upo_ht_swiss_create(100, upo_ht_hash64_int, int_compare);
+
+    assert(upo_ht_swiss_capacity(ht) == 128);
+
+    upo_ht_swiss_destroy(ht, 0);
+
+    ht = upo_ht_swiss_create(0, upo_ht_hash64_int, int_compare);
+
+    assert(upo_ht_swiss_capacity(ht) == 0);
+    assert(upo_ht_swiss_is_empty(ht));
+
+    upo_ht_swiss_destroy(ht, 0);
+}
+
+void test_put_get_contains_delete()
+{
+    int keys[1000];
+    int values[1000];
+    int missing[1000];
+    size_t n = sizeof keys / sizeof keys[0];
+    size_t i = 0;
+    upo_ht_swiss_t ht = NULL;
+
+    for (i = 0; i < n; ++i)
+    {
+        keys[i] = (int) (i * 3);
+        values[i] = (int) i;
+        missing[i] = (int) (i * 3 + 1);
+    }
+
+    ht = upo_ht_swiss_create(UPO_HT_SWISS_DEFAULT_CAPACITY, upo_ht_hash64_int, int_compare);
+
+    assert(ht != NULL);
+
+    /* Insertion */
+    for (i = 0; i < n; ++i)
+    {
+        assert(upo_ht_swiss_put(ht, &keys[i], &values[i]) == NULL);
+    }
+    assert(upo_ht_swiss_size(ht) == n);
+    /* Search */
+    for (i = 0; i < n; ++i)
+    {
+        int *value = upo_ht_swiss_get(ht, &keys[i]);
+
+        assert(value != NULL);
+        assert(*value == values[i]);
+        assert(upo_ht_swiss_contains(ht, &keys[i]));
+        assert(upo_ht_swiss_get(ht, &missing[i]) == NULL);
+        assert(!upo_ht_swiss_contains(ht, &missing[i]));
+    }
+    /* Update */
+    for (i = 0; i < n; ++i)
+    {
+        assert(upo_ht_swiss_put(ht, &keys[i], &keys[i]) == &values[i]);
+    }
+    assert(upo_ht_swiss_size(ht) == n);
+    /* Removal */
+    for (i = 0; i < n; i += 2)
+    {
+        upo_ht_swiss_delete(ht, &keys[i], 0);
+        upo_ht_swiss_delete(ht, &missing[i], 0);
+    }
+    assert(upo_ht_swiss_size(ht) == n / 2);
+    for (i = 0; i < n; ++i)
+    {
+        assert(upo_ht_swiss_get(ht, &keys[i]) == ((i % 2) ? &keys[i] : NULL));
+    }
+
+    upo_ht_swiss_destroy(ht, 0);
+}
+
+void test_insert()
+{
+    int keys[] = {0, 10, 20, 30};
+    int values[] = {0, 1, 2, 3};
+    int values_upd[] = {3, 2, 1, 0};
+    size_t n = sizeof keys / sizeof keys[0];
+    size_t i = 0;
+    upo_ht_swiss_t ht = NULL;
+
+    ht = upo_ht_swiss_create(0, upo_ht_hash64_int, int_compare);
+
+    assert(ht != NULL);
+
+    for (i = 0; i < n; ++i)
+    {
+        upo_ht_swiss_insert(ht, &keys[i], &values[i]);
+    }
+    /* Duplicates are ignored */
+    for (i = 0; i < n; ++i)
+    {
+        upo_ht_swiss_insert(ht, &keys[i], &values_upd[i]);
+    }
+
+    assert(upo_ht_swiss_size(ht) == n);
+    assert(upo_ht_swiss_capacity(ht) == UPO_HT_SWISS_DEFAULT_CAPACITY);
+    for (i = 0; i < n; ++i)
+    {
+        assert(upo_ht_swiss_get(ht, &keys[i]) == &values[i]);
+    }
+
+    upo_ht_swiss_destroy(ht, 0);
+}
+
+void test_clear_empty_size()
+{
+    size_t n = 100;
+    size_t i = 0;
+    int key = 0;
+    upo_ht_swiss_t ht = NULL;
+
+    ht = upo_ht_swiss_create(UPO_HT_SWISS_DEFAULT_CAPACITY, upo_ht_hash64_int, int_compare);
+
+    assert(ht != NULL);
+    assert(upo_ht_swiss_is_empty(ht));
+    assert(upo_ht_swiss_size(ht) == 0);
+
+    /* Keys and values are freed on clear */
+    for (i = 0; i < n; ++i)
+    {
+        int *key = malloc(sizeof(int));
+        int *value = malloc(sizeof(int));
+
+        if (key == NULL || value == NULL)
+        {
+            upo_throw_sys_error("Unable to allocate memory for key-value pairs");
+        }
+        *key = (int) i;
+        *value = (int) i;
+        upo_ht_swiss_put(ht, key, value);
+
+        assert(upo_ht_swiss_size(ht) == i + 1);
+        assert(!upo_ht_swiss_is_empty(ht));
+    }
+
+    upo_ht_swiss_clear(ht, 1);
+
+    assert(upo_ht_swiss_is_empty(ht));
+    assert(upo_ht_swiss_size(ht) == 0);
+    assert(upo_ht_swiss_get(ht, &key) == NULL);
+
+    upo_ht_swiss_destroy(ht, 0);
+}
+
+void test_resize()
+{
+    int keys[5000];
+    size_t n = sizeof keys / sizeof keys[0];
+    size_t i = 0;
+    upo_ht_swiss_t ht = NULL;
+
+    for (i = 0; i < n; ++i)
+    {
+        keys[i] = (int) i;
+    }
+
+    ht = upo_ht_swiss_create(0, upo_ht_hash64_int, int_compare);
+
+    assert(ht != NULL);
+
+    /* Insertion */
+    for (i = 0; i < n; ++i)
+    {
+        size_t m = 0;
+
+        upo_ht_swiss_put(ht, &keys[i], &keys[i]);
+
+        m = upo_ht_swiss_capacity(ht);
+
+        assert(upo_ht_swiss_size(ht) == i + 1);
+        assert(upo_ht_swiss_load_factor(ht) <= 0.875);
+        assert((m & (m - 1)) == 0);
+    }
+    for (i = 0; i < n; ++i)
+    {
+        assert(upo_ht_swiss_get(ht, &keys[i]) == &keys[i]);
+    }
+
+    /* Removal */
+    for (i = 0; i < n; ++i)
+    {
+        size_t j = 0;
+
+        upo_ht_swiss_delete(ht, &keys[i], 0);
+
+        assert(upo_ht_swiss_size(ht) == n - i - 1);
+        if (i % 500 == 0)
+        {
+            for (j = i + 1; j < n; ++j)
+            {
+                assert(upo_ht_swiss_get(ht, &keys[j]) == &keys[j]);
+            }
+        }
+    }
+    assert(upo_ht_swiss_capacity(ht) == UPO_HT_SWISS_DEFAULT_CAPACITY);
+
+    upo_ht_swiss_destroy(ht, 0);
+}
+
+void test_load_factor()
+{
+    int keys[896];
+    size_t n = sizeof keys / sizeof keys[0];
+    size_t i = 0;
+    upo_ht_swiss_t ht = NULL;
+
+    for (i = 0; i < n; ++i)
+    {
+        keys[i] = (int) (i * 7919);
+    }
+
+    /* The table is filled up to 7/8 of its slots without growing */
+    ht = upo_ht_swiss_create(1024, upo_ht_hash64_int, int_compare);
+    for (i = 0; i < n; ++i)
+    {
+        upo_ht_swiss_put(ht, &keys[i], &keys[i]);
+    }
+
+    assert(upo_ht_swiss_capacity(ht) == 1024);
+    assert(upo_ht_swiss_load_factor(ht) == 0.875);
+
+    for (i = 0; i < n; ++i)
+    {
+        int missing = keys[i] + 1;
+
+        assert(upo_ht_swiss_get(ht, &keys[i]) == &keys[i]);
+        assert(!upo_ht_swiss_contains(ht, &missing));
+    }
+
+    upo_ht_swiss_destroy(ht, 0);
+}
+
+void test_collisions()
+{
+    int keys[100];
+    size_t n = sizeof keys / sizeof keys[0];
+    size_t i = 0;
+    upo_ht_swiss_t ht = NULL;
+
+    for (i = 0; i < n; ++i)
+    {
+        keys[i] = (int) i;
+    }
+
+    /* All keys share the first group and the tag, so that groups overflow
+     * and every tag matches */
+    ht = upo_ht_swiss_create(UPO_HT_SWISS_DEFAULT_CAPACITY, const_hash, int_compare);
+    for (i = 0; i < n; ++i)
+    {
+        upo_ht_swiss_put(ht, &keys[i], &keys[i]);
+    }
+
+    assert(upo_ht_swiss_size(ht) == n);
+
+    /* Deletions from full groups leave markers which must not stop lookups */
+    for (i = 0; i < n; i += 3)
+    {
+        upo_ht_swiss_delete(ht, &keys[i], 0);
+    }
+    for (i = 0; i < n; ++i)
+    {
+        assert(upo_ht_swiss_contains(ht, &keys[i]) == ((i % 3) != 0));
+    }
+
+    /* Reinsertions reuse the marked slots */
+    for (i = 0; i < n; i += 3)
+    {
+        upo_ht_swiss_insert(ht, &keys[i], &keys[i]);
+    }
+    for (i = 0; i < n; ++i)
+    {
+        assert(upo_ht_swiss_get(ht, &keys[i]) == &keys[i]);
+    }
+
+    upo_ht_swiss_destroy(ht, 0);
+}
+
+void test_churn()
+{
+    int keys[20000];
+    size_t n = sizeof keys / sizeof keys[0];
+    size_t live = 50;
+    size_t m = 128;
+    size_t i = 0;
+    upo_ht_swiss_t ht = NULL;
+
+    for (i = 0; i < n; ++i)
+    {
+        keys[i] = (int) i;
+    }
+
+    ht = upo_ht_swiss_create(m, upo_ht_hash64_int, int_compare);
+
+    assert(ht != NULL);
+
+    /* Keeps a window of keys while inserting and deleting many others: once
+     * keys and deleted slots fill 7/8 of the table, the deleted slots are
+     * dropped by rebuilding it in place */
+    for (i = 0; i < live; ++i)
+    {
+        upo_ht_swiss_put(ht, &keys[i], &keys[i]);
+    }
+    for (i = live; i < n; ++i)
+    {
+        upo_ht_swiss_put(ht, &keys[i], &keys[i]);
+        upo_ht_swiss_delete(ht, &keys[i - live], 0);
+
+        assert(upo_ht_swiss_size(ht) == live);
+        assert(upo_ht_swiss_capacity(ht) == m);
+        assert(!upo_ht_swiss_contains(ht, &keys[i - live]));
+        assert(upo_ht_swiss_get(ht, &keys[i]) == &keys[i]);
+        assert(upo_ht_swiss_get(ht, &keys[i - live + 1]) == &keys[i - live + 1]);
+    }
+    for (i = n - live; i < n; ++i)
+    {
+        assert(upo_ht_swiss_get(ht, &keys[i]) == &keys[i]);
+    }
+
+    upo_ht_swiss_destroy(ht, 0);
+}
+
+void test_keys_traverse()
+{
+    int keys[50];
+    size_t n = sizeof keys / sizeof keys[0];
+    size_t count = 0;
+    size_t i = 0;
+    upo_ht_key_list_t list = NULL;
+    upo_ht_swiss_t ht = NULL;
+
+    ht = upo_ht_swiss_create(0, upo_ht_hash64_int, int_compare);
+
+    assert(upo_ht_swiss_keys(ht) == NULL);
+
+    for (i = 0; i < n; ++i)
+    {
+        keys[i] = (int) (i * 1024);
+        upo_ht_swiss_put(ht, &keys[i], &keys[i]);
+    }
+
+    upo_ht_swiss_traverse(ht, count_visitor, &count);
+
+    assert(count == n);
+
+    list = upo_ht_swiss_keys(ht);
+    count = 0;
+    while (list != NULL)
+    {
+        upo_ht_key_list_t next = list->next;
+
+        assert(upo_ht_swiss_contains(ht, list->key));
+
+        ++count;
+        free(list);
+        list = next;
+    }
+
+    assert(count == n);
+
+    upo_ht_swiss_destroy(ht, 0);
+}
+
+void test_str_keys()
+{
+    char *str_keys[] = {"alice", "bob", "charlie", "dany", "eric", "george", "john", "katy", "luke", "mark"};
+    char *missing = "zoe";
+    int values[] = {0, 1, 2, 3, 4, 5, 6, 7, 8, 9};
+    size_t n = sizeof str_keys / sizeof str_keys[0];
+    size_t i = 0;
+    upo_ht_swiss_t ht = NULL;
+
+    ht = upo_ht_swiss_create(0, upo_ht_hash64_str_djb2, str_compare);
+    for (i = 0; i < n; ++i)
+    {
+        upo_ht_swiss_put(ht, &str_keys[i], &values[i]);
+    }
+    for (i = 0; i < n; ++i)
+    {
+        assert(upo_ht_swiss_get(ht, &str_keys[i]) == &values[i]);
+    }
+    assert(!upo_ht_swiss_contains(ht, &missing));
+
+    upo_ht_swiss_destroy(ht, 0);
+}
+
+void test_null()
+{
+    upo_ht_swiss_t ht = NULL;
+    int key = 0;
+
+    assert(upo_ht_swiss_size(ht) == 0);
+
+    assert(upo_ht_swiss_is_empty(ht));
+
+    assert(upo_ht_swiss_get(ht, &key) == NULL);
+
+    assert(!upo_ht_swiss_contains(ht, &key));
+
+    upo_ht_swiss_clear(ht, 0);
+
+    assert(upo_ht_swiss_size(ht) == 0);
+
+    upo_ht_swiss_destroy(ht, 0);
+}
+
+int main()
+{
+    printf("Test case 'create/destroy'... ");
+    fflush(stdout);
+    test_create_destroy();
+    printf("OK\n");
+
+    printf("Test case 'put/get/delete'... ");
+    fflush(stdout);
+    test_put_get_contains_delete();
+    printf("OK\n");
+
+    printf("Test case 'insert'... ");
+    fflush(stdout);
+    test_insert();
+    printf("OK\n");
+
+    printf("Test case 'clear/empty/size'... ");
+    fflush(stdout);
+    test_clear_empty_size();
+    printf("OK\n");
+
+    printf("Test case 'resize'... ");
+    fflush(stdout);
+    test_resize();
+    printf("OK\n");
+
+    printf("Test case 'load factor'... ");
+    fflush(stdout);
+    test_load_factor();
+    printf("OK\n");
+
+    printf("Test case 'collisions'... ");
+    fflush(stdout);
+    test_collisions();
+    printf("OK\n");
+
+    printf("Test case 'churn'... ");
+    fflush(stdout);
+    test_churn();
+    printf("OK\n");
+
+    printf("Test case 'keys/traverse'... ");
+    fflush(stdout);
+    test_keys_traverse();
+    printf("OK\n");
+
+    printf("Test case 'str keys'... ");
+    fflush(stdout);
+    test_str_keys();
+    printf("OK\n");
+
+    printf("Test case 'null'... ");
+    fflush(stdout);
+    test_null();
+    printf("OK\n");
+
+    return 0;
+}
@@ -0,0 +1,184 @@
+/* vim: set tabstop=4 expandtab shiftwidth=4 softtabstop=4: */
+
+/*
+ * Copyright 2015 University of Piemonte Orientale, Computer Science Institute
+ *
+ * This file is part of UPOalglib.
+ *
+ * UPOalglib is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * UPOalglib is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with UPOalglib.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <assert.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <upo/perf_timer.h>
+
+
+static void test_create_destroy();
+static void test_start();
+static void test_stop();
+static void test_elapsed();
+static void test_counts();
+static void test_event_names();
+
+
+void test_create_destroy()
+{
+    upo_perf_timer_t timer = upo_perf_timer_create();
+
+    assert(timer != NULL);
+
+    upo_perf_timer_destroy(timer);
+    upo_perf_timer_destroy(NULL);
+}
+
+void test_start()
+{
+    upo_perf_timer_t timer = upo_perf_timer_create();
+
+    assert(upo_perf_timer_is_started(timer) == 0);
+
+    upo_perf_timer_start(timer);
+
+    assert(upo_perf_timer_is_started(timer) == 1);
+
+    upo_perf_timer_destroy(timer);
+}
+
+void test_stop()
+{
+    upo_perf_timer_t timer = upo_perf_timer_create();
+
+    assert(upo_perf_timer_is_stopped(timer) == 0);
+
+    upo_perf_timer_start(timer);
+
+    assert(upo_perf_timer_is_stopped(timer) == 0);
+
+    upo_perf_timer_stop(timer);
+
+    assert(upo_perf_timer_is_stopped(timer) == 1);
+
+    /* Restarting invalidates the stop */
+    upo_perf_timer_start(timer);
+
+    assert(upo_perf_timer_is_stopped(timer) == 0);
+
+    upo_perf_timer_destroy(timer);
+}
+
+void test_elapsed()
+{
+    upo_perf_timer_t timer = upo_perf_timer_create();
+    double elapsed;
+
+    assert(upo_perf_timer_elapsed(timer) == -1);
+
+    upo_perf_timer_start(timer);
+
+    assert(upo_perf_timer_elapsed(timer) >= 0);
+
+    upo_perf_timer_stop(timer);
+    elapsed = upo_perf_timer_elapsed(timer);
+
+    assert(elapsed >= 0);
+    assert(upo_perf_timer_elapsed(timer) == elapsed);
+
+    upo_perf_timer_destroy(timer);
+}
+
+void test_counts()
+{
+    upo_perf_timer_t timer = upo_perf_timer_create();
+    volatile unsigned long sum = 0;
+    unsigned long i;
+    int e;
+
+    for (e = 0; e < UPO_PERF_TIMER_NUM_EVENTS; ++e)
+    {
+        assert(upo_perf_timer_count(timer, e) < 0);
+    }
+
+    upo_perf_timer_start(timer);
+    for (i = 0; i < 1000000; ++i)
+    {
+        sum += i;
+    }
+    upo_perf_timer_stop(timer);
+
+    /* Events may be unavailable (e.g. in virtual machines), but never fail */
+    for (e = 0; e < UPO_PERF_TIMER_NUM_EVENTS; ++e)
+    {
+        if (upo_perf_timer_has_event(timer, e))
+        {
+            assert(upo_perf_timer_count(timer, e) >= 0);
+        }
+        else
+        {
+            assert(upo_perf_timer_count(timer, e) < 0);
+        }
+    }
+    if (upo_perf_timer_has_event(timer, upo_perf_instructions_event))
+    {
+        assert(upo_perf_timer_count(timer, upo_perf_instructions_event) >= 1000000);
+    }
+
+    upo_perf_timer_destroy(timer);
+}
+
+void test_event_names()
+{
+    assert(strcmp(upo_perf_event_name(upo_perf_cycles_event), "cycles") == 0);
+    assert(strcmp(upo_perf_event_name(upo_perf_instructions_event), "instructions") == 0);
+    assert(strcmp(upo_perf_event_name(upo_perf_cache_misses_event), "cache_misses") == 0);
+    assert(strcmp(upo_perf_event_name(upo_perf_branch_misses_event), "branch_misses") == 0);
+    assert(strcmp(upo_perf_event_name(upo_perf_task_clock_event), "task_clock") == 0);
+}
+
+
+int main()
+{
+    printf("Test case 'create/destroy'... ");
+    fflush(stdout);
+    test_create_destroy();
+    printf("OK\n");
+
+    printf("Test case 'start'... ");
+    fflush(stdout);
+    test_start();
+    printf("OK\n");
+
+    printf("Test case 'stop'... ");
+    fflush(stdout);
+    test_stop();
+    printf("OK\n");
+
+    printf("Test case 'elapsed'... ");
+    fflush(stdout);
+    test_elapsed();
+    printf("OK\n");
+
+    printf("Test case 'counts'... ");
+    fflush(stdout);
+    test_counts();
+    printf("OK\n");
+
+    printf("Test case 'event names'... ");
+    fflush(stdout);
+    test_event_names();
+    printf("OK\n");
+
+    return 0;
+}
@@ -0,0 +1,364 @@
+/* vim: set tabstop=4 expandtab shiftwidth=4 softtabstop=4: */
+
+/**
+ * \file test/test_pq.c
+ *
+ * \brief Implementation for priority queue testing.
+ *
+ * \author Simone Gattini, Federico Barbero, Anton Iliev
+ *
+ * \copyright 2015 University of Piemonte Orientale, Computer Science Institute
+ *
+ *  This file is part of UPOalglib.
+ *
+ *  UPOalglib is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  UPOalglib is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with UPOalglib.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <assert.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <upo/pq.h>
+
+
+#define N 5000
+
+
+static const size_t arities[] = {2, 3, 4, 8};
+static const size_t num_arities = sizeof(arities) / sizeof(arities[0]);
+
+
+static int int_comparator(const void *a, const void *b);
+static void check_pop_order(upo_pq_t pq, size_t n);
+
+static void test_create_destroy();
+static void test_push_pop();
+static void test_heapify();
+static void test_decrease_key();
+static void test_handles();
+static void test_clear();
+static void test_null();
+
+
+int int_comparator(const void *a, const void *b)
+{
+    const int *aa = a;
+    const int *bb = b;
+
+    return (*aa > *bb) - (*aa < *bb);
+}
+
+void check_pop_order(upo_pq_t pq, size_t n)
+{
+    const int *prev = NULL;
+    size_t i;
+
+    assert(upo_pq_size(pq) == n);
+    for (i = 0; i < n; ++i)
+    {
+        const int *top = upo_pq_peek(pq);
+        const int *cur = upo_pq_pop(pq);
+
+        assert(cur != NULL);
+        assert(cur == top);
+        assert(prev == NULL || *prev <= *cur);
+        prev = cur;
+    }
+    assert(upo_pq_is_empty(pq));
+    assert(upo_pq_peek(pq) == NULL);
+    assert(upo_pq_pop(pq) == NULL);
+}
+
+void test_create_destroy()
+{
+    size_t k;
+
+    for (k = 0; k < num_arities; ++k)
+    {
+        upo_pq_t pq = upo_pq_create(arities[k], int_comparator);
+        assert(pq != NULL);
+        assert(upo_pq_size(pq) == 0);
+        assert(upo_pq_is_empty(pq));
+        upo_pq_destroy(pq, 0);
+    }
+}
+
+void test_push_pop()
+{
+    int *keys = malloc(N * sizeof(int));
+    size_t i;
+    size_t k;
+
+    assert(keys != NULL);
+    srand(1);
+    for (i = 0; i < N; ++i)
+    {
+        /* Few distinct values, so that there are many duplicates */
+        keys[i] = rand() % (N / 10);
+    }
+    for (k = 0; k < num_arities; ++k)
+    {
+        upo_pq_t pq = upo_pq_create(arities[k], int_comparator);
+
+        for (i = 0; i < N; ++i)
+        {
+            upo_pq_push(pq, &keys[i]);
+            assert(upo_pq_size(pq) == i + 1);
+        }
+        check_pop_order(pq, N);
+
+        /* Interleaved pushes and pops */
+        for (i = 0; i < N; ++i)
+        {
+            upo_pq_push(pq, &keys[i]);
+            if (i % 3 == 2)
+            {
+                const int *top = upo_pq_pop(pq);
+                assert(*top <= *(const int *) upo_pq_peek(pq));
+            }
+        }
+        check_pop_order(pq, N - N / 3);
+        upo_pq_destroy(pq, 0);
+    }
+    free(keys);
+}
+
+void test_heapify()
+{
+    int *keys = malloc(N * sizeof(int));
+    void **data = malloc(N * sizeof(void*));
+    upo_pq_handle_t *handles = malloc(N * sizeof(upo_pq_handle_t));
+    size_t i;
+    size_t k;
+
+    assert(keys != NULL && data != NULL && handles != NULL);
+    srand(2);
+    for (i = 0; i < N; ++i)
+    {
+        keys[i] = rand();
+        data[i] = &keys[i];
+    }
+    for (k = 0; k < num_arities; ++k)
+    {
+        upo_pq_t pq = upo_pq_create(arities[k], int_comparator);
+
+        upo_pq_heapify(pq, data, N, handles);
+        for (i = 0; i < N; ++i)
+        {
+            assert(upo_pq_get(pq, handles[i]) == &keys[i]);
+        }
+        check_pop_order(pq, N);
+
+        /* Heapify on a non-empty queue, without handles */
+        for (i = 0; i < N / 2; ++i)
+        {
+            upo_pq_push(pq, &keys[i]);
+        }
+        upo_pq_heapify(pq, data + N / 2, N - N / 2, NULL);
+        check_pop_order(pq, N);
+
+        /* Degenerate cases */
+        upo_pq_heapify(pq, NULL, 0, NULL);
+        assert(upo_pq_is_empty(pq));
+        upo_pq_heapify(pq, data, 1, handles);
+        assert(upo_pq_get(pq, handles[0]) == &keys[0]);
+        check_pop_order(pq, 1);
+        upo_pq_destroy(pq, 0);
+    }
+    free(handles);
+    free(data);
+    free(keys);
+}
+
+void test_decrease_key()
+{
+    int *keys = malloc(N * sizeof(int));
+    int *lower = malloc(N * sizeof(int));
+    upo_pq_handle_t *handles = malloc(N * sizeof(upo_pq_handle_t));
+    size_t i;
+    size_t k;
+
+    assert(keys != NULL && lower != NULL && handles != NULL);
+    for (k = 0; k < num_arities; ++k)
+    {
+        upo_pq_t pq = upo_pq_create(arities[k], int_comparator);
+        size_t num_popped = 0;
+
+        srand(3);
+        for (i = 0; i < N; ++i)
+        {
+            keys[i] = rand() % N;
+            handles[i] = upo_pq_push(pq, &keys[i]);
+        }
+        for (i = 0; i < N; ++i)
+        {
+            size_t j = rand() % N;
+            int *cur = upo_pq_get(pq, handles[j]);
+
+            if (i % 2 == 0 || cur == &lower[j])
+            {
+                /* Lowers the key in place */
+                *cur -= rand() % N;
+                upo_pq_decrease_key(pq, handles[j], cur);
+            }
+            else
+            {
+                /* Replaces the element with another one with a lower key */
+                lower[j] = *cur - rand() % N;
+                upo_pq_decrease_key(pq, handles[j], &lower[j]);
+            }
+            assert(upo_pq_get(pq, handles[j]) == &keys[j] || upo_pq_get(pq, handles[j]) == &lower[j]);
+            assert(*(int *) upo_pq_peek(pq) <= *(int *) upo_pq_get(pq, handles[j]));
+        }
+        /* Pops a few elements, then keeps lowering the remaining ones */
+        while (num_popped < N / 2)
+        {
+            int *top = upo_pq_pop(pq);
+            size_t j = (top >= keys && top < keys + N) ? (size_t) (top - keys) : (size_t) (top - lower);
+
+            /* Marks the element as removed */
+            handles[j] = (upo_pq_handle_t) -1;
+            ++num_popped;
+        }
+        for (i = 0; i < N; ++i)
+        {
+            if (handles[i] != (upo_pq_handle_t) -1)
+            {
+                int *cur = upo_pq_get(pq, handles[i]);
+
+                *cur -= N;
+                upo_pq_decrease_key(pq, handles[i], cur);
+            }
+        }
+        check_pop_order(pq, N - num_popped);
+        upo_pq_destroy(pq, 0);
+    }
+    free(handles);
+    free(lower);
+    free(keys);
+}
+
+void test_handles()
+{
+    int keys[] = {5, 3, 8, 1, 9, 2};
+    size_t n = sizeof(keys) / sizeof(keys[0]);
+    upo_pq_handle_t handles[sizeof(keys) / sizeof(keys[0])];
+    upo_pq_t pq = upo_pq_create(4, int_comparator);
+    size_t i;
+    size_t j;
+
+    for (i = 0; i < n; ++i)
+    {
+        handles[i] = upo_pq_push(pq, &keys[i]);
+        for (j = 0; j < i; ++j)
+        {
+            assert(handles[j] != handles[i]);
+        }
+    }
+    for (i = 0; i < n; ++i)
+    {
+        assert(upo_pq_get(pq, handles[i]) == &keys[i]);
+    }
+    /* The handle of the popped element (key 1) can be reused, the others stay valid */
+    assert(upo_pq_pop(pq) == &keys[3]);
+    handles[3] = upo_pq_push(pq, &keys[3]);
+    for (i = 0; i < n; ++i)
+    {
+        assert(upo_pq_get(pq, handles[i]) == &keys[i]);
+    }
+    check_pop_order(pq, n);
+    upo_pq_destroy(pq, 0);
+}
+
+void test_clear()
+{
+    upo_pq_t pq = upo_pq_create(2, int_comparator);
+    size_t i;
+
+    for (i = 0; i < 100; ++i)
+    {
+        int *key = malloc(sizeof(int));
+
+        assert(key != NULL);
+        *key = (int) (100 - i);
+        upo_pq_push(pq, key);
+    }
+    assert(upo_pq_size(pq) == 100);
+    upo_pq_clear(pq, 1);
+    assert(upo_pq_is_empty(pq));
+
+    /* The queue can be used again after being cleared */
+    for (i = 0; i < 10; ++i)
+    {
+        int *key = malloc(sizeof(int));
+
+        assert(key != NULL);
+        *key = (int) i;
+        upo_pq_push(pq, key);
+    }
+    assert(*(int *) upo_pq_peek(pq) == 0);
+    upo_pq_destroy(pq, 1);
+}
+
+void test_null()
+{
+    upo_pq_t pq = NULL;
+
+    assert(upo_pq_size(pq) == 0);
+    assert(upo_pq_is_empty(pq));
+    assert(upo_pq_peek(pq) == NULL);
+    assert(upo_pq_pop(pq) == NULL);
+    upo_pq_clear(pq, 0);
+    upo_pq_destroy(pq, 0);
+}
+
+
+int main(void)
+{
+    printf("Test case 'create/destroy'... ");
+    fflush(stdout);
+    test_create_destroy();
+    printf("OK\n");
+
+    printf("Test case 'push/pop'... ");
+    fflush(stdout);
+    test_push_pop();
+    printf("OK\n");
+
+    printf("Test case 'heapify'... ");
+    fflush(stdout);
+    test_heapify();
+    printf("OK\n");
+
+    printf("Test case 'decrease key'... ");
+    fflush(stdout);
+    test_decrease_key();
+    printf("OK\n");
+
+    printf("Test case 'handles'... ");
+    fflush(stdout);
+    test_handles();
+    printf("OK\n");
+
+    printf("Test case 'clear'... ");
+    fflush(stdout);
+    test_clear();
+    printf("OK\n");
+
+    printf("Test case 'null'... ");
+    fflush(stdout);
+    test_null();
+    printf("OK\n");
+
+    return 0;
+}
@@ -0,0 +1,325 @@
+/* vim: set tabstop=4 expandtab shiftwidth=4 softtabstop=4: */
+
+/**
+ * \file test/test_random.c
+ *
+ * \brief Implementation for random key generation testing.
+ *
+ * \author Simone Gattini, Federico Barbero, Anton Iliev
+ *
+ * \copyright 2015 University of Piemonte Orientale, Computer Science Institute
+ *
+ *  This file is part of UPOalglib.
+ *
+ *  UPOalglib is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  UPOalglib is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with UPOalglib.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <assert.h>
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <upo/random.h>
+#include <upo/sort.h>
+
+
+#define N 2000
+
+
+static int int_comparator(const void *a, const void *b);
+static int counting_int_comparator(const void *a, const void *b, void *ctx);
+static int is_permutation(const int *keys, size_t n);
+static size_t count_median3_comparisons(const int *keys, size_t n);
+
+static void test_uniform();
+static void test_few_unique();
+static void test_organ_pipe();
+static void test_sawtooth();
+static void test_sorted_swaps();
+static void test_zipf();
+static void test_all_equal();
+static void test_median3_killer();
+
+
+int int_comparator(const void *a, const void *b)
+{
+    const int *aa = a;
+    const int *bb = b;
+
+    return (*aa > *bb) - (*aa < *bb);
+}
+
+int counting_int_comparator(const void *a, const void *b, void *ctx)
+{
+    ++*(size_t *) ctx;
+
+    return int_comparator(a, b);
+}
+
+int is_permutation(const int *keys, size_t n)
+{
+    int *sorted = malloc(n * sizeof(int));
+    size_t i;
+    int ok = 1;
+
+    assert(sorted != NULL);
+    memcpy(sorted, keys, n * sizeof(int));
+    qsort(sorted, n, sizeof(int), int_comparator);
+    for (i = 0; i < n && ok; ++i)
+    {
+        ok = (sorted[i] == (int) i);
+    }
+    free(sorted);
+
+    return ok;
+}
+
+size_t count_median3_comparisons(const int *keys, size_t n)
+{
+    int *a = malloc(n * sizeof(int));
+    size_t count = 0;
+    size_t i;
+
+    assert(a != NULL);
+    memcpy(a, keys, n * sizeof(int));
+    upo_quick_sort_median3_cutoff_r(a, n, sizeof(int), counting_int_comparator, &count);
+    for (i = 1; i < n; ++i)
+    {
+        assert(a[i - 1] <= a[i]);
+    }
+    free(a);
+
+    return count;
+}
+
+void test_uniform()
+{
+    int keys[N];
+    size_t i;
+
+    upo_random_keys(keys, N, upo_random_uniform_dist, 10);
+    for (i = 0; i < N; ++i)
+    {
+        assert(keys[i] >= 0 && keys[i] < 10);
+    }
+
+    upo_random_keys(keys, N, upo_random_uniform_dist, 0);
+    for (i = 0; i < N; ++i)
+    {
+        assert(keys[i] >= 0);
+    }
+}
+
+void test_few_unique()
+{
+    int keys[N];
+    int seen[16] = {0};
+    size_t i;
+
+    upo_random_keys(keys, N, upo_random_few_unique_dist, 0);
+    for (i = 0; i < N; ++i)
+    {
+        assert(keys[i] >= 0 && keys[i] < 16);
+        seen[keys[i]] = 1;
+    }
+    for (i = 0; i < 16; ++i)
+    {
+        assert(seen[i]);
+    }
+
+    upo_random_keys(keys, N, upo_random_few_unique_dist, 3);
+    for (i = 0; i < N; ++i)
+    {
+        assert(keys[i] >= 0 && keys[i] < 3);
+    }
+}
+
+void test_organ_pipe()
+{
+    int keys[6];
+    int even[] = {0, 1, 2, 2, 1, 0};
+    int odd[] = {0, 1, 2, 1, 0};
+
+    upo_random_keys(keys, 6, upo_random_organ_pipe_dist, 0);
+    assert(memcmp(keys, even, sizeof(even)) == 0);
+    upo_random_keys(keys, 5, upo_random_organ_pipe_dist, 0);
+    assert(memcmp(keys, odd, sizeof(odd)) == 0);
+    upo_random_keys(keys, 1, upo_random_organ_pipe_dist, 0);
+    assert(keys[0] == 0);
+}
+
+void test_sawtooth()
+{
+    int keys[10];
+    int expect3[] = {0, 1, 2, 0, 1, 2, 0, 1, 2, 0};
+    int expect4[] = {0, 1, 2, 3, 0, 1, 2, 3, 0, 1};
+
+    upo_random_keys(keys, 10, upo_random_sawtooth_dist, 3);
+    assert(memcmp(keys, expect3, sizeof(expect3)) == 0);
+    /* The default length of the runs is the square root of the size */
+    upo_random_keys(keys, 10, upo_random_sawtooth_dist, 0);
+    assert(memcmp(keys, expect4, sizeof(expect4)) == 0);
+}
+
+void test_sorted_swaps()
+{
+    int keys[N];
+    size_t misplaced = 0;
+    size_t i;
+
+    upo_random_keys(keys, N, upo_random_sorted_swaps_dist, 5);
+    assert(is_permutation(keys, N));
+    for (i = 0; i < N; ++i)
+    {
+        misplaced += (keys[i] != (int) i);
+    }
+    assert(misplaced <= 10);
+
+    upo_random_keys(keys, N, upo_random_sorted_swaps_dist, 0);
+    assert(is_permutation(keys, N));
+
+    upo_random_keys(keys, 50, upo_random_sorted_swaps_dist, 0);
+    for (i = 0; i < 50; ++i)
+    {
+        assert(keys[i] == (int) i);
+    }
+}
+
+void test_zipf()
+{
+    size_t counts[10] = {0};
+    size_t num_samples = 100000;
+    double harmonic = 0;
+    int keys[N];
+    size_t i;
+
+    for (i = 0; i < 10; ++i)
+    {
+        harmonic += 1.0 / (i + 1);
+    }
+    for (i = 0; i < num_samples; ++i)
+    {
+        size_t k = upo_random_zipf(10, 1);
+
+        assert(k < 10);
+        ++counts[k];
+    }
+    /* The frequencies are close to 1/((k+1) H_10) */
+    for (i = 0; i < 10; ++i)
+    {
+        double expected = 1.0 / ((i + 1) * harmonic);
+
+        assert(fabs(counts[i] / (double) num_samples - expected) < 0.01);
+    }
+
+    /* Other exponents */
+    memset(counts, 0, sizeof(counts));
+    for (i = 0; i < num_samples; ++i)
+    {
+        ++counts[upo_random_zipf(3, 2)];
+    }
+    assert(fabs(counts[0] / (double) num_samples - 1 / (1 + 0.25 + 1.0 / 9)) < 0.01);
+    memset(counts, 0, sizeof(counts));
+    for (i = 0; i < num_samples; ++i)
+    {
+        ++counts[upo_random_zipf(2, 0.5)];
+    }
+    assert(fabs(counts[0] / (double) num_samples - 1 / (1 + 1 / sqrt(2))) < 0.01);
+    assert(upo_random_zipf(1, 1) == 0);
+
+    upo_random_keys(keys, N, upo_random_zipf_dist, 0);
+    for (i = 0; i < N; ++i)
+    {
+        assert(keys[i] >= 0 && keys[i] < N);
+    }
+}
+
+void test_all_equal()
+{
+    int keys[N];
+    size_t i;
+
+    upo_random_keys(keys, N, upo_random_all_equal_dist, 0);
+    for (i = 0; i < N; ++i)
+    {
+        assert(keys[i] == 0);
+    }
+}
+
+void test_median3_killer()
+{
+    int keys[N];
+    size_t n;
+
+    for (n = 0; n < 40; ++n)
+    {
+        upo_random_keys(keys, n, upo_random_median3_killer_dist, 0);
+        assert(is_permutation(keys, n));
+    }
+
+    /* Quadratic on the killer, about 2 n log2(n) on random keys */
+    upo_random_keys(keys, N, upo_random_median3_killer_dist, 0);
+    assert(is_permutation(keys, N));
+    assert(count_median3_comparisons(keys, N) > (size_t) N * N / 8);
+    upo_random_keys(keys, N, upo_random_uniform_dist, 0);
+    assert(count_median3_comparisons(keys, N) < (size_t) N * 30);
+}
+
+
+int main(void)
+{
+    srand(42);
+
+    printf("Test case 'uniform'... ");
+    fflush(stdout);
+    test_uniform();
+    printf("OK\n");
+
+    printf("Test case 'few unique'... ");
+    fflush(stdout);
+    test_few_unique();
+    printf("OK\n");
+
+    printf("Test case 'organ pipe'... ");
+    fflush(stdout);
+    test_organ_pipe();
+    printf("OK\n");
+
+    printf("Test case 'sawtooth'... ");
+    fflush(stdout);
+    test_sawtooth();
+    printf("OK\n");
+
+    printf("Test case 'sorted with swaps'... ");
+    fflush(stdout);
+    test_sorted_swaps();
+    printf("OK\n");
+
+    printf("Test case 'Zipf'... ");
+    fflush(stdout);
+    test_zipf();
+    printf("OK\n");
+
+    printf("Test case 'all equal'... ");
+    fflush(stdout);
+    test_all_equal();
+    printf("OK\n");
+
+    printf("Test case 'median-of-3 killer'... ");
+    fflush(stdout);
+    test_median3_killer();
+    printf("OK\n");
+
+    return 0;
+}
@@ -25,10 +25,14 @@
 #include <string.h>
 #include <upo/error.h>
 #include <upo/sort.h>
+#include <upo/sort_template.h>
+#include <upo/utility.h>
 
 /* Types and global data */
 
 #define N 9
+#define LARGE_N 20000
+#define LARGE_NUM_KEYS 1000
 
 struct item_s
 {
@@ -37,6 +41,34 @@ struct item_s
 };
 typedef struct item_s item_t;
 
+struct record_s
+{
+    int key;
+    size_t pos;
+};
+typedef struct record_s record_t;
+
+/* A record larger than the buffer used by insertion sort on the stack */
+typedef struct
+{
+    int key;
+    char payload[300];
+} big_record_t;
+
+/* Context of record_ctx_comparator */
+typedef struct
+{
+    int descending;
+    size_t num_calls;
+} record_sort_ctx_t;
+
+typedef struct
+{
+    int age;
+    const char *name;
+    size_t pos;
+} person_t;
+
 static double da[] = {3.0, 1.3, 0.4, 7.8, 13.2, -1.1, 6.0, -3.2, 78};
 static double expect_da[] = {-3.2, -1.1, 0.4, 1.3, 3.0, 6.0, 7.8, 13.2, 78.0};
 static const char *sa[] = {"The", "quick", "brown", "fox", "jumps", "over", "the", "lazy", "dog"};
@@ -49,14 +81,192 @@ static item_t expect_ca[] = {{1, "alice"}, {2, "claire"}, {3, "ann"}, {4, "bob"}
 static int double_comparator(const void *a, const void *b);
 static int string_comparator(const void *a, const void *b);
 static int item_comparator(const void *a, const void *b);
+static int record_comparator(const void *a, const void *b);
+static int big_record_comparator(const void *a, const void *b);
+static uint32_t record_key(const void *a);
+static void reference_insertion_sort(void *base, size_t n, size_t size, upo_sort_comparator_t cmp);
+static void indirect_sort(void *base, size_t n, size_t size, upo_sort_comparator_t cmp);
+static int record_ctx_comparator(const void *a, const void *b, void *ctx);
+static void person_key(const void *a, unsigned char *key, void *ctx);
+static int person_comparator(const void *a, const void *b, void *ctx);
+static void merge_sort_ex_r(void *base, size_t n, size_t size, upo_sort_comparator_r_t cmp, void *ctx);
+static void parallel_merge_sort_r(void *base, size_t n, size_t size, upo_sort_comparator_r_t cmp, void *ctx);
+static void parallel_quick_sort_r(void *base, size_t n, size_t size, upo_sort_comparator_r_t cmp, void *ctx);
+static void sort_indirect_r(void *base, size_t n, size_t size, upo_sort_comparator_r_t cmp, void *ctx);
+static const char *string_key(const void *a);
 
 /* Test cases */
+int record_comparator(const void *a, const void *b)
+{
+    const record_t *aa = a;
+    const record_t *bb = b;
+
+    return (aa->key > bb->key) - (aa->key < bb->key);
+}
+
+int big_record_comparator(const void *a, const void *b)
+{
+    const big_record_t *aa = a;
+    const big_record_t *bb = b;
+
+    return (aa->key > bb->key) - (aa->key < bb->key);
+}
+
+uint32_t record_key(const void *a)
+{
+    const record_t *aa = a;
+
+    return (uint32_t) aa->key ^ 0x80000000U;
+}
+
+const char *string_key(const void *a)
+{
+    return *(const char **)a;
+}
+
+/* The original swap-based insertion sort, kept as a reference for upo_insertion_sort */
+void reference_insertion_sort(void *base, size_t n, size_t size, upo_sort_comparator_t cmp)
+{
+    unsigned char *ptr = base, *current = NULL, *previous = NULL;
+
+    for (size_t i = 1; i < n; ++i)
+    {
+        size_t j = i;
+        while (j > 0 && cmp(ptr + j * size, ptr + (j - 1) * size) < 0)
+        {
+            current = ptr + j * size;
+            previous = ptr + (j * size) - (1 * size);
+
+            upo_swap(current, previous, size);
+            j--;
+        }
+    }
+}
+
+/* upo_sort_indirect without key prefix, with the signature of the other sorts */
+void indirect_sort(void *base, size_t n, size_t size, upo_sort_comparator_t cmp)
+{
+    upo_sort_indirect(base, n, size, cmp, NULL);
+}
+
+int record_ctx_comparator(const void *a, const void *b, void *ctx)
+{
+    record_sort_ctx_t *rc = ctx;
+    int res = record_comparator(a, b);
+
+    ++rc->num_calls;
+    return rc->descending ? -res : res;
+}
+
+/* The context points to the key size, which selects the sort criteria:
+ * 2 = name, 4 = age, more = age then name. */
+void person_key(const void *a, unsigned char *key, void *ctx)
+{
+    const person_t *aa = a;
+    size_t key_size = *(const size_t *)ctx;
+
+    if (key_size == 2)
+    {
+        upo_sort_key_put_str(key, aa->name, key_size);
+        return;
+    }
+    key = upo_sort_key_put_i32(key, aa->age);
+    if (key_size > 4)
+    {
+        upo_sort_key_put_str(key, aa->name, key_size - 4);
+    }
+}
+
+int person_comparator(const void *a, const void *b, void *ctx)
+{
+    const person_t *aa = a;
+    const person_t *bb = b;
+    size_t key_size = *(const size_t *)ctx;
+    int res = 0;
+
+    if (key_size == 2)
+    {
+        return strcmp(aa->name, bb->name);
+    }
+    res = (aa->age > bb->age) - (aa->age < bb->age);
+    if (res == 0 && key_size > 4)
+    {
+        res = strcmp(aa->name, bb->name);
+    }
+    return res;
+}
+
+void merge_sort_ex_r(void *base, size_t n, size_t size, upo_sort_comparator_r_t cmp, void *ctx)
+{
+    upo_merge_sort_ex_r(base, n, size, cmp, ctx, NULL);
+}
+
+void parallel_merge_sort_r(void *base, size_t n, size_t size, upo_sort_comparator_r_t cmp, void *ctx)
+{
+    upo_parallel_merge_sort_r(base, n, size, cmp, ctx, 4);
+}
+
+void parallel_quick_sort_r(void *base, size_t n, size_t size, upo_sort_comparator_r_t cmp, void *ctx)
+{
+    upo_parallel_quick_sort_r(base, n, size, cmp, ctx, 4);
+}
+
+void sort_indirect_r(void *base, size_t n, size_t size, upo_sort_comparator_r_t cmp, void *ctx)
+{
+    upo_sort_indirect_r(base, n, size, cmp, ctx, NULL);
+}
+
+void test_sort_algorithm_large(void (*sort)(void *, size_t, size_t, upo_sort_comparator_t), int stable)
+{
+    int ok = 1;
+    size_t i = 0;
+    record_t *ra = NULL;
+
+    srand(LARGE_N);
+    ra = malloc(LARGE_N * sizeof(record_t));
+    assert(ra != NULL);
+    for (i = 0; i < LARGE_N; ++i)
+    {
+        ra[i].key = rand() % LARGE_NUM_KEYS;
+        ra[i].pos = i;
+    }
+    sort(ra, LARGE_N, sizeof(record_t), record_comparator);
+    for (i = 1; i < LARGE_N; ++i)
+    {
+        ok &= record_comparator(&ra[i - 1], &ra[i]) <= 0;
+        if (stable && ra[i - 1].key == ra[i].key)
+        {
+            ok &= ra[i - 1].pos < ra[i].pos;
+        }
+    }
+    free(ra);
+    assert(ok);
+}
+
 void test_sort_algorithm(void (*sort)(void *, size_t, size_t, upo_sort_comparator_t));
+void test_sort_algorithm_large(void (*sort)(void *, size_t, size_t, upo_sort_comparator_t), int stable);
+void test_sort_algorithm_special(void (*sort)(void *, size_t, size_t, upo_sort_comparator_t));
 static void test_insertion_sort();
 static void test_merge_sort();
+static void test_merge_sort_ex();
+static void test_merge_sort_bottomup();
+static void test_parallel_merge_sort();
+static void test_adaptive_sort();
 static void test_quick_sort();
+static void test_quick_sort_3way();
+static void test_intro_sort();
+static void test_heap_sort();
+static void test_parallel_quick_sort();
+static void test_radix_sort();
+static void test_indirect_sort();
+static void test_sort_r();
+static void test_sort_by_key();
+static void test_selection();
 static void test_bubble_sort();
+static void test_sort_template();
 static void test_quick_sort_median3_cutoff();
+static void test_sort_stats();
+static int counting_int_comparator(const void *a, const void *b, void *ctx);
 
 int double_comparator(const void *a, const void *b)
 {
@@ -82,6 +292,59 @@ int item_comparator(const void *a, const void *b)
     return (aa->id > bb->id) - (aa->id < bb->id);
 }
 
+void test_sort_algorithm_special(void (*sort)(void *, size_t, size_t, upo_sort_comparator_t))
+{
+    int ok = 1;
+    size_t i = 0;
+    record_t *ra = NULL;
+
+    ra = malloc(LARGE_N * sizeof(record_t));
+    assert(ra != NULL);
+
+    /* Already sorted */
+    for (i = 0; i < LARGE_N; ++i)
+    {
+        ra[i].key = i;
+    }
+    sort(ra, LARGE_N, sizeof(record_t), record_comparator);
+    for (i = 0; i < LARGE_N; ++i)
+    {
+        ok &= ra[i].key == (int)i;
+    }
+    assert(ok);
+
+    /* Reversely sorted */
+    for (i = 0; i < LARGE_N; ++i)
+    {
+        ra[i].key = LARGE_N - i;
+    }
+    sort(ra, LARGE_N, sizeof(record_t), record_comparator);
+    for (i = 0; i < LARGE_N; ++i)
+    {
+        ok &= ra[i].key == (int)(i + 1);
+    }
+    assert(ok);
+
+    /* All equal */
+    for (i = 0; i < LARGE_N; ++i)
+    {
+        ra[i].key = 7;
+    }
+    sort(ra, LARGE_N, sizeof(record_t), record_comparator);
+    for (i = 0; i < LARGE_N; ++i)
+    {
+        ok &= ra[i].key == 7;
+    }
+    assert(ok);
+
+    /* Empty and singleton arrays */
+    sort(ra, 0, sizeof(record_t), record_comparator);
+    sort(ra, 1, sizeof(record_t), record_comparator);
+    assert(ra[0].key == 7);
+
+    free(ra);
+}
+
 void test_sort_algorithm(void (*sort)(void *, size_t, size_t, upo_sort_comparator_t))
 {
     int ok = 1;
@@ -129,12 +392,187 @@ void test_sort_algorithm(void (*sort)(void *, size_t, size_t, upo_sort_comparato
 
 void test_insertion_sort()
 {
+    int ok = 1;
+    size_t i = 0;
+    size_t n = 0;
+    record_t *ra = NULL;
+    record_t *expect_ra = NULL;
+    big_record_t big[N];
+
     test_sort_algorithm(upo_insertion_sort);
+    test_sort_algorithm_special(upo_insertion_sort);
+
+    /* Same result of the reference implementation (both are stable) */
+    ra = malloc(1000 * sizeof(record_t));
+    expect_ra = malloc(1000 * sizeof(record_t));
+    assert(ra != NULL && expect_ra != NULL);
+    srand(N);
+    for (n = 0; n <= 1000; n += 50)
+    {
+        for (i = 0; i < n; ++i)
+        {
+            ra[i].key = rand() % 100;
+            ra[i].pos = i;
+        }
+        memcpy(expect_ra, ra, n * sizeof(record_t));
+        upo_insertion_sort(ra, n, sizeof(record_t), record_comparator);
+        reference_insertion_sort(expect_ra, n, sizeof(record_t), record_comparator);
+        for (i = 0; i < n; ++i)
+        {
+            ok &= ra[i].key == expect_ra[i].key && ra[i].pos == expect_ra[i].pos;
+        }
+        assert(ok);
+    }
+    free(expect_ra);
+    free(ra);
+
+    /* Elements too large to be saved on the stack */
+    for (i = 0; i < N; ++i)
+    {
+        big[i].key = (int) ((i * 5) % N);
+        memset(big[i].payload, big[i].key, sizeof(big[i].payload));
+    }
+    upo_insertion_sort(big, N, sizeof(big[0]), big_record_comparator);
+    for (i = 0; i < N; ++i)
+    {
+        ok &= big[i].key == (int) i && big[i].payload[0] == (char) i && big[i].payload[299] == (char) i;
+    }
+    assert(ok);
 }
 
 void test_merge_sort()
 {
     test_sort_algorithm(upo_merge_sort);
+    test_sort_algorithm_large(upo_merge_sort, 1);
+}
+
+void test_merge_sort_ex()
+{
+    int ok = 1;
+    size_t i = 0;
+    item_t aux[2 * N];
+    item_t stable_ca[2 * N];
+    item_t expect_stable_ca[2 * N];
+
+    /* Elements with the same key must keep their relative order */
+    for (i = 0; i < N; ++i)
+    {
+        stable_ca[i] = ca[i];
+        stable_ca[N + i] = ca[N - 1 - i];
+        stable_ca[N + i].name = "dup";
+        expect_stable_ca[2 * i] = expect_ca[i];
+        expect_stable_ca[2 * i + 1] = expect_ca[i];
+        expect_stable_ca[2 * i + 1].name = "dup";
+    }
+    upo_merge_sort_ex(stable_ca, 2 * N, sizeof(item_t), item_comparator, aux);
+    for (i = 0; i < 2 * N; ++i)
+    {
+        ok &= !item_comparator(&stable_ca[i], &expect_stable_ca[i]);
+        ok &= !strcmp(stable_ca[i].name, expect_stable_ca[i].name);
+    }
+    assert(ok);
+
+    /* The same buffer can be reused across calls */
+    upo_merge_sort_ex(stable_ca, 2 * N, sizeof(item_t), item_comparator, aux);
+    for (i = 0; i < 2 * N; ++i)
+    {
+        ok &= !strcmp(stable_ca[i].name, expect_stable_ca[i].name);
+    }
+    assert(ok);
+}
+
+void test_merge_sort_bottomup()
+{
+    test_sort_algorithm(upo_merge_sort_bottomup);
+    test_sort_algorithm_large(upo_merge_sort_bottomup, 1);
+}
+
+void test_parallel_merge_sort()
+{
+    int ok = 1;
+    size_t i = 0;
+    size_t t = 0;
+    size_t n = 0;
+    size_t sizes[] = {1, 100, 4096 * 2, 4096 * 3 + 1, 100000};
+    size_t nthreads[] = {0, 1, 2, 3, 5, 8};
+    record_t *orig_ra = NULL;
+    record_t *ra = NULL;
+    record_t *expect_ra = NULL;
+
+    orig_ra = malloc(100000 * sizeof(record_t));
+    ra = malloc(100000 * sizeof(record_t));
+    expect_ra = malloc(100000 * sizeof(record_t));
+    assert(orig_ra != NULL && ra != NULL && expect_ra != NULL);
+
+    /* The result must be the same of (stable) merge sort, whatever the number of threads */
+    srand(LARGE_N);
+    for (n = 0; n < sizeof(sizes) / sizeof(sizes[0]); ++n)
+    {
+        for (i = 0; i < sizes[n]; ++i)
+        {
+            orig_ra[i].key = rand() % LARGE_NUM_KEYS;
+            orig_ra[i].pos = i;
+        }
+        memcpy(expect_ra, orig_ra, sizes[n] * sizeof(record_t));
+        upo_merge_sort(expect_ra, sizes[n], sizeof(record_t), record_comparator);
+        for (t = 0; t < sizeof(nthreads) / sizeof(nthreads[0]); ++t)
+        {
+            memcpy(ra, orig_ra, sizes[n] * sizeof(record_t));
+            upo_parallel_merge_sort(ra, sizes[n], sizeof(record_t), record_comparator, nthreads[t]);
+            for (i = 0; i < sizes[n]; ++i)
+            {
+                ok &= ra[i].key == expect_ra[i].key && ra[i].pos == expect_ra[i].pos;
+            }
+            assert(ok);
+        }
+    }
+
+    free(expect_ra);
+    free(ra);
+    free(orig_ra);
+}
+
+void test_adaptive_sort()
+{
+    int ok = 1;
+    size_t i = 0;
+    record_t *ra = NULL;
+
+    test_sort_algorithm(upo_adaptive_sort);
+    test_sort_algorithm_large(upo_adaptive_sort, 1);
+    test_sort_algorithm_special(upo_adaptive_sort);
+
+    ra = malloc(LARGE_N * sizeof(record_t));
+    assert(ra != NULL);
+
+    /* Descending runs with duplicates: only strictly descending runs can be
+     * reversed, so equal keys must keep their relative order */
+    for (i = 0; i < LARGE_N; ++i)
+    {
+        ra[i].key = (LARGE_N - i) / 3;
+        ra[i].pos = i;
+    }
+    upo_adaptive_sort(ra, LARGE_N, sizeof(record_t), record_comparator);
+    for (i = 1; i < LARGE_N; ++i)
+    {
+        ok &= ra[i - 1].key < ra[i].key || (ra[i - 1].key == ra[i].key && ra[i - 1].pos < ra[i].pos);
+    }
+    assert(ok);
+
+    /* Two interleaved sorted halves, which are merged in galloping mode */
+    for (i = 0; i < LARGE_N; ++i)
+    {
+        ra[i].key = (i < LARGE_N / 2) ? (int) (i / 100) * 200 : (int) ((i - LARGE_N / 2) / 100) * 200 + 100;
+        ra[i].pos = i;
+    }
+    upo_adaptive_sort(ra, LARGE_N, sizeof(record_t), record_comparator);
+    for (i = 1; i < LARGE_N; ++i)
+    {
+        ok &= ra[i - 1].key < ra[i].key || (ra[i - 1].key == ra[i].key && ra[i - 1].pos < ra[i].pos);
+    }
+    assert(ok);
+
+    free(ra);
 }
 
 void test_quick_sort()
@@ -142,11 +580,500 @@ void test_quick_sort()
     test_sort_algorithm(upo_quick_sort);
 }
 
+void test_quick_sort_3way()
+{
+    test_sort_algorithm(upo_quick_sort_3way);
+    test_sort_algorithm_large(upo_quick_sort_3way, 0);
+    test_sort_algorithm_special(upo_quick_sort_3way);
+}
+
+void test_intro_sort()
+{
+    test_sort_algorithm(upo_intro_sort);
+    test_sort_algorithm_large(upo_intro_sort, 0);
+    test_sort_algorithm_special(upo_intro_sort);
+}
+
+void test_heap_sort()
+{
+    test_sort_algorithm(upo_heap_sort);
+    test_sort_algorithm_large(upo_heap_sort, 0);
+    test_sort_algorithm_special(upo_heap_sort);
+}
+
+void test_parallel_quick_sort()
+{
+    int ok = 1;
+    size_t i = 0;
+    size_t t = 0;
+    size_t n = 200000;
+    size_t nthreads[] = {0, 1, 2, 3, 8};
+    record_t *ra = NULL;
+
+    ra = malloc(n * sizeof(record_t));
+    assert(ra != NULL);
+
+    srand(LARGE_N);
+    for (t = 0; t < sizeof(nthreads) / sizeof(nthreads[0]); ++t)
+    {
+        /* Random keys with duplicates */
+        for (i = 0; i < n; ++i)
+        {
+            ra[i].key = rand() % LARGE_NUM_KEYS;
+        }
+        upo_parallel_quick_sort(ra, n, sizeof(record_t), record_comparator, nthreads[t]);
+        for (i = 1; i < n; ++i)
+        {
+            ok &= ra[i - 1].key <= ra[i].key;
+        }
+        assert(ok);
+
+        /* Already sorted and reversely sorted keys */
+        for (i = 0; i < n; ++i)
+        {
+            ra[i].key = (t % 2) ? (int) i : (int) (n - i);
+        }
+        upo_parallel_quick_sort(ra, n, sizeof(record_t), record_comparator, nthreads[t]);
+        for (i = 0; i < n; ++i)
+        {
+            ok &= ra[i].key == (int) ((t % 2) ? i : i + 1);
+        }
+        assert(ok);
+    }
+
+    free(ra);
+}
+
+void test_radix_sort()
+{
+    int ok = 1;
+    size_t i = 0;
+    uint32_t *ua = NULL;
+    record_t *ra = NULL;
+    char (*words)[8] = NULL;
+    const char **wa = NULL;
+    const char **expect_wa = NULL;
+    char *sa_clone[N];
+
+    /* Unsigned integers, spanning all digits */
+    srand(LARGE_N);
+    ua = malloc(LARGE_N * sizeof(uint32_t));
+    assert(ua != NULL);
+    for (i = 0; i < LARGE_N; ++i)
+    {
+        ua[i] = ((uint32_t) rand() << 16) ^ (uint32_t) rand();
+    }
+    upo_radix_sort_u32(ua, LARGE_N);
+    for (i = 1; i < LARGE_N; ++i)
+    {
+        ok &= ua[i - 1] <= ua[i];
+    }
+    upo_radix_sort_u32(ua, 0);
+    free(ua);
+    assert(ok);
+
+    /* Records by (signed) key, with duplicates */
+    ra = malloc(LARGE_N * sizeof(record_t));
+    assert(ra != NULL);
+    for (i = 0; i < LARGE_N; ++i)
+    {
+        ra[i].key = rand() % LARGE_NUM_KEYS - LARGE_NUM_KEYS / 2;
+        ra[i].pos = i;
+    }
+    upo_radix_sort_by_key(ra, LARGE_N, sizeof(record_t), record_key);
+    for (i = 1; i < LARGE_N; ++i)
+    {
+        ok &= ra[i - 1].key < ra[i].key || (ra[i - 1].key == ra[i].key && ra[i - 1].pos < ra[i].pos);
+    }
+    free(ra);
+    assert(ok);
+
+    /* Strings */
+    memcpy(sa_clone, sa, N * sizeof(char *));
+    upo_radix_sort_str(sa_clone, N, sizeof(char *), string_key);
+    for (i = 0; i < N; ++i)
+    {
+        ok &= !string_comparator(&sa_clone[i], &expect_sa[i]);
+    }
+    assert(ok);
+
+    /* Many strings with common prefixes, compared against merge sort */
+    words = malloc(LARGE_N * sizeof words[0]);
+    wa = malloc(LARGE_N * sizeof(char *));
+    expect_wa = malloc(LARGE_N * sizeof(char *));
+    assert(words != NULL && wa != NULL && expect_wa != NULL);
+    for (i = 0; i < LARGE_N; ++i)
+    {
+        size_t len = rand() % 7;
+        size_t k;
+
+        for (k = 0; k < len; ++k)
+        {
+            words[i][k] = "ab\xe0"[rand() % 3];
+        }
+        words[i][len] = '\0';
+        wa[i] = words[i];
+    }
+    memcpy(expect_wa, wa, LARGE_N * sizeof(char *));
+    upo_merge_sort(expect_wa, LARGE_N, sizeof(char *), string_comparator);
+    upo_radix_sort_str(wa, LARGE_N, sizeof(char *), string_key);
+    for (i = 0; i < LARGE_N; ++i)
+    {
+        /* Stability: equal strings keep the order of their storage */
+        ok &= wa[i] == expect_wa[i];
+    }
+    free(expect_wa);
+    free(wa);
+    free(words);
+    assert(ok);
+}
+
+void test_indirect_sort()
+{
+    int ok = 1;
+    size_t i = 0;
+    record_t *ra = NULL;
+    record_t *expect_ra = NULL;
+    big_record_t *ba = NULL;
+    size_t *perm = NULL;
+
+    test_sort_algorithm(indirect_sort);
+    test_sort_algorithm_special(indirect_sort);
+    test_sort_algorithm_large(indirect_sort, 1);
+
+    /* With a key prefix, compared against merge sort */
+    srand(LARGE_N);
+    ra = malloc(LARGE_N * sizeof(record_t));
+    expect_ra = malloc(LARGE_N * sizeof(record_t));
+    perm = malloc(LARGE_N * sizeof(size_t));
+    assert(ra != NULL && expect_ra != NULL && perm != NULL);
+    for (i = 0; i < LARGE_N; ++i)
+    {
+        ra[i].key = rand() % LARGE_NUM_KEYS - LARGE_NUM_KEYS / 2;
+        ra[i].pos = i;
+    }
+    memcpy(expect_ra, ra, LARGE_N * sizeof(record_t));
+    upo_merge_sort(expect_ra, LARGE_N, sizeof(record_t), record_comparator);
+
+    /* The permutation alone leaves the array untouched */
+    upo_sort_permutation(ra, LARGE_N, sizeof(record_t), record_comparator, record_key, perm);
+    for (i = 0; i < LARGE_N; ++i)
+    {
+        ok &= ra[i].pos == i;
+        ok &= ra[perm[i]].pos == expect_ra[i].pos;
+    }
+    assert(ok);
+
+    /* Applying it sorts the array and resets it to the identity */
+    upo_sort_apply_permutation(ra, LARGE_N, sizeof(record_t), perm);
+    for (i = 0; i < LARGE_N; ++i)
+    {
+        ok &= ra[i].pos == expect_ra[i].pos;
+        ok &= perm[i] == i;
+    }
+    assert(ok);
+
+    /* Sorting again changes nothing */
+    upo_sort_indirect(ra, LARGE_N, sizeof(record_t), record_comparator, record_key);
+    for (i = 0; i < LARGE_N; ++i)
+    {
+        ok &= ra[i].pos == expect_ra[i].pos;
+    }
+    free(perm);
+    free(expect_ra);
+    free(ra);
+    assert(ok);
+
+    /* Big records */
+    ba = malloc(N * sizeof(big_record_t));
+    assert(ba != NULL);
+    for (i = 0; i < N; ++i)
+    {
+        ba[i].key = (int) (N - i) / 2;
+        memset(ba[i].payload, (int) i, sizeof ba[i].payload);
+    }
+    upo_sort_indirect(ba, N, sizeof(big_record_t), big_record_comparator, NULL);
+    for (i = 1; i < N; ++i)
+    {
+        ok &= ba[i - 1].key < ba[i].key || (ba[i - 1].key == ba[i].key && ba[i - 1].payload[0] < ba[i].payload[0]);
+        ok &= ba[i].payload[0] == ba[i].payload[sizeof ba[i].payload - 1];
+    }
+    free(ba);
+    assert(ok);
+
+    /* Empty and singleton arrays */
+    upo_sort_indirect(ca, 0, sizeof(item_t), item_comparator, NULL);
+    upo_sort_indirect(ca, 1, sizeof(item_t), item_comparator, NULL);
+}
+
+void test_sort_r()
+{
+    void (*sorts[])(void *, size_t, size_t, upo_sort_comparator_r_t, void *) = {
+        upo_insertion_sort_r, upo_merge_sort_r, merge_sort_ex_r, upo_merge_sort_bottomup_r,
+        upo_adaptive_sort_r, parallel_merge_sort_r, sort_indirect_r, upo_bubble_sort_r,
+        upo_quick_sort_r, upo_quick_sort_3way_r, upo_intro_sort_r, upo_heap_sort_r,
+        parallel_quick_sort_r, upo_quick_sort_median3_cutoff_r
+    };
+    /* The first num_stable sorts are stable */
+    const size_t num_stable = 8;
+    int ok = 1;
+    size_t i = 0;
+    size_t k = 0;
+    record_t *ra = NULL;
+    record_sort_ctx_t rc;
+
+    ra = malloc(LARGE_N * sizeof(record_t));
+    assert(ra != NULL);
+    for (k = 0; k < sizeof sorts / sizeof sorts[0]; ++k)
+    {
+        /* Quadratic sorts get a smaller array */
+        size_t n = (sorts[k] == upo_insertion_sort_r || sorts[k] == upo_bubble_sort_r) ? LARGE_N / 10 : LARGE_N;
+
+        srand(LARGE_N);
+        for (i = 0; i < n; ++i)
+        {
+            ra[i].key = rand() % LARGE_NUM_KEYS;
+            ra[i].pos = i;
+        }
+        /* The context reverses the order and counts the comparisons */
+        rc.descending = 1;
+        rc.num_calls = 0;
+        sorts[k](ra, n, sizeof(record_t), record_ctx_comparator, &rc);
+        ok &= rc.num_calls > 0;
+        for (i = 1; i < n; ++i)
+        {
+            ok &= ra[i - 1].key >= ra[i].key;
+            if (k < num_stable && ra[i - 1].key == ra[i].key)
+            {
+                ok &= ra[i - 1].pos < ra[i].pos;
+            }
+        }
+        assert(ok);
+    }
+    free(ra);
+}
+
+void test_sort_by_key()
+{
+    int ok = 1;
+    size_t i = 0;
+    size_t key_size = 0;
+    person_t *pa = NULL;
+    person_t *expect_pa = NULL;
+    static const char *names[] = {"ann", "annabel", "annabella", "annabelle", "bob", "", "zoe"};
+
+    srand(LARGE_N);
+    pa = malloc(LARGE_N * sizeof(person_t));
+    expect_pa = malloc(LARGE_N * sizeof(person_t));
+    assert(pa != NULL && expect_pa != NULL);
+    for (i = 0; i < LARGE_N; ++i)
+    {
+        pa[i].age = rand() % 100 - 10;
+        pa[i].name = names[rand() % (sizeof names / sizeof names[0])];
+        pa[i].pos = i;
+    }
+
+    /* Exact key: age only */
+    key_size = 4;
+    memcpy(expect_pa, pa, LARGE_N * sizeof(person_t));
+    upo_merge_sort_r(expect_pa, LARGE_N, sizeof(person_t), person_comparator, &key_size);
+    upo_sort_by_key_r(pa, LARGE_N, sizeof(person_t), 4, person_key, NULL, &key_size);
+    for (i = 0; i < LARGE_N; ++i)
+    {
+        ok &= pa[i].pos == expect_pa[i].pos;
+    }
+    assert(ok);
+
+    /* Age, then name truncated to 6 bytes: ties go to the comparator */
+    key_size = 10;
+    memcpy(expect_pa, pa, LARGE_N * sizeof(person_t));
+    upo_merge_sort_r(expect_pa, LARGE_N, sizeof(person_t), person_comparator, &key_size);
+    upo_sort_by_key_r(pa, LARGE_N, sizeof(person_t), key_size, person_key, person_comparator, &key_size);
+    for (i = 0; i < LARGE_N; ++i)
+    {
+        ok &= pa[i].pos == expect_pa[i].pos;
+    }
+    assert(ok);
+
+    /* Keys shorter than the prefix */
+    key_size = 2;
+    srand(N);
+    for (i = 0; i < LARGE_N; ++i)
+    {
+        pa[i].name = names[rand() % (sizeof names / sizeof names[0])];
+        pa[i].pos = i;
+    }
+    memcpy(expect_pa, pa, LARGE_N * sizeof(person_t));
+    upo_merge_sort_r(expect_pa, LARGE_N, sizeof(person_t), person_comparator, &key_size);
+    upo_sort_by_key_r(pa, LARGE_N, sizeof(person_t), key_size, person_key, person_comparator, &key_size);
+    for (i = 0; i < LARGE_N; ++i)
+    {
+        ok &= pa[i].pos == expect_pa[i].pos;
+    }
+    free(expect_pa);
+    free(pa);
+    assert(ok);
+}
+
+void test_selection()
+{
+    int ok = 1;
+    size_t i = 0;
+    size_t t = 0;
+    size_t ks[] = {0, 1, 7, 100, LARGE_N / 2, LARGE_N - 1};
+    record_t *ra = NULL;
+    record_t *sorted_ra = NULL;
+    record_t *work_ra = NULL;
+    upo_top_k_t top = NULL;
+
+    srand(LARGE_N);
+    ra = malloc(LARGE_N * sizeof(record_t));
+    sorted_ra = malloc(LARGE_N * sizeof(record_t));
+    work_ra = malloc(LARGE_N * sizeof(record_t));
+    assert(ra != NULL && sorted_ra != NULL && work_ra != NULL);
+    for (i = 0; i < LARGE_N; ++i)
+    {
+        ra[i].key = rand() % LARGE_NUM_KEYS;
+        ra[i].pos = i;
+    }
+    memcpy(sorted_ra, ra, LARGE_N * sizeof(record_t));
+    upo_merge_sort(sorted_ra, LARGE_N, sizeof(record_t), record_comparator);
+
+    for (t = 0; t < sizeof ks / sizeof ks[0]; ++t)
+    {
+        size_t k = ks[t];
+
+        /* Selection: the k-th key is in place and the array is partitioned around it */
+        memcpy(work_ra, ra, LARGE_N * sizeof(record_t));
+        upo_select_nth(work_ra, LARGE_N, sizeof(record_t), record_comparator, k);
+        ok &= work_ra[k].key == sorted_ra[k].key;
+        for (i = 0; i < LARGE_N; ++i)
+        {
+            ok &= (i < k) ? work_ra[i].key <= work_ra[k].key : work_ra[i].key >= work_ra[k].key;
+        }
+        assert(ok);
+
+        /* Partial sort: the first k keys are the sorted ones */
+        memcpy(work_ra, ra, LARGE_N * sizeof(record_t));
+        upo_partial_sort(work_ra, LARGE_N, sizeof(record_t), record_comparator, k);
+        for (i = 0; i < k; ++i)
+        {
+            ok &= work_ra[i].key == sorted_ra[i].key;
+        }
+        for (i = k; k > 0 && i < LARGE_N; ++i)
+        {
+            ok &= work_ra[i].key >= work_ra[k - 1].key;
+        }
+        assert(ok);
+
+        /* Top-k: the same keys as the first k sorted records */
+        if (k > 0)
+        {
+            top = upo_top_k_create(k, sizeof(record_t), record_comparator);
+            upo_top_k_push_array(top, ra, LARGE_N);
+            ok &= upo_top_k_size(top) == k;
+            ok &= upo_top_k_get(top, work_ra) == k;
+            for (i = 0; i < k; ++i)
+            {
+                ok &= work_ra[i].key == sorted_ra[i].key;
+            }
+            upo_top_k_destroy(top);
+            assert(ok);
+        }
+    }
+
+    /* Fewer elements than k, and reuse after clearing */
+    top = upo_top_k_create(N + 1, sizeof(double), double_comparator);
+    upo_top_k_push_array(top, da, N);
+    ok &= upo_top_k_size(top) == N;
+    upo_top_k_get(top, work_ra);
+    ok &= !memcmp(work_ra, expect_da, N * sizeof(double));
+    upo_top_k_clear(top);
+    ok &= upo_top_k_size(top) == 0;
+    upo_top_k_push(top, &da[0]);
+    ok &= upo_top_k_size(top) == 1;
+    upo_top_k_destroy(top);
+
+    /* Partial sort of the whole array, and of small arrays */
+    memcpy(work_ra, ra, LARGE_N * sizeof(record_t));
+    upo_partial_sort(work_ra, LARGE_N, sizeof(record_t), record_comparator, LARGE_N + 1);
+    for (i = 0; i < LARGE_N; ++i)
+    {
+        ok &= work_ra[i].key == sorted_ra[i].key;
+    }
+    memcpy(work_ra, ra, 3 * sizeof(record_t));
+    upo_select_nth(work_ra, 3, sizeof(record_t), record_comparator, 2);
+    ok &= work_ra[2].key >= work_ra[0].key && work_ra[2].key >= work_ra[1].key;
+    upo_select_nth(work_ra, 1, sizeof(record_t), record_comparator, 0);
+    upo_partial_sort(work_ra, 0, sizeof(record_t), record_comparator, 1);
+
+    free(work_ra);
+    free(sorted_ra);
+    free(ra);
+    assert(ok);
+}
+
 void test_bubble_sort()
 {
     test_sort_algorithm(upo_bubble_sort);
 }
 
+void test_sort_template()
+{
+    int ok = 1;
+    size_t i = 0;
+    int ia[LARGE_N];
+    double da_clone[N];
+    upo_sort_kv_t kva[LARGE_N];
+    void (*int_sorts[])(int *, size_t) = {upo_int_insertion_sort, upo_int_merge_sort, upo_int_quick_sort};
+    void (*double_sorts[])(double *, size_t) = {upo_double_insertion_sort, upo_double_merge_sort, upo_double_quick_sort};
+    void (*kv_sorts[])(upo_sort_kv_t *, size_t) = {upo_kv_insertion_sort, upo_kv_merge_sort, upo_kv_quick_sort};
+    size_t s;
+
+    for (s = 0; s < 3; ++s)
+    {
+        size_t n = (s == 0) ? 1000 : LARGE_N;
+
+        memcpy(da_clone, da, N * sizeof(double));
+        double_sorts[s](da_clone, N);
+        for (i = 0; i < N; ++i)
+        {
+            ok &= !double_comparator(&da_clone[i], &expect_da[i]);
+        }
+        assert(ok);
+
+        srand(LARGE_N);
+        for (i = 0; i < n; ++i)
+        {
+            ia[i] = rand() % LARGE_NUM_KEYS;
+            kva[i].key = ia[i];
+            kva[i].value = i;
+        }
+        int_sorts[s](ia, n);
+        kv_sorts[s](kva, n);
+        for (i = 1; i < n; ++i)
+        {
+            ok &= ia[i - 1] <= ia[i];
+            ok &= kva[i - 1].key <= kva[i].key;
+            if (s < 2 && kva[i - 1].key == kva[i].key)
+            {
+                /* Insertion sort and merge sort are stable */
+                ok &= kva[i - 1].value < kva[i].value;
+            }
+        }
+        assert(ok);
+
+        /* Sorted and empty input */
+        int_sorts[s](ia, n);
+        int_sorts[s](ia, 0);
+        for (i = 1; i < n; ++i)
+        {
+            ok &= ia[i - 1] <= ia[i];
+        }
+        assert(ok);
+    }
+}
+
 void test_quick_sort_median3_cutoff()
 {
     int ok = 1;
@@ -159,6 +1086,124 @@ void test_quick_sort_median3_cutoff()
     }
     assert(ok);
     test_sort_algorithm(upo_quick_sort_median3_cutoff);
+    test_sort_algorithm_large(upo_quick_sort_median3_cutoff, 0);
+    test_sort_algorithm_special(upo_quick_sort_median3_cutoff);
+}
+
+int counting_int_comparator(const void *a, const void *b, void *ctx)
+{
+    const int *aa = a;
+    const int *bb = b;
+
+    ++*(size_t *) ctx;
+
+    return (*aa > *bb) - (*aa < *bb);
+}
+
+void test_sort_stats()
+{
+    void (*sorts[])(void *, size_t, size_t, upo_sort_comparator_r_t, void *) = {
+        upo_insertion_sort_r,
+        upo_merge_sort_r,
+        upo_merge_sort_bottomup_r,
+        upo_adaptive_sort_r,
+        upo_quick_sort_r,
+        upo_quick_sort_3way_r,
+        upo_intro_sort_r,
+        upo_heap_sort_r,
+        upo_quick_sort_median3_cutoff_r
+    };
+    size_t num_sorts = sizeof(sorts) / sizeof(sorts[0]);
+    size_t n = 1000;
+    int *a = malloc(n * sizeof(int));
+    double *da = NULL;
+    upo_sort_stats_t stats;
+    size_t num_compares;
+    size_t s;
+    size_t i;
+
+    assert(a != NULL);
+
+    upo_sort_stats_reset();
+    upo_sort_stats_get(&stats);
+    assert(stats.num_compares == 0 && stats.num_swaps == 0 && stats.num_bytes_moved == 0);
+    assert(stats.num_allocs == 0 && stats.max_depth == 0);
+
+    if (!upo_sort_stats_enabled())
+    {
+        /* Nothing is counted */
+        for (i = 0; i < n; ++i)
+        {
+            a[i] = rand();
+        }
+        upo_merge_sort_r(a, n, sizeof(int), counting_int_comparator, &num_compares);
+        upo_sort_stats_get(&stats);
+        assert(stats.num_compares == 0 && stats.num_allocs == 0 && stats.max_depth == 0);
+        free(a);
+        return;
+    }
+
+    /* Every call to the comparison function is counted */
+    for (s = 0; s < num_sorts; ++s)
+    {
+        for (i = 0; i < n; ++i)
+        {
+            a[i] = rand() % 100;
+        }
+        num_compares = 0;
+        upo_sort_stats_reset();
+        sorts[s](a, n, sizeof(int), counting_int_comparator, &num_compares);
+        upo_sort_stats_get(&stats);
+        assert(stats.num_compares == num_compares);
+        assert(stats.num_bytes_moved >= 2 * sizeof(int) * stats.num_swaps);
+    }
+
+    /* Merge sort allocates its auxiliary array once and recurses log2(n) times */
+    upo_sort_stats_reset();
+    upo_merge_sort_r(a, n, sizeof(int), counting_int_comparator, &num_compares);
+    upo_sort_stats_get(&stats);
+    assert(stats.num_allocs == 1);
+    assert(stats.num_swaps == 0);
+    assert(stats.max_depth == 10);
+
+    /* Heap sort works in place through swaps */
+    upo_sort_stats_reset();
+    upo_heap_sort_r(a, n, sizeof(int), counting_int_comparator, &num_compares);
+    upo_sort_stats_get(&stats);
+    assert(stats.num_allocs == 0);
+    assert(stats.num_swaps >= n - 1);
+    assert(stats.max_depth == 0);
+
+    /* Plain quick sort recurses once per element on sorted input */
+    for (i = 0; i < n; ++i)
+    {
+        a[i] = i;
+    }
+    upo_sort_stats_reset();
+    upo_quick_sort_r(a, n, sizeof(int), counting_int_comparator, &num_compares);
+    upo_sort_stats_get(&stats);
+    assert(stats.max_depth == n - 1);
+
+    free(a);
+
+    /* Threads add up to the same counters */
+    n = 4 * LARGE_N;
+    da = malloc(n * sizeof(double));
+    assert(da != NULL);
+    for (i = 0; i < n; ++i)
+    {
+        da[i] = rand();
+    }
+    upo_sort_stats_reset();
+    upo_parallel_merge_sort(da, n, sizeof(double), double_comparator, 4);
+    upo_sort_stats_get(&stats);
+    assert(stats.num_compares >= n);
+    assert(stats.num_allocs >= 1);
+    for (i = 1; i < n; ++i)
+    {
+        assert(da[i - 1] <= da[i]);
+    }
+    free(da);
 }
 
 int main()
@@ -173,20 +1218,95 @@ int main()
     test_merge_sort();
     printf("OK\n");
 
+    printf("Test case 'merge sort with auxiliary buffer'... ");
+    fflush(stdout);
+    test_merge_sort_ex();
+    printf("OK\n");
+
+    printf("Test case 'bottom-up merge sort'... ");
+    fflush(stdout);
+    test_merge_sort_bottomup();
+    printf("OK\n");
+
+    printf("Test case 'adaptive sort'... ");
+    fflush(stdout);
+    test_adaptive_sort();
+    printf("OK\n");
+
+    printf("Test case 'parallel merge sort'... ");
+    fflush(stdout);
+    test_parallel_merge_sort();
+    printf("OK\n");
+
     printf("Test case 'quick sort'... ");
     fflush(stdout);
     test_quick_sort();
     printf("OK\n");
 
+    printf("Test case 'quick sort 3-way'... ");
+    fflush(stdout);
+    test_quick_sort_3way();
+    printf("OK\n");
+
+    printf("Test case 'intro sort'... ");
+    fflush(stdout);
+    test_intro_sort();
+    printf("OK\n");
+
+    printf("Test case 'heap sort'... ");
+    fflush(stdout);
+    test_heap_sort();
+    printf("OK\n");
+
+    printf("Test case 'parallel quick sort'... ");
+    fflush(stdout);
+    test_parallel_quick_sort();
+    printf("OK\n");
+
+    printf("Test case 'radix sort'... ");
+    fflush(stdout);
+    test_radix_sort();
+    printf("OK\n");
+
+    printf("Test case 'indirect sort'... ");
+    fflush(stdout);
+    test_indirect_sort();
+    printf("OK\n");
+
+    printf("Test case 'sorts with context'... ");
+    fflush(stdout);
+    test_sort_r();
+    printf("OK\n");
+
+    printf("Test case 'sort by normalized key'... ");
+    fflush(stdout);
+    test_sort_by_key();
+    printf("OK\n");
+
+    printf("Test case 'selection and partial sort'... ");
+    fflush(stdout);
+    test_selection();
+    printf("OK\n");
+
     printf("Test case 'bubble sort'... ");
     fflush(stdout);
     test_bubble_sort();
     printf("OK\n");
 
+    printf("Test case 'type-specialized sorts'... ");
+    fflush(stdout);
+    test_sort_template();
+    printf("OK\n");
+
     printf("Test case 'quick sort median 3 with cutoff'... ");
     fflush(stdout);
     test_quick_sort_median3_cutoff();
     printf("OK\n");
 
+    printf("Test case 'sort statistics'... ");
+    fflush(stdout);
+    test_sort_stats();
+    printf("OK\n");
+
     return 0;
 }
@@ -0,0 +1,184 @@
+/* vim: set tabstop=4 expandtab shiftwidth=4 softtabstop=4: */
+
+/**
+ * \file test/test_task.c
+ *
+ * \brief Implementation for task scheduler testing.
+ *
+ * \author Simone Gattini, Federico Barbero, Anton Iliev
+ *
+ * \copyright 2015 University of Piemonte Orientale, Computer Science Institute
+ *
+ *  This file is part of UPOalglib.
+ *
+ *  UPOalglib is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  UPOalglib is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with UPOalglib.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <assert.h>
+#include <stdatomic.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <upo/task.h>
+
+
+#define NUM_FLAT_TASKS 1000
+#define TREE_DEPTH 12
+
+
+/** \brief The argument of the tasks of the tree test. */
+typedef struct {
+            atomic_size_t *num_leaves;
+            size_t depth;
+        } tree_node_t;
+
+
+static void count_task(upo_task_pool_t pool, void *arg);
+static void tree_task(upo_task_pool_t pool, void *arg);
+static void spawn_tree_node(upo_task_pool_t pool, atomic_size_t *num_leaves, size_t depth);
+
+static void test_create_destroy();
+static void test_flat_tasks();
+static void test_nested_tasks();
+static void test_empty_wait();
+
+
+void count_task(upo_task_pool_t pool, void *arg)
+{
+    (void) pool;
+
+    atomic_fetch_add((atomic_size_t *) arg, 1);
+}
+
+void tree_task(upo_task_pool_t pool, void *arg)
+{
+    tree_node_t node = *(tree_node_t *) arg;
+
+    free(arg);
+    if (node.depth == 0)
+    {
+        atomic_fetch_add(node.num_leaves, 1);
+        return;
+    }
+    spawn_tree_node(pool, node.num_leaves, node.depth - 1);
+    spawn_tree_node(pool, node.num_leaves, node.depth - 1);
+}
+
+void spawn_tree_node(upo_task_pool_t pool, atomic_size_t *num_leaves, size_t depth)
+{
+    tree_node_t *node = malloc(sizeof(tree_node_t));
+
+    assert(node != NULL);
+    node->num_leaves = num_leaves;
+    node->depth = depth;
+    upo_task_spawn(pool, tree_task, node);
+}
+
+void test_create_destroy()
+{
+    size_t nthreads;
+
+    for (nthreads = 1; nthreads <= 4; ++nthreads)
+    {
+        upo_task_pool_t pool = upo_task_pool_create(nthreads);
+        assert(pool != NULL);
+        assert(upo_task_pool_size(pool) == nthreads);
+        upo_task_pool_destroy(pool);
+    }
+
+    /* Zero means as many threads as the processors */
+    upo_task_pool_t pool = upo_task_pool_create(0);
+    assert(pool != NULL);
+    assert(upo_task_pool_size(pool) >= 1);
+    upo_task_pool_destroy(pool);
+
+    upo_task_pool_destroy(NULL);
+}
+
+void test_flat_tasks()
+{
+    size_t nthreads;
+
+    for (nthreads = 1; nthreads <= 4; ++nthreads)
+    {
+        upo_task_pool_t pool = upo_task_pool_create(nthreads);
+        atomic_size_t counter;
+        size_t round;
+
+        atomic_init(&counter, 0);
+        /* The same pool can be waited for several times */
+        for (round = 1; round <= 3; ++round)
+        {
+            size_t i;
+
+            for (i = 0; i < NUM_FLAT_TASKS; ++i)
+            {
+                upo_task_spawn(pool, count_task, &counter);
+            }
+            upo_task_pool_wait(pool);
+            assert(atomic_load(&counter) == round * NUM_FLAT_TASKS);
+        }
+        upo_task_pool_destroy(pool);
+    }
+}
+
+void test_nested_tasks()
+{
+    size_t nthreads;
+
+    for (nthreads = 1; nthreads <= 8; nthreads *= 2)
+    {
+        upo_task_pool_t pool = upo_task_pool_create(nthreads);
+        atomic_size_t num_leaves;
+
+        atomic_init(&num_leaves, 0);
+        spawn_tree_node(pool, &num_leaves, TREE_DEPTH);
+        upo_task_pool_wait(pool);
+        assert(atomic_load(&num_leaves) == (size_t) 1 << TREE_DEPTH);
+        upo_task_pool_destroy(pool);
+    }
+}
+
+void test_empty_wait()
+{
+    upo_task_pool_t pool = upo_task_pool_create(2);
+
+    upo_task_pool_wait(pool);
+    upo_task_pool_destroy(pool);
+}
+
+
+int main(void)
+{
+    printf("Test case 'create/destroy'... ");
+    fflush(stdout);
+    test_create_destroy();
+    printf("OK\n");
+
+    printf("Test case 'flat tasks'... ");
+    fflush(stdout);
+    test_flat_tasks();
+    printf("OK\n");
+
+    printf("Test case 'nested tasks'... ");
+    fflush(stdout);
+    test_nested_tasks();
+    printf("OK\n");
+
+    printf("Test case 'wait without tasks'... ");
+    fflush(stdout);
+    test_empty_wait();
+    printf("OK\n");
+
+    return 0;
+}
@@ -0,0 +1,129 @@
+/* vim: set tabstop=4 expandtab shiftwidth=4 softtabstop=4: */
+
+/*
+ * Copyright 2015 University of Piemonte Orientale, Computer Science Institute
+ *
+ * This file is part of UPOalglib.
+ *
+ * UPOalglib is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * UPOalglib is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with UPOalglib.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <assert.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+#include <upo/utility.h>
+
+
+/**
+ * \brief The largest size of the swapped buffers.
+ *
+ * Besides every size up to `2*sizeof(uintmax_t) + 3`, which covers the fast
+ * paths, the word loop and the byte tail, it spans two of the 32-byte chunks
+ * that upo_swap() exchanges at once.
+ */
+#define MAX_SWAP_SIZE (2*32 + 2*sizeof(uintmax_t))
+
+/** \brief The room left around the swapped buffers, to misalign them and to detect overruns. */
+#define SWAP_PADDING sizeof(uintmax_t)
+
+
+static void swap_bytes(unsigned char *a, unsigned char *b, size_t size);
+
+static void test_swap();
+static void test_swap_same();
+
+
+void swap_bytes(unsigned char *a, unsigned char *b, size_t size)
+{
+    size_t i;
+
+    for (i = 0; i < size; ++i)
+    {
+        unsigned char tmp = a[i];
+        a[i] = b[i];
+        b[i] = tmp;
+    }
+}
+
+void test_swap()
+{
+    unsigned char buf[2*(MAX_SWAP_SIZE + 2*SWAP_PADDING)];
+    unsigned char ref[sizeof buf];
+    size_t half = sizeof buf / 2;
+    size_t size;
+    size_t off_a;
+    size_t off_b;
+    size_t i;
+
+    /* Every size, with the buffers starting at every misalignment within a
+     * word */
+    for (size = 0; size <= MAX_SWAP_SIZE; ++size)
+    {
+        for (off_a = 0; off_a < SWAP_PADDING; ++off_a)
+        {
+            for (off_b = 0; off_b < SWAP_PADDING; ++off_b)
+            {
+                unsigned char *a = buf + SWAP_PADDING + off_a;
+                unsigned char *b = buf + half + SWAP_PADDING + off_b;
+
+                for (i = 0; i < sizeof buf; ++i)
+                {
+                    buf[i] = (unsigned char) (i*7 + 1);
+                }
+                memcpy(ref, buf, sizeof buf);
+
+                upo_swap(a, b, size);
+                swap_bytes(ref + (a - buf), ref + (b - buf), size);
+
+                assert( memcmp(buf, ref, sizeof buf) == 0 );
+            }
+        }
+    }
+}
+
+void test_swap_same()
+{
+    unsigned char buf[MAX_SWAP_SIZE];
+    unsigned char ref[sizeof buf];
+    size_t i;
+
+    for (i = 0; i < sizeof buf; ++i)
+    {
+        buf[i] = (unsigned char) i;
+    }
+    memcpy(ref, buf, sizeof buf);
+
+    /* Swapping a buffer with itself leaves it unchanged */
+    upo_swap(buf, buf, sizeof buf);
+
+    assert( memcmp(buf, ref, sizeof buf) == 0 );
+}
+
+
+int main()
+{
+    printf("Test case 'swap'... ");
+    fflush(stdout);
+    test_swap();
+    printf("OK\n");
+
+    printf("Test case 'swap (same buffer)'... ");
+    fflush(stdout);
+    test_swap_same();
+    printf("OK\n");
+
+    return 0;
+}